@@ -1,23 +1,18 @@
 #ifndef DATA_CHANNEL_H
 #define DATA_CHANNEL_H
 
+#include "nav_sample.h"
+
 #include <Arduino.h>
 #include <stdint.h>
 
-struct NavDataSample {
-  float latitude = 0.0f;
-  float longitude = 0.0f;
-  float heading = 0.0f;
-  float speed = 0.0f;
-  float altitude = 0.0f;
-};
-
 struct SystemStatusSample {
   uint8_t fix = 0;
   float hdop = 0.0f;
   uint8_t satellites = 0;
   int32_t ttffSeconds = -1;
   String signalsJson;
+  uint8_t rfFlags = 0; // kRfFlagJamming | kRfFlagSpoofing
 };
 
 class NavDataPublisher {
@@ -9,12 +9,12 @@ public:
 
 private:
   void configurePublishers();
+  void scheduleTasks();
   static void onWifiApStateChanged(bool active);
   void processPendingRestart();
 
   bool restartPending = false;
   const char *restartReason = nullptr;
-  unsigned long restartRequestedAt = 0;
 };
 
 FirmwareApp &firmwareApp();
@@ -0,0 +1,69 @@
+#ifndef FIX_HISTORY_H
+#define FIX_HISTORY_H
+
+#include "data_channel.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One measured fix in the replay ring; 40 bytes against 64 for a
+// NavDataSample.
+struct HistoryFix {
+  uint32_t sequence = 0;
+  uint32_t recordedMs = 0; // millis() when the fix was published
+  int64_t utcMs = 0;       // 0 while GNSS time is unknown
+  int32_t latitudeE7 = 0;
+  int32_t longitudeE7 = 0;
+  int32_t altitudeCm = 0;
+  uint16_t speedCms = 0;
+  uint16_t headingCdeg = 0;
+  uint16_t horizontalAccuracyCm = 0; // saturates at 655 m
+  uint16_t verticalAccuracyCm = 0;
+  uint16_t speedAccuracyCms = 0;
+  uint8_t headingAccuracyDeg = 0;
+  uint8_t flags = 0;
+};
+
+struct FixHistoryStats {
+  uint32_t capacity = 0;
+  uint32_t stored = 0;
+  uint32_t oldestSequence = 0;
+  uint32_t latestSequence = 0;
+  uint32_t catchUps = 0;
+  uint32_t replayedFixes = 0;
+};
+
+/**
+ * RAM ring of the last FIX_HISTORY_CAPACITY measured fixes, numbered with a
+ * per-boot sequence starting at 1. Live samples carry the sequence of the
+ * fix they came from, so a client that loses its link can ask for every fix
+ * after the last sequence it saw and get the gap replayed before live data
+ * resumes. Sequence n lives in slot (n - 1) % capacity, so a lookup is a
+ * bounds check and an index. Long outages are covered by the track logger
+ * on flash rather than by this ring.
+ */
+class FixHistory {
+public:
+  // Stores a measured fix and returns its sequence.
+  uint32_t append(const NavDataSample &sample, uint32_t nowMs);
+  // First stored fix with sequence > after. A client sequence from the
+  // future (i.e. before a reboot) restarts from the oldest fix.
+  bool next(uint32_t after, HistoryFix &out) const;
+  uint32_t latestSequence() const { return latest; }
+  uint32_t oldestSequence() const;
+  void noteCatchUp() { catchUps++; }
+  void noteReplayed() { replayedFixes++; }
+  FixHistoryStats stats() const;
+
+private:
+  uint32_t latest = 0;
+  uint32_t catchUps = 0;
+  uint32_t replayedFixes = 0;
+};
+
+FixHistory &fixHistory();
+
+// Expands a stored fix back into a sample for the publishers' encoders.
+NavDataSample historyFixToSample(const HistoryFix &fix);
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+enum class GeofenceShape : uint8_t { Circle = 0, Polygon = 1 };
+
+struct Geofence {
+  uint16_t id = 0;
+  GeofenceShape shape = GeofenceShape::Circle;
+  // Bounding box in 1e-7 degrees; fences may not cross the antimeridian.
+  int32_t minLatitudeE7 = 0;
+  int32_t maxLatitudeE7 = 0;
+  int32_t minLongitudeE7 = 0;
+  int32_t maxLongitudeE7 = 0;
+  // Circle: centre, radius in latitude units and Q15 cos(latitude).
+  int32_t centerLatitudeE7 = 0;
+  int32_t centerLongitudeE7 = 0;
+  int64_t radiusSquaredE7 = 0;
+  int32_t cosQ15 = 0;
+  // Polygon: vertices in the shared vertex arrays.
+  uint32_t firstVertex = 0;
+  uint16_t vertexCount = 0;
+};
+
+struct GeofenceTransition {
+  uint16_t fenceId = 0;
+  bool entered = false;
+};
+
+/**
+ * Circles and polygons with a uniform grid index over their common
+ * bounding box. Each fence is listed in every cell its bounding box
+ * touches, so a fix only tests the fences of its own cell (plus the few
+ * that cover most of the grid and are tested always), then the ones it
+ * was inside of. The exact test is integer-only: a crossing-number test
+ * on 1e-7 degree coordinates for polygons and a Q15-scaled distance for
+ * circles. A membership change must hold for two fixes before it is
+ * reported, so jitter on a boundary does not flap.
+ */
+class GeofenceSet {
+public:
+  void clear();
+  bool addCircle(uint16_t id, int32_t latitudeE7, int32_t longitudeE7,
+                 uint32_t radiusM);
+  bool addPolygon(uint16_t id, const int32_t *latitudeE7,
+                  const int32_t *longitudeE7, size_t count);
+  // Rebuilds the grid; call after the last add.
+  void build();
+  // Tests a fix; writes confirmed transitions to out and returns how many.
+  size_t update(int32_t latitudeE7, int32_t longitudeE7,
+                GeofenceTransition *out, size_t capacity);
+  bool contains(size_t index, int32_t latitudeE7, int32_t longitudeE7) const;
+
+  size_t size() const { return fences.size(); }
+  size_t vertexCount() const { return vertexLatitude.size(); }
+  size_t insideCount() const;
+  const Geofence &fence(size_t index) const { return fences[index]; }
+  bool inside(size_t index) const { return (state[index] & kInside) != 0; }
+  uint32_t lastCandidates() const { return candidates; }
+  uint32_t gridCells() const { return columns * rows; }
+
+private:
+  static constexpr uint8_t kInside = 0x01;
+  static constexpr uint8_t kPendingStep = 0x02;
+
+  bool addFence(const Geofence &fence);
+  bool evaluate(uint16_t index, int32_t latitudeE7, int32_t longitudeE7,
+                GeofenceTransition *out, size_t capacity, size_t &count);
+
+  std::vector<Geofence> fences;
+  std::vector<int32_t> vertexLatitude;
+  std::vector<int32_t> vertexLongitude;
+  std::vector<uint32_t> cellStart; // CSR offsets into cellFences
+  std::vector<uint16_t> cellFences;
+  std::vector<uint16_t> wideFences;
+  std::vector<uint8_t> state; // kInside plus a pending-change count
+  std::vector<uint32_t> visited;
+  std::vector<uint16_t> active; // inside or pending
+  std::vector<uint16_t> nextActive;
+  uint32_t stamp = 0;
+  uint32_t candidates = 0;
+  int32_t gridLatitudeE7 = 0;
+  int32_t gridLongitudeE7 = 0;
+  int64_t cellHeightE7 = 1;
+  int64_t cellWidthE7 = 1;
+  uint32_t columns = 0;
+  uint32_t rows = 0;
+};
+
+// One line of the upload format:
+//   C <id> <lat> <lon> <radius_m>
+//   P <id> <lat>,<lon> <lat>,<lon> <lat>,<lon> ...
+// Blank lines and lines starting with '#' are accepted and ignored.
+bool parseGeofenceLine(const char *line, GeofenceSet &set);
+
+#endif
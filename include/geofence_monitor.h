@@ -0,0 +1,61 @@
+#ifndef GEOFENCE_MONITOR_H
+#define GEOFENCE_MONITOR_H
+
+#include "data_channel.h"
+#include "geofence.h"
+
+#include <Arduino.h>
+#include <stdint.h>
+
+struct GeofenceEvent {
+  uint32_t sequence = 0; // per boot, starting at 1
+  uint16_t fenceId = 0;
+  bool entered = false;
+  int64_t utcMs = 0;
+  uint32_t fixSequence = 0;
+};
+
+struct GeofenceStats {
+  uint32_t fences = 0;
+  uint32_t vertices = 0;
+  uint32_t gridCells = 0;
+  uint32_t inside = 0;
+  uint32_t events = 0;
+  uint32_t lastCandidates = 0;
+  uint32_t lastEvalUs = 0;
+  uint32_t maxEvalUs = 0;
+};
+
+/**
+ * Runs measured fixes through the uploaded GeofenceSet and keeps the last
+ * few enter/exit events for the BLE and TCP publishers to pick up by
+ * sequence. Fences live in LittleFS as the text upload format and are
+ * reloaded on boot.
+ */
+class GeofenceMonitor : public NavDataPublisher {
+public:
+  void begin();
+  void publishNavData(const NavDataSample &sample) override;
+  // Parses and stores a new fence list; error gets a line-numbered reason.
+  bool replace(const String &text, String &error);
+  String storedText() const;
+  // First kept event after `after`; false when there is none.
+  bool nextEvent(uint32_t after, GeofenceEvent &out) const;
+  uint32_t latestEventSequence() const { return eventSequence; }
+  GeofenceStats stats() const;
+
+private:
+  bool parse(const String &text, GeofenceSet &target, String &error) const;
+  void pushEvent(const GeofenceTransition &transition,
+                 const NavDataSample &sample);
+
+  GeofenceSet fences;
+  uint32_t eventSequence = 0;
+  uint32_t lastFixSequence = 0;
+  uint32_t lastEvalUs = 0;
+  uint32_t maxEvalUs = 0;
+};
+
+GeofenceMonitor &geofenceMonitor();
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef GNSS_SIGNALS_H
+#define GNSS_SIGNALS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr size_t kSignalTableSize = 128;
+
+// Frequency bands the signals are grouped by; one record per SV and band.
+enum class GnssBand : uint8_t {
+  Unknown = 0,
+  L1 = 1,  // GPS/QZSS L1, Galileo E1, BeiDou B1I/B1C, GLONASS G1
+  L2 = 2,  // GPS/QZSS L2C, GLONASS G2
+  L5 = 3,  // GPS/QZSS/NavIC L5, Galileo E5a, BeiDou B2a
+  E5b = 4, // Galileo E5b, BeiDou B2I
+  E6 = 5,  // Galileo E6, BeiDou B3I
+};
+
+constexpr size_t kGnssBandCount = 6; // indexed by GnssBand, Unknown included
+
+constexpr uint8_t kSignalQualityUnknown = 0x0F;
+
+struct SignalRecord {
+  uint8_t system = 0; // NMEA system code, 1 GPS .. 5 QZSS, 6 NavIC
+  uint8_t svId = 0;   // NMEA numbering (GLONASS 65+)
+  GnssBand band = GnssBand::Unknown;
+  uint8_t sigId = 0;  // as reported; numbering depends on fromUbx
+  bool fromUbx = false;
+  uint8_t cno = 0;    // dB-Hz
+  uint8_t quality = kSignalQualityUnknown; // NAV-SIG qualityInd 0..7
+  bool used = false;
+};
+
+// Signals of one band: tracked, used in the solution, mean C/N0 (dB-Hz).
+struct SignalBandSummary {
+  uint8_t tracked = 0;
+  uint8_t used = 0;
+  uint8_t cno = 0;
+};
+
+/**
+ * Per-signal C/N0 of a multi-band receiver, keyed by (system, band, svId)
+ * in an open addressing table like SatelliteTable. Columns are packed to
+ * six bytes a signal. Records not refreshed for maxAgeS seconds expire.
+ */
+class SignalTable {
+public:
+  void clear();
+  bool update(const SignalRecord &record, uint32_t nowS);
+  // NMEA reports use per satellite (GSA); applies one epoch's used SVs,
+  // packed as system << 8 | svId, to every band of the systems whose bit
+  // is set in systemMask. Systems without a GSA that epoch keep theirs.
+  void setUsed(uint8_t systemMask, const uint16_t *usedSvs, size_t count);
+  void expire(uint32_t nowS, uint8_t maxAgeS);
+
+  size_t size() const { return count; }
+  static constexpr size_t capacity() { return kSignalTableSize; }
+  bool at(size_t slot, SignalRecord &out) const;
+  void summarize(SignalBandSummary (&bands)[kGnssBandCount]) const;
+
+private:
+  static constexpr uint8_t kUsedFlag = 0x80;
+  static constexpr uint8_t kCnoMask = 0x7F;
+  static constexpr uint8_t kUbxFlag = 0x80;
+  static constexpr uint8_t kQualityMask = 0x0F;
+
+  static size_t home(uint16_t key);
+  void removeSlot(size_t slot);
+
+  uint16_t keys[kSignalTableSize] = {}; // system<<11 | band<<8 | svId
+  uint8_t signal[kSignalTableSize] = {}; // cno | kUsedFlag
+  uint8_t detail[kSignalTableSize] = {}; // quality | kUbxFlag
+  uint8_t sigIds[kSignalTableSize] = {};
+  uint8_t seen[kSignalTableSize] = {};
+  uint8_t count = 0;
+};
+
+const char *gnssBandName(GnssBand band);
+
+/**
+ * Watches the receiver byte stream next to the NMEA library and picks out
+ * what it does not parse: GSV sentences with the NMEA 4.10+ signal ID, GSA
+ * with the system ID, UBX-NAV-SIG frames, and the GGA/RMC position at full
+ * resolution (the library keeps it as float, ~0.4 m steps). NAV-SIG
+ * records are staged and only committed once the frame checksum matches;
+ * GSA used flags once the epoch's GSA run ends. Other UBX frames of up to
+ * kMaxCapturedPayload bytes (polled monitor messages) are handed to the
+ * frame handler after the same check.
+ */
+class GnssSignalParser {
+public:
+  using UbxFrameHandler = void (*)(uint8_t msgClass, uint8_t msgId,
+                                   const uint8_t *payload, size_t length);
+
+  void feed(uint8_t value);
+  void setFrameHandler(UbxFrameHandler handler) { frameHandler = handler; }
+  void setTime(uint32_t nowS) { timeS = nowS; }
+  SignalTable &table() { return signals; }
+  const SignalTable &table() const { return signals; }
+  uint32_t navSigFrames() const { return navSigCount; }
+  uint32_t gsvSentences() const { return gsvCount; }
+  // Last valid GGA/RMC position in 1e-7 degrees; false before the first.
+  bool position(int32_t &latitude, int32_t &longitude) const;
+
+private:
+  static constexpr size_t kMaxSentence = 96;
+  static constexpr size_t kMaxStagedSignals = 96;
+  static constexpr size_t kMaxCapturedPayload = 64;
+  static constexpr size_t kMaxUsedPerEpoch = 64;
+
+  enum class UbxState : uint8_t {
+    Sync2,
+    Class,
+    Id,
+    Len1,
+    Len2,
+    Payload,
+    CkA,
+    CkB,
+  };
+
+  void handleSentence();
+  void handleGsv(char **fields, size_t count, uint8_t system);
+  void handleGsa(char **fields, size_t count, uint8_t system);
+  void commitUsed();
+  void handlePosition(char **fields, size_t count, size_t first,
+                      bool valid);
+  void feedUbx(uint8_t value);
+  void stageNavSigByte(uint8_t value);
+
+  SignalTable signals;
+  uint32_t timeS = 0;
+
+  char sentence[kMaxSentence + 1] = {};
+  size_t sentenceLength = 0;
+  bool inSentence = false;
+
+  bool inUbx = false;
+  UbxState ubxState = UbxState::Sync2;
+  uint8_t ubxClass = 0;
+  uint8_t ubxId = 0;
+  uint16_t ubxLength = 0;
+  uint16_t ubxRead = 0;
+  uint8_t ckA = 0;
+  uint8_t ckB = 0;
+  uint8_t block[16] = {};
+  SignalRecord staged[kMaxStagedSignals];
+  uint8_t stagedCount = 0;
+  uint8_t captured[kMaxCapturedPayload] = {};
+  UbxFrameHandler frameHandler = nullptr;
+
+  // Used SVs from the GSA run of the current epoch, one GSA per system and
+  // more than one for a system with over 12. Applied when the run ends.
+  uint16_t usedSvs[kMaxUsedPerEpoch] = {};
+  uint8_t usedCount = 0;
+  uint8_t usedSystems = 0;
+
+  int32_t latitudeE7 = 0;
+  int32_t longitudeE7 = 0;
+  bool havePosition = false;
+
+  uint32_t navSigCount = 0;
+  uint32_t gsvCount = 0;
+};
+
+#endif
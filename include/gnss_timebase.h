@@ -0,0 +1,79 @@
+#ifndef GNSS_TIMEBASE_H
+#define GNSS_TIMEBASE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "nav_sample.h"
+
+enum class TimeSource : uint8_t {
+  None = 0,
+  Nmea = 1,
+  Pps = 2,
+};
+
+struct UtcTimestamp {
+  int64_t unixUs = 0;
+  bool valid = false;
+  bool ppsLocked = false;
+};
+
+struct TimebaseStats {
+  TimeSource source = TimeSource::None;
+  bool ppsLocked = false;
+  uint32_t ppsEdges = 0;
+  uint32_t disciplinedEdges = 0;
+  int32_t driftPpb = 0;
+  int32_t lastResidualUs = 0;
+  uint32_t jitterUs = 0;
+  uint32_t ppsAgeUs = kNoPpsAge;
+  int64_t referenceUtcUs = 0;
+  // Leap second announced by the receiver (UBX-NAV-TIMELS): +1 or -1 taking
+  // effect at leapEventUnixS, 0 when none is scheduled.
+  int8_t leapChange = 0;
+  uint32_t leapEventUnixS = 0;
+};
+
+/**
+ * UTC clock derived from the GNSS receiver. The PPS ISR latches
+ * esp_timer_get_time(); the first NMEA time after that edge names the UTC
+ * second it marked. Consecutive pairs give the local oscillator drift, which
+ * is applied when extrapolating between edges. Without PPS the clock falls
+ * back to NMEA arrival times (tens of milliseconds of error).
+ */
+class GnssTimebase {
+public:
+  void IRAM_ATTR onPpsEdge();
+  void onUtcSecond(uint32_t unixSeconds, int64_t receivedUs);
+  void onLeapSecond(int8_t change, uint32_t eventUnixS);
+  UtcTimestamp utcAt(int64_t localUs) const;
+  UtcTimestamp now() const;
+  uint32_t ppsAgeUs(int64_t localUs) const;
+  TimebaseStats stats() const;
+
+private:
+  void discipline(uint32_t unixSeconds, int64_t ppsLocalUs);
+  int64_t latestPps(uint32_t *sequence) const;
+
+  volatile int64_t lastPpsUs = 0;
+  volatile uint32_t ppsSequence = 0;
+  uint32_t pairedSequence = 0;
+  uint32_t lastUtcSeconds = 0;
+
+  TimeSource source = TimeSource::None;
+  int64_t anchorUtcUs = 0;
+  int64_t anchorLocalUs = 0;
+  int32_t driftPpb = 0;
+  bool driftValid = false;
+  int32_t lastResidualUs = 0;
+  uint32_t jitterUs = 0;
+  uint32_t disciplinedEdges = 0;
+  int8_t leapChange = 0;
+  uint32_t leapEventUnixS = 0;
+};
+
+GnssTimebase &gnssTimebase();
+
+const char *timeSourceName(TimeSource source);
+
+#endif
@@ -36,6 +36,21 @@ static const char *CHAR_KEEPALIVE_UUID =
     "6b5d5304-4523-4db4-9a31-0f3d88c2ce11";
 static const char *CHAR_BUILD_VERSION_UUID =
     "c4e6f890-6b5e-4f1b-9d2e-7a3c8d2f1b01";
+static const char *CHAR_POWER_PROFILE_UUID =
+    "8bd751fa-3e6c-4afa-9fc8-47f407f36cf0";
+static const char *CHAR_NAV_HISTORY_UUID =
+    "b7e3c1d4-9a52-4f08-8e6b-3d1f2a7c5e90";
+static const char *CHAR_TRIP_UUID = "e4a8f1c2-6d3b-4b7e-9f05-1c2d3e4f5a6b";
+static const char *CHAR_GEOFENCE_UUID =
+    "5f2c9e71-b84a-4d36-a1e8-93c07d6b2f48";
+static const char *CHAR_SIGNALS_UUID =
+    "a3d6b0e2-51c4-4f79-8e2a-6c9d1b7f0e35";
+static const char *CHAR_SKY_VIEW_UUID =
+    "c81f4a96-2d7e-4b35-9a60-e5b2d9c31f74";
+static const char *CHAR_NAV_RATE_UUID =
+    "5e7a2b94-0c6d-4f1e-b8a3-d29f64c1e7b5";
+static const char *CHAR_UBX_NAMED_PROFILES_UUID =
+    "9c3e7d21-4a8b-4f6c-b1d5-7e2a0f9c8b36";
 
 extern NimBLECharacteristic *pCharNavData;
 extern NimBLECharacteristic *pCharStatus;
@@ -51,6 +66,14 @@ extern NimBLECharacteristic *pCharUbxSettingsProfile;
 extern NimBLECharacteristic *pCharUbxCustomProfile;
 extern NimBLECharacteristic *pCharUbxCustomSettings;
 extern NimBLECharacteristic *pCharBuildVersion;
+extern NimBLECharacteristic *pCharPowerProfile;
+extern NimBLECharacteristic *pCharNavHistory;
+extern NimBLECharacteristic *pCharTrip;
+extern NimBLECharacteristic *pCharGeofence;
+extern NimBLECharacteristic *pCharSignals;
+extern NimBLECharacteristic *pCharSkyView;
+extern NimBLECharacteristic *pCharNavRate;
+extern NimBLECharacteristic *pCharUbxNamedProfiles;
 
 extern NimBLEServer *pServer;
 
@@ -58,6 +81,8 @@ void initBLE();
 void updateApControlCharacteristic(bool apActive);
 void updatePassthroughModeCharacteristic();
 void updateGpsBaudCharacteristic(uint32_t baud);
+// Tightens the connection interval so notifications keep up with the rate.
+void updateBleNavRate(uint8_t rateHz);
 void updateUbxProfileCharacteristic(UbxConfigProfile profile);
 void updateUbxSettingsProfileCharacteristic(UbxSettingsProfile profile);
 
@@ -19,10 +19,77 @@
 
 // Настройки UART
 #define GPS_BAUD_RATE 38400 // Скорость обмена с GPS по UART
+// Автоподбор скорости: после загрузки скорость приемника ищется перебором,
+// затем он переводится командой CFG-UART1-BAUDRATE на самую высокую
+// скорость до этой (или до заданной вручную), с проверкой и откатом
+// (0 — выключено)
+#define GPS_AUTOBAUD_TARGET 460800
 
-// Интервал вывода информации в миллисекундах (10 Гц)
+// Интервал вывода информации в миллисекундах (10 Гц); при частоте
+// измерений выше 10 Гц сокращается до периода эпохи
 #define OUTPUT_INTERVAL_MS 100
 
+// Частота измерений приемника (CFG-RATE-MEAS), Гц; 0 — как в профиле
+// настроек (150 мс). Меняется по BLE и сохраняется в NVS; перед применением
+// проверяется, что NMEA на такой частоте помещается в скорость UART
+#define GNSS_MEAS_RATE_HZ 0
+#define GNSS_MEAS_RATE_MAX_HZ 25
+
+// Сколько именованных UBX-профилей (списков ключ/значение, загружаются по
+// HTTP и BLE) хранится в NVS; выбранный применяется поверх профилей GNSS и
+// настроек
+#define UBX_NAMED_PROFILE_SLOTS 4
+
+// Сглаживание координат и скорости фильтром Калмана (0 — сырые данные NMEA)
+#define NAV_FILTER_ENABLED 1
+
+// Частота выдачи координат с экстраполяцией между эпохами приемника, Гц
+// (0 — только измеренные эпохи с периодом OUTPUT_INTERVAL_MS)
+#define NAV_OUTPUT_RATE_HZ 20
+
+// Сколько секунд после потери фикса выдавать оценку координат по последней
+// скорости и курсу (туннели, парковки); 0 — сразу прекращать выдачу
+#define NAV_OUTAGE_BRIDGE_S 30
+
+// Удержание координат на стоянке: после стольких секунд без движения и с
+// разбросом в пределах точности позиция замораживается (0 — выключено)
+#define STATIONARY_WINDOW_S 5
+// Период повторной отправки замороженной позиции по BLE/TCP, с
+#define STATIONARY_HEARTBEAT_S 10
+
+// Вывод UBX-NAV-SIG (C/N0 и качество по каждому сигналу L1/L5/E5) раз в
+// столько эпох; 0 — выключено, сигналы берутся только из GSV (NMEA 4.11).
+// Для двухчастотного приемника нужна скорость порта от 115200
+#define GNSS_NAV_SIG_RATE 0
+
+// Опрос UBX-MON-RF и UBX-SEC-SIG для контроля помех и подмены сигнала и
+// UBX-NAV-TIMELS для високосных секунд NTP, с (0 — выключено, остается
+// только анализ C/N0)
+#define RF_MONITOR_PERIOD_S 5
+
+// Запись трека во flash (LittleFS, раздел spiffs) по умолчанию (0 — выключено)
+#define TRACK_LOG_ENABLED 1
+// Политика прореживания: не чаще MIN_INTERVAL, не реже MAX_INTERVAL
+// (0 — без ограничения), либо при смещении/повороте больше порога
+#define TRACK_MIN_INTERVAL_MS 1000
+#define TRACK_MAX_INTERVAL_MS 30000
+#define TRACK_MIN_DISTANCE_M 5
+#define TRACK_MIN_TURN_DEG 15
+// Неполный блок 4 КБ сбрасывается на flash не реже чем раз в N секунд
+#define TRACK_FLUSH_INTERVAL_S 60
+
+// Кольцо последних измеренных эпох в RAM для догрузки после переподключения
+// клиента TCP/BLE (40 байт на эпоху, 512 — около 8 минут при 1 Гц)
+#define FIX_HISTORY_CAPACITY 512
+
+// Одометр поездки: контрольная точка в NVS не чаще чем раз в N секунд
+// в движении (и сразу после остановки, но не чаще раза в минуту)
+#define TRIP_CHECKPOINT_INTERVAL_S 300
+
+// Геозоны (круги и многоугольники), загружаются через /api/geofences
+#define GEOFENCE_MAX_FENCES 256
+#define GEOFENCE_MAX_VERTICES 4096
+
 // Максимальное количество спутников для отслеживания
 #define MAX_SATELLITES 64
 
@@ -32,6 +99,7 @@
 #define STATUS_FIX_SYNC 3 // Фиксация с PPS (мигание по фронту PPS)
 #define STATUS_NO_MODEM 4 // Нет связи с модемом (три импульса в секунду)
 #define STATUS_READY 5    // Готов к работе
+#define STATUS_INTERFERENCE 6 // Помехи или подмена сигнала (частое мигание)
 
 // Временные интервалы для индикации (мс)
 #define BOOT_DURATION_MS 3000    // Длительность подсветки при запуске
@@ -2,18 +2,26 @@
 #define GPS_CONTROLLER_H
 
 #include <stdint.h>
+#include <string>
 
 #include "data_channel.h"
+#include "gnss_signals.h"
+#include "gps_config.h"
 #include "gps_runtime_state.h"
+#include "interference_monitor.h"
+#include "nav_extrapolator.h"
+#include "nav_kalman.h"
+#include "stationary_detector.h"
 #include "ubx_command_set.h"
+#include "ubx_config_set.h"
+#include "ubx_profile.h"
 
 enum class GnssReceiverType : uint8_t { Ublox = 0, GenericNmea = 1 };
 
 struct GpsDebugSnapshot {
-  SatelliteDebugEntry satellites[kMaxTrackedSatellites] = {};
-  size_t satelliteCount = 0;
-  uint8_t signalDb[kMaxTrackedSatellites] = {};
-  size_t signalCount = 0;
+  SatelliteTable satellites;
+  SignalBandSummary bands[kGnssBandCount];
+  uint8_t signalCount = 0;
   uint8_t visibleCount = 0;
   uint8_t activeCount = 0;
   float tempC = 0.0f;
@@ -21,34 +29,95 @@ struct GpsDebugSnapshot {
   uint32_t uptimeSeconds = 0;
 };
 
+struct NavFilterStats {
+  bool enabled = false;
+  uint32_t runs = 0;
+  uint32_t avgUs = 0;
+  uint32_t maxUs = 0;
+  uint32_t resets = 0;
+  uint32_t rejected = 0;
+};
+
+struct UbxConfigStats {
+  bool linkOk = false;
+  bool configured = false;
+  uint32_t configMs = 0;
+  uint8_t keysChanged = 0;
+  uint8_t keysTotal = 0;
+  uint8_t verifyMismatches = 0;
+  uint32_t verifiedAgeMs = 0; // 0 before the first verification
+};
+
 class GpsController {
 public:
   void begin();
-  void loop();
   bool setBaud(uint32_t baud);
   uint32_t baud() const;
+  // Receiver measurement rate, 0 while the settings profile decides.
+  bool setMeasurementRate(uint8_t rateHz);
+  uint8_t measurementRate() const { return measRateHz; }
+  // Highest rate whose NMEA output fits the UART at the current baud.
+  uint8_t maxMeasurementRate() const;
   bool setUbxProfile(UbxConfigProfile profile);
   UbxConfigProfile ubxProfile() const;
   bool setUbxSettingsProfile(UbxSettingsProfile profile);
   UbxSettingsProfile ubxSettingsProfile() const;
+  // Named key/value profiles (ubx_profile_store.h). A change that touches
+  // the active profile is applied at once and taken back, on the receiver
+  // and in the store, when verification fails.
+  bool selectNamedProfile(const char *name, std::string &error);
+  bool storeNamedProfile(const UbxNamedProfile &profile, std::string &error);
+  bool deleteNamedProfile(const char *name, std::string &error);
   bool setReceiverType(GnssReceiverType type);
   GnssReceiverType receiverType() const { return receiverTypeValue; }
   void addNavPublisher(NavDataPublisher *publisher);
   void addStatusPublisher(SystemStatusPublisher *publisher);
   GpsDebugSnapshot debugSnapshot() const;
+  NavFilterStats navFilterStats() const;
+  ExtrapolationStats extrapolationStats() const;
+  StationaryStats stationaryStats() const;
+  const SatelliteTable &satelliteTable() const { return state.satellites; }
+  const SignalTable &signalTable() const;
+  RfMonitorStats rfMonitorStats() const;
+  UbxConfigStats ubxConfigStats() const;
+  // RAM values of the last verification read-back.
+  const UbxConfigSet &verifiedUbxConfig() const;
+  uint32_t navSigFrames() const;
 
 private:
   void configureGpsSerial(bool enableParser, bool forceReinit);
   uint32_t loadStoredGpsBaud();
   void persistGpsBaud(uint32_t baud);
+  uint32_t loadStoredBaudCeiling();
+  void persistBaudCeiling(uint32_t baud);
+  void setHostBaud(uint32_t baud);
+  bool detectReceiverBaud();
+  bool switchReceiverBaud(uint32_t baud);
+  bool negotiateBaud();
+  uint8_t loadStoredMeasurementRate();
+  void persistMeasurementRate(uint8_t rateHz);
+  void applyOutputRate();
+  uint8_t maxMeasurementRateAt(uint32_t baud) const;
   GnssReceiverType loadStoredReceiverType();
   void persistReceiverType(GnssReceiverType type);
   void resetNavigationState();
+  void serviceReceiver();
+  void updateSatelliteTable(const uint8_t (*rows)[7], size_t rowCount);
   void processPassthroughIO();
-  void processNavigationUpdate();
+  void processNavigationUpdate(uint32_t now);
+  void applyNavFilter(NavDataSample &sample, int64_t nowUs);
+  void publishNav(const NavDataSample &sample);
+  void publishExtrapolatedNav();
+  void pollRfMonitor();
   uint8_t determineSystemStatus(uint8_t fix, uint8_t activeSatellites) const;
   bool runUbxStartupSequence();
   bool verifyUbxProfile(UbxConfigProfile profile);
+  bool collectUbxConfig(const UbxCommandSequence &sequence, const char *label);
+  bool addNamedProfileConfig();
+  void addRuntimeConfig();
+  void addDroppedProfileDefaults();
+  bool applyNamedProfileChange();
+  bool applyUbxConfigDiff();
   UbxConfigProfile loadStoredUbxProfile();
   void persistUbxProfile(UbxConfigProfile profile);
   UbxSettingsProfile loadStoredUbxSettingsProfile();
@@ -59,16 +128,37 @@ private:
   GpsRuntimeState state;
   GnssReceiverType receiverTypeValue = GnssReceiverType::Ublox;
   uint32_t gpsSerialBaudValue = 0;
+  // Highest rate autobaud may pick; 0 for GPS_AUTOBAUD_TARGET. Set by
+  // setBaud().
+  uint32_t baudCeiling = 0;
+  bool baudNegotiated = false;
+  // The UBX ping of the last configuration run got an answer.
+  bool receiverAnswered = false;
+  uint8_t measRateHz = GNSS_MEAS_RATE_HZ;
   UbxConfigProfile currentProfile = UbxConfigProfile::FullSystems;
   UbxSettingsProfile currentSettingsProfile =
       UbxSettingsProfile::DefaultRamBbr;
   bool parserEnabled = false;
+  bool rollbackArmed = false;
+  bool rolledBack = false;
+  int8_t rxTaskId = -1;
+  int8_t publishTaskId = -1;
+  int8_t outputTaskId = -1;
   uint8_t prevFix = 255;
   int prevHdop10 = -1;
   uint8_t prevStrong = 255;
   uint8_t prevMedium = 255;
   uint8_t prevWeak = 255;
-  static constexpr size_t kMaxNavPublishers = 4;
+  uint8_t prevRfFlags = 255;
+  NavKalmanFilter navFilter;
+  int64_t navFilterUpdatedUs = 0;
+  uint64_t navFilterTotalUs = 0;
+  NavFilterStats navFilterStatsValue;
+  NavExtrapolator navExtrapolator;
+  StationaryDetector stationaryDetector{STATIONARY_WINDOW_S * 1000UL};
+  int64_t navRxUs = 0;
+  int64_t measuredPublishedUs = 0;
+  static constexpr size_t kMaxNavPublishers = 6;
   static constexpr size_t kMaxStatusPublishers = 4;
   NavDataPublisher *navPublishers[kMaxNavPublishers] = {};
   SystemStatusPublisher *statusPublishers[kMaxStatusPublishers] = {};
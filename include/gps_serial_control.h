@@ -19,5 +19,13 @@ bool setGpsCustomProfileCommand(const std::string &hex);
 bool setGpsCustomSettingsCommand(const std::string &hex);
 std::string getGpsCustomProfileCommand();
 std::string getGpsCustomSettingsCommand();
+// Named UBX profiles, JSON as described in ubx_profile.h. The list holds
+// whole profiles, or just names and key counts; errors are short reasons.
+std::string getGpsNamedProfilesJson(bool withItems);
+bool saveGpsNamedProfile(const std::string &json, std::string &error);
+bool selectGpsNamedProfile(const std::string &name, std::string &error);
+bool deleteGpsNamedProfile(const std::string &name, std::string &error);
+uint8_t getGpsMeasurementRate();
+bool setGpsMeasurementRate(uint8_t rateHz);
 
 #endif
@@ -0,0 +1,100 @@
+#ifndef INTERFERENCE_MONITOR_H
+#define INTERFERENCE_MONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "satellite_table.h"
+
+// Alert bits, also sent as "rf" in status outputs.
+constexpr uint8_t kRfFlagJamming = 0x01;
+constexpr uint8_t kRfFlagSpoofing = 0x02;
+
+// u-blox jamming/spoofing state scale (MON-RF, SEC-SIG).
+constexpr uint8_t kRfStateUnknown = 0;
+constexpr uint8_t kRfStateOk = 1;
+constexpr uint8_t kRfStateWarning = 2;
+constexpr uint8_t kRfStateCritical = 3;
+
+struct RfMonitorStats {
+  uint8_t flags = 0;
+  // Last MON-RF: worst state over the RF blocks, noise/AGC of block 0.
+  bool monRfValid = false;
+  uint8_t jammingState = kRfStateUnknown;
+  uint8_t jamIndicator = 0; // CW jamming, 0..255
+  uint16_t agcCount = 0;    // 0..8191
+  uint16_t noisePerMs = 0;
+  uint16_t noiseBaseline = 0;
+  uint16_t agcBaseline = 0;
+  uint8_t antennaStatus = 0; // 0 init, 1 unknown, 2 ok, 3 short, 4 open
+  // SEC-SIG, when the firmware answers it.
+  bool secSigValid = false;
+  bool secSigUnsupported = false;
+  uint8_t secJammingState = kRfStateUnknown;
+  uint8_t spoofingState = 0; // 0 unknown, 1 none, 2 indicated, 3 affirmed
+  // C/N0 of the strongest satellites, dB-Hz.
+  float cnoMean = 0.0f;
+  float cnoBaseline = 0.0f;
+  float cnoSpread = 0.0f;
+  // Mean C/N0 of the strongest satellites over the learned level for their
+  // elevation; valid once enough of them have a learned level.
+  float cnoExcess = 0.0f;
+  bool cnoExcessValid = false;
+  uint32_t monRfFrames = 0;
+  uint32_t jammingEvents = 0;
+  uint32_t spoofingEvents = 0;
+};
+
+/**
+ * Raises jamming and spoofing flags from the receiver's RF monitor and the
+ * C/N0 of the tracked satellites.
+ *
+ * Jamming: MON-RF or SEC-SIG at warning or worse, a strong CW indicator, or
+ * a C/N0 drop against the learned baseline that comes with a noise floor
+ * rise or an AGC cut (a drop alone is usually a blocked sky). Spoofing:
+ * SEC-SIG indicated or affirmed. Without SEC-SIG, the strongest satellites
+ * arriving at nearly the same high C/N0, as from a single transmitter,
+ * well above what was learned for their elevations. A strong open sky
+ * looks uniform too, so the pattern alone never raises the flag, and a
+ * fresh SEC-SIG report overrides it.
+ * Flags are held for kClearHoldMs after the last trigger. Baselines stop
+ * learning while jamming is flagged, since it pulls C/N0 and the noise
+ * floor away from normal; a spoofing flag does not stop them.
+ */
+class InterferenceMonitor {
+public:
+  static constexpr uint32_t kClearHoldMs = 10000;
+
+  void reset();
+  // Called when MON-RF/SEC-SIG polls go out; SEC-SIG is given up after a
+  // few unanswered polls since older firmware does not know it.
+  void onPoll();
+  void onMonRf(const uint8_t *payload, size_t length, uint32_t nowMs);
+  void onSecSig(const uint8_t *payload, size_t length, uint32_t nowMs);
+  // Once per navigation epoch.
+  void onSatellites(const SatelliteTable &table, uint32_t nowMs);
+
+  bool wantsSecSig() const { return !stats.secSigUnsupported; }
+  uint8_t flags() const { return stats.flags; }
+  const RfMonitorStats &snapshot() const { return stats; }
+
+private:
+  static constexpr size_t kElevationBins = 9; // 10 degrees each
+
+  void learnElevation(uint8_t elevation, uint8_t cno);
+  void evaluate(uint32_t nowMs);
+
+  RfMonitorStats stats;
+  uint32_t monRfAtMs = 0;
+  uint32_t secSigAtMs = 0;
+  uint8_t unansweredSecSig = 0;
+  uint16_t cnoEpochs = 0;
+  uint8_t trackedCount = 0;
+  float elevationCno[kElevationBins] = {};
+  uint16_t elevationSamples[kElevationBins] = {};
+  // Last time each condition triggered, for the clear hold.
+  uint32_t jammingSeenMs = 0;
+  uint32_t spoofingSeenMs = 0;
+};
+
+#endif
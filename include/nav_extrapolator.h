@@ -0,0 +1,69 @@
+#ifndef NAV_EXTRAPOLATOR_H
+#define NAV_EXTRAPOLATOR_H
+
+#include <stdint.h>
+
+#include "nav_sample.h"
+
+struct ExtrapolationStats {
+  uint32_t epochPeriodMs = 0;
+  uint32_t extrapolated = 0;
+  uint32_t scored = 0;
+  float lastErrorM = 0.0f;
+  float rmsErrorM = 0.0f;
+  float maxErrorM = 0.0f;
+  uint32_t estimated = 0; // samples bridged through a fix outage
+  uint32_t outages = 0;   // outages closed by a fix inside the window
+  float lastOutageS = 0.0f;
+  float lastOutageErrorM = 0.0f;
+  float maxOutageErrorM = 0.0f;
+};
+
+/**
+ * Dead-reckons the last fix forward along its velocity so the output rate
+ * can exceed the receiver's navigation rate. Fix epochs are placed on the
+ * PPS grid when PPS is available. Every new fix scores the prediction made
+ * for its epoch, which gives the live extrapolation error.
+ *
+ * With an outage window set, the same prediction bridges a lost fix: it
+ * keeps going for up to the window after the last fix, marked estimated,
+ * with the horizontal accuracy grown for an unknown acceleration. The fix
+ * that ends the outage scores the bridge separately.
+ */
+class NavExtrapolator {
+public:
+  void reset();
+  void setOutageWindow(uint32_t windowMs);
+  void onMeasurement(const NavDataSample &sample, int64_t arrivalUs,
+                     int64_t ppsUs);
+  // fixLost: the receiver reports no fix, so only bridging is allowed.
+  bool extrapolate(int64_t localUs, NavDataSample &out, bool fixLost = false);
+  int64_t epochUs() const { return baseEpochUs; }
+  ExtrapolationStats stats() const;
+
+private:
+  int64_t alignEpoch(int64_t arrivalUs, int64_t ppsUs) const;
+  void predict(int64_t localUs, double &latitude, double &longitude) const;
+
+  bool haveBase = false;
+  NavDataSample base;
+  int64_t baseEpochUs = 0;
+  float velEast = 0.0f;
+  float velNorth = 0.0f;
+  int64_t lastArrivalUs = 0;
+  uint32_t periodUs = 1000000;
+  int64_t outageWindowUs = 0;
+
+  uint32_t extrapolatedCount = 0;
+  uint32_t scoredCount = 0;
+  float lastError = 0.0f;
+  double errorSumSq = 0.0;
+  float maxError = 0.0f;
+  uint32_t estimatedCount = 0;
+  uint32_t outageCount = 0;
+  float lastOutage = 0.0f;
+  float lastOutageError = 0.0f;
+  float maxOutageError = 0.0f;
+};
+
+#endif
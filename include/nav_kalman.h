@@ -0,0 +1,79 @@
+#ifndef NAV_KALMAN_H
+#define NAV_KALMAN_H
+
+#include <stdint.h>
+
+// Same heuristic the TCP stream has always used: ~5 m UERE, 3 m floor.
+float horizontalAccuracyFromHdop(float hdop);
+
+struct NavMeasurement {
+  double latitude = 0.0;
+  double longitude = 0.0;
+  float altitude = 0.0f;
+  float speed = 0.0f;   // m/s
+  float heading = 0.0f; // degrees from north
+  float horizontalAccuracy = 0.0f;
+  bool hasVelocity = true;
+};
+
+struct NavEstimate {
+  bool valid = false;
+  double latitude = 0.0;
+  double longitude = 0.0;
+  float altitude = 0.0f;
+  float speed = 0.0f;
+  float heading = 0.0f;
+  float velocityEast = 0.0f;
+  float velocityNorth = 0.0f;
+  float horizontalAccuracy = 0.0f;
+  float verticalAccuracy = 0.0f;
+  float speedAccuracy = 0.0f;
+  float headingAccuracy = 0.0f;
+};
+
+/**
+ * Constant-velocity Kalman filter in a local east/north/up frame anchored
+ * at the first fix. Axes are decoupled, so each one is a 2-state filter
+ * updated with scalar measurements; no matrix library and no heap.
+ */
+class NavKalmanFilter {
+public:
+  void reset();
+  void predict(float dtSeconds);
+  void update(const NavMeasurement &measurement);
+  bool initialized() const { return isInitialized; }
+  NavEstimate estimate() const;
+  uint32_t resetCount() const { return resets; }
+  uint32_t rejectedCount() const { return rejected; }
+
+private:
+  struct Axis {
+    float pos = 0.0f;
+    float vel = 0.0f;
+    float p00 = 0.0f;
+    float p01 = 0.0f;
+    float p11 = 0.0f;
+  };
+
+  void initialize(const NavMeasurement &measurement);
+  void toLocal(double latitude, double longitude, float &east,
+               float &north) const;
+  void recenter();
+  static void predictAxis(Axis &axis, float dt, float accelVariance);
+  static bool updatePosition(Axis &axis, float z, float variance, float gate);
+  static void updateVelocity(Axis &axis, float z, float variance);
+
+  bool isInitialized = false;
+  double originLat = 0.0;
+  double originLon = 0.0;
+  double metersPerDegLon = 0.0;
+  Axis east;
+  Axis north;
+  Axis up;
+  float lastHeading = 0.0f;
+  uint8_t consecutiveRejects = 0;
+  uint32_t resets = 0;
+  uint32_t rejected = 0;
+};
+
+#endif
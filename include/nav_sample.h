@@ -0,0 +1,31 @@
+#ifndef NAV_SAMPLE_H
+#define NAV_SAMPLE_H
+
+#include <stdint.h>
+
+constexpr uint32_t kNoPpsAge = UINT32_MAX;
+
+// One navigation solution as it travels from the controller to the
+// publishers. Kept apart from data_channel.h so the host-built navigation
+// modules do not pull in Arduino.
+struct NavDataSample {
+  double latitude = 0.0; // float steps are ~0.4 m at mid latitudes
+  double longitude = 0.0;
+  float heading = 0.0f;
+  float speed = 0.0f;
+  float altitude = 0.0f;
+  int64_t utcEpochUs = 0;        // UTC of the fix epoch, 0 while unknown
+  uint32_t ppsAgeUs = kNoPpsAge; // last PPS edge -> sample creation
+  bool ppsLocked = false;
+  float horizontalAccuracy = 0.0f; // metres, 1-sigma; 0 when unknown
+  float verticalAccuracy = 0.0f;
+  float speedAccuracy = 0.0f;   // m/s
+  float headingAccuracy = 0.0f; // degrees
+  bool filtered = false;
+  bool extrapolated = false; // dead-reckoned between receiver epochs
+  bool estimated = false;    // extrapolated through a fix outage
+  bool stationary = false;   // position frozen by the static hold
+  uint32_t sequence = 0;     // fix history sequence, 0 for predictions
+};
+
+#endif
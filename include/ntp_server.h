@@ -0,0 +1,24 @@
+#ifndef NTP_SERVER_H
+#define NTP_SERVER_H
+
+#include <stdint.h>
+
+constexpr uint16_t kNtpServerPort = 123;
+
+struct NtpServerStats {
+  bool running = false;
+  uint32_t served = 0;
+  uint32_t unsynced = 0;
+  uint32_t ignored = 0;
+};
+
+/**
+ * SNTP/NTPv4 server on UDP/123 answering from the GNSS timebase. Requests
+ * are handled by a dedicated task blocked in recvfrom(), so receive and
+ * transmit stamps are taken right at the socket and the scheduler loop is
+ * never involved.
+ */
+void initNtpServer();
+NtpServerStats ntpServerStats();
+
+#endif
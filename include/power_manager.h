@@ -0,0 +1,119 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+enum class PowerProfile : uint8_t {
+  AlwaysOn = 0,
+  LightSleep = 1,
+};
+
+constexpr size_t kPowerProfileCount = 2;
+
+enum class PowerLock : uint8_t {
+  GnssRx = 0,
+  Ble = 1,
+  Wifi = 2,
+};
+
+constexpr size_t kPowerLockCount = 3;
+
+struct PowerStats {
+  PowerProfile profile = PowerProfile::AlwaysOn;
+  bool lightSleepActive = false;
+  bool lightSleepAvailable = false;
+  uint16_t awakePermille = 1000;
+  float estimatedCurrentMa = 0.0f;
+  uint32_t epochMs = 0;
+  uint32_t fixLatencyAvgMs = 0;
+  uint32_t fixLatencyMaxMs = 0;
+  uint32_t fixLatencySamples = 0;
+};
+
+struct CpuFreqStats {
+  uint32_t maxMhz = 0;
+  uint32_t baseMhz = 0;
+  uint32_t boostMs = 0;
+  uint32_t baseMs = 0;
+  uint32_t boosts = 0;
+};
+
+/**
+ * Power profiles for battery installs. In the light-sleep profile the SoC
+ * drops into automatic light sleep whenever no PM lock is held; the GNSS RX
+ * lock is taken ahead of every expected epoch (predicted from PPS or from
+ * the previous NMEA burst) and released once the burst has gone quiet.
+ */
+class PowerManager {
+public:
+  void begin();
+  bool setProfile(PowerProfile profile);
+  PowerProfile profile() const { return currentProfile; }
+  void acquire(PowerLock lock);
+  void release(PowerLock lock);
+  void noteGnssActivity();
+  void IRAM_ATTR notePpsEdge();
+  void noteFixDelivered();
+  void boostCpu();
+  void releaseCpuBoost();
+  PowerStats stats() const;
+  CpuFreqStats cpuStats() const;
+
+private:
+  void applyProfile(PowerProfile profile);
+  void tick();
+  void armEpochGuard();
+  void setHeld(PowerLock lock, bool held);
+  void applyCpuBoost(bool boosted);
+  PowerProfile loadStoredProfile();
+  void persistProfile(PowerProfile profile);
+
+  PowerProfile currentProfile = PowerProfile::AlwaysOn;
+  bool lightSleepActive = false;
+  int8_t tickTaskId = -1;
+  int8_t guardTaskId = -1;
+
+  volatile uint8_t heldMask = 0;
+  volatile int64_t lastPpsUs = 0;
+  volatile bool ppsAwaitingFix = false;
+  int64_t lastActivityUs = 0;
+  int64_t burstStartUs = 0;
+  int64_t epochAnchorUs = 0;
+  int64_t gnssHeldSinceUs = 0;
+  uint32_t epochUs = 1000000;
+
+  int64_t statsSinceUs = 0;
+  int64_t awakeSinceUs = 0;
+  int64_t awakeUs = 0;
+  uint64_t fixLatencySumUs = 0;
+  uint32_t fixLatencyMaxUs = 0;
+  uint32_t fixLatencySamples = 0;
+
+  uint8_t boostDepth = 0;
+  uint32_t boostCount = 0;
+  int64_t cpuStatsSinceUs = 0;
+  int64_t boostSinceUs = 0;
+  int64_t boostedUs = 0;
+};
+
+PowerManager &powerManager();
+
+/**
+ * Holds the CPU at the maximum DFS frequency for the lifetime of the scope.
+ * Meant for short bursts: UBX reconfiguration, JSON builds, TCP fan-out.
+ */
+class CpuBoostGuard {
+public:
+  CpuBoostGuard() { powerManager().boostCpu(); }
+  ~CpuBoostGuard() { powerManager().releaseCpuBoost(); }
+  CpuBoostGuard(const CpuBoostGuard &) = delete;
+  CpuBoostGuard &operator=(const CpuBoostGuard &) = delete;
+};
+
+const char *powerProfileName(PowerProfile profile);
+// Whether the firmware was built with what light sleep needs; without it
+// setProfile() refuses PowerProfile::LightSleep.
+bool lightSleepAvailable();
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef SATELLITE_TABLE_H
+#define SATELLITE_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr size_t kSatelliteTableSize = 64;
+
+struct SatelliteRecord {
+  uint8_t gnssId = 0; // constellation code, 1 GPS .. 5 QZSS
+  uint8_t svId = 0;
+  uint8_t cno = 0;       // dB-Hz, 0 when not tracked
+  uint8_t elevation = 0; // degrees, 0..90
+  uint16_t azimuth = 0;  // degrees, 0..359
+  bool used = false;     // in the navigation solution
+};
+
+struct SignalLevelCounts {
+  uint8_t weak = 0;
+  uint8_t medium = 0;
+  uint8_t strong = 0;
+};
+
+/**
+ * Every satellite the receiver reports, keyed by (gnssId, svId) in an open
+ * addressing table with linear probing, so one GSV or NAV-SAT record is an
+ * O(1) insert or refresh. Columns are stored separately and packed to six
+ * bytes a satellite: the signal histogram only walks keys and signal
+ * bytes. A record not refreshed for maxAgeS seconds is expired; removal
+ * shifts the probe chain back so no tombstones build up.
+ */
+class SatelliteTable {
+public:
+  void clear();
+  // nowS is any seconds counter; only differences modulo 256 are used.
+  bool update(const SatelliteRecord &record, uint32_t nowS);
+  bool remove(uint8_t gnssId, uint8_t svId);
+  void expire(uint32_t nowS, uint8_t maxAgeS);
+  bool find(uint8_t gnssId, uint8_t svId, SatelliteRecord &out) const;
+
+  size_t size() const { return count; }
+  size_t usedCount() const;
+  SignalLevelCounts signalLevels() const;
+  // Slot iteration: slots 0..capacity()-1, empty ones return false.
+  static constexpr size_t capacity() { return kSatelliteTableSize; }
+  bool at(size_t slot, SatelliteRecord &out) const;
+
+private:
+  static constexpr uint8_t kUsedFlag = 0x80;
+  static constexpr uint8_t kCnoMask = 0x7F;
+  static constexpr uint16_t kAzimuthMask = 0x01FF;
+  static constexpr uint8_t kElevationShift = 9;
+
+  static size_t home(uint16_t key);
+  // Slot holding key, or kSatelliteTableSize when absent.
+  size_t slotOf(uint16_t key) const;
+  void removeSlot(size_t slot);
+
+  uint16_t keys[kSatelliteTableSize] = {};   // gnssId << 8 | svId, 0 = empty
+  uint8_t signal[kSatelliteTableSize] = {};  // cno | kUsedFlag
+  uint16_t position[kSatelliteTableSize] = {}; // elevation << 9 | azimuth
+  uint8_t seen[kSatelliteTableSize] = {};    // nowS of the last refresh
+  uint8_t count = 0;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SKY_VIEW_H
+#define SKY_VIEW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "satellite_table.h"
+
+constexpr uint8_t kSkyViewVersion = 1;
+constexpr size_t kSkyViewHeaderSize = 4;
+constexpr size_t kSkyViewRecordSize = 5;
+
+// Frame header flags.
+constexpr uint8_t kSkyViewFlagReset = 0x01; // drop the list, then apply
+constexpr uint8_t kSkyViewFlagMore = 0x02;  // further frames pending
+
+/**
+ * Encodes the satellite table as a binary sky view for notifications:
+ * header {version, flags, sequence, count} and 5-byte records
+ * {gnssId | flags, svId, elevation, azimuth low byte, cno}. The first
+ * record byte carries gnssId in bits 0-3, the azimuth high bit in bit 6,
+ * "used" in bit 7 and "removed" in bit 5.
+ *
+ * The encoder remembers what the client was last sent and only emits
+ * satellites that appeared, disappeared, changed their use flag, moved by
+ * a degree or changed C/N0 by kCnoDeadbandDb. A keyframe resends the
+ * whole table. Frames are cut to the caller's limit (the ATT MTU), with
+ * kSkyViewFlagMore set while changes remain.
+ */
+class SkyViewEncoder {
+public:
+  static constexpr uint8_t kCnoDeadbandDb = 2;
+
+  void requestKeyframe();
+  // Returns the frame length, 0 when the client is up to date.
+  size_t nextFrame(const SatelliteTable &current, uint8_t *out,
+                   size_t maxLength);
+  // Whole table in one frame with the reset flag; delta state untouched.
+  static size_t snapshot(const SatelliteTable &current, uint8_t *out,
+                         size_t maxLength);
+
+  uint32_t framesSent() const { return frames; }
+  uint32_t bytesSent() const { return bytes; }
+
+private:
+  SatelliteTable sent;
+  bool resetPending = true;
+  uint8_t sequence = 0;
+  uint32_t frames = 0;
+  uint32_t bytes = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef STATIONARY_DETECTOR_H
+#define STATIONARY_DETECTOR_H
+
+#include <stdint.h>
+
+#include "nav_sample.h"
+
+struct StationaryStats {
+  bool holding = false;
+  uint32_t holds = 0;      // stationary periods entered
+  uint32_t heldFixes = 0;  // fixes replaced by the frozen position
+  uint32_t heldMs = 0;     // total time spent holding, current hold included
+  float spreadM = 0.0f;    // RMS scatter of the window that started the hold
+};
+
+/**
+ * Static hold for a parked receiver. Measured fixes go into a short time
+ * window; once the whole window is slow and its positions scatter less
+ * than the fix accuracy, the detector freezes on the window mean and
+ * rewrites every following fix to that position with zero speed. One fix
+ * that is fast or lands clearly outside the scatter releases the hold at
+ * once, so movement is never delayed by more than a fix.
+ */
+class StationaryDetector {
+public:
+  explicit StationaryDetector(uint32_t windowMs) : windowMs(windowMs) {}
+
+  void reset(uint32_t nowMs);
+  // Feeds a measured fix; while holding rewrites it and returns true.
+  bool update(NavDataSample &sample, uint32_t nowMs);
+  bool holding() const { return held; }
+  StationaryStats stats(uint32_t nowMs) const;
+
+private:
+  static constexpr uint8_t kWindowSize = 16;
+
+  struct Entry {
+    uint32_t timeMs;
+    float east; // metres from the window origin
+    float north;
+    float altitude;
+  };
+
+  void release(uint32_t nowMs);
+  bool tryHold(uint32_t nowMs, float accuracy);
+
+  uint32_t windowMs;
+  Entry entries[kWindowSize] = {};
+  uint8_t count = 0;
+  uint8_t head = 0;
+  bool haveOrigin = false;
+  double originLatitude = 0.0;
+  double originLongitude = 0.0;
+  float metersPerDegLon = 0.0f;
+  uint32_t slowSinceMs = 0;
+  bool slow = false;
+
+  bool held = false;
+  double heldLatitude = 0.0;
+  double heldLongitude = 0.0;
+  float heldAltitude = 0.0f;
+  float heldHeading = 0.0f;
+  float heldEast = 0.0f;
+  float heldNorth = 0.0f;
+  float releaseRadius = 0.0f;
+  uint32_t heldSinceMs = 0;
+
+  uint32_t holdCount = 0;
+  uint32_t heldFixCount = 0;
+  uint32_t heldTotalMs = 0;
+  float lastSpread = 0.0f;
+};
+
+#endif
@@ -22,7 +22,6 @@ private:
   volatile bool ppsDetected = false;
   unsigned long bootStartTime = 0;
   unsigned long patternStartTime = 0;
-  unsigned long lastLedTick = 0;
   bool lastPinHigh = true;
 };
 
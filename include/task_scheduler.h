@@ -0,0 +1,84 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+using TaskCallback = void (*)(uint32_t now);
+
+enum class TaskPriority : uint8_t { High = 0, Normal = 1, Low = 2 };
+
+constexpr int8_t kInvalidTaskId = -1;
+constexpr size_t kMaxScheduledTasks = 20; // triggeredMask holds up to 32
+
+struct ScheduledTaskStats {
+  const char *name = nullptr;
+  uint32_t periodMs = 0;
+  uint32_t runs = 0;
+  uint32_t maxRunUs = 0;
+  uint32_t maxLateMs = 0;
+};
+
+struct SchedulerStats {
+  uint16_t loadPermille = 0;
+  uint32_t wakeups = 0;
+  ScheduledTaskStats tasks[kMaxScheduledTasks] = {};
+  size_t taskCount = 0;
+};
+
+/**
+ * Cooperative deadline scheduler for the Arduino loop task.
+ * Jobs run to completion in priority order once their deadline passes;
+ * between deadlines the loop task blocks so the CPU can idle. trigger()
+ * pulls a job forward (e.g. on UART RX) and wakes the dispatcher.
+ */
+class TaskScheduler {
+public:
+  void begin();
+  int8_t addPeriodic(const char *name, TaskCallback callback,
+                     uint32_t periodMs, TaskPriority priority,
+                     uint32_t firstDelayMs = 0);
+  int8_t addOneShot(const char *name, TaskCallback callback, uint32_t delayMs,
+                    TaskPriority priority);
+  void cancel(int8_t id);
+  void setPeriod(int8_t id, uint32_t periodMs);
+  void postpone(int8_t id, uint32_t delayMs);
+  void trigger(int8_t id);
+  void IRAM_ATTR triggerFromIsr(int8_t id);
+  void wake();
+  void IRAM_ATTR wakeFromIsr();
+  uint32_t dispatch();
+  void idle(uint32_t maxWaitMs);
+  SchedulerStats stats() const;
+
+private:
+  struct Task {
+    const char *name = nullptr;
+    TaskCallback callback = nullptr;
+    uint32_t deadline = 0;
+    uint32_t periodMs = 0;
+    TaskPriority priority = TaskPriority::Normal;
+    bool used = false;
+    uint32_t runs = 0;
+    uint32_t maxRunUs = 0;
+    uint32_t maxLateMs = 0;
+  };
+
+  int8_t allocate(const char *name, TaskCallback callback, uint32_t delayMs,
+                  uint32_t periodMs, TaskPriority priority);
+  void runTask(size_t index, uint32_t now);
+  void accountBusy(uint32_t busyUs);
+
+  Task tasks[kMaxScheduledTasks];
+  volatile uint32_t triggeredMask = 0;
+  TaskHandle_t waiter = nullptr;
+  uint32_t windowStartMs = 0;
+  uint32_t windowBusyUs = 0;
+  uint16_t loadPermille = 0;
+  uint32_t wakeups = 0;
+};
+
+TaskScheduler &taskScheduler();
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef TRACK_EXPORT_H
+#define TRACK_EXPORT_H
+
+#include "track_format.h"
+
+#include <FS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum class TrackExportFormat : uint8_t { Gpx = 0, Nmea = 1, Binary = 2 };
+
+// "12.gpx" / "00012.nmea" / "12.bin" -> id and format.
+bool parseTrackExportName(const char *name, uint32_t &id,
+                          TrackExportFormat &format);
+const char *trackExportContentType(TrackExportFormat format);
+const char *trackExportExtension(TrackExportFormat format);
+
+/**
+ * Pull-style converter from a stored track file to GPX, NMEA (RMC + GGA)
+ * or the raw binary. Blocks are decoded one at a time into a fixed buffer
+ * and text is produced a fix at a time, so memory use does not depend on
+ * track length. Corrupted blocks are skipped, like tools/track_decode.py.
+ */
+class TrackExportStream {
+public:
+  bool open(uint32_t id, TrackExportFormat format);
+  void close();
+  bool isOpen() const { return opened; }
+  // Copies up to capacity bytes into out; 0 means the export is complete.
+  size_t read(uint8_t *out, size_t capacity);
+  uint32_t fixesExported() const { return fixCount; }
+
+private:
+  enum class Stage : uint8_t { Header, Fixes, Footer, Done };
+
+  bool nextFix(TrackFix &fix);
+  bool loadBlock();
+  void formatNext();
+  void formatFix(const TrackFix &fix);
+
+  File file;
+  bool opened = false;
+  uint32_t trackId = 0;
+  TrackExportFormat formatValue = TrackExportFormat::Gpx;
+  Stage stage = Stage::Header;
+  TrackDecoder decoder;
+  uint8_t payload[kTrackBlockPayloadSize];
+  size_t payloadLength = 0;
+  size_t payloadOffset = 0;
+  char line[208];
+  size_t lineLength = 0;
+  size_t lineOffset = 0;
+  uint32_t fixCount = 0;
+};
+
+#endif
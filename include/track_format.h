@@ -0,0 +1,94 @@
+#ifndef TRACK_FORMAT_H
+#define TRACK_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * On-flash track format (little endian, see tools/track_decode.py):
+ *
+ *   file   := header block*
+ *   header := "GTRK" u8 version u8 reserved u16 reserved u32 trackId
+ *   block  := 0xA5 0x5A u16 payloadLength u16 recordCount u32 crc32 payload
+ *
+ * Every block opens with a key record holding absolute values and the rest
+ * are deltas against the previous record, so a truncated or corrupted
+ * block only loses itself. Record type sits in the low nibble of the first
+ * byte and TrackFixFlags in the high nibble; fields are LEB128 varints,
+ * signed ones zigzag-encoded.
+ */
+constexpr char kTrackFileMagic[4] = {'G', 'T', 'R', 'K'};
+constexpr uint8_t kTrackFormatVersion = 1;
+constexpr size_t kTrackFileHeaderSize = 12;
+constexpr uint8_t kTrackBlockSync0 = 0xA5;
+constexpr uint8_t kTrackBlockSync1 = 0x5A;
+constexpr size_t kTrackBlockHeaderSize = 10;
+// Upper bound, not a stride: time-based flushes write shorter blocks and
+// the file header shifts the rest, so blocks do not line up with flash
+// erase units. The size caps the RAM buffer and what one bad CRC loses.
+constexpr size_t kTrackBlockSize = 4096;
+constexpr size_t kTrackBlockPayloadSize =
+    kTrackBlockSize - kTrackBlockHeaderSize;
+constexpr size_t kTrackMaxRecordSize = 64;
+
+enum TrackRecordType : uint8_t {
+  kTrackRecordKey = 1,
+  kTrackRecordDelta = 2,
+};
+
+enum TrackFixFlags : uint8_t {
+  kTrackFlagPpsLocked = 0x01,
+  kTrackFlagFiltered = 0x02,
+  kTrackFlagLocalTime = 0x04, // no UTC yet; timeMs is uptime
+};
+
+struct TrackFix {
+  int64_t timeMs = 0;
+  int32_t latitudeE7 = 0;
+  int32_t longitudeE7 = 0;
+  int32_t altitudeDm = 0;
+  uint32_t speedCms = 0;
+  uint16_t headingCdeg = 0; // 0..35999
+  uint16_t accuracyDm = 0;  // horizontal, 0 when unknown
+  uint8_t flags = 0;
+};
+
+uint32_t trackCrc32(const uint8_t *data, size_t length, uint32_t crc = 0);
+void writeTrackFileHeader(uint8_t *out, uint32_t trackId);
+bool readTrackFileHeader(const uint8_t *data, size_t length,
+                         uint32_t *trackId);
+void writeTrackBlockHeader(uint8_t *out, uint16_t payloadLength,
+                           uint16_t recordCount, uint32_t crc);
+
+struct TrackBlockHeader {
+  uint16_t payloadLength = 0;
+  uint16_t recordCount = 0;
+  uint32_t crc = 0;
+};
+
+bool readTrackBlockHeader(const uint8_t *data, TrackBlockHeader &header);
+
+class TrackEncoder {
+public:
+  void beginBlock() { haveReference = false; }
+  // Writes one record (at most kTrackMaxRecordSize bytes), returns its size.
+  size_t encode(const TrackFix &fix, uint8_t *out);
+
+private:
+  TrackFix reference;
+  bool haveReference = false;
+};
+
+class TrackDecoder {
+public:
+  void beginBlock() { haveReference = false; }
+  // Decodes the record at data[offset], advancing offset past it.
+  bool decode(const uint8_t *data, size_t length, size_t &offset,
+              TrackFix &fix);
+
+private:
+  TrackFix reference;
+  bool haveReference = false;
+};
+
+#endif
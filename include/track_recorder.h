@@ -0,0 +1,100 @@
+#ifndef TRACK_RECORDER_H
+#define TRACK_RECORDER_H
+
+#include "data_channel.h"
+#include "track_format.h"
+
+#include <Arduino.h>
+#include <stdint.h>
+
+constexpr const char *kTrackDirectory = "/tracks";
+
+struct TrackFileInfo {
+  uint32_t id = 0;
+  uint32_t size = 0;
+};
+
+String trackFilePath(uint32_t id);
+// Fills out with stored tracks in ascending id order.
+size_t listTrackFiles(TrackFileInfo *out, size_t capacity);
+
+struct TrackSamplingPolicy {
+  uint32_t minIntervalMs = 0; // never log faster than this
+  uint32_t maxIntervalMs = 0; // log at least this often while fixed
+  uint16_t minDistanceM = 0;  // ...or when moved this far
+  uint16_t minTurnDeg = 0;    // ...or when heading turned this much
+  uint16_t flushIntervalS = 0; // partial blocks older than this hit flash
+};
+
+struct TrackRecorderStats {
+  bool mounted = false;
+  bool enabled = false;
+  uint32_t trackId = 0;
+  uint32_t fixesSeen = 0;
+  uint32_t fixesLogged = 0;
+  uint32_t fixesDropped = 0; // both buffers busy
+  uint32_t blocksWritten = 0;
+  uint32_t bytesWritten = 0;
+  uint32_t writeErrors = 0;
+  uint32_t tracksDeleted = 0;
+  float fixesPerSecond = 0.0f; // logged, since the first fix of this boot
+  float bytesPerFix = 0.0f;    // on flash, block headers included
+  uint32_t lastWriteUs = 0;
+  uint32_t maxWriteUs = 0;
+  uint32_t writeBytesPerSecond = 0; // while a write is in progress
+  uint32_t capacityFixesPerSecond = 0;
+  uint32_t totalBytes = 0;
+  uint32_t usedBytes = 0;
+};
+
+/**
+ * Records measured fixes to LittleFS in the delta/varint format from
+ * track_format.h. Records accumulate in a 4 KiB RAM block; full (or aged)
+ * blocks go to a writer task through a double buffer, so flash erase and
+ * program time never stalls the scheduler loop. A new track file starts on
+ * boot and after a long gap without fixes; the oldest tracks are removed
+ * when the partition runs low.
+ */
+class TrackRecorder : public NavDataPublisher {
+public:
+  void begin();
+  void publishNavData(const NavDataSample &sample) override;
+  void tick(uint32_t nowMs);
+  // Queues the partial block and waits for the writer (restart, download).
+  void flush(uint32_t timeoutMs);
+  void startNewTrack();
+  void setEnabled(bool enabled);
+  bool enabled() const { return enabledValue; }
+  bool setPolicy(const TrackSamplingPolicy &policy);
+  TrackSamplingPolicy policy() const { return policyValue; }
+  uint32_t currentTrackId() const { return trackId; }
+  TrackRecorderStats stats() const;
+
+private:
+  bool shouldLog(const NavDataSample &sample, uint32_t nowMs) const;
+  void append(const TrackFix &fix, uint32_t nowMs);
+  bool submitActive();
+  void loadStoredSettings();
+  void persistSettings();
+  uint32_t allocateTrackId();
+
+  TrackSamplingPolicy policyValue;
+  TrackEncoder encoder;
+  bool mounted = false;
+  bool enabledValue = true;
+  bool trackOpen = false;
+  uint32_t trackId = 0;
+  uint8_t activeIndex = 0;
+  uint32_t blockOpenedMs = 0;
+  bool haveLogged = false;
+  NavDataSample lastLogged;
+  uint32_t lastLoggedMs = 0;
+  uint32_t firstLoggedMs = 0;
+  uint32_t fixesSeen = 0;
+  uint32_t fixesLogged = 0;
+  uint32_t fixesDropped = 0;
+};
+
+TrackRecorder &trackRecorder();
+
+#endif
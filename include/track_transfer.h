@@ -0,0 +1,39 @@
+#ifndef TRACK_TRANSFER_H
+#define TRACK_TRANSFER_H
+
+#include <NimBLEServer.h>
+#include <stdint.h>
+
+static const char *TRACK_TRANSFER_CTRL_UUID =
+    "5c3e2b7a-8d41-4f6e-a0c9-2e7b91d4f3a5";
+static const char *TRACK_TRANSFER_DATA_UUID =
+    "e1a4d6f2-37b8-4c05-9e6d-b8f05a2c7d19";
+
+struct TrackTransferStats {
+  bool active = false;
+  uint32_t trackId = 0;
+  uint32_t size = 0;
+  uint32_t acked = 0;
+  uint16_t mtu = 0;
+  uint16_t chunkSize = 0;
+  uint8_t window = 0;
+  uint32_t retransmits = 0;
+  uint32_t completed = 0;
+  uint32_t lastBytesPerSecond = 0;
+  uint32_t bestBytesPerSecond = 0;
+};
+
+/**
+ * Bulk download of stored track files over GATT. The control
+ * characteristic takes ASCII commands (G<id>[,<offset>[,<window>]] to
+ * start or resume, A<offset> to acknowledge, S to stop); the data
+ * characteristic notifies <u32 offset><bytes> chunks sized to the
+ * negotiated MTU. At most <window> chunks are unacknowledged at a time and
+ * an acknowledgement below the send position (or a stalled one) rewinds
+ * the sender, so dropped notifications are recovered go-back-N style.
+ */
+void initTrackTransferService(NimBLEService *service);
+void trackTransferHandleDisconnect();
+TrackTransferStats trackTransferStats();
+
+#endif
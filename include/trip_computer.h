@@ -0,0 +1,62 @@
+#ifndef TRIP_COMPUTER_H
+#define TRIP_COMPUTER_H
+
+#include <stdint.h>
+
+struct TripFix {
+  uint32_t timeMs = 0; // monotonic
+  int32_t latitudeE7 = 0;
+  int32_t longitudeE7 = 0;
+  int32_t altitudeCm = 0;
+  uint16_t speedCms = 0;
+  uint16_t accuracyCm = 0; // horizontal, 0 when unknown
+};
+
+// Everything a trip needs to resume after a reboot; stored as-is in NVS.
+struct TripTotals {
+  uint64_t distanceMm = 0;
+  uint32_t elapsedMs = 0;
+  uint32_t movingMs = 0;
+  uint32_t maxSpeedCms = 0;
+  uint32_t elevationGainCm = 0;
+  uint32_t elevationLossCm = 0;
+  uint32_t stops = 0;
+};
+
+/**
+ * Incremental trip statistics, O(1) work and no heap per fix. Steps are
+ * measured in integer millimetres on a local flat-earth projection with a
+ * Q15 cos(latitude) from a 1-degree table; between consecutive fixes this
+ * agrees with haversine far below GNSS noise and needs no floating point,
+ * which the C3 only has in software. While stopped the odometer holds an
+ * anchor fix so position jitter does not add distance, and climb/descent
+ * use smoothed altitude and a hysteresis band so altitude noise does not
+ * add elevation gain.
+ */
+class TripComputer {
+public:
+  void reset();
+  void restore(const TripTotals &totals);
+  void update(const TripFix &fix);
+  const TripTotals &totals() const { return value; }
+  bool moving() const { return isMoving; }
+  uint32_t averageSpeedCms() const; // over moving time
+
+  // Straight-line distance between two fixes in millimetres.
+  static uint32_t stepMm(int32_t latitudeE7A, int32_t longitudeE7A,
+                         int32_t latitudeE7B, int32_t longitudeE7B);
+
+private:
+  TripTotals value;
+  bool haveFix = false;
+  bool isMoving = false;
+  bool slowing = false;
+  uint32_t lastTimeMs = 0;
+  uint32_t slowSinceMs = 0;
+  int32_t anchorLatitudeE7 = 0;
+  int32_t anchorLongitudeE7 = 0;
+  int32_t elevationReferenceCm = 0;
+  int32_t smoothedAltitudeCm = 0;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef TRIP_METER_H
+#define TRIP_METER_H
+
+#include "data_channel.h"
+#include "trip_computer.h"
+
+#include <stdint.h>
+
+struct TripMeterStats {
+  TripTotals totals;
+  bool moving = false;
+  uint32_t averageSpeedCms = 0;
+  uint32_t checkpoints = 0; // NVS writes this boot
+  uint32_t checkpointAgeS = 0;
+  uint32_t revision = 0;    // bumps whenever totals change
+};
+
+/**
+ * Feeds measured fixes into a TripComputer and keeps its totals across
+ * reboots. Checkpoints go to NVS only when something changed, at most
+ * every TRIP_CHECKPOINT_INTERVAL_S while moving, and right after the
+ * vehicle stops (the likely moment before power is cut), but never more
+ * often than once a minute; a restart request writes the last one.
+ */
+class TripMeter : public NavDataPublisher {
+public:
+  void begin();
+  void publishNavData(const NavDataSample &sample) override;
+  void tick(uint32_t nowMs);
+  void checkpoint();
+  // Safe from any task; applied by the next tick.
+  void requestReset();
+  TripMeterStats stats() const;
+
+private:
+  void applyReset();
+  void maybeCheckpoint(uint32_t nowMs, bool stopped);
+
+  TripComputer computer;
+  bool started = false;
+  bool dirty = false;
+  uint32_t revision = 0;
+  uint32_t lastSequence = 0;
+  uint32_t checkpoints = 0;
+  uint32_t lastCheckpointMs = 0;
+};
+
+TripMeter &tripMeter();
+
+#endif
@@ -16,7 +16,7 @@ struct UbxCommandSequence {
 
 struct UbxKeyValue {
   uint32_t key;
-  uint8_t value;
+  uint64_t value;
 };
 
 enum class UbxConfigProfile : uint8_t {
@@ -60,5 +60,14 @@ bool ubxProfileFromChar(char value, UbxConfigProfile &profileOut);
 char ubxSettingsProfileToChar(UbxSettingsProfile profile);
 bool ubxSettingsProfileFromChar(char value,
                                 UbxSettingsProfile &profileOut);
+// Value size in bytes encoded in bits 28..30 of a CFG-VAL key ID (one bit
+// values take a byte), 0 when invalid.
+constexpr size_t ubxKeyValueSize(uint32_t key) {
+  return ((key >> 28) & 0x07u) == 1 || ((key >> 28) & 0x07u) == 2 ? 1
+         : ((key >> 28) & 0x07u) == 3                            ? 2
+         : ((key >> 28) & 0x07u) == 4                            ? 4
+         : ((key >> 28) & 0x07u) == 5                            ? 8
+                                                                 : 0;
+}
 
 #endif
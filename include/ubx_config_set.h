@@ -0,0 +1,72 @@
+#ifndef UBX_CONFIG_SET_H
+#define UBX_CONFIG_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CFG-VALSET layer bits; CFG-VALGET takes the bit index (0 RAM, 1 BBR,
+// 2 flash) instead.
+constexpr uint8_t kUbxLayerRam = 0x01;
+constexpr uint8_t kUbxLayerBbr = 0x02;
+constexpr uint8_t kUbxLayerFlash = 0x04;
+constexpr uint8_t kUbxLayerAll = 0x07;
+constexpr size_t kUbxMaxKeysPerMessage = 64;
+
+struct UbxConfigItem {
+  uint32_t key = 0;
+  uint64_t value = 0;
+  uint8_t layers = 0;
+};
+
+/**
+ * Receiver configuration as key/value items, each tagged with the layers it
+ * belongs to. One key may appear in several items as long as their layers
+ * do not overlap (e.g. a rate set in RAM only on top of a RAM+BBR default);
+ * set() keeps that invariant. Reads CFG-VALSET frames and CFG-VALGET
+ * answers, encodes the batched requests and computes per-layer diffs.
+ */
+class UbxConfigSet {
+public:
+  static constexpr size_t kCapacity = kUbxMaxKeysPerMessage;
+
+  void clear() { count = 0; }
+  // Values are cut to the size encoded in the key; later calls win.
+  bool set(uint32_t key, uint64_t value, uint8_t layers);
+  // First item for the key that includes any of the layers.
+  const UbxConfigItem *find(uint32_t key, uint8_t layers = kUbxLayerAll) const;
+
+  // Adds the items of a whole CFG-VALSET frame (sync bytes to checksum).
+  // Any other frame, or one that does not fit, leaves the set untouched.
+  bool addValsetFrame(const uint8_t *frame, size_t size);
+  // Adds the items of a CFG-VALGET answer payload under the given layer.
+  bool addValgetPayload(const uint8_t *payload, size_t length,
+                        uint8_t layer);
+
+  // CFG-VALGET request payload for up to maxKeys keys that belong to the
+  // layer, starting at item `next`, which is advanced. 0 when none left.
+  size_t encodeValget(uint8_t layer, size_t &next, size_t maxKeys,
+                      uint8_t *out, size_t capacity) const;
+  // CFG-VALSET payload with every item whose layers equal `layers`.
+  size_t encodeValset(uint8_t layers, uint8_t *out, size_t capacity) const;
+  // CFG-VALSET payload with item `index` alone, in its own layers; for
+  // retrying a rejected batch key by key.
+  size_t encodeValsetItem(size_t index, uint8_t *out, size_t capacity) const;
+  // Adds to `changes` the items of this set in `layer` whose value in
+  // `current` (as read from that layer) differs or is missing.
+  void diffLayer(const UbxConfigSet &current, uint8_t layer,
+                 UbxConfigSet &changes) const;
+
+  size_t size() const { return count; }
+  const UbxConfigItem &operator[](size_t index) const { return items[index]; }
+
+private:
+  void removeAt(size_t index);
+
+  UbxConfigItem items[kCapacity];
+  size_t count = 0;
+};
+
+// VALGET layer index for a single layer bit.
+uint8_t ubxValgetLayer(uint8_t layerBit);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef UBX_PROFILE_H
+#define UBX_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ubx_command_set.h"
+
+constexpr size_t kUbxProfileNameMax = 15;
+constexpr size_t kUbxProfileMaxItems = 32;
+// Largest encoded profile: header, name, items of 4 + 8 bytes.
+constexpr size_t kUbxProfileBlobMax =
+    4 + kUbxProfileNameMax + kUbxProfileMaxItems * 12;
+
+// A named list of receiver configuration keys, applied on top of the GNSS
+// and settings profiles.
+struct UbxNamedProfile {
+  char name[kUbxProfileNameMax + 1] = {};
+  uint8_t layers = 0x01; // CFG-VALSET layer bits, RAM by default
+  uint8_t itemCount = 0;
+  UbxKeyValue items[kUbxProfileMaxItems] = {};
+};
+
+/**
+ * Text and storage formats of named UBX profiles. JSON, one object:
+ *
+ *   {"name":"rover","layers":1,"items":{"20110021":4,"0x30210001":100}}
+ *
+ * Keys are key IDs in hex, values decimal (negative for signed keys) or
+ * "0x..." strings. A value that does not fit the key size is refused
+ * rather than cut, and L keys take only 0 or 1. "layers" is optional.
+ * The storage blob is the same data packed with values at their key size.
+ */
+bool parseUbxProfileJson(const char *text, size_t length,
+                         UbxNamedProfile &out, const char *&error);
+// Appends the profile as JSON; false when it does not fit.
+bool formatUbxProfileJson(const UbxNamedProfile &profile, char *out,
+                          size_t capacity, size_t &length);
+// "KEY":VALUE as in the profile JSON, with a leading comma if asked.
+size_t formatUbxItemJson(uint32_t key, uint64_t value, bool comma, char *out,
+                         size_t capacity);
+bool isValidUbxProfileName(const char *name);
+
+size_t encodeUbxProfile(const UbxNamedProfile &profile, uint8_t *out,
+                        size_t capacity);
+bool decodeUbxProfile(const uint8_t *data, size_t length,
+                      UbxNamedProfile &out);
+
+#endif
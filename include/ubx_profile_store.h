@@ -0,0 +1,50 @@
+#ifndef UBX_PROFILE_STORE_H
+#define UBX_PROFILE_STORE_H
+
+#include <stddef.h>
+
+#include "gps_config.h"
+#include "ubx_profile.h"
+
+/**
+ * Named UBX profiles kept in NVS, one blob per slot, plus the name of the
+ * active one. Changes to the list are written through at once; the active
+ * name only when persistActive() is called and a staged profile only when
+ * persist() is, so the controller can try a change before committing to it.
+ */
+class UbxProfileStore {
+public:
+  static constexpr size_t kCapacity = UBX_NAMED_PROFILE_SLOTS;
+
+  void begin();
+  size_t size() const { return count; }
+  const UbxNamedProfile &operator[](size_t index) const {
+    return profiles[index];
+  }
+  const UbxNamedProfile *find(const char *name) const;
+  // Adds the profile or replaces the one with the same name; false when
+  // every slot is taken.
+  bool save(const UbxNamedProfile &profile);
+  bool remove(const char *name);
+  // Replaces a stored profile in RAM only; false when there is none by that
+  // name. persist() writes it out.
+  bool stage(const UbxNamedProfile &profile);
+  void persist(const char *name);
+
+  // Empty when none is selected.
+  const char *activeName() const { return activeNameValue; }
+  const UbxNamedProfile *active() const { return find(activeNameValue); }
+  void setActive(const char *name);
+  void persistActive();
+
+private:
+  void persistSlots(size_t from, size_t to = kCapacity);
+
+  UbxNamedProfile profiles[kCapacity];
+  size_t count = 0;
+  char activeNameValue[kUbxProfileNameMax + 1] = {};
+};
+
+UbxProfileStore &ubxProfileStore();
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef UBX_VALSET_BUILDER_H
+#define UBX_VALSET_BUILDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ubx_command_set.h"
+
+/**
+ * CFG-VALSET frames built by the compiler from a UbxKeyValue list:
+ *
+ *   constexpr UbxKeyValue kItems[] = {{0x10310001u, 1}, ...};
+ *   typedef UbxValsetFrame<kItems, ubxItemCount(kItems), 0x01> Frame;
+ *   const UbxBinaryCommand kCommand = {Frame::data, Frame::size};
+ *
+ * Sync bytes, length, value encoding (size from the key) and checksum are
+ * all computed at compile time, so the frame sits in flash exactly like a
+ * hand-written array and the same list can serve as validation targets.
+ * Written for C++11 constexpr (single-return recursion) so it builds with
+ * any toolchain the framework ships.
+ */
+
+namespace ubx_valset_detail {
+
+constexpr size_t kFrameOverhead = 8;  // sync, class, id, length, checksum
+constexpr size_t kPayloadHeader = 4; // version, layers, reserved
+constexpr size_t kItemsOffset = 6 + kPayloadHeader;
+
+constexpr size_t itemsLength(const UbxKeyValue *items, size_t count) {
+  return count == 0 ? 0
+                    : 4 + ubxKeyValueSize(items[0].key) +
+                          itemsLength(items + 1, count - 1);
+}
+
+constexpr size_t frameSize(const UbxKeyValue *items, size_t count) {
+  return kFrameOverhead + kPayloadHeader + itemsLength(items, count);
+}
+
+constexpr bool itemsValid(const UbxKeyValue *items, size_t count) {
+  return count == 0 || (ubxKeyValueSize(items[0].key) != 0 &&
+                        itemsValid(items + 1, count - 1));
+}
+
+// Byte `offset` of the key/value area, little endian key then value.
+constexpr uint8_t itemByte(const UbxKeyValue *items, size_t offset) {
+  return offset < 4 ? static_cast<uint8_t>(items[0].key >> (8 * offset))
+         : offset < 4 + ubxKeyValueSize(items[0].key)
+             ? static_cast<uint8_t>(items[0].value >> (8 * (offset - 4)))
+             : itemByte(items + 1, offset - 4 - ubxKeyValueSize(items[0].key));
+}
+
+// Frame without the checksum; the payload starts with version 0.
+constexpr uint8_t bodyByte(const UbxKeyValue *items, size_t count,
+                           uint8_t layers, size_t index) {
+  return index == 0   ? 0xB5
+         : index == 1 ? 0x62
+         : index == 2 ? 0x06
+         : index == 3 ? 0x8A
+         : index == 4 ? static_cast<uint8_t>(frameSize(items, count) -
+                                             kFrameOverhead)
+         : index == 5 ? static_cast<uint8_t>(
+                            (frameSize(items, count) - kFrameOverhead) >> 8)
+         : index == 7 ? layers
+         : index < kItemsOffset ? 0
+                                : itemByte(items, index - kItemsOffset);
+}
+
+// Fletcher sums over [lo, hi), split in halves to keep the constexpr
+// recursion depth logarithmic. ckB weighs each byte by how many bytes up
+// to `end` follow it, itself included.
+constexpr uint32_t sumA(const UbxKeyValue *items, size_t count,
+                        uint8_t layers, size_t lo, size_t hi) {
+  return hi <= lo       ? 0
+         : hi - lo == 1 ? bodyByte(items, count, layers, lo)
+                        : sumA(items, count, layers, lo, lo + (hi - lo) / 2) +
+                              sumA(items, count, layers, lo + (hi - lo) / 2,
+                                   hi);
+}
+
+constexpr uint32_t sumB(const UbxKeyValue *items, size_t count,
+                        uint8_t layers, size_t lo, size_t hi, size_t end) {
+  return hi <= lo ? 0
+         : hi - lo == 1
+             ? (end - lo) * bodyByte(items, count, layers, lo)
+             : sumB(items, count, layers, lo, lo + (hi - lo) / 2, end) +
+                   sumB(items, count, layers, lo + (hi - lo) / 2, hi, end);
+}
+
+constexpr uint8_t frameByte(const UbxKeyValue *items, size_t count,
+                            uint8_t layers, size_t index) {
+  return index + 2 < frameSize(items, count)
+             ? bodyByte(items, count, layers, index)
+         : index + 2 == frameSize(items, count)
+             ? static_cast<uint8_t>(
+                   sumA(items, count, layers, 2, index))
+             : static_cast<uint8_t>(
+                   sumB(items, count, layers, 2, index - 1, index - 1));
+}
+
+template <size_t... I> struct IndexList {};
+template <size_t N, size_t... I>
+struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeIndexList<0, I...> {
+  typedef IndexList<I...> type;
+};
+
+} // namespace ubx_valset_detail
+
+template <size_t N> constexpr size_t ubxItemCount(const UbxKeyValue (&)[N]) {
+  return N;
+}
+
+template <const UbxKeyValue *Items, size_t Count, uint8_t Layers,
+          typename Indices = typename ubx_valset_detail::MakeIndexList<
+              ubx_valset_detail::frameSize(Items, Count)>::type>
+struct UbxValsetFrame;
+
+template <const UbxKeyValue *Items, size_t Count, uint8_t Layers,
+          size_t... I>
+struct UbxValsetFrame<Items, Count, Layers,
+                      ubx_valset_detail::IndexList<I...>> {
+  static_assert(Count > 0 && Count <= 64,
+                "CFG-VALSET takes 1 to 64 keys per message");
+  static_assert(ubx_valset_detail::itemsValid(Items, Count),
+                "key with no value size in bits 28..30");
+  static_assert(Layers != 0 && (Layers & ~0x07) == 0,
+                "layers are RAM 0x01, BBR 0x02, flash 0x04");
+
+  static constexpr const UbxKeyValue *items = Items;
+  static constexpr size_t itemCount = Count;
+  static constexpr size_t size = sizeof...(I);
+  static constexpr uint8_t data[sizeof...(I)] = {
+      ubx_valset_detail::frameByte(Items, Count, Layers, I)...};
+};
+
+template <const UbxKeyValue *Items, size_t Count, uint8_t Layers,
+          size_t... I>
+constexpr uint8_t UbxValsetFrame<Items, Count, Layers,
+                                 ubx_valset_detail::IndexList<I...>>::data[];
+
+#endif
@@ -24,7 +24,7 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0elocation.proto\x12\x04gnss\"_\n\x0eServerResponse\x12/\n\x0flocation_update\x18\x01 \x01(\x0b\x32\x14.gnss.LocationUpdateH\x00\x12\x10\n\x06status\x18\x02 \x01(\tH\x00\x42\n\n\x08response\"\x95\x02\n\x0eLocationUpdate\x12\x11\n\ttimestamp\x18\x01 \x01(\x03\x12\x10\n\x08latitude\x18\x02 \x01(\x01\x12\x11\n\tlongitude\x18\x03 \x01(\x01\x12\x10\n\x08\x61ltitude\x18\x04 \x01(\x01\x12\x10\n\x08\x61\x63\x63uracy\x18\x05 \x01(\x02\x12\x0f\n\x07\x62\x65\x61ring\x18\x06 \x01(\x02\x12\r\n\x05speed\x18\x07 \x01(\x02\x12\x12\n\nsatellites\x18\x08 \x01(\x05\x12\x10\n\x08provider\x18\t \x01(\t\x12\x14\n\x0clocation_age\x18\n \x01(\x02\x12\x19\n\x11vertical_accuracy\x18\x0b \x01(\x02\x12\x18\n\x10\x62\x65\x61ring_accuracy\x18\x0c \x01(\x02\x12\x16\n\x0espeed_accuracy\x18\r \x01(\x02\x42%\n\x14\x64\x65zz.gnssshare.protoB\rLocationProtob\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0elocation.proto\x12\x04gnss\"\xb1\x01\n\x0eServerResponse\x12/\n\x0flocation_update\x18\x01 \x01(\x0b\x32\x14.gnss.LocationUpdateH\x00\x12\x10\n\x06status\x18\x02 \x01(\tH\x00\x12!\n\x04trip\x18\x03 \x01(\x0b\x32\x11.gnss.TripSummaryH\x00\x12-\n\x0egeofence_event\x18\x04 \x01(\x0b\x32\x13.gnss.GeofenceEventH\x00\x42\n\n\x08response\"\x8a\x03\n\x0eLocationUpdate\x12\x11\n\ttimestamp\x18\x01 \x01(\x03\x12\x10\n\x08latitude\x18\x02 \x01(\x01\x12\x11\n\tlongitude\x18\x03 \x01(\x01\x12\x10\n\x08\x61ltitude\x18\x04 \x01(\x01\x12\x10\n\x08\x61\x63\x63uracy\x18\x05 \x01(\x02\x12\x0f\n\x07\x62\x65\x61ring\x18\x06 \x01(\x02\x12\r\n\x05speed\x18\x07 \x01(\x02\x12\x12\n\nsatellites\x18\x08 \x01(\x05\x12\x10\n\x08provider\x18\t \x01(\t\x12\x14\n\x0clocation_age\x18\n \x01(\x02\x12\x19\n\x11vertical_accuracy\x18\x0b \x01(\x02\x12\x18\n\x10\x62\x65\x61ring_accuracy\x18\x0c \x01(\x02\x12\x16\n\x0espeed_accuracy\x18\r \x01(\x02\x12\x12\n\npps_age_us\x18\x0e \x01(\r\x12\x14\n\x0c\x65xtrapolated\x18\x0f \x01(\x08\x12\x10\n\x08sequence\x18\x10 \x01(\r\x12\x10\n\x08replayed\x18\x11 \x01(\x08\x12\x11\n\testimated\x18\x12 \x01(\x08\x12\x12\n\nstationary\x18\x13 \x01(\x08\"\xc3\x01\n\x0bTripSummary\x12\x10\n\x08\x64istance\x18\x01 \x01(\x01\x12\x13\n\x0bmoving_time\x18\x02 \x01(\x02\x12\x14\n\x0c\x65lapsed_time\x18\x03 \x01(\x02\x12\x11\n\tmax_speed\x18\x04 \x01(\x02\x12\x15\n\raverage_speed\x18\x05 \x01(\x02\x12\x16\n\x0e\x65levation_gain\x18\x06 \x01(\x02\x12\x16\n\x0e\x65levation_loss\x18\x07 \x01(\x02\x12\r\n\x05stops\x18\x08 \x01(\r\x12\x0e\n\x06moving\x18\t \x01(\x08\"m\n\rGeofenceEvent\x12\x10\n\x08\x66\x65nce_id\x18\x01 \x01(\r\x12\x0f\n\x07\x65ntered\x18\x02 \x01(\x08\x12\x11\n\ttimestamp\x18\x03 \x01(\x03\x12\x10\n\x08sequence\x18\x04 \x01(\r\x12\x14\n\x0c\x66ix_sequence\x18\x05 \x01(\rB%\n\x14\x64\x65zz.gnssshare.protoB\rLocationProtob\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
@@ -32,8 +32,12 @@ _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'location_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   _globals['DESCRIPTOR']._loaded_options = None
   _globals['DESCRIPTOR']._serialized_options = b'\n\024dezz.gnssshare.protoB\rLocationProto'
-  _globals['_SERVERRESPONSE']._serialized_start=24
-  _globals['_SERVERRESPONSE']._serialized_end=119
-  _globals['_LOCATIONUPDATE']._serialized_start=122
-  _globals['_LOCATIONUPDATE']._serialized_end=399
+  _globals['_SERVERRESPONSE']._serialized_start=25
+  _globals['_SERVERRESPONSE']._serialized_end=202
+  _globals['_LOCATIONUPDATE']._serialized_start=205
+  _globals['_LOCATIONUPDATE']._serialized_end=599
+  _globals['_TRIPSUMMARY']._serialized_start=602
+  _globals['_TRIPSUMMARY']._serialized_end=797
+  _globals['_GEOFENCEEVENT']._serialized_start=799
+  _globals['_GEOFENCEEVENT']._serialized_end=908
 # @@protoc_insertion_point(module_scope)
@@ -1,16 +1,28 @@
 #include "firmware_app.h"
 
+#include "geofence_monitor.h"
 #include "gps_ble.h"
 #include "gps_controller.h"
 #include "led_status.h"
 #include "logger.h"
 #include "ota_service.h"
+#include "power_manager.h"
 #include "system_mode.h"
+#include "task_scheduler.h"
+#include "track_recorder.h"
+#include "trip_meter.h"
 #include "wifi_manager.h"
 
 #include <Arduino.h>
 #include <esp_system.h>
 
+namespace {
+constexpr uint32_t kLedTaskPeriodMs = 20;
+constexpr uint32_t kOtaTaskPeriodMs = 50;
+constexpr uint32_t kRestartDelayMs = 200;
+constexpr uint32_t kTrackFlushTimeoutMs = 1000;
+} // namespace
+
 FirmwareApp &firmwareApp() {
   static FirmwareApp app;
   return app;
@@ -25,10 +37,15 @@ void FirmwareApp::begin() {
   digitalWrite(GPS_EN, HIGH);
 
   Serial.begin(115200);
+  taskScheduler().begin();
   initSystemMode();
   logPrintln("[sys] Booting firmware...");
+  powerManager().begin();
 
   gpsController().begin();
+  trackRecorder().begin();
+  tripMeter().begin();
+  geofenceMonitor().begin();
 
   initBLE();
   configurePublishers();
@@ -36,19 +53,14 @@ void FirmwareApp::begin() {
   initModeLED();
   initWifiManager(onWifiApStateChanged);
   updateApControlCharacteristic(wifiManagerIsApActive());
+  scheduleTasks();
 
   logPrintln("[sys] Boot complete.");
 }
 
 void FirmwareApp::tick() {
-  updateWifiManager();
-  otaTick();
-  gpsController().loop();
-  updateStatusLED();
-  updateModeLED(isSerialPassthroughMode(), otaUpdateInProgress(),
-                wifiManagerIsConnected());
-  bleTick();
-  processPendingRestart();
+  uint32_t waitMs = taskScheduler().dispatch();
+  taskScheduler().idle(waitMs);
 }
 
 void FirmwareApp::requestRestart(const char *reason) {
@@ -56,12 +68,27 @@ void FirmwareApp::requestRestart(const char *reason) {
     return;
   restartPending = true;
   restartReason = reason;
-  restartRequestedAt = millis();
   if (reason) {
     logPrintf("[sys] Restart requested (%s)\n", reason);
   } else {
     logPrintln("[sys] Restart requested");
   }
+  taskScheduler().addOneShot(
+      "restart", [](uint32_t) { firmwareApp().processPendingRestart(); },
+      kRestartDelayMs, TaskPriority::Low);
+}
+
+void FirmwareApp::scheduleTasks() {
+  taskScheduler().addPeriodic(
+      "leds",
+      [](uint32_t) {
+        updateStatusLED();
+        updateModeLED(isSerialPassthroughMode(), otaUpdateInProgress(),
+                      wifiManagerIsConnected());
+      },
+      kLedTaskPeriodMs, TaskPriority::Normal);
+  taskScheduler().addPeriodic(
+      "ota", [](uint32_t) { otaTick(); }, kOtaTaskPeriodMs, TaskPriority::Low);
 }
 
 void FirmwareApp::configurePublishers() {
@@ -69,6 +96,9 @@ void FirmwareApp::configurePublishers() {
   gpsController().addStatusPublisher(bleStatusPublisher());
   gpsController().addNavPublisher(wifiManagerNavPublisher());
   gpsController().addStatusPublisher(wifiManagerStatusPublisher());
+  gpsController().addNavPublisher(&trackRecorder());
+  gpsController().addNavPublisher(&tripMeter());
+  gpsController().addNavPublisher(&geofenceMonitor());
 }
 
 void FirmwareApp::onWifiApStateChanged(bool active) {
@@ -78,8 +108,8 @@ void FirmwareApp::onWifiApStateChanged(bool active) {
 void FirmwareApp::processPendingRestart() {
   if (!restartPending)
     return;
-  if (millis() - restartRequestedAt < 200)
-    return;
+  trackRecorder().flush(kTrackFlushTimeoutMs);
+  tripMeter().checkpoint();
   if (restartReason) {
     logPrintf("[sys] Restarting now (%s)\n", restartReason);
     Serial.print("[sys] Restarting now (");
@@ -0,0 +1,97 @@
+#include "fix_history.h"
+
+#include "gps_config.h"
+
+#include <math.h>
+
+namespace {
+constexpr uint32_t kCapacity = FIX_HISTORY_CAPACITY;
+constexpr uint8_t kFlagPpsLocked = 0x01;
+constexpr uint8_t kFlagFiltered = 0x02;
+
+HistoryFix gRing[kCapacity];
+
+uint16_t toUnsigned16(float value, float scale) {
+  float scaled = value * scale;
+  if (!(scaled > 0.0f)) {
+    return 0;
+  }
+  return scaled >= 65535.0f ? 65535 : static_cast<uint16_t>(lroundf(scaled));
+}
+} // namespace
+
+uint32_t FixHistory::append(const NavDataSample &sample, uint32_t nowMs) {
+  HistoryFix &fix = gRing[latest % kCapacity];
+  fix.sequence = ++latest;
+  fix.recordedMs = nowMs;
+  fix.utcMs = sample.utcEpochUs / 1000;
+  fix.latitudeE7 = static_cast<int32_t>(lround(sample.latitude * 1e7));
+  fix.longitudeE7 = static_cast<int32_t>(lround(sample.longitude * 1e7));
+  fix.altitudeCm = static_cast<int32_t>(lroundf(sample.altitude * 100.0f));
+  fix.speedCms = toUnsigned16(sample.speed, 100.0f);
+  fix.headingCdeg = toUnsigned16(sample.heading, 100.0f) % 36000;
+  fix.horizontalAccuracyCm = toUnsigned16(sample.horizontalAccuracy, 100.0f);
+  fix.verticalAccuracyCm = toUnsigned16(sample.verticalAccuracy, 100.0f);
+  fix.speedAccuracyCms = toUnsigned16(sample.speedAccuracy, 100.0f);
+  uint16_t headingAccuracy = toUnsigned16(sample.headingAccuracy, 1.0f);
+  fix.headingAccuracyDeg =
+      static_cast<uint8_t>(headingAccuracy > 180 ? 180 : headingAccuracy);
+  fix.flags = (sample.ppsLocked ? kFlagPpsLocked : 0) |
+              (sample.filtered ? kFlagFiltered : 0);
+  return latest;
+}
+
+uint32_t FixHistory::oldestSequence() const {
+  if (latest == 0) {
+    return 0;
+  }
+  return latest > kCapacity ? latest - kCapacity + 1 : 1;
+}
+
+bool FixHistory::next(uint32_t after, HistoryFix &out) const {
+  if (latest == 0) {
+    return false;
+  }
+  uint32_t sequence = after >= latest + 1 ? 0 : after;
+  uint32_t oldest = oldestSequence();
+  sequence = sequence + 1 < oldest ? oldest : sequence + 1;
+  if (sequence > latest) {
+    return false;
+  }
+  out = gRing[(sequence - 1) % kCapacity];
+  return true;
+}
+
+FixHistoryStats FixHistory::stats() const {
+  FixHistoryStats stats;
+  stats.capacity = kCapacity;
+  stats.latestSequence = latest;
+  stats.oldestSequence = oldestSequence();
+  stats.stored = latest == 0 ? 0 : latest - stats.oldestSequence + 1;
+  stats.catchUps = catchUps;
+  stats.replayedFixes = replayedFixes;
+  return stats;
+}
+
+FixHistory &fixHistory() {
+  static FixHistory history;
+  return history;
+}
+
+NavDataSample historyFixToSample(const HistoryFix &fix) {
+  NavDataSample sample;
+  sample.latitude = fix.latitudeE7 * 1e-7;
+  sample.longitude = fix.longitudeE7 * 1e-7;
+  sample.altitude = fix.altitudeCm / 100.0f;
+  sample.speed = fix.speedCms / 100.0f;
+  sample.heading = fix.headingCdeg / 100.0f;
+  sample.utcEpochUs = fix.utcMs * 1000;
+  sample.ppsLocked = (fix.flags & kFlagPpsLocked) != 0;
+  sample.filtered = (fix.flags & kFlagFiltered) != 0;
+  sample.horizontalAccuracy = fix.horizontalAccuracyCm / 100.0f;
+  sample.verticalAccuracy = fix.verticalAccuracyCm / 100.0f;
+  sample.speedAccuracy = fix.speedAccuracyCms / 100.0f;
+  sample.headingAccuracy = fix.headingAccuracyDeg;
+  sample.sequence = fix.sequence;
+  return sample;
+}
@@ -0,0 +1,383 @@
+#include "geofence.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+constexpr double kMetersPerDegree = 111195.0;
+constexpr double kE7 = 1e7;
+constexpr int32_t kMaxLatitudeE7 = 900000000;
+constexpr int32_t kMaxLongitudeE7 = 1800000000;
+// Keeps polygon cross products inside int64.
+constexpr int64_t kMaxPolygonSpanE7 = 1800000000LL;
+constexpr uint32_t kMaxRadiusM = 1000000;
+constexpr uint32_t kMaxGridSide = 32;
+// A fence whose box touches more than 1/kWideShare of the cells is tested
+// on every fix instead of being copied into all of them.
+constexpr uint32_t kWideShare = 4;
+constexpr uint8_t kConfirmFixes = 2;
+
+bool validPoint(int64_t latitudeE7, int64_t longitudeE7) {
+  return latitudeE7 >= -kMaxLatitudeE7 && latitudeE7 <= kMaxLatitudeE7 &&
+         longitudeE7 >= -kMaxLongitudeE7 && longitudeE7 <= kMaxLongitudeE7;
+}
+
+int32_t clampE7(int64_t value, int32_t limit) {
+  if (value < -limit) {
+    return -limit;
+  }
+  return value > limit ? limit : static_cast<int32_t>(value);
+}
+
+const char *skipSpaces(const char *text) {
+  while (*text == ' ' || *text == '\t') {
+    ++text;
+  }
+  return text;
+}
+
+bool parseCoordinate(const char *&text, int32_t &out) {
+  char *end = nullptr;
+  double value = strtod(text, &end);
+  if (end == text || !isfinite(value)) {
+    return false;
+  }
+  text = end;
+  out = static_cast<int32_t>(lround(value * kE7));
+  return true;
+}
+} // namespace
+
+void GeofenceSet::clear() { *this = GeofenceSet(); }
+
+bool GeofenceSet::addFence(const Geofence &fence) {
+  if (fences.size() >= UINT16_MAX) {
+    return false;
+  }
+  fences.push_back(fence);
+  return true;
+}
+
+bool GeofenceSet::addCircle(uint16_t id, int32_t latitudeE7,
+                            int32_t longitudeE7, uint32_t radiusM) {
+  if (radiusM == 0 || radiusM > kMaxRadiusM ||
+      !validPoint(latitudeE7, longitudeE7)) {
+    return false;
+  }
+  Geofence fence;
+  fence.id = id;
+  fence.shape = GeofenceShape::Circle;
+  fence.centerLatitudeE7 = latitudeE7;
+  fence.centerLongitudeE7 = longitudeE7;
+  int64_t radiusE7 = llround(radiusM / kMetersPerDegree * kE7);
+  fence.radiusSquaredE7 = radiusE7 * radiusE7;
+  double cosine = cos(latitudeE7 / kE7 * M_PI / 180.0);
+  fence.cosQ15 = static_cast<int32_t>(lround(cosine * 32768.0));
+  int64_t halfWidthE7 =
+      fence.cosQ15 > 0 ? radiusE7 * 32768 / fence.cosQ15 : kMaxLongitudeE7;
+  fence.minLatitudeE7 = clampE7(latitudeE7 - radiusE7, kMaxLatitudeE7);
+  fence.maxLatitudeE7 = clampE7(latitudeE7 + radiusE7, kMaxLatitudeE7);
+  fence.minLongitudeE7 = clampE7(longitudeE7 - halfWidthE7, kMaxLongitudeE7);
+  fence.maxLongitudeE7 = clampE7(longitudeE7 + halfWidthE7, kMaxLongitudeE7);
+  return addFence(fence);
+}
+
+bool GeofenceSet::addPolygon(uint16_t id, const int32_t *latitudeE7,
+                             const int32_t *longitudeE7, size_t count) {
+  if (count < 3 || count > UINT16_MAX) {
+    return false;
+  }
+  Geofence fence;
+  fence.id = id;
+  fence.shape = GeofenceShape::Polygon;
+  fence.minLatitudeE7 = fence.maxLatitudeE7 = latitudeE7[0];
+  fence.minLongitudeE7 = fence.maxLongitudeE7 = longitudeE7[0];
+  for (size_t i = 0; i < count; ++i) {
+    if (!validPoint(latitudeE7[i], longitudeE7[i])) {
+      return false;
+    }
+    if (latitudeE7[i] < fence.minLatitudeE7) {
+      fence.minLatitudeE7 = latitudeE7[i];
+    } else if (latitudeE7[i] > fence.maxLatitudeE7) {
+      fence.maxLatitudeE7 = latitudeE7[i];
+    }
+    if (longitudeE7[i] < fence.minLongitudeE7) {
+      fence.minLongitudeE7 = longitudeE7[i];
+    } else if (longitudeE7[i] > fence.maxLongitudeE7) {
+      fence.maxLongitudeE7 = longitudeE7[i];
+    }
+  }
+  if (static_cast<int64_t>(fence.maxLongitudeE7) - fence.minLongitudeE7 >
+      kMaxPolygonSpanE7) {
+    return false;
+  }
+  fence.firstVertex = static_cast<uint32_t>(vertexLatitude.size());
+  fence.vertexCount = static_cast<uint16_t>(count);
+  if (!addFence(fence)) {
+    return false;
+  }
+  vertexLatitude.insert(vertexLatitude.end(), latitudeE7, latitudeE7 + count);
+  vertexLongitude.insert(vertexLongitude.end(), longitudeE7,
+                         longitudeE7 + count);
+  return true;
+}
+
+void GeofenceSet::build() {
+  size_t count = fences.size();
+  state.assign(count, 0);
+  visited.assign(count, 0);
+  active.clear();
+  nextActive.clear();
+  wideFences.clear();
+  cellFences.clear();
+  stamp = 0;
+  if (count == 0) {
+    columns = rows = 0;
+    cellStart.assign(1, 0);
+    return;
+  }
+
+  int32_t minLat = fences[0].minLatitudeE7;
+  int32_t maxLat = fences[0].maxLatitudeE7;
+  int32_t minLon = fences[0].minLongitudeE7;
+  int32_t maxLon = fences[0].maxLongitudeE7;
+  for (const Geofence &fence : fences) {
+    minLat = fence.minLatitudeE7 < minLat ? fence.minLatitudeE7 : minLat;
+    maxLat = fence.maxLatitudeE7 > maxLat ? fence.maxLatitudeE7 : maxLat;
+    minLon = fence.minLongitudeE7 < minLon ? fence.minLongitudeE7 : minLon;
+    maxLon = fence.maxLongitudeE7 > maxLon ? fence.maxLongitudeE7 : maxLon;
+  }
+  // About two cells per fence keeps most cells down to a fence or two.
+  uint32_t side = static_cast<uint32_t>(ceil(sqrt(2.0 * count)));
+  side = side > kMaxGridSide ? kMaxGridSide : side;
+  columns = rows = side;
+  gridLatitudeE7 = minLat;
+  gridLongitudeE7 = minLon;
+  cellHeightE7 = (static_cast<int64_t>(maxLat) - minLat) / rows + 1;
+  cellWidthE7 = (static_cast<int64_t>(maxLon) - minLon) / columns + 1;
+
+  uint32_t cells = columns * rows;
+  std::vector<uint32_t> counts(cells + 1, 0);
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < count; ++i) {
+      const Geofence &fence = fences[i];
+      uint32_t row0 = (fence.minLatitudeE7 - static_cast<int64_t>(minLat)) /
+                      cellHeightE7;
+      uint32_t row1 = (fence.maxLatitudeE7 - static_cast<int64_t>(minLat)) /
+                      cellHeightE7;
+      uint32_t col0 = (fence.minLongitudeE7 - static_cast<int64_t>(minLon)) /
+                      cellWidthE7;
+      uint32_t col1 = (fence.maxLongitudeE7 - static_cast<int64_t>(minLon)) /
+                      cellWidthE7;
+      uint32_t covered = (row1 - row0 + 1) * (col1 - col0 + 1);
+      if (cells > kWideShare && covered * kWideShare > cells) {
+        if (pass == 0) {
+          wideFences.push_back(static_cast<uint16_t>(i));
+        }
+        continue;
+      }
+      for (uint32_t row = row0; row <= row1; ++row) {
+        for (uint32_t col = col0; col <= col1; ++col) {
+          uint32_t cell = row * columns + col;
+          if (pass == 0) {
+            counts[cell + 1]++;
+          } else {
+            cellFences[cellStart[cell] + counts[cell]++] =
+                static_cast<uint16_t>(i);
+          }
+        }
+      }
+    }
+    if (pass == 0) {
+      for (uint32_t cell = 0; cell < cells; ++cell) {
+        counts[cell + 1] += counts[cell];
+      }
+      cellStart = counts;
+      cellFences.assign(cellStart[cells], 0);
+      counts.assign(cells + 1, 0);
+    }
+  }
+}
+
+bool GeofenceSet::contains(size_t index, int32_t latitudeE7,
+                           int32_t longitudeE7) const {
+  const Geofence &fence = fences[index];
+  if (latitudeE7 < fence.minLatitudeE7 || latitudeE7 > fence.maxLatitudeE7 ||
+      longitudeE7 < fence.minLongitudeE7 ||
+      longitudeE7 > fence.maxLongitudeE7) {
+    return false;
+  }
+  if (fence.shape == GeofenceShape::Circle) {
+    int64_t north = static_cast<int64_t>(latitudeE7) - fence.centerLatitudeE7;
+    int64_t east =
+        ((static_cast<int64_t>(longitudeE7) - fence.centerLongitudeE7) *
+         fence.cosQ15) >>
+        15;
+    return north * north + east * east <= fence.radiusSquaredE7;
+  }
+
+  // Crossing number with latitude as y; products of in-box differences
+  // stay below 2^63.
+  bool inside = false;
+  const int32_t *lat = &vertexLatitude[fence.firstVertex];
+  const int32_t *lon = &vertexLongitude[fence.firstVertex];
+  size_t previous = fence.vertexCount - 1;
+  for (size_t i = 0; i < fence.vertexCount; previous = i++) {
+    int64_t ay = lat[previous];
+    int64_t by = lat[i];
+    if ((ay > latitudeE7) == (by > latitudeE7)) {
+      continue;
+    }
+    int64_t ax = lon[previous];
+    int64_t bx = lon[i];
+    int64_t lhs = (longitudeE7 - ax) * (by - ay);
+    int64_t rhs = (bx - ax) * (latitudeE7 - ay);
+    if (by > ay ? lhs < rhs : lhs > rhs) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+bool GeofenceSet::evaluate(uint16_t index, int32_t latitudeE7,
+                           int32_t longitudeE7, GeofenceTransition *out,
+                           size_t capacity, size_t &count) {
+  if (visited[index] == stamp) {
+    return false;
+  }
+  visited[index] = stamp;
+  candidates++;
+  bool wasInside = (state[index] & kInside) != 0;
+  bool isInside = contains(index, latitudeE7, longitudeE7);
+  if (isInside == wasInside) {
+    state[index] = wasInside ? kInside : 0;
+    return wasInside;
+  }
+  uint8_t pending = static_cast<uint8_t>((state[index] >> 1) + 1);
+  if (pending < kConfirmFixes) {
+    state[index] = static_cast<uint8_t>((pending << 1) |
+                                        (wasInside ? kInside : 0));
+    return true;
+  }
+  state[index] = isInside ? kInside : 0;
+  if (count < capacity) {
+    out[count].fenceId = fences[index].id;
+    out[count].entered = isInside;
+    count++;
+  }
+  return isInside;
+}
+
+size_t GeofenceSet::update(int32_t latitudeE7, int32_t longitudeE7,
+                           GeofenceTransition *out, size_t capacity) {
+  size_t count = 0;
+  candidates = 0;
+  if (fences.empty()) {
+    return 0;
+  }
+  if (++stamp == 0) {
+    visited.assign(visited.size(), 0);
+    stamp = 1;
+  }
+  nextActive.clear();
+  auto visit = [&](uint16_t index) {
+    if (evaluate(index, latitudeE7, longitudeE7, out, capacity, count)) {
+      nextActive.push_back(index);
+    }
+  };
+
+  int64_t row = (latitudeE7 - static_cast<int64_t>(gridLatitudeE7)) /
+                cellHeightE7;
+  int64_t col = (longitudeE7 - static_cast<int64_t>(gridLongitudeE7)) /
+                cellWidthE7;
+  if (latitudeE7 >= gridLatitudeE7 && longitudeE7 >= gridLongitudeE7 &&
+      row < rows && col < columns) {
+    uint32_t cell = static_cast<uint32_t>(row) * columns +
+                    static_cast<uint32_t>(col);
+    for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+      visit(cellFences[i]);
+    }
+  }
+  for (uint16_t index : wideFences) {
+    visit(index);
+  }
+  // Fences left behind still need their exit.
+  for (uint16_t index : active) {
+    visit(index);
+  }
+  active.swap(nextActive);
+  return count;
+}
+
+size_t GeofenceSet::insideCount() const {
+  size_t count = 0;
+  for (uint16_t index : active) {
+    count += (state[index] & kInside) ? 1 : 0;
+  }
+  return count;
+}
+
+bool parseGeofenceLine(const char *line, GeofenceSet &set) {
+  const char *text = skipSpaces(line);
+  if (*text == '\0' || *text == '#' || *text == '\r' || *text == '\n') {
+    return true;
+  }
+  char type = static_cast<char>(toupper(static_cast<unsigned char>(*text)));
+  if ((type != 'C' && type != 'P') || !isspace(text[1])) {
+    return false;
+  }
+  char *end = nullptr;
+  text = skipSpaces(text + 1);
+  unsigned long id = strtoul(text, &end, 10);
+  if (end == text || id > UINT16_MAX) {
+    return false;
+  }
+  text = end;
+
+  if (type == 'C') {
+    int32_t latitude = 0;
+    int32_t longitude = 0;
+    text = skipSpaces(text);
+    if (!parseCoordinate(text, latitude)) {
+      return false;
+    }
+    text = skipSpaces(text);
+    if (!parseCoordinate(text, longitude)) {
+      return false;
+    }
+    text = skipSpaces(text);
+    unsigned long radius = strtoul(text, &end, 10);
+    if (end == text) {
+      return false;
+    }
+    text = skipSpaces(end);
+    if (*text != '\0' && *text != '\r' && *text != '\n') {
+      return false;
+    }
+    return set.addCircle(static_cast<uint16_t>(id), latitude, longitude,
+                         static_cast<uint32_t>(radius));
+  }
+
+  std::vector<int32_t> latitudes;
+  std::vector<int32_t> longitudes;
+  for (;;) {
+    text = skipSpaces(text);
+    if (*text == '\0' || *text == '\r' || *text == '\n') {
+      break;
+    }
+    int32_t latitude = 0;
+    int32_t longitude = 0;
+    if (!parseCoordinate(text, latitude) || *text != ',') {
+      return false;
+    }
+    ++text;
+    if (!parseCoordinate(text, longitude)) {
+      return false;
+    }
+    latitudes.push_back(latitude);
+    longitudes.push_back(longitude);
+  }
+  return set.addPolygon(static_cast<uint16_t>(id), latitudes.data(),
+                        longitudes.data(), latitudes.size());
+}
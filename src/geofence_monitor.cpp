@@ -0,0 +1,161 @@
+#include "geofence_monitor.h"
+
+#include "gps_config.h"
+#include "logger.h"
+
+#include <LittleFS.h>
+#include <esp_timer.h>
+#include <math.h>
+#include <utility>
+
+namespace {
+constexpr const char *kGeofenceFile = "/geofences.txt";
+constexpr size_t kEventRingSize = 16;
+constexpr size_t kMaxTransitionsPerFix = 8;
+
+GeofenceEvent gEvents[kEventRingSize];
+} // namespace
+
+void GeofenceMonitor::begin() {
+  // LittleFS is mounted by the track recorder.
+  File file = LittleFS.open(kGeofenceFile, FILE_READ);
+  if (!file) {
+    return;
+  }
+  String text = file.readString();
+  file.close();
+  GeofenceSet loaded;
+  String error;
+  if (!parse(text, loaded, error)) {
+    logPrintf("[geo] Stored fences rejected: %s\n", error.c_str());
+    return;
+  }
+  fences = std::move(loaded);
+  logPrintf("[geo] %u fences, %u vertices, %u grid cells\n",
+            static_cast<unsigned>(fences.size()),
+            static_cast<unsigned>(fences.vertexCount()),
+            static_cast<unsigned>(fences.gridCells()));
+}
+
+bool GeofenceMonitor::parse(const String &text, GeofenceSet &target,
+                            String &error) const {
+  target.clear();
+  int start = 0;
+  unsigned lineNumber = 0;
+  while (start < static_cast<int>(text.length())) {
+    int end = text.indexOf('\n', start);
+    if (end < 0) {
+      end = text.length();
+    }
+    String line = text.substring(start, end);
+    start = end + 1;
+    lineNumber++;
+    if (!parseGeofenceLine(line.c_str(), target)) {
+      error = "строка " + String(lineNumber) + ": неверный формат";
+      return false;
+    }
+    if (target.size() > GEOFENCE_MAX_FENCES ||
+        target.vertexCount() > GEOFENCE_MAX_VERTICES) {
+      error = "строка " + String(lineNumber) + ": превышен лимит (" +
+              String(GEOFENCE_MAX_FENCES) + " зон, " +
+              String(GEOFENCE_MAX_VERTICES) + " вершин)";
+      return false;
+    }
+  }
+  target.build();
+  return true;
+}
+
+bool GeofenceMonitor::replace(const String &text, String &error) {
+  GeofenceSet loaded;
+  if (!parse(text, loaded, error)) {
+    return false;
+  }
+  if (loaded.size() == 0) {
+    LittleFS.remove(kGeofenceFile);
+  } else {
+    File file = LittleFS.open(kGeofenceFile, FILE_WRITE);
+    if (!file || file.print(text) != text.length()) {
+      error = "не удалось записать файл";
+      return false;
+    }
+    file.close();
+  }
+  fences = std::move(loaded);
+  logPrintf("[geo] Loaded %u fences, %u vertices\n",
+            static_cast<unsigned>(fences.size()),
+            static_cast<unsigned>(fences.vertexCount()));
+  return true;
+}
+
+String GeofenceMonitor::storedText() const {
+  File file = LittleFS.open(kGeofenceFile, FILE_READ);
+  if (!file) {
+    return String();
+  }
+  String text = file.readString();
+  file.close();
+  return text;
+}
+
+void GeofenceMonitor::publishNavData(const NavDataSample &sample) {
+  if (fences.size() == 0 || sample.extrapolated ||
+      (sample.sequence != 0 && sample.sequence == lastFixSequence)) {
+    return;
+  }
+  lastFixSequence = sample.sequence;
+  int64_t startUs = esp_timer_get_time();
+  GeofenceTransition transitions[kMaxTransitionsPerFix];
+  size_t count = fences.update(
+      static_cast<int32_t>(lround(sample.latitude * 1e7)),
+      static_cast<int32_t>(lround(sample.longitude * 1e7)), transitions,
+      kMaxTransitionsPerFix);
+  lastEvalUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+  if (lastEvalUs > maxEvalUs) {
+    maxEvalUs = lastEvalUs;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    pushEvent(transitions[i], sample);
+  }
+}
+
+void GeofenceMonitor::pushEvent(const GeofenceTransition &transition,
+                                const NavDataSample &sample) {
+  GeofenceEvent &event = gEvents[eventSequence % kEventRingSize];
+  event.sequence = ++eventSequence;
+  event.fenceId = transition.fenceId;
+  event.entered = transition.entered;
+  event.utcMs = sample.utcEpochUs / 1000;
+  event.fixSequence = sample.sequence;
+  logPrintf("[geo] %s fence %u\n", transition.entered ? "Enter" : "Exit",
+            static_cast<unsigned>(transition.fenceId));
+}
+
+bool GeofenceMonitor::nextEvent(uint32_t after, GeofenceEvent &out) const {
+  if (after >= eventSequence) {
+    return false;
+  }
+  uint32_t oldest =
+      eventSequence > kEventRingSize ? eventSequence - kEventRingSize + 1 : 1;
+  uint32_t sequence = after + 1 < oldest ? oldest : after + 1;
+  out = gEvents[(sequence - 1) % kEventRingSize];
+  return true;
+}
+
+GeofenceStats GeofenceMonitor::stats() const {
+  GeofenceStats stats;
+  stats.fences = fences.size();
+  stats.vertices = fences.vertexCount();
+  stats.gridCells = fences.gridCells();
+  stats.inside = fences.insideCount();
+  stats.events = eventSequence;
+  stats.lastCandidates = fences.lastCandidates();
+  stats.lastEvalUs = lastEvalUs;
+  stats.maxEvalUs = maxEvalUs;
+  return stats;
+}
+
+GeofenceMonitor &geofenceMonitor() {
+  static GeofenceMonitor monitor;
+  return monitor;
+}
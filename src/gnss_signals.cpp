@@ -0,0 +1,671 @@
+#include "gnss_signals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+constexpr uint8_t kSystemGps = 1;
+constexpr uint8_t kSystemGlonass = 2;
+constexpr uint8_t kSystemGalileo = 3;
+constexpr uint8_t kSystemBeidou = 4;
+constexpr uint8_t kSystemQzss = 5;
+constexpr uint8_t kSystemNavic = 6;
+
+constexpr uint8_t kUbxClassNav = 0x01;
+constexpr uint8_t kUbxIdNavSig = 0x43;
+constexpr size_t kNavSigHeaderSize = 8;
+constexpr size_t kNavSigBlockSize = 16;
+constexpr uint16_t kUbxPrUsedFlag = 0x0008;
+constexpr size_t kMaxFields = 24;
+constexpr uint8_t kMaxUsedPerGsa = 12;
+
+uint16_t makeKey(uint8_t system, GnssBand band, uint8_t svId) {
+  return static_cast<uint16_t>((system & 0x07) << 11 |
+                               (static_cast<uint8_t>(band) & 0x07) << 8 |
+                               svId);
+}
+
+uint8_t systemFromTalker(const char *talker) {
+  if (talker[0] == 'G' && talker[1] == 'P') {
+    return kSystemGps;
+  }
+  if (talker[0] == 'G' && talker[1] == 'L') {
+    return kSystemGlonass;
+  }
+  if (talker[0] == 'G' && talker[1] == 'A') {
+    return kSystemGalileo;
+  }
+  if ((talker[0] == 'G' && talker[1] == 'B') ||
+      (talker[0] == 'B' && talker[1] == 'D')) {
+    return kSystemBeidou;
+  }
+  if (talker[0] == 'G' && talker[1] == 'Q') {
+    return kSystemQzss;
+  }
+  if (talker[0] == 'G' && talker[1] == 'I') {
+    return kSystemNavic;
+  }
+  return 0; // GN: mixed, needs the system ID field
+}
+
+// NMEA 4.11 signal IDs (u-blox interface description, GSV/GRS/GST).
+GnssBand bandFromNmea(uint8_t system, uint8_t signalId) {
+  switch (system) {
+  case kSystemGps:
+  case kSystemQzss:
+    if (signalId == 1 || signalId == 4) {
+      return GnssBand::L1;
+    }
+    if (signalId == 5 || signalId == 6) {
+      return GnssBand::L2;
+    }
+    if (signalId == 7 || signalId == 8) {
+      return GnssBand::L5;
+    }
+    break;
+  case kSystemGlonass:
+    if (signalId == 1) {
+      return GnssBand::L1;
+    }
+    if (signalId == 3) {
+      return GnssBand::L2;
+    }
+    break;
+  case kSystemGalileo:
+    if (signalId == 1) {
+      return GnssBand::L5;
+    }
+    if (signalId == 2) {
+      return GnssBand::E5b;
+    }
+    if (signalId == 4 || signalId == 5) {
+      return GnssBand::E6;
+    }
+    if (signalId == 6 || signalId == 7) {
+      return GnssBand::L1;
+    }
+    break;
+  case kSystemBeidou:
+    if (signalId == 1 || signalId == 3) {
+      return GnssBand::L1;
+    }
+    if (signalId == 5) {
+      return GnssBand::L5;
+    }
+    if (signalId == 0x0B) {
+      return GnssBand::E5b;
+    }
+    if (signalId == 8) {
+      return GnssBand::E6;
+    }
+    break;
+  case kSystemNavic:
+    if (signalId == 1) {
+      return GnssBand::L5;
+    }
+    break;
+  default:
+    break;
+  }
+  return GnssBand::Unknown;
+}
+
+// UBX gnssId/sigId (NAV-SIG) to the NMEA system and band; svId is moved to
+// NMEA numbering so records line up with GSV.
+bool fromUbx(uint8_t gnssId, uint8_t sigId, uint8_t &svId, uint8_t &system,
+             GnssBand &band) {
+  band = GnssBand::Unknown;
+  switch (gnssId) {
+  case 0: // GPS
+    system = kSystemGps;
+    if (sigId == 0) {
+      band = GnssBand::L1;
+    } else if (sigId == 3 || sigId == 4) {
+      band = GnssBand::L2;
+    } else if (sigId == 6 || sigId == 7) {
+      band = GnssBand::L5;
+    }
+    return true;
+  case 1: // SBAS, reported under GPS in NMEA
+    system = kSystemGps;
+    band = GnssBand::L1;
+    if (svId >= 120) {
+      svId = static_cast<uint8_t>(svId - 87);
+    }
+    return true;
+  case 2: // Galileo
+    system = kSystemGalileo;
+    if (sigId <= 1) {
+      band = GnssBand::L1;
+    } else if (sigId == 3 || sigId == 4) {
+      band = GnssBand::L5;
+    } else if (sigId == 5 || sigId == 6) {
+      band = GnssBand::E5b;
+    } else if (sigId >= 8 && sigId <= 10) {
+      band = GnssBand::E6;
+    }
+    return true;
+  case 3: // BeiDou
+    system = kSystemBeidou;
+    if (sigId <= 1 || sigId == 5 || sigId == 6) {
+      band = GnssBand::L1;
+    } else if (sigId == 2 || sigId == 3) {
+      band = GnssBand::E5b;
+    } else if (sigId == 7 || sigId == 8) {
+      band = GnssBand::L5;
+    } else if (sigId == 4 || sigId == 10) {
+      band = GnssBand::E6;
+    }
+    return true;
+  case 5: // QZSS
+    system = kSystemQzss;
+    if (sigId <= 1 || sigId == 12) {
+      band = GnssBand::L1;
+    } else if (sigId == 4 || sigId == 5) {
+      band = GnssBand::L2;
+    } else if (sigId == 8 || sigId == 9) {
+      band = GnssBand::L5;
+    }
+    return true;
+  case 6: // GLONASS
+    system = kSystemGlonass;
+    if (svId >= 1 && svId <= 32) {
+      svId = static_cast<uint8_t>(svId + 64);
+    }
+    band = sigId == 2 ? GnssBand::L2 : GnssBand::L1;
+    return true;
+  case 7: // NavIC
+    system = kSystemNavic;
+    band = GnssBand::L5;
+    return true;
+  default:
+    return false;
+  }
+}
+
+uint8_t hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return static_cast<uint8_t>(c - '0');
+  }
+  if (c >= 'A' && c <= 'F') {
+    return static_cast<uint8_t>(c - 'A' + 10);
+  }
+  return 0xFF;
+}
+
+uint8_t fieldValue(const char *field) {
+  long value = strtol(field, nullptr, 10);
+  if (value < 0 || value > 255) {
+    return 0;
+  }
+  return static_cast<uint8_t>(value);
+}
+
+// "ddmm.mmmmm" or "dddmm.mmmmm" plus N/S/E/W to 1e-7 degrees, exactly;
+// minute digits past the seventh are dropped.
+bool parseNmeaAngle(const char *field, const char *hemisphere,
+                    int32_t &outE7) {
+  int64_t whole = 0;
+  size_t digits = 0;
+  const char *p = field;
+  for (; *p >= '0' && *p <= '9'; ++p, ++digits) {
+    whole = whole * 10 + (*p - '0');
+  }
+  if (digits < 3 || digits > 5) {
+    return false;
+  }
+  int64_t minutesE7 = (whole % 100) * 10000000;
+  if (*p == '.') {
+    int64_t scale = 1000000;
+    for (++p; *p >= '0' && *p <= '9'; ++p) {
+      minutesE7 += (*p - '0') * scale;
+      scale /= 10;
+    }
+  }
+  if (*p != '\0' || minutesE7 >= 60 * 10000000LL) {
+    return false;
+  }
+  int64_t value = (whole / 100) * 10000000 + (minutesE7 + 30) / 60;
+  if (hemisphere[0] == 'S' || hemisphere[0] == 'W') {
+    value = -value;
+  } else if (hemisphere[0] != 'N' && hemisphere[0] != 'E') {
+    return false;
+  }
+  outE7 = static_cast<int32_t>(value);
+  return true;
+}
+} // namespace
+
+const char *gnssBandName(GnssBand band) {
+  switch (band) {
+  case GnssBand::L1:
+    return "L1";
+  case GnssBand::L2:
+    return "L2";
+  case GnssBand::L5:
+    return "L5";
+  case GnssBand::E5b:
+    return "E5b";
+  case GnssBand::E6:
+    return "E6";
+  default:
+    return "?";
+  }
+}
+
+void SignalTable::clear() {
+  for (size_t i = 0; i < kSignalTableSize; ++i) {
+    keys[i] = 0;
+  }
+  count = 0;
+}
+
+size_t SignalTable::home(uint16_t key) {
+  // Same Fibonacci hashing as SatelliteTable, one more bit for 128 slots.
+  return static_cast<uint16_t>(key * 40503u) >> 9;
+}
+
+bool SignalTable::update(const SignalRecord &record, uint32_t nowS) {
+  if (record.svId == 0 || record.system == 0) {
+    return false;
+  }
+  uint16_t key = makeKey(record.system, record.band, record.svId);
+  size_t start = home(key);
+  size_t slot = start;
+  while (keys[slot] != 0 && keys[slot] != key) {
+    slot = (slot + 1) % kSignalTableSize;
+    if (slot == start) {
+      return false;
+    }
+  }
+  bool used = record.used;
+  if (keys[slot] == 0) {
+    // Keep one slot free so probing always terminates.
+    if (count + 1u >= kSignalTableSize) {
+      return false;
+    }
+    keys[slot] = key;
+    count++;
+  } else if (!record.fromUbx) {
+    // GSV carries no use flag; keep the one the last GSA set.
+    used = (signal[slot] & kUsedFlag) != 0;
+  }
+  uint8_t cno = record.cno > kCnoMask ? kCnoMask : record.cno;
+  signal[slot] = static_cast<uint8_t>(cno | (used ? kUsedFlag : 0));
+  detail[slot] = static_cast<uint8_t>((record.quality & kQualityMask) |
+                                      (record.fromUbx ? kUbxFlag : 0));
+  sigIds[slot] = record.sigId;
+  seen[slot] = static_cast<uint8_t>(nowS);
+  return true;
+}
+
+void SignalTable::setUsed(uint8_t systemMask, const uint16_t *usedSvs,
+                          size_t usedCount) {
+  for (size_t slot = 0; slot < kSignalTableSize; ++slot) {
+    if (keys[slot] == 0) {
+      continue;
+    }
+    uint8_t system = static_cast<uint8_t>(keys[slot] >> 11);
+    if ((systemMask & (1u << system)) == 0) {
+      continue;
+    }
+    uint16_t sv = static_cast<uint16_t>(system << 8 | (keys[slot] & 0xFF));
+    bool used = false;
+    for (size_t i = 0; i < usedCount && !used; ++i) {
+      used = usedSvs[i] == sv;
+    }
+    signal[slot] = static_cast<uint8_t>((signal[slot] & kCnoMask) |
+                                        (used ? kUsedFlag : 0));
+  }
+}
+
+void SignalTable::removeSlot(size_t slot) {
+  keys[slot] = 0;
+  count--;
+  size_t hole = slot;
+  size_t next = (slot + 1) % kSignalTableSize;
+  while (keys[next] != 0) {
+    size_t want = home(keys[next]);
+    bool movable = hole <= next ? (want <= hole || want > next)
+                                : (want <= hole && want > next);
+    if (movable) {
+      keys[hole] = keys[next];
+      signal[hole] = signal[next];
+      detail[hole] = detail[next];
+      sigIds[hole] = sigIds[next];
+      seen[hole] = seen[next];
+      keys[next] = 0;
+      hole = next;
+    }
+    next = (next + 1) % kSignalTableSize;
+  }
+}
+
+void SignalTable::expire(uint32_t nowS, uint8_t maxAgeS) {
+  uint8_t now = static_cast<uint8_t>(nowS);
+  size_t slot = 0;
+  while (slot < kSignalTableSize) {
+    if (keys[slot] != 0 && static_cast<uint8_t>(now - seen[slot]) > maxAgeS) {
+      removeSlot(slot);
+      continue;
+    }
+    slot++;
+  }
+}
+
+bool SignalTable::at(size_t slot, SignalRecord &out) const {
+  if (slot >= kSignalTableSize || keys[slot] == 0) {
+    return false;
+  }
+  out.system = static_cast<uint8_t>(keys[slot] >> 11);
+  out.band = static_cast<GnssBand>((keys[slot] >> 8) & 0x07);
+  out.svId = static_cast<uint8_t>(keys[slot]);
+  out.sigId = sigIds[slot];
+  out.fromUbx = (detail[slot] & kUbxFlag) != 0;
+  out.quality = detail[slot] & kQualityMask;
+  out.cno = signal[slot] & kCnoMask;
+  out.used = (signal[slot] & kUsedFlag) != 0;
+  return true;
+}
+
+void SignalTable::summarize(
+    SignalBandSummary (&bands)[kGnssBandCount]) const {
+  uint16_t cnoSum[kGnssBandCount] = {};
+  for (size_t i = 0; i < kGnssBandCount; ++i) {
+    bands[i] = SignalBandSummary();
+  }
+  for (size_t slot = 0; slot < kSignalTableSize; ++slot) {
+    if (keys[slot] == 0) {
+      continue;
+    }
+    size_t band = (keys[slot] >> 8) & 0x07;
+    if (band >= kGnssBandCount) {
+      continue;
+    }
+    bands[band].tracked++;
+    bands[band].used += (signal[slot] & kUsedFlag) ? 1 : 0;
+    cnoSum[band] += signal[slot] & kCnoMask;
+  }
+  for (size_t i = 0; i < kGnssBandCount; ++i) {
+    uint8_t n = bands[i].tracked;
+    if (n != 0) {
+      bands[i].cno = static_cast<uint8_t>((cnoSum[i] + n / 2) / n);
+    }
+  }
+}
+
+void GnssSignalParser::feed(uint8_t value) {
+  if (inUbx) {
+    feedUbx(value);
+    return;
+  }
+  if (value == 0xB5) {
+    inUbx = true;
+    ubxState = UbxState::Sync2;
+    inSentence = false;
+    return;
+  }
+  if (value == '$') {
+    inSentence = true;
+    sentenceLength = 0;
+    return;
+  }
+  if (!inSentence) {
+    return;
+  }
+  if (value == '\r' || value == '\n') {
+    inSentence = false;
+    sentence[sentenceLength] = '\0';
+    handleSentence();
+    return;
+  }
+  if (sentenceLength >= kMaxSentence) {
+    inSentence = false;
+    return;
+  }
+  sentence[sentenceLength++] = static_cast<char>(value);
+}
+
+void GnssSignalParser::handleSentence() {
+  // Only "xxGSV,", "xxGSA," and the position in "xxGGA," / "xxRMC,".
+  if (sentenceLength < 6 || sentence[5] != ',') {
+    return;
+  }
+  const char *type = sentence + 2;
+  bool gsv = strncmp(type, "GSV", 3) == 0;
+  bool gsa = strncmp(type, "GSA", 3) == 0;
+  if (!gsa && usedSystems != 0) {
+    // Any other sentence closes the epoch's GSA run.
+    commitUsed();
+  }
+  bool gga = strncmp(type, "GGA", 3) == 0;
+  bool rmc = strncmp(type, "RMC", 3) == 0;
+  if (!gsv && !gsa && !gga && !rmc) {
+    return;
+  }
+  char *star = strchr(sentence, '*');
+  if (!star || star[1] == '\0' || star[2] == '\0') {
+    return;
+  }
+  uint8_t high = hexValue(star[1]);
+  uint8_t low = hexValue(star[2]);
+  if (high == 0xFF || low == 0xFF) {
+    return;
+  }
+  uint8_t checksum = 0;
+  for (char *p = sentence; p < star; ++p) {
+    checksum ^= static_cast<uint8_t>(*p);
+  }
+  if (checksum != static_cast<uint8_t>(high << 4 | low)) {
+    return;
+  }
+  *star = '\0';
+
+  char *fields[kMaxFields];
+  size_t count = 0;
+  char *cursor = sentence;
+  while (count < kMaxFields) {
+    fields[count++] = cursor;
+    char *comma = strchr(cursor, ',');
+    if (!comma) {
+      break;
+    }
+    *comma = '\0';
+    cursor = comma + 1;
+  }
+  // xxGGA,time,lat,N,lon,E,quality,...  xxRMC,time,status,lat,N,lon,E,...
+  if (gga) {
+    handlePosition(fields, count, 2, count > 6 && fields[6][0] > '0');
+    return;
+  }
+  if (rmc) {
+    handlePosition(fields, count, 3, count > 2 && fields[2][0] == 'A');
+    return;
+  }
+  uint8_t system = systemFromTalker(fields[0]);
+  if (gsv) {
+    handleGsv(fields, count, system);
+  } else {
+    handleGsa(fields, count, system);
+  }
+}
+
+void GnssSignalParser::handlePosition(char **fields, size_t count,
+                                      size_t first, bool valid) {
+  int32_t latitude = 0;
+  int32_t longitude = 0;
+  if (!valid || count < first + 4 ||
+      !parseNmeaAngle(fields[first], fields[first + 1], latitude) ||
+      !parseNmeaAngle(fields[first + 2], fields[first + 3], longitude)) {
+    return;
+  }
+  latitudeE7 = latitude;
+  longitudeE7 = longitude;
+  havePosition = true;
+}
+
+bool GnssSignalParser::position(int32_t &latitude, int32_t &longitude) const {
+  if (!havePosition) {
+    return false;
+  }
+  latitude = latitudeE7;
+  longitude = longitudeE7;
+  return true;
+}
+
+void GnssSignalParser::handleGsv(char **fields, size_t count,
+                                 uint8_t system) {
+  // xxGSV,numMsg,msgNum,numSV,{sv,elv,az,cno}*n[,signalId]
+  if (count < 4 || system == 0 || (count - 4) % 4 != 1) {
+    return; // no signal ID before NMEA 4.10
+  }
+  uint8_t signalId = hexValue(fields[count - 1][0]);
+  if (signalId == 0xFF || fields[count - 1][1] != '\0') {
+    return;
+  }
+  GnssBand band = bandFromNmea(system, signalId);
+  gsvCount++;
+  for (size_t i = 4; i + 3 < count; i += 4) {
+    SignalRecord record;
+    record.system = system;
+    record.svId = fieldValue(fields[i]);
+    record.band = band;
+    record.sigId = signalId;
+    record.cno = fieldValue(fields[i + 3]);
+    if (record.cno == 0) {
+      continue; // in view but not tracked on this signal
+    }
+    signals.update(record, timeS);
+  }
+}
+
+void GnssSignalParser::handleGsa(char **fields, size_t count,
+                                 uint8_t system) {
+  // xxGSA,mode,fix,sv*12,pdop,hdop,vdop[,systemId]
+  if (count < 18) {
+    return;
+  }
+  if (count >= 19 && fields[18][0] != '\0') {
+    system = fieldValue(fields[18]);
+  }
+  if (system == 0) {
+    return;
+  }
+  if (system >= 8) {
+    return;
+  }
+  // A system can span several GSA when it has more than 12 used SVs, so
+  // the flags are only replaced once the whole run is in.
+  usedSystems = static_cast<uint8_t>(usedSystems | 1u << system);
+  for (size_t i = 3; i < 3 + kMaxUsedPerGsa; ++i) {
+    if (fields[i][0] == '\0' || usedCount >= kMaxUsedPerEpoch) {
+      continue;
+    }
+    usedSvs[usedCount++] =
+        static_cast<uint16_t>(system << 8 | fieldValue(fields[i]));
+  }
+}
+
+void GnssSignalParser::commitUsed() {
+  signals.setUsed(usedSystems, usedSvs, usedCount);
+  usedSystems = 0;
+  usedCount = 0;
+}
+
+void GnssSignalParser::feedUbx(uint8_t value) {
+  switch (ubxState) {
+  case UbxState::Sync2:
+    if (value != 0x62) {
+      inUbx = false;
+      feed(value);
+      return;
+    }
+    ubxState = UbxState::Class;
+    break;
+  case UbxState::Class:
+    ubxClass = value;
+    ckA = value;
+    ckB = ckA;
+    ubxState = UbxState::Id;
+    break;
+  case UbxState::Id:
+    ubxId = value;
+    ckA += value;
+    ckB += ckA;
+    ubxState = UbxState::Len1;
+    break;
+  case UbxState::Len1:
+    ubxLength = value;
+    ckA += value;
+    ckB += ckA;
+    ubxState = UbxState::Len2;
+    break;
+  case UbxState::Len2:
+    ubxLength |= static_cast<uint16_t>(value) << 8;
+    ckA += value;
+    ckB += ckA;
+    ubxRead = 0;
+    stagedCount = 0;
+    ubxState = ubxLength == 0 ? UbxState::CkA : UbxState::Payload;
+    break;
+  case UbxState::Payload:
+    ckA += value;
+    ckB += ckA;
+    if (ubxClass == kUbxClassNav && ubxId == kUbxIdNavSig) {
+      stageNavSigByte(value);
+    } else if (ubxLength <= kMaxCapturedPayload) {
+      captured[ubxRead] = value;
+    }
+    if (++ubxRead >= ubxLength) {
+      ubxState = UbxState::CkA;
+    }
+    break;
+  case UbxState::CkA:
+    ubxState = value == ckA ? UbxState::CkB : UbxState::Sync2;
+    if (ubxState == UbxState::Sync2) {
+      inUbx = false;
+    }
+    break;
+  case UbxState::CkB:
+    inUbx = false;
+    if (value != ckB) {
+      break;
+    }
+    if (ubxClass == kUbxClassNav && ubxId == kUbxIdNavSig) {
+      for (uint8_t i = 0; i < stagedCount; ++i) {
+        signals.update(staged[i], timeS);
+      }
+      navSigCount++;
+    } else if (frameHandler && ubxLength <= kMaxCapturedPayload) {
+      frameHandler(ubxClass, ubxId, captured, ubxLength);
+    }
+    break;
+  }
+}
+
+void GnssSignalParser::stageNavSigByte(uint8_t value) {
+  if (ubxRead < kNavSigHeaderSize) {
+    return;
+  }
+  size_t offset = (ubxRead - kNavSigHeaderSize) % kNavSigBlockSize;
+  block[offset] = value;
+  if (offset != kNavSigBlockSize - 1 || stagedCount >= kMaxStagedSignals) {
+    return;
+  }
+  // gnssId, svId, sigId, freqId, prRes(2), cno, qualityInd, corrSource,
+  // ionoModel, sigFlags(2), reserved(4)
+  SignalRecord record;
+  uint8_t svId = block[1];
+  if (!fromUbx(block[0], block[2], svId, record.system, record.band) ||
+      svId == 0 || block[6] == 0) {
+    return;
+  }
+  record.svId = svId;
+  record.sigId = block[2];
+  record.fromUbx = true;
+  record.cno = block[6];
+  record.quality = block[7] & 0x07;
+  uint16_t flags = static_cast<uint16_t>(block[10] | block[11] << 8);
+  record.used = (flags & kUbxPrUsedFlag) != 0;
+  staged[stagedCount++] = record;
+}
@@ -0,0 +1,188 @@
+#include "gnss_timebase.h"
+
+#include "logger.h"
+
+#include <esp_timer.h>
+
+namespace {
+// NMEA for an epoch follows its PPS edge by well under a second; anything
+// later belongs to a newer edge that was missed.
+constexpr int64_t kPpsPairWindowUs = 950000;
+constexpr int64_t kPpsHoldoverUs = 2500000;
+constexpr int64_t kNmeaLatencyUs = 50000;
+constexpr int64_t kMaxDisciplineGapUs = 64000000;
+constexpr int64_t kMaxDriftPpb = 500000;
+constexpr int64_t kMaxResidualUs = 100000;
+
+portMUX_TYPE gTimebaseMux = portMUX_INITIALIZER_UNLOCKED;
+} // namespace
+
+GnssTimebase &gnssTimebase() {
+  static GnssTimebase instance;
+  return instance;
+}
+
+const char *timeSourceName(TimeSource source) {
+  switch (source) {
+  case TimeSource::None:
+    return "none";
+  case TimeSource::Nmea:
+    return "nmea";
+  case TimeSource::Pps:
+    return "pps";
+  }
+  return "unknown";
+}
+
+void IRAM_ATTR GnssTimebase::onPpsEdge() {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&gTimebaseMux);
+  lastPpsUs = now;
+  ppsSequence = ppsSequence + 1;
+  portEXIT_CRITICAL_ISR(&gTimebaseMux);
+}
+
+int64_t GnssTimebase::latestPps(uint32_t *sequence) const {
+  portENTER_CRITICAL(&gTimebaseMux);
+  int64_t pps = lastPpsUs;
+  if (sequence) {
+    *sequence = ppsSequence;
+  }
+  portEXIT_CRITICAL(&gTimebaseMux);
+  return pps;
+}
+
+void GnssTimebase::onUtcSecond(uint32_t unixSeconds, int64_t receivedUs) {
+  // Every sentence of the burst repeats the same second.
+  if (unixSeconds == 0 || unixSeconds == lastUtcSeconds) {
+    return;
+  }
+  lastUtcSeconds = unixSeconds;
+
+  uint32_t sequence = 0;
+  int64_t pps = latestPps(&sequence);
+  int64_t sincePps = receivedUs - pps;
+  if (pps != 0 && sequence != pairedSequence && sincePps >= 0 &&
+      sincePps < kPpsPairWindowUs) {
+    pairedSequence = sequence;
+    discipline(unixSeconds, pps);
+    return;
+  }
+
+  if (source == TimeSource::Pps &&
+      receivedUs - anchorLocalUs < kPpsHoldoverUs) {
+    return;
+  }
+  if (source != TimeSource::Nmea) {
+    logPrintln("[time] Using NMEA arrival time (no PPS)");
+  }
+  portENTER_CRITICAL(&gTimebaseMux);
+  source = TimeSource::Nmea;
+  anchorUtcUs = static_cast<int64_t>(unixSeconds) * 1000000LL;
+  anchorLocalUs = receivedUs - kNmeaLatencyUs;
+  portEXIT_CRITICAL(&gTimebaseMux);
+}
+
+void GnssTimebase::onLeapSecond(int8_t change, uint32_t eventUnixS) {
+  if (change != leapChange && change != 0) {
+    logPrintf("[time] Leap second %+d announced for %lu\n", change,
+              static_cast<unsigned long>(eventUnixS));
+  }
+  portENTER_CRITICAL(&gTimebaseMux);
+  leapChange = change;
+  leapEventUnixS = change != 0 ? eventUnixS : 0;
+  portEXIT_CRITICAL(&gTimebaseMux);
+}
+
+void GnssTimebase::discipline(uint32_t unixSeconds, int64_t ppsLocalUs) {
+  int64_t utcUs = static_cast<int64_t>(unixSeconds) * 1000000LL;
+
+  if (source == TimeSource::Pps) {
+    int64_t utcDelta = utcUs - anchorUtcUs;
+    int64_t localDelta = ppsLocalUs - anchorLocalUs;
+    if (utcDelta > 0 && utcDelta <= kMaxDisciplineGapUs) {
+      int64_t predicted =
+          anchorLocalUs + utcDelta + utcDelta * driftPpb / 1000000000LL;
+      int64_t residual = ppsLocalUs - predicted;
+      int64_t rate = (localDelta - utcDelta) * 1000000000LL / utcDelta;
+      // A leap second or a missed edge shows up as a whole-second residual;
+      // it only re-anchors the clock and never feeds the drift estimate.
+      if (residual > -kMaxResidualUs && residual < kMaxResidualUs &&
+          rate > -kMaxDriftPpb && rate < kMaxDriftPpb) {
+        int32_t drift = static_cast<int32_t>(rate);
+        if (driftValid) {
+          drift = driftPpb + static_cast<int32_t>((rate - driftPpb) / 8);
+        }
+        driftValid = true;
+        portENTER_CRITICAL(&gTimebaseMux);
+        driftPpb = drift;
+        portEXIT_CRITICAL(&gTimebaseMux);
+        lastResidualUs = static_cast<int32_t>(residual);
+        uint32_t absResidual =
+            static_cast<uint32_t>(residual < 0 ? -residual : residual);
+        jitterUs = (jitterUs * 7 + absResidual) / 8;
+      }
+    }
+  } else {
+    logPrintln("[time] Locked to PPS");
+  }
+
+  portENTER_CRITICAL(&gTimebaseMux);
+  source = TimeSource::Pps;
+  anchorUtcUs = utcUs;
+  anchorLocalUs = ppsLocalUs;
+  portEXIT_CRITICAL(&gTimebaseMux);
+  disciplinedEdges++;
+}
+
+UtcTimestamp GnssTimebase::utcAt(int64_t localUs) const {
+  // Readers include the NTP task, so copy the anchor as one unit.
+  portENTER_CRITICAL(&gTimebaseMux);
+  TimeSource currentSource = source;
+  int64_t utcBase = anchorUtcUs;
+  int64_t localBase = anchorLocalUs;
+  int64_t drift = driftPpb;
+  portEXIT_CRITICAL(&gTimebaseMux);
+
+  UtcTimestamp result;
+  if (currentSource == TimeSource::None) {
+    return result;
+  }
+  int64_t elapsed = localUs - localBase;
+  result.unixUs = utcBase + elapsed - elapsed * drift / 1000000000LL;
+  result.valid = true;
+  result.ppsLocked =
+      currentSource == TimeSource::Pps && elapsed < kPpsHoldoverUs;
+  return result;
+}
+
+UtcTimestamp GnssTimebase::now() const { return utcAt(esp_timer_get_time()); }
+
+uint32_t GnssTimebase::ppsAgeUs(int64_t localUs) const {
+  int64_t pps = latestPps(nullptr);
+  if (pps == 0 || localUs < pps || localUs - pps >= kNoPpsAge) {
+    return kNoPpsAge;
+  }
+  return static_cast<uint32_t>(localUs - pps);
+}
+
+TimebaseStats GnssTimebase::stats() const {
+  TimebaseStats result;
+  int64_t now = esp_timer_get_time();
+  uint32_t sequence = 0;
+  latestPps(&sequence);
+  portENTER_CRITICAL(&gTimebaseMux);
+  result.source = source;
+  result.referenceUtcUs = anchorUtcUs;
+  result.leapChange = leapChange;
+  result.leapEventUnixS = leapEventUnixS;
+  portEXIT_CRITICAL(&gTimebaseMux);
+  result.ppsLocked = utcAt(now).ppsLocked;
+  result.ppsEdges = sequence;
+  result.disciplinedEdges = disciplinedEdges;
+  result.driftPpb = driftPpb;
+  result.lastResidualUs = lastResidualUs;
+  result.jitterUs = jitterUs;
+  result.ppsAgeUs = ppsAgeUs(now);
+  return result;
+}
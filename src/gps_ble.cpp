@@ -1,12 +1,19 @@
 #include "gps_ble.h"
 #include "data_channel.h"
 #include "firmware_app.h"
+#include "fix_history.h"
+#include "geofence_monitor.h"
 #include "gps_config.h"
 #include "gps_controller.h"
 #include "gps_serial_control.h"
 #include "logger.h"
 #include "ota_service.h"
+#include "power_manager.h"
+#include "sky_view.h"
 #include "system_mode.h"
+#include "task_scheduler.h"
+#include "track_transfer.h"
+#include "trip_meter.h"
 #include "wifi_manager.h"
 #include "build_version.h"
 #include <Arduino.h>
@@ -27,6 +34,14 @@ NimBLECharacteristic *pCharUbxCustomProfile = nullptr;
 NimBLECharacteristic *pCharUbxCustomSettings = nullptr;
 NimBLECharacteristic *pCharKeepAlive = nullptr;
 NimBLECharacteristic *pCharBuildVersion = nullptr;
+NimBLECharacteristic *pCharPowerProfile = nullptr;
+NimBLECharacteristic *pCharNavHistory = nullptr;
+NimBLECharacteristic *pCharTrip = nullptr;
+NimBLECharacteristic *pCharGeofence = nullptr;
+NimBLECharacteristic *pCharSignals = nullptr;
+NimBLECharacteristic *pCharSkyView = nullptr;
+NimBLECharacteristic *pCharNavRate = nullptr;
+NimBLECharacteristic *pCharUbxNamedProfiles = nullptr;
 
 NimBLEServer *pServer = nullptr;
 
@@ -34,11 +49,20 @@ static bool bleConnected = false;
 static uint16_t currentConnHandle = 0xFFFF;
 static unsigned long lastKeepAliveMillis = 0;
 static constexpr unsigned long kKeepAliveTimeoutMs = 10000;
+static uint8_t navRateHz = 0;
+// Connection interval in 1.25 ms units; the default suits rates up to 10 Hz.
+static constexpr uint16_t kConnIntervalMin = 24;
+static constexpr uint16_t kConnIntervalMax = 48;
+static constexpr uint16_t kConnIntervalFloor = 6;
+static constexpr uint16_t kConnSupervisionTimeout = 400;
 
 static constexpr float kLatLonEps = 1e-5f;
 static constexpr float kHeadingEps = 1.0f;
 static constexpr float kSpeedEps = 0.2f;
 static constexpr float kAltEps = 0.5f;
+// A frozen (stationary) position is only repeated at this period.
+static constexpr unsigned long kStationaryHeartbeatMs =
+    STATIONARY_HEARTBEAT_S * 1000UL;
 
 static constexpr uint8_t kVoltageSensePin = VIN_SENSE_PIN;
 static constexpr float kVoltageDividerTopOhms = 100000.0f;
@@ -47,15 +71,84 @@ static constexpr float kVoltageDividerGain =
     (kVoltageDividerTopOhms + kVoltageDividerBottomOhms) /
     kVoltageDividerBottomOhms;
 static constexpr float kVoltageOffsetVolts = 0.3f; // compensate Schottky drop
-static constexpr unsigned long kVoltageUpdateIntervalMs = 1000;
-
-static float lastVoltageVolts = 0.0f;
-static unsigned long lastVoltageSampleMs = 0;
+static constexpr uint32_t kBleTaskPeriodMs = 1000;
+// NimBLE refuses attribute values above BLE_ATT_ATTR_MAX_LEN.
+static constexpr size_t kMaxAttributeLength = 512;
+// Per-signal record: system, svId, sigId, band, cno, flags.
+static constexpr uint8_t kSignalsFormatVersion = 1;
+static constexpr size_t kSignalsHeaderSize = 2;
+static constexpr size_t kSignalRecordSize = 6;
+static constexpr uint16_t kAttHeaderSize = 3;
+// Largest ATT MTU; bulk track transfer packs a chunk per notification.
+static constexpr uint16_t kPreferredMtu = 517;
+// History catch-up replays stored fixes on the nav characteristic a few
+// notifications per pass, then live notifications resume.
+static constexpr uint32_t kReplayIdlePeriodMs = 1000;
+static constexpr uint32_t kReplayActivePeriodMs = 20;
+static constexpr uint8_t kReplayNotifiesPerTick = 4;
+
+// Catch-up requests arrive on the NimBLE host task; the replay job owns the
+// replay cursor.
+static portMUX_TYPE replayRequestMux = portMUX_INITIALIZER_UNLOCKED;
+static bool replayRequested = false;
+static uint32_t replayRequestAfter = 0;
+static bool replayActive = false;
+static uint32_t replayAfter = 0;
+static int8_t replayTaskId = kInvalidTaskId;
+
+static void serviceNavReplay(uint32_t now);
+
+// Trip totals change with every fix; notify them on a slower cadence.
+static constexpr uint8_t kTripNotifyEveryTicks = 5;
+static uint8_t tripNotifyCountdown = 0;
+static uint32_t tripRevisionSent = 0;
+
+// Sky view deltas go out once a tick; a keyframe resyncs the client on
+// subscribe and periodically. The subscribe callback only raises a flag.
+static constexpr uint8_t kSkyViewKeyframeEveryTicks = 60;
+static constexpr uint8_t kSkyViewMaxFramesPerTick = 8;
+static SkyViewEncoder skyViewEncoder;
+static uint8_t skyViewKeyframeCountdown = 0;
+// Reads come on the NimBLE host task, which must not walk the satellite
+// table while the loop task updates it; bleTick leaves a copy here.
+static portMUX_TYPE skyViewMux = portMUX_INITIALIZER_UNLOCKED;
+static SatelliteTable skyViewPublished;
+
+// Geofence events queue in the monitor's ring; one notify per tick.
+static uint32_t geofenceEventSent = 0;
 
 static uint8_t apStateValue = '0';
 static uint8_t modeStateValue = '0';
 static uint8_t ubxProfileStateValue = '0';
 static uint8_t ubxSettingsProfileStateValue = '0';
+// Profile digit, then whether this build can light-sleep at all.
+static uint8_t powerProfileStateValue[2] = {'0', '0'};
+
+// Writes that reconfigure the receiver run the UBX configuration chain,
+// which takes seconds and must not interleave with one started from the
+// web UI. They go to the gps-config job on the loop task, where the HTTP
+// handlers run too; a write while one is still pending is refused. The
+// owner of gpsConfigBusy alone touches the request fields.
+enum class GpsConfigWrite : uint8_t {
+  ReceiverType,
+  Baud,
+  MeasurementRate,
+  UbxProfile,
+  UbxSettingsProfile,
+  CustomProfile,
+  CustomSettings,
+  NamedProfiles,
+};
+static portMUX_TYPE gpsConfigMux = portMUX_INITIALIZER_UNLOCKED;
+static bool gpsConfigBusy = false;
+static bool gpsConfigReady = false;
+static GpsConfigWrite gpsConfigKind = GpsConfigWrite::Baud;
+static std::string gpsConfigValue;
+static int8_t gpsConfigTaskId = kInvalidTaskId;
+static constexpr uint32_t kGpsConfigIdlePeriodMs = 1000;
+// Outcome of the last write to the named profiles characteristic, under
+// gpsConfigMux: "pending" while queued, then "ok", "busy" or the error.
+static char namedProfilesResult[48] = "ok";
 
 static const char *wifiStateToString(WifiConnectionState state) {
   switch (state) {
@@ -98,20 +191,44 @@ static void refreshGnssTypeCharacteristic() {
   pCharGnssType->setValue(&value, 1);
 }
 
+static void appendSatelliteJson(std::string &json,
+                                const SatelliteRecord &sat) {
+  json.append("{\"id\":");
+  json.append(std::to_string(static_cast<unsigned>(sat.svId)));
+  json.append(",\"snr\":");
+  json.append(std::to_string(static_cast<unsigned>(sat.cno)));
+  json.append(",\"c\":");
+  json.append(std::to_string(static_cast<unsigned>(sat.gnssId)));
+  json.append(",\"active\":");
+  json.append(sat.used ? "1" : "0");
+  json.append(",\"el\":");
+  json.append(std::to_string(static_cast<unsigned>(sat.elevation)));
+  json.append(",\"az\":");
+  json.append(std::to_string(static_cast<unsigned>(sat.azimuth)));
+  json.push_back('}');
+}
+
 static void refreshDebugStatusCharacteristic() {
   if (!pCharDebugStatus)
     return;
 
   GpsDebugSnapshot snapshot = gpsController().debugSnapshot();
+  const SatelliteTable &table = snapshot.satellites;
 
   std::string json;
-  json.reserve(256);
+  json.reserve(kMaxAttributeLength);
   json.append("{\"signalsDb\":[");
-  for (size_t i = 0; i < snapshot.signalCount; ++i) {
-    if (i > 0) {
+  bool first = true;
+  SatelliteRecord sat;
+  for (size_t i = 0; i < table.capacity(); ++i) {
+    if (!table.at(i, sat) || !sat.used) {
+      continue;
+    }
+    if (!first) {
       json.push_back(',');
     }
-    json.append(std::to_string(static_cast<unsigned>(snapshot.signalDb[i])));
+    first = false;
+    json.append(std::to_string(static_cast<unsigned>(sat.cno)));
   }
   json.append("],\"visible\":");
   json.append(std::to_string(static_cast<unsigned>(snapshot.visibleCount)));
@@ -130,34 +247,108 @@ static void refreshDebugStatusCharacteristic() {
   } else {
     json.append("null");
   }
-  json.append(",\"satellites\":[");
-  for (size_t i = 0; i < snapshot.satelliteCount; ++i) {
-    const auto &sat = snapshot.satellites[i];
-    if (i > 0) {
+  json.append(",\"svs\":");
+  json.append(std::to_string(table.size()));
+  // Per band: tracked signals, used in the solution, mean C/N0.
+  json.append(",\"signals\":");
+  json.append(std::to_string(static_cast<unsigned>(snapshot.signalCount)));
+  json.append(",\"bands\":{");
+  first = true;
+  for (size_t i = 1; i < kGnssBandCount; ++i) {
+    const SignalBandSummary &band = snapshot.bands[i];
+    if (band.tracked == 0) {
+      continue;
+    }
+    if (!first) {
       json.push_back(',');
     }
-    json.append("{\"id\":");
-    json.append(std::to_string(static_cast<unsigned>(sat.id)));
-    json.append(",\"snr\":");
-    json.append(std::to_string(static_cast<unsigned>(sat.snr)));
-    json.append(",\"c\":");
-    json.append(std::to_string(static_cast<unsigned>(sat.constellation)));
-    json.append(",\"active\":");
-    json.append(std::to_string(static_cast<unsigned>(sat.active)));
-    json.append(",\"el\":");
-    json.append(std::to_string(static_cast<unsigned>(sat.elevation)));
-    json.append(",\"az\":");
-    json.append(std::to_string(static_cast<unsigned>(sat.azimuth)));
-    json.push_back('}');
-  }
-  json.append("],\"uptime\":");
-  json.append(
-      std::to_string(static_cast<unsigned long>(snapshot.uptimeSeconds)));
+    first = false;
+    json.push_back('"');
+    json.append(gnssBandName(static_cast<GnssBand>(i)));
+    json.append("\":[");
+    json.append(std::to_string(static_cast<unsigned>(band.tracked)));
+    json.push_back(',');
+    json.append(std::to_string(static_cast<unsigned>(band.used)));
+    json.push_back(',');
+    json.append(std::to_string(static_cast<unsigned>(band.cno)));
+    json.push_back(']');
+  }
   json.push_back('}');
+  std::string tail = "],\"uptime\":";
+  tail.append(
+      std::to_string(static_cast<unsigned long>(snapshot.uptimeSeconds)));
+  tail.push_back('}');
+
+  // Used satellites first, then the rest while the attribute has room.
+  json.append(",\"satellites\":[");
+  first = true;
+  bool full = false;
+  for (int pass = 0; pass < 2 && !full; ++pass) {
+    for (size_t i = 0; i < table.capacity(); ++i) {
+      if (!table.at(i, sat) || sat.used != (pass == 0)) {
+        continue;
+      }
+      std::string entry;
+      appendSatelliteJson(entry, sat);
+      if (json.size() + entry.size() + 1 + tail.size() >
+          kMaxAttributeLength) {
+        full = true;
+        break;
+      }
+      if (!first) {
+        json.push_back(',');
+      }
+      first = false;
+      json.append(entry);
+    }
+  }
+  json.append(tail);
 
   pCharDebugStatus->setValue(json);
 }
 
+// Built once a tick on the loop task, where GnssSignalParser updates the
+// table; reads are served from the stored value, so the NimBLE host task
+// neither walks the table nor holds the frame on its stack.
+static void refreshSignalsCharacteristic() {
+  if (!pCharSignals)
+    return;
+
+  const SignalTable &table = gpsController().signalTable();
+  static uint8_t buffer[kMaxAttributeLength];
+  buffer[0] = kSignalsFormatVersion;
+  size_t length = kSignalsHeaderSize;
+  uint8_t count = 0;
+  SignalRecord record;
+  // Used signals first so a truncated list keeps the solution.
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < table.capacity(); ++i) {
+      if (!table.at(i, record) || record.used != (pass == 0)) {
+        continue;
+      }
+      if (length + kSignalRecordSize > sizeof(buffer)) {
+        break;
+      }
+      uint8_t flags = static_cast<uint8_t>(record.quality << 4);
+      if (record.used) {
+        flags |= 0x01;
+      }
+      if (record.fromUbx) {
+        flags |= 0x02;
+      }
+      buffer[length++] = record.system;
+      buffer[length++] = record.svId;
+      buffer[length++] = record.sigId;
+      buffer[length++] = static_cast<uint8_t>(record.band);
+      buffer[length++] = record.cno;
+      buffer[length++] = flags;
+      count++;
+    }
+  }
+  buffer[1] = count;
+  pCharSignals->setValue(buffer, length);
+}
+
 class BleDataPublisher : public NavDataPublisher, public SystemStatusPublisher {
 public:
   void publishNavData(const NavDataSample &sample) override;
@@ -166,12 +357,13 @@ public:
   bool hasLastStatus() const { return haveLastStatus; }
 
 private:
-  float lastLat = 0.0f;
-  float lastLon = 0.0f;
+  double lastLat = 0.0;
+  double lastLon = 0.0;
   float lastHeading = 0.0f;
   float lastSpeed = 0.0f;
   float lastAlt = 0.0f;
   bool haveLastNav = false;
+  unsigned long lastNavSentMs = 0;
   std::string lastStatusJson;
   bool haveLastStatus = false;
 };
@@ -184,24 +376,14 @@ static float readInputVoltage() {
   return senseVolts * kVoltageDividerGain + kVoltageOffsetVolts;
 }
 
-static void refreshInputVoltageCharacteristic(bool forceNotify) {
+static void refreshInputVoltageCharacteristic() {
   if (!pCharInputVoltage)
     return;
 
-  unsigned long now = millis();
-  bool shouldSample = lastVoltageSampleMs == 0 ||
-                      now - lastVoltageSampleMs >= kVoltageUpdateIntervalMs;
-
-  if (shouldSample) {
-    lastVoltageVolts = readInputVoltage();
-    lastVoltageSampleMs = now;
-  } else if (!forceNotify) {
-    return;
-  }
-
+  float volts = readInputVoltage();
   char buffer[24];
   int len = snprintf(buffer, sizeof(buffer), "{\"vin\":%.2f}",
-                     static_cast<double>(lastVoltageVolts));
+                     static_cast<double>(volts));
   if (len <= 0)
     return;
 
@@ -243,6 +425,41 @@ static void refreshGpsBaudCharacteristic() {
   setGpsBaudCharacteristicValue(getGpsSerialBaud());
 }
 
+static void refreshNavRateCharacteristic() {
+  if (!pCharNavRate)
+    return;
+
+  char buffer[4];
+  int len = snprintf(buffer, sizeof(buffer), "%u",
+                     static_cast<unsigned>(getGpsMeasurementRate()));
+  if (len <= 0)
+    return;
+
+  pCharNavRate->setValue(reinterpret_cast<uint8_t *>(buffer), len);
+}
+
+static void requestConnParams(uint16_t handle) {
+  if (!pServer || handle == 0 || handle == 0xFFFF)
+    return;
+
+  uint16_t maxInterval = kConnIntervalMax;
+  if (navRateHz > 0) {
+    // 80% of the epoch in 1.25 ms units: each fix finds a connection event.
+    uint32_t epochUnits = 640u / navRateHz;
+    if (epochUnits < maxInterval)
+      maxInterval = static_cast<uint16_t>(epochUnits);
+    if (maxInterval < kConnIntervalFloor)
+      maxInterval = kConnIntervalFloor;
+  }
+  uint16_t minInterval = maxInterval / 2;
+  if (minInterval > kConnIntervalMin)
+    minInterval = kConnIntervalMin;
+  if (minInterval < kConnIntervalFloor)
+    minInterval = kConnIntervalFloor;
+  pServer->updateConnParams(handle, minInterval, maxInterval, 0,
+                            kConnSupervisionTimeout);
+}
+
 static void refreshUbxProfileCharacteristic() {
   if (!pCharUbxProfile)
     return;
@@ -251,6 +468,94 @@ static void refreshUbxProfileCharacteristic() {
   pCharUbxProfile->setValue(&ubxProfileStateValue, 1);
 }
 
+static void notifyGeofenceEvent() {
+  if (!pCharGeofence)
+    return;
+  GeofenceEvent event;
+  if (!geofenceMonitor().nextEvent(geofenceEventSent, event))
+    return;
+  char json[96];
+  int len = snprintf(json, sizeof(json),
+                     "{\"id\":%u,\"ev\":\"%s\",\"ts\":%lld,\"sq\":%lu}",
+                     static_cast<unsigned>(event.fenceId),
+                     event.entered ? "enter" : "exit",
+                     static_cast<long long>(event.utcMs),
+                     static_cast<unsigned long>(event.sequence));
+  if (len <= 0 || len >= static_cast<int>(sizeof(json)))
+    return;
+  geofenceEventSent = event.sequence;
+  pCharGeofence->setValue(reinterpret_cast<uint8_t *>(json), len);
+  pCharGeofence->notify();
+}
+
+static void publishSkyView() {
+  const SatelliteTable &table = gpsController().satelliteTable();
+  portENTER_CRITICAL(&skyViewMux);
+  skyViewPublished = table;
+  portEXIT_CRITICAL(&skyViewMux);
+}
+
+static void notifySkyView() {
+  if (!pCharSkyView || pCharSkyView->getSubscribedCount() == 0)
+    return;
+  if (skyViewKeyframeCountdown > 0) {
+    skyViewKeyframeCountdown--;
+  } else {
+    skyViewKeyframeCountdown = kSkyViewKeyframeEveryTicks - 1;
+    skyViewEncoder.requestKeyframe();
+  }
+  uint16_t mtu = pServer ? pServer->getPeerMTU(currentConnHandle) : 0;
+  size_t limit = mtu > kAttHeaderSize ? mtu - kAttHeaderSize : 0;
+  if (limit > kMaxAttributeLength) {
+    limit = kMaxAttributeLength;
+  }
+  const SatelliteTable &table = gpsController().satelliteTable();
+  uint8_t frame[kMaxAttributeLength];
+  for (uint8_t i = 0; i < kSkyViewMaxFramesPerTick; ++i) {
+    size_t length = skyViewEncoder.nextFrame(table, frame, limit);
+    if (length == 0)
+      break;
+    pCharSkyView->setValue(frame, length);
+    pCharSkyView->notify();
+    if ((frame[1] & kSkyViewFlagMore) == 0)
+      break;
+  }
+}
+
+static void refreshTripCharacteristic(bool notify) {
+  if (!pCharTrip)
+    return;
+  TripMeterStats trip = tripMeter().stats();
+  char json[160];
+  int len = snprintf(
+      json, sizeof(json),
+      "{\"d\":%.1f,\"mt\":%lu,\"et\":%lu,\"vmax\":%.2f,\"vavg\":%.2f,"
+      "\"up\":%.1f,\"dn\":%.1f,\"st\":%lu,\"mv\":%u}",
+      trip.totals.distanceMm / 1000.0,
+      static_cast<unsigned long>(trip.totals.movingMs / 1000),
+      static_cast<unsigned long>(trip.totals.elapsedMs / 1000),
+      trip.totals.maxSpeedCms / 100.0, trip.averageSpeedCms / 100.0,
+      trip.totals.elevationGainCm / 100.0, trip.totals.elevationLossCm / 100.0,
+      static_cast<unsigned long>(trip.totals.stops), trip.moving ? 1u : 0u);
+  if (len <= 0 || len >= static_cast<int>(sizeof(json)))
+    return;
+  pCharTrip->setValue(reinterpret_cast<uint8_t *>(json), len);
+  tripRevisionSent = trip.revision;
+  if (notify && bleConnected) {
+    pCharTrip->notify();
+  }
+}
+
+static void refreshPowerProfileCharacteristic() {
+  if (!pCharPowerProfile)
+    return;
+  uint8_t index = static_cast<uint8_t>(powerManager().profile());
+  powerProfileStateValue[0] = static_cast<uint8_t>('0' + index);
+  powerProfileStateValue[1] = lightSleepAvailable() ? '1' : '0';
+  pCharPowerProfile->setValue(powerProfileStateValue,
+                              sizeof(powerProfileStateValue));
+}
+
 static void refreshUbxSettingsProfileCharacteristic() {
   if (!pCharUbxSettingsProfile)
     return;
@@ -267,6 +572,24 @@ static void refreshCustomProfileCommandCharacteristic() {
   pCharUbxCustomProfile->setValue(value);
 }
 
+// Names and key counts only: whole profiles do not fit one attribute.
+static void refreshNamedProfilesCharacteristic() {
+  if (!pCharUbxNamedProfiles)
+    return;
+  std::string value = getGpsNamedProfilesJson(false);
+  value.pop_back();
+  char result[sizeof(namedProfilesResult)];
+  portENTER_CRITICAL(&gpsConfigMux);
+  memcpy(result, namedProfilesResult, sizeof(result));
+  portEXIT_CRITICAL(&gpsConfigMux);
+  value += ",\"last\":\"";
+  value += result;
+  value += "\"}";
+  if (value.size() > kMaxAttributeLength)
+    return;
+  pCharUbxNamedProfiles->setValue(value);
+}
+
 static void refreshCustomSettingsCommandCharacteristic() {
   if (!pCharUbxCustomSettings)
     return;
@@ -335,9 +658,7 @@ class ServerCallbacks : public NimBLEServerCallbacks {
   void onConnect(NimBLEServer *server, ble_gap_conn_desc *desc) override {
     logPrintln("[ble] Client connected");
     uint16_t handle = desc ? desc->conn_handle : 0;
-    if (handle != 0) {
-      server->updateConnParams(handle, 24, 48, 0, 400);
-    }
+    requestConnParams(handle);
     if (handle == 0) {
       auto peers = server->getPeerDevices();
       if (!peers.empty()) {
@@ -345,6 +666,7 @@ class ServerCallbacks : public NimBLEServerCallbacks {
       }
     }
     bleConnected = true;
+    powerManager().acquire(PowerLock::Ble);
     currentConnHandle = (handle != 0) ? handle : 0xFFFF;
     lastKeepAliveMillis = millis();
     if (gBlePublisher.hasLastStatus()) {
@@ -366,11 +688,13 @@ class ServerCallbacks : public NimBLEServerCallbacks {
     refreshModeCharacteristic();
     refreshGnssTypeCharacteristic();
     refreshGpsBaudCharacteristic();
+    refreshNavRateCharacteristic();
     refreshUbxProfileCharacteristic();
     refreshUbxSettingsProfileCharacteristic();
     refreshCustomProfileCommandCharacteristic();
     refreshCustomSettingsCommandCharacteristic();
-    refreshInputVoltageCharacteristic(true);
+    refreshInputVoltageCharacteristic();
+    refreshPowerProfileCharacteristic();
   }
 
   void onConnect(NimBLEServer *server) override { onConnect(server, nullptr); }
@@ -381,7 +705,9 @@ class ServerCallbacks : public NimBLEServerCallbacks {
     bleConnected = false;
     currentConnHandle = 0xFFFF;
     lastKeepAliveMillis = 0;
+    powerManager().release(PowerLock::Ble);
     otaHandleBleDisconnect();
+    trackTransferHandleDisconnect();
     if (pServer) {
       pServer->startAdvertising();
     }
@@ -429,14 +755,37 @@ class ModeControlCallbacks : public NimBLECharacteristicCallbacks {
   void onRead(NimBLECharacteristic *) { refreshModeCharacteristic(); }
 } modeControlCallbacks;
 
+static void setNamedProfilesResult(const char *result) {
+  portENTER_CRITICAL(&gpsConfigMux);
+  strncpy(namedProfilesResult, result, sizeof(namedProfilesResult) - 1);
+  namedProfilesResult[sizeof(namedProfilesResult) - 1] = '\0';
+  portEXIT_CRITICAL(&gpsConfigMux);
+}
+
+// Queues a receiver reconfiguration for the gps-config job; false when
+// one is still pending or running.
+static bool postGpsConfigWrite(GpsConfigWrite kind, const std::string &value) {
+  portENTER_CRITICAL(&gpsConfigMux);
+  bool busy = gpsConfigBusy;
+  gpsConfigBusy = true;
+  portEXIT_CRITICAL(&gpsConfigMux);
+  if (busy) {
+    logPrintln("[ble] Receiver reconfiguration in progress, write refused");
+    return false;
+  }
+  gpsConfigKind = kind;
+  gpsConfigValue = value;
+  portENTER_CRITICAL(&gpsConfigMux);
+  gpsConfigReady = true;
+  portEXIT_CRITICAL(&gpsConfigMux);
+  taskScheduler().trigger(gpsConfigTaskId);
+  return true;
+}
+
 class GnssTypeCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
-    const std::string &value = characteristic->getValue();
-    GnssReceiverType type = GnssReceiverType::Ublox;
-    if (!value.empty() && value[0] == '1') {
-      type = GnssReceiverType::GenericNmea;
-    }
-    gpsController().setReceiverType(type);
+    postGpsConfigWrite(GpsConfigWrite::ReceiverType,
+                       characteristic->getValue());
     refreshGnssTypeCharacteristic();
   }
 
@@ -445,28 +794,26 @@ class GnssTypeCallbacks : public NimBLECharacteristicCallbacks {
 
 class GpsBaudCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
-    const std::string &value = characteristic->getValue();
-    uint32_t baud = 0;
-    if (parseGpsBaudValue(value, baud)) {
-      setGpsSerialBaud(baud);
-    }
+    postGpsConfigWrite(GpsConfigWrite::Baud, characteristic->getValue());
     refreshGpsBaudCharacteristic();
   }
 
   void onRead(NimBLECharacteristic *) { refreshGpsBaudCharacteristic(); }
 } gpsBaudCallbacks;
 
+class NavRateCallbacks : public NimBLECharacteristicCallbacks {
+  void onWrite(NimBLECharacteristic *characteristic) {
+    postGpsConfigWrite(GpsConfigWrite::MeasurementRate,
+                       characteristic->getValue());
+    refreshNavRateCharacteristic();
+  }
+
+  void onRead(NimBLECharacteristic *) { refreshNavRateCharacteristic(); }
+} navRateCallbacks;
+
 class UbxProfileCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
-    const std::string &value = characteristic->getValue();
-    if (value.empty())
-      return;
-    UbxConfigProfile profile;
-    if (!ubxProfileFromChar(value[0], profile))
-      return;
-    if (!setGpsUbxProfile(profile)) {
-      logPrintln("[ble] Failed to apply UBX profile");
-    }
+    postGpsConfigWrite(GpsConfigWrite::UbxProfile, characteristic->getValue());
     refreshUbxProfileCharacteristic();
   }
 
@@ -475,15 +822,8 @@ class UbxProfileCallbacks : public NimBLECharacteristicCallbacks {
 
 class UbxSettingsProfileCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
-    const std::string &value = characteristic->getValue();
-    if (value.empty())
-      return;
-    UbxSettingsProfile profile;
-    if (!ubxSettingsProfileFromChar(value[0], profile))
-      return;
-    if (!setGpsUbxSettingsProfile(profile)) {
-      logPrintln("[ble] Failed to apply UBX settings profile");
-    }
+    postGpsConfigWrite(GpsConfigWrite::UbxSettingsProfile,
+                       characteristic->getValue());
     refreshUbxSettingsProfileCharacteristic();
   }
 
@@ -492,14 +832,25 @@ class UbxSettingsProfileCallbacks : public NimBLECharacteristicCallbacks {
   }
 } ubxSettingsProfileCallbacks;
 
-class UbxCustomProfileCallbacks : public NimBLECharacteristicCallbacks {
+class PowerProfileCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
     const std::string &value = characteristic->getValue();
     if (value.empty())
       return;
-    if (!setGpsCustomProfileCommand(value)) {
-      logPrintln("[ble] Failed to store custom UBX profile command");
-    }
+    uint8_t index = static_cast<uint8_t>(value[0] - '0');
+    if (index >= kPowerProfileCount)
+      return;
+    powerManager().setProfile(static_cast<PowerProfile>(index));
+    refreshPowerProfileCharacteristic();
+  }
+
+  void onRead(NimBLECharacteristic *) { refreshPowerProfileCharacteristic(); }
+} powerProfileCallbacks;
+
+class UbxCustomProfileCallbacks : public NimBLECharacteristicCallbacks {
+  void onWrite(NimBLECharacteristic *characteristic) {
+    postGpsConfigWrite(GpsConfigWrite::CustomProfile,
+                       characteristic->getValue());
     refreshCustomProfileCommandCharacteristic();
   }
 
@@ -509,20 +860,151 @@ class UbxCustomProfileCallbacks : public NimBLECharacteristicCallbacks {
 } ubxCustomProfileCallbacks;
 
 class UbxCustomSettingsCallbacks : public NimBLECharacteristicCallbacks {
+  void onWrite(NimBLECharacteristic *characteristic) {
+    postGpsConfigWrite(GpsConfigWrite::CustomSettings,
+                       characteristic->getValue());
+    refreshCustomSettingsCommandCharacteristic();
+  }
+
+  void onRead(NimBLECharacteristic *) {
+    refreshCustomSettingsCommandCharacteristic();
+  }
+} ubxCustomSettingsCallbacks;
+
+// The outcome shows up as "last" once the gps-config job has run it.
+class UbxNamedProfilesCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
     const std::string &value = characteristic->getValue();
     if (value.empty())
       return;
-    if (!setGpsCustomSettingsCommand(value)) {
+    if (postGpsConfigWrite(GpsConfigWrite::NamedProfiles, value)) {
+      setNamedProfilesResult("pending");
+    } else {
+      setNamedProfilesResult("busy");
+    }
+    refreshNamedProfilesCharacteristic();
+  }
+
+  void onRead(NimBLECharacteristic *) { refreshNamedProfilesCharacteristic(); }
+} ubxNamedProfilesCallbacks;
+
+// A JSON object saves a profile; "select:<name>" and "delete:<name>" act
+// on a stored one ("select:" alone switches named profiles off).
+static void runNamedProfilesWrite(const std::string &value) {
+  static const std::string kSelect = "select:";
+  static const std::string kDelete = "delete:";
+  std::string error;
+  bool ok;
+  if (value[0] == '{') {
+    ok = saveGpsNamedProfile(value, error);
+  } else if (value.compare(0, kSelect.size(), kSelect) == 0) {
+    ok = selectGpsNamedProfile(value.substr(kSelect.size()), error);
+  } else if (value.compare(0, kDelete.size(), kDelete) == 0) {
+    ok = deleteGpsNamedProfile(value.substr(kDelete.size()), error);
+  } else {
+    ok = false;
+    error = "unknown command";
+  }
+  if (!ok) {
+    logPrintf("[ble] UBX named profile command failed: %s\n", error.c_str());
+  }
+  setNamedProfilesResult(ok ? "ok" : error.c_str());
+  refreshNamedProfilesCharacteristic();
+}
+
+static bool parseNavRateValue(const std::string &value, uint8_t &rate) {
+  uint32_t parsed = 0;
+  if (value.empty() || value.size() > 3) {
+    return false;
+  }
+  for (char c : value) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    parsed = parsed * 10u + static_cast<uint32_t>(c - '0');
+  }
+  if (parsed > GNSS_MEAS_RATE_MAX_HZ) {
+    return false;
+  }
+  rate = static_cast<uint8_t>(parsed);
+  return true;
+}
+
+static void runGpsConfigWrite(GpsConfigWrite kind, const std::string &value) {
+  switch (kind) {
+  case GpsConfigWrite::ReceiverType:
+    gpsController().setReceiverType(!value.empty() && value[0] == '1'
+                                        ? GnssReceiverType::GenericNmea
+                                        : GnssReceiverType::Ublox);
+    refreshGnssTypeCharacteristic();
+    break;
+  case GpsConfigWrite::Baud: {
+    uint32_t baud = 0;
+    if (parseGpsBaudValue(value, baud)) {
+      setGpsSerialBaud(baud);
+    }
+    refreshGpsBaudCharacteristic();
+    refreshNavRateCharacteristic();
+    break;
+  }
+  case GpsConfigWrite::MeasurementRate: {
+    uint8_t rate = 0;
+    if (parseNavRateValue(value, rate)) {
+      setGpsMeasurementRate(rate);
+    }
+    refreshNavRateCharacteristic();
+    break;
+  }
+  case GpsConfigWrite::UbxProfile: {
+    UbxConfigProfile profile;
+    if (!value.empty() && ubxProfileFromChar(value[0], profile) &&
+        !setGpsUbxProfile(profile)) {
+      logPrintln("[ble] Failed to apply UBX profile");
+    }
+    refreshUbxProfileCharacteristic();
+    break;
+  }
+  case GpsConfigWrite::UbxSettingsProfile: {
+    UbxSettingsProfile profile;
+    if (!value.empty() && ubxSettingsProfileFromChar(value[0], profile) &&
+        !setGpsUbxSettingsProfile(profile)) {
+      logPrintln("[ble] Failed to apply UBX settings profile");
+    }
+    refreshUbxSettingsProfileCharacteristic();
+    break;
+  }
+  case GpsConfigWrite::CustomProfile:
+    if (!value.empty() && !setGpsCustomProfileCommand(value)) {
+      logPrintln("[ble] Failed to store custom UBX profile command");
+    }
+    refreshCustomProfileCommandCharacteristic();
+    break;
+  case GpsConfigWrite::CustomSettings:
+    if (!value.empty() && !setGpsCustomSettingsCommand(value)) {
       logPrintln("[ble] Failed to store custom UBX settings command");
     }
     refreshCustomSettingsCommandCharacteristic();
+    break;
+  case GpsConfigWrite::NamedProfiles:
+    runNamedProfilesWrite(value);
+    break;
   }
+}
 
-  void onRead(NimBLECharacteristic *) {
-    refreshCustomSettingsCommandCharacteristic();
+static void serviceGpsConfigWrite(uint32_t) {
+  portENTER_CRITICAL(&gpsConfigMux);
+  bool ready = gpsConfigReady;
+  portEXIT_CRITICAL(&gpsConfigMux);
+  if (!ready) {
+    return;
   }
-} ubxCustomSettingsCallbacks;
+  runGpsConfigWrite(gpsConfigKind, gpsConfigValue);
+  gpsConfigValue.clear();
+  portENTER_CRITICAL(&gpsConfigMux);
+  gpsConfigReady = false;
+  gpsConfigBusy = false;
+  portEXIT_CRITICAL(&gpsConfigMux);
+}
 
 class KeepAliveCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *characteristic) {
@@ -531,6 +1013,54 @@ class KeepAliveCallbacks : public NimBLECharacteristicCallbacks {
   }
 } keepAliveCallbacks;
 
+class TripCallbacks : public NimBLECharacteristicCallbacks {
+  void onRead(NimBLECharacteristic *) { refreshTripCharacteristic(false); }
+
+  void onWrite(NimBLECharacteristic *characteristic) {
+    std::string value = characteristic->getValue();
+    if (!value.empty() && (value[0] == 'R' || value[0] == 'r')) {
+      tripMeter().requestReset();
+    }
+  }
+} tripCallbacks;
+
+class SkyViewCallbacks : public NimBLECharacteristicCallbacks {
+  // Static: the host task stack has no room for a frame.
+  void onRead(NimBLECharacteristic *characteristic) {
+    static SatelliteTable table;
+    static uint8_t frame[kMaxAttributeLength];
+    portENTER_CRITICAL(&skyViewMux);
+    table = skyViewPublished;
+    portEXIT_CRITICAL(&skyViewMux);
+    size_t length = SkyViewEncoder::snapshot(table, frame, sizeof(frame));
+    characteristic->setValue(frame, length);
+  }
+
+  void onSubscribe(NimBLECharacteristic *, ble_gap_conn_desc *,
+                   uint16_t subValue) {
+    if (subValue != 0) {
+      skyViewKeyframeCountdown = 0;
+    }
+  }
+} skyViewCallbacks;
+
+class NavHistoryCallbacks : public NimBLECharacteristicCallbacks {
+  void onWrite(NimBLECharacteristic *characteristic) {
+    std::string value = characteristic->getValue();
+    char *end = nullptr;
+    unsigned long after = strtoul(value.c_str(), &end, 10);
+    if (value.empty() || end == value.c_str()) {
+      return;
+    }
+    portENTER_CRITICAL(&replayRequestMux);
+    replayRequested = true;
+    replayRequestAfter = static_cast<uint32_t>(after);
+    portEXIT_CRITICAL(&replayRequestMux);
+    lastKeepAliveMillis = millis();
+    taskScheduler().trigger(replayTaskId);
+  }
+} navHistoryCallbacks;
+
 int bleGapEventHandler(ble_gap_event *event, void *arg) {
   (void)arg;
   if (!event)
@@ -552,6 +1082,7 @@ void initBLE() {
   NimBLEDevice::init("ESP32-GPS-BLE");
   NimBLEDevice::setPower(ESP_PWR_LVL_P9);
   NimBLEDevice::setSecurityAuth(false, false, false);
+  NimBLEDevice::setMTU(kPreferredMtu);
   NimBLEDevice::setCustomGapHandler(bleGapEventHandler);
   NimBLEDevice::setCustomGapHandler(bleGapEventHandler);
 
@@ -580,7 +1111,7 @@ void initBLE() {
       CHAR_INPUT_VOLTAGE_UUID,
       NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
   pCharInputVoltage->setCallbacks(&generalChrCallbacks);
-  refreshInputVoltageCharacteristic(true);
+  refreshInputVoltageCharacteristic();
 
   pCharWifiStatus = pService->createCharacteristic(
       CHAR_WIFI_STATUS_UUID, NIMBLE_PROPERTY::READ);
@@ -608,6 +1139,11 @@ void initBLE() {
   pCharGpsBaud->setCallbacks(&gpsBaudCallbacks);
   refreshGpsBaudCharacteristic();
 
+  pCharNavRate = pService->createCharacteristic(
+      CHAR_NAV_RATE_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::WRITE);
+  pCharNavRate->setCallbacks(&navRateCallbacks);
+  refreshNavRateCharacteristic();
+
   pCharUbxProfile = pService->createCharacteristic(
       CHAR_UBX_PROFILE_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::WRITE);
   pCharUbxProfile->setCallbacks(&ubxProfileCallbacks);
@@ -631,16 +1167,48 @@ void initBLE() {
   pCharUbxCustomSettings->setCallbacks(&ubxCustomSettingsCallbacks);
   refreshCustomSettingsCommandCharacteristic();
 
+  pCharUbxNamedProfiles = pService->createCharacteristic(
+      CHAR_UBX_NAMED_PROFILES_UUID,
+      NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::WRITE);
+  pCharUbxNamedProfiles->setCallbacks(&ubxNamedProfilesCallbacks);
+  refreshNamedProfilesCharacteristic();
+
   pCharBuildVersion = pService->createCharacteristic(
       CHAR_BUILD_VERSION_UUID,
       NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
   refreshBuildVersionCharacteristic();
 
+  pCharPowerProfile = pService->createCharacteristic(
+      CHAR_POWER_PROFILE_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::WRITE);
+  pCharPowerProfile->setCallbacks(&powerProfileCallbacks);
+  refreshPowerProfileCharacteristic();
+
   pCharKeepAlive = pService->createCharacteristic(CHAR_KEEPALIVE_UUID,
                                                   NIMBLE_PROPERTY::WRITE);
   pCharKeepAlive->setCallbacks(&keepAliveCallbacks);
 
+  pCharNavHistory = pService->createCharacteristic(CHAR_NAV_HISTORY_UUID,
+                                                   NIMBLE_PROPERTY::WRITE);
+  pCharNavHistory->setCallbacks(&navHistoryCallbacks);
+
+  pCharTrip = pService->createCharacteristic(
+      CHAR_TRIP_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::WRITE |
+                          NIMBLE_PROPERTY::NOTIFY);
+  pCharTrip->setCallbacks(&tripCallbacks);
+  refreshTripCharacteristic(false);
+
+  pCharGeofence = pService->createCharacteristic(
+      CHAR_GEOFENCE_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
+
+  pCharSignals =
+      pService->createCharacteristic(CHAR_SIGNALS_UUID, NIMBLE_PROPERTY::READ);
+
+  pCharSkyView = pService->createCharacteristic(
+      CHAR_SKY_VIEW_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
+  pCharSkyView->setCallbacks(&skyViewCallbacks);
+
   initOtaService(pService);
+  initTrackTransferService(pService);
   pService->start();
 
   NimBLEAdvertising *pAdvertising = NimBLEDevice::getAdvertising();
@@ -650,17 +1218,48 @@ void initBLE() {
   pAdvertising->setMinInterval(0x0800);
   pAdvertising->setMaxInterval(0x1000);
   pAdvertising->start();
+
+  taskScheduler().addPeriodic(
+      "ble", [](uint32_t) { bleTick(); }, kBleTaskPeriodMs, TaskPriority::Low);
+  replayTaskId = taskScheduler().addPeriodic(
+      "ble-replay", serviceNavReplay, kReplayIdlePeriodMs, TaskPriority::Low);
+  gpsConfigTaskId = taskScheduler().addPeriodic(
+      "gps-config", serviceGpsConfigWrite, kGpsConfigIdlePeriodMs,
+      TaskPriority::Low);
 }
 
-static inline bool diffExceeds(float a, float b, float eps) {
-  float d = a - b;
+static void notifyNavSample(const NavDataSample &sample, bool replayed) {
+  char json[192];
+  long ppsAgeMs = sample.ppsAgeUs != kNoPpsAge
+                      ? static_cast<long>(sample.ppsAgeUs / 1000)
+                      : -1L;
+  int len = snprintf(
+      json, sizeof(json),
+      "{\"lt\":%.6f,\"lg\":%.6f,\"hd\":%.1f,\"spd\":%.1f,\"alt\":%.1f,"
+      "\"ts\":%lld,\"pa\":%ld,\"ex\":%u,\"sq\":%lu%s%s}",
+      sample.latitude, sample.longitude, sample.heading, sample.speed,
+      sample.altitude, static_cast<long long>(sample.utcEpochUs / 1000),
+      ppsAgeMs, sample.estimated ? 2u : (sample.extrapolated ? 1u : 0u),
+      static_cast<unsigned long>(sample.sequence),
+      sample.stationary ? ",\"st\":1" : "", replayed ? ",\"rp\":1" : "");
+  if (len <= 0 || len >= static_cast<int>(sizeof(json)))
+    return;
+  pCharNavData->setValue((uint8_t *)json, len);
+  pCharNavData->notify();
+}
+
+static inline bool diffExceeds(double a, double b, double eps) {
+  double d = a - b;
   if (d < 0)
     d = -d;
   return d > eps;
 }
 
 void BleDataPublisher::publishNavData(const NavDataSample &sample) {
+  unsigned long now = millis();
   bool needSend = !haveLastNav ||
+                  (sample.stationary &&
+                   now - lastNavSentMs >= kStationaryHeartbeatMs) ||
                   diffExceeds(sample.latitude, lastLat, kLatLonEps) ||
                   diffExceeds(sample.longitude, lastLon, kLatLonEps) ||
                   diffExceeds(sample.heading, lastHeading, kHeadingEps) ||
@@ -676,30 +1275,58 @@ void BleDataPublisher::publishNavData(const NavDataSample &sample) {
   lastSpeed = sample.speed;
   lastAlt = sample.altitude;
   haveLastNav = true;
+  lastNavSentMs = now;
 
-  if (!pCharNavData || !bleConnected)
+  // During a catch-up the replay reaches this fix anyway; keep order.
+  if (!pCharNavData || !bleConnected || replayActive)
     return;
 
-  char json[112];
-  int len = snprintf(
-      json, sizeof(json),
-      "{\"lt\":%.6f,\"lg\":%.6f,\"hd\":%.1f,\"spd\":%.1f,\"alt\":%.1f}",
-      sample.latitude, sample.longitude, sample.heading, sample.speed,
-      sample.altitude);
-  if (len <= 0)
+  notifyNavSample(sample, false);
+}
+
+static void serviceNavReplay(uint32_t) {
+  portENTER_CRITICAL(&replayRequestMux);
+  bool requested = replayRequested;
+  uint32_t requestAfter = replayRequestAfter;
+  replayRequested = false;
+  portEXIT_CRITICAL(&replayRequestMux);
+
+  if (requested) {
+    replayActive = true;
+    replayAfter = requestAfter;
+    fixHistory().noteCatchUp();
+    taskScheduler().setPeriod(replayTaskId, kReplayActivePeriodMs);
+    logPrintf("[ble] Catch-up after #%lu\n",
+              static_cast<unsigned long>(requestAfter));
+  }
+  if (!replayActive) {
     return;
-  pCharNavData->setValue((uint8_t *)json, len);
-  pCharNavData->notify();
+  }
+
+  for (uint8_t i = 0; i < kReplayNotifiesPerTick; ++i) {
+    HistoryFix fix;
+    if (!bleConnected || !pCharNavData ||
+        !fixHistory().next(replayAfter, fix)) {
+      replayActive = false;
+      taskScheduler().setPeriod(replayTaskId, kReplayIdlePeriodMs);
+      return;
+    }
+    notifyNavSample(historyFixToSample(fix), true);
+    replayAfter = fix.sequence;
+    fixHistory().noteReplayed();
+  }
 }
 
 void BleDataPublisher::publishSystemStatus(const SystemStatusSample &sample) {
-  char json[112];
+  char json[192];
   int len = snprintf(json, sizeof(json),
-                     "{\"fix\":%u,\"hdop\":%.1f,\"signals\":%s,\"ttff\":%d}",
+                     "{\"fix\":%u,\"hdop\":%.1f,\"signals\":%s,\"ttff\":%d,"
+                     "\"rf\":%u}",
                      static_cast<unsigned>(sample.fix), sample.hdop,
                      sample.signalsJson.c_str(),
-                     static_cast<int>(sample.ttffSeconds));
-  if (len <= 0)
+                     static_cast<int>(sample.ttffSeconds),
+                     static_cast<unsigned>(sample.rfFlags));
+  if (len <= 0 || len >= static_cast<int>(sizeof(json)))
     return;
   lastStatusJson.assign(json, static_cast<size_t>(len));
   haveLastStatus = true;
@@ -736,6 +1363,17 @@ void updateGpsBaudCharacteristic(uint32_t baud) {
   setGpsBaudCharacteristicValue(baud);
 }
 
+void updateBleNavRate(uint8_t rateHz) {
+  if (navRateHz == rateHz)
+    return;
+
+  navRateHz = rateHz;
+  refreshNavRateCharacteristic();
+  if (bleConnected) {
+    requestConnParams(currentConnHandle);
+  }
+}
+
 void updateUbxProfileCharacteristic(UbxConfigProfile profile) {
   ubxProfileStateValue = static_cast<uint8_t>(ubxProfileToChar(profile));
   if (pCharUbxProfile) {
@@ -767,7 +1405,17 @@ void bleTick() {
   if (currentConnHandle == 0xFFFF)
     return;
 
-  refreshInputVoltageCharacteristic(false);
+  refreshInputVoltageCharacteristic();
+  if (tripNotifyCountdown > 0) {
+    tripNotifyCountdown--;
+  } else if (tripMeter().stats().revision != tripRevisionSent) {
+    tripNotifyCountdown = kTripNotifyEveryTicks - 1;
+    refreshTripCharacteristic(true);
+  }
+  notifyGeofenceEvent();
+  publishSkyView();
+  notifySkyView();
+  refreshSignalsCharacteristic();
 
   unsigned long now = millis();
   if (lastKeepAliveMillis != 0 &&
@@ -783,4 +1431,5 @@ void bleTick() {
   bleConnected = false;
   currentConnHandle = 0xFFFF;
   lastKeepAliveMillis = 0;
+  powerManager().release(PowerLock::Ble);
 }
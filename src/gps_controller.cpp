@@ -2,41 +2,128 @@
 
 #include "gps_ble.h"
 #include "gps_config.h"
+#include "gnss_signals.h"
+#include "gnss_timebase.h"
 #include "gps_serial_control.h"
+#include "interference_monitor.h"
 #include "led_status.h"
 #include "logger.h"
+#include "fix_history.h"
+#include "nav_extrapolator.h"
+#include "nav_kalman.h"
+#include "power_manager.h"
 #include "system_mode.h"
+#include "task_scheduler.h"
 #include "ubx_command_set.h"
+#include "ubx_config_set.h"
+#include "ubx_profile.h"
+#include "ubx_profile_store.h"
 
 #include <Arduino.h>
 #include "driver/temp_sensor.h"
 #include <Preferences.h>
 #include <ctype.h>
+#include <esp_timer.h>
 #include <iarduino_GPS_NMEA.h>
+#include <math.h>
 #include <string>
 
 namespace {
-HardwareSerial gpsSerial(1);
+GnssSignalParser signalParser;
+InterferenceMonitor rfMonitor;
+
+// The NMEA library owns the UART; bytes it reads are copied to the signal
+// parser so GSV signal IDs and NAV-SIG frames are seen without a second
+// reader on the port.
+class TappedGpsSerial : public HardwareSerial {
+public:
+  using HardwareSerial::HardwareSerial;
+  using HardwareSerial::read;
+
+  int read() override {
+    int value = HardwareSerial::read();
+    if (value >= 0 && tapEnabled) {
+      signalParser.feed(static_cast<uint8_t>(value));
+    }
+    return value;
+  }
+
+  bool tapEnabled = false;
+};
+
+TappedGpsSerial gpsSerial(1);
 iarduino_GPS_NMEA gpsParser;
 constexpr const char *kGpsPrefsNamespace = "gpscfg";
 constexpr const char *kGpsBaudKey = "baud";
+constexpr const char *kGpsBaudCeilingKey = "baudmax";
 constexpr const char *kGpsProfileKey = "profile";
 constexpr const char *kGpsSettingsProfileKey = "cfgsel";
 constexpr const char *kGpsCustomProfileKey = "custprof";
 constexpr const char *kGpsCustomSettingsKey = "custset";
 constexpr const char *kGpsReceiverTypeKey = "gnssrx";
+constexpr const char *kGpsMeasRateKey = "measrate";
 constexpr UbxConfigProfile kDefaultUbxProfile = UbxConfigProfile::FullSystems;
 constexpr UbxSettingsProfile kDefaultUbxSettingsProfile =
     UbxSettingsProfile::DefaultRamBbr;
 constexpr GnssReceiverType kDefaultReceiverType = GnssReceiverType::Ublox;
-constexpr size_t kUbxPayloadBufferSize = 196;
+constexpr size_t kUbxPayloadBufferSize = 512;
 constexpr uint32_t kUbxAckTimeoutMs = 600;
 constexpr uint32_t kUbxResponseTimeoutMs = 1200;
 constexpr uint32_t kUbxInterCommandDelayMs = 30;
 constexpr uint32_t kUbxDrainWindowMs = 50;
 constexpr uint32_t kUbxStartupDelayMs = 250;
-constexpr uint8_t kUbxValgetLayerRam = 0;
 constexpr uint32_t kUbxKeyMask = 0xFFFFFFF8u;
+constexpr uint32_t kGpsRxPollIntervalMs = 20;
+constexpr int64_t kNavFilterMaxGapUs = 5000000;
+constexpr uint32_t kNavOutputPeriodMs =
+    NAV_OUTPUT_RATE_HZ > 0 ? 1000 / NAV_OUTPUT_RATE_HZ : OUTPUT_INTERVAL_MS;
+constexpr int64_t kNavOutputPeriodUs = kNavOutputPeriodMs * 1000LL;
+// Status goes out on its own clock, whatever the fix and nav-out rates.
+constexpr uint32_t kStatusIntervalMs = 5 * OUTPUT_INTERVAL_MS;
+constexpr uint32_t kPassthroughPollIntervalMs = 2;
+// iarduino_GPS_NMEA fills one row per GSV satellite: id, SNR, system,
+// used, elevation, azimuth split over two bytes.
+constexpr size_t kParserSatelliteRows = 32;
+// Satellites missing from this many seconds of GSV output are dropped.
+constexpr uint8_t kSatelliteMaxAgeS = 20;
+constexpr uint32_t kUbxKeyMsgoutNavSigUart1 = 0x20910346;
+constexpr uint8_t kUbxClassMon = 0x0A;
+constexpr uint8_t kUbxIdMonRf = 0x38;
+constexpr uint8_t kUbxClassSec = 0x27;
+constexpr uint8_t kUbxIdSecSig = 0x09;
+constexpr uint8_t kUbxClassNav = 0x01;
+constexpr uint8_t kUbxIdNavTimeLs = 0x26;
+constexpr size_t kNavTimeLsSize = 24;
+constexpr uint32_t kUbxKeyRateMeas = 0x30210001; // U2, ms
+constexpr uint32_t kUbxKeyRateNav = 0x30210002;  // U2, measurements/solution
+// Share of the UART line rate the NMEA output may fill (8N1, 10 bits/byte).
+constexpr uint32_t kUartBudgetPercent = 85;
+constexpr uint32_t kNmeaSentenceBytes = 70;
+// RMC, GGA, GLL and VTG go out once an epoch, GSA once per system, GSV per
+// four satellites of each system and signal.
+constexpr uint32_t kNmeaFixedSentences = 4;
+constexpr uint32_t kMinAssumedSatellites = 12;
+constexpr uint32_t kNmeaSystemSlots = 8;
+constexpr uint32_t kUbxKeyUart1Baudrate = 0x40520001; // U4
+// Likely receiver rates first: u-blox defaults are 9600 and 38400.
+constexpr uint32_t kAutobaudProbeRates[] = {9600,  38400, 115200,
+                                            460800, 230400, 57600,
+                                            19200, 921600, 4800};
+constexpr uint32_t kAutobaudTargets[] = {921600, 460800, 230400, 115200};
+// Long enough for one 1 Hz NMEA burst if the MON-VER poll goes unanswered.
+constexpr uint32_t kAutobaudListenMs = 1100;
+constexpr uint32_t kBaudSwitchSettleMs = 100;
+constexpr uint8_t kBaudVerifyAttempts = 3;
+constexpr uint16_t kMaxSyncFrameLength = 1024;
+constexpr uint8_t kMaxNmeaSentenceLength = 82;
+// Keys per CFG-VALGET, so an answer of 8-byte values still fits the frame
+// buffer.
+constexpr size_t kUbxValgetChunk = 32;
+// CFG-VALGET layer that answers with the firmware defaults.
+constexpr uint8_t kUbxValgetDefaultLayer = 7;
+// The library's float position is within half a float step (~8e-6 deg at
+// 180 deg) of the GGA/RMC text; beyond that they are not the same fix.
+constexpr double kPositionMatchDeg = 2e-5;
 static bool initTempSensorOnce() {
   static bool initialized = false;
   if (initialized)
@@ -57,6 +144,22 @@ static bool readChipTemperature(float &outC) {
   return temp_sensor_read_celsius(&outC) == ESP_OK;
 }
 
+// Swaps the library's float position for the digits of the same sentence.
+void refinePosition(double &latitude, double &longitude) {
+  int32_t latitudeE7 = 0;
+  int32_t longitudeE7 = 0;
+  if (!signalParser.position(latitudeE7, longitudeE7)) {
+    return;
+  }
+  double preciseLatitude = latitudeE7 * 1e-7;
+  double preciseLongitude = longitudeE7 * 1e-7;
+  if (fabs(preciseLatitude - latitude) < kPositionMatchDeg &&
+      fabs(preciseLongitude - longitude) < kPositionMatchDeg) {
+    latitude = preciseLatitude;
+    longitude = preciseLongitude;
+  }
+}
+
 struct UbxFrame {
   uint8_t msgClass = 0;
   uint8_t msgId = 0;
@@ -65,9 +168,6 @@ struct UbxFrame {
   uint8_t payload[kUbxPayloadBufferSize] = {};
 };
 
-bool waitForSpecificFrame(uint8_t desiredClass, uint8_t desiredId,
-                          UbxFrame &frame, uint32_t timeoutMs);
-
 void logUbxFrame(const char *label, const UbxFrame &frame) {
   const char *tag = label ? label : "UBX";
   logPrintf("[gps] %s: class=0x%02X id=0x%02X len=%u\n", tag, frame.msgClass,
@@ -254,41 +354,6 @@ bool sendUbxMessage(uint8_t msgClass, uint8_t msgId, const uint8_t *payload,
   return bytesWritten == expected;
 }
 
-bool requestUbxConfigValue(uint32_t key, uint8_t &valueOut, uint8_t layer) {
-  uint8_t payload[8];
-  payload[0] = 0; // version
-  payload[1] = layer;
-  payload[2] = 0;
-  payload[3] = 0;
-  uint32_t maskedKey = key;
-  payload[4] = static_cast<uint8_t>(maskedKey & 0xFFu);
-  payload[5] = static_cast<uint8_t>((maskedKey >> 8) & 0xFFu);
-  payload[6] = static_cast<uint8_t>((maskedKey >> 16) & 0xFFu);
-  payload[7] = static_cast<uint8_t>((maskedKey >> 24) & 0xFFu);
-  if (!sendUbxMessage(0x06, 0x8B, payload, sizeof(payload))) {
-    return false;
-  }
-
-  UbxFrame frame;
-  if (!waitForSpecificFrame(0x06, 0x8B, frame, kUbxResponseTimeoutMs)) {
-    return false;
-  }
-  logUbxFrame("UBX VALGET", frame);
-  if (frame.payloadStored < 9) {
-    return false;
-  }
-
-  uint32_t responseKey = static_cast<uint32_t>(frame.payload[4]) |
-                         (static_cast<uint32_t>(frame.payload[5]) << 8) |
-                         (static_cast<uint32_t>(frame.payload[6]) << 16) |
-                         (static_cast<uint32_t>(frame.payload[7]) << 24);
-  if ((responseKey & kUbxKeyMask) != (maskedKey & kUbxKeyMask)) {
-    return false;
-  }
-  valueOut = frame.payload[8];
-  return true;
-}
-
 void drainGpsSerialInput() {
   unsigned long start = millis();
   while (millis() - start < kUbxDrainWindowMs) {
@@ -411,27 +476,10 @@ bool readUbxFrame(UbxFrame &frame, uint32_t timeoutMs) {
   return false;
 }
 
-bool waitForSpecificFrame(uint8_t desiredClass, uint8_t desiredId,
-                          UbxFrame &frame, uint32_t timeoutMs) {
-  unsigned long start = millis();
-  while (millis() - start < timeoutMs) {
-    uint32_t elapsed = millis() - start;
-    uint32_t remaining = (elapsed >= timeoutMs) ? 0 : (timeoutMs - elapsed);
-    if (remaining == 0) {
-      remaining = 1;
-    }
-    if (!readUbxFrame(frame, remaining)) {
-      return false;
-    }
-    if (frame.msgClass == desiredClass && frame.msgId == desiredId) {
-      return true;
-    }
-  }
-  return false;
-}
-
 bool waitForUbxAck(uint8_t msgClass, uint8_t msgId, uint32_t timeoutMs) {
-  UbxFrame frame;
+  // Static like every UbxFrame here: the configuration chain also runs on
+  // the NimBLE host task, whose ~4 KB stack cannot spare half a kilobyte.
+  static UbxFrame frame;
   unsigned long start = millis();
   while (millis() - start < timeoutMs) {
     uint32_t elapsed = millis() - start;
@@ -495,7 +543,7 @@ bool runUbxSequence(const UbxCommandSequence &sequence, const char *label) {
 
 bool waitForUbxResponse(uint8_t expectedClass, uint8_t expectedId,
                         uint32_t timeoutMs) {
-  UbxFrame frame;
+  static UbxFrame frame;
   unsigned long start = millis();
   while (millis() - start < timeoutMs) {
     uint32_t elapsed = millis() - start;
@@ -531,6 +579,355 @@ bool probeUbxLink() {
   logPrintln("[gps] UBX ping timed out");
   return false;
 }
+
+bool sendUartBaudrate(uint32_t baud) {
+  uint8_t payload[4 + 8];
+  payload[0] = 0; // version
+  payload[1] = kUbxLayerRam;
+  payload[2] = 0;
+  payload[3] = 0;
+  for (int i = 0; i < 4; ++i) {
+    payload[4 + i] =
+        static_cast<uint8_t>((kUbxKeyUart1Baudrate >> (8 * i)) & 0xFFu);
+    payload[8 + i] = static_cast<uint8_t>((baud >> (8 * i)) & 0xFFu);
+  }
+  return sendUbxMessage(0x06, 0x8A, payload, sizeof(payload));
+}
+
+// Looks for a whole NMEA sentence or UBX frame with a valid checksum; line
+// noise at a wrong baud rate practically never produces either.
+class GpsSyncDetector {
+public:
+  bool feed(uint8_t c) { return feedNmea(c) || feedUbx(c); }
+
+private:
+  bool feedNmea(uint8_t c) {
+    if (c == '$') {
+      nmeaState = 1;
+      nmeaSum = 0;
+      nmeaLength = 0;
+      return false;
+    }
+    switch (nmeaState) {
+    case 1:
+      if (c == '*') {
+        nmeaState = nmeaLength >= 5 ? 2 : 0;
+      } else if (c < 0x20 || c > 0x7E ||
+                 ++nmeaLength > kMaxNmeaSentenceLength) {
+        nmeaState = 0;
+      } else {
+        nmeaSum ^= c;
+      }
+      return false;
+    case 2: {
+      int digit = hexDigitValue(static_cast<char>(c));
+      nmeaState = digit < 0 ? 0 : 3;
+      nmeaCheck = static_cast<uint8_t>(digit << 4);
+      return false;
+    }
+    case 3: {
+      int digit = hexDigitValue(static_cast<char>(c));
+      nmeaState = 0;
+      return digit >= 0 && (nmeaCheck | digit) == nmeaSum;
+    }
+    default:
+      return false;
+    }
+  }
+
+  bool feedUbx(uint8_t c) {
+    switch (ubxState) {
+    case 0:
+      ubxState = c == 0xB5 ? 1 : 0;
+      return false;
+    case 1:
+      ubxState = c == 0x62 ? 2 : (c == 0xB5 ? 1 : 0);
+      ubxA = ubxB = 0;
+      ubxCount = 0;
+      ubxLength = 0;
+      return false;
+    case 2:
+      ubxA = static_cast<uint8_t>(ubxA + c);
+      ubxB = static_cast<uint8_t>(ubxB + ubxA);
+      if (ubxCount == 2) {
+        ubxLength = c;
+      } else if (ubxCount == 3) {
+        ubxLength |= static_cast<uint16_t>(c) << 8;
+      }
+      ubxCount++;
+      if (ubxCount == 4 && ubxLength > kMaxSyncFrameLength) {
+        ubxState = 0;
+      } else if (ubxCount >= 4 && ubxCount == 4u + ubxLength) {
+        ubxState = 3;
+      }
+      return false;
+    case 3:
+      ubxState = c == ubxA ? 4 : 0;
+      return false;
+    case 4:
+      ubxState = 0;
+      return c == ubxB;
+    default:
+      return false;
+    }
+  }
+
+  uint8_t nmeaState = 0;
+  uint8_t nmeaSum = 0;
+  uint8_t nmeaCheck = 0;
+  uint8_t nmeaLength = 0;
+  uint8_t ubxState = 0;
+  uint8_t ubxA = 0;
+  uint8_t ubxB = 0;
+  uint16_t ubxCount = 0;
+  uint16_t ubxLength = 0;
+};
+
+bool listenForGpsSync(uint32_t timeoutMs) {
+  GpsSyncDetector detector;
+  unsigned long start = millis();
+  while (millis() - start < timeoutMs) {
+    if (gpsSerial.available() == 0) {
+      delay(1);
+      continue;
+    }
+    if (detector.feed(static_cast<uint8_t>(gpsSerial.read()))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t estimateEpochBytes(const SatelliteTable &satellites,
+                            const SignalTable &signals) {
+  // NMEA 4.10+ repeats GSV for every signal of a system, so a dual-band
+  // receiver sends about twice the sentences of the satellite count. In
+  // view per system from the satellite table (GSV lists untracked ones
+  // too), tracked per system and band from the signal table.
+  uint8_t inView[kNmeaSystemSlots] = {};
+  uint8_t perBand[kNmeaSystemSlots][kGnssBandCount] = {};
+  SatelliteRecord sat;
+  for (size_t i = 0; i < satellites.capacity(); ++i) {
+    if (satellites.at(i, sat) && sat.gnssId < kNmeaSystemSlots) {
+      inView[sat.gnssId]++;
+    }
+  }
+  SignalRecord record;
+  for (size_t i = 0; i < signals.capacity(); ++i) {
+    if (signals.at(i, record) && record.system < kNmeaSystemSlots) {
+      perBand[record.system][static_cast<uint8_t>(record.band)]++;
+    }
+  }
+  uint32_t systemCount = 0;
+  uint32_t gsvSentences = 0;
+  for (size_t system = 0; system < kNmeaSystemSlots; ++system) {
+    uint32_t bySignal = 0;
+    for (size_t band = 0; band < kGnssBandCount; ++band) {
+      bySignal += (perBand[system][band] + 3u) / 4u;
+    }
+    uint32_t byView = (inView[system] + 3u) / 4u;
+    if (bySignal == 0 && byView == 0) {
+      continue;
+    }
+    systemCount++;
+    gsvSentences += bySignal > byView ? bySignal : byView;
+  }
+  if (systemCount == 0) {
+    systemCount = 1;
+  }
+  if (gsvSentences < (kMinAssumedSatellites + 3) / 4) {
+    gsvSentences = (kMinAssumedSatellites + 3) / 4;
+  }
+  uint32_t sentences = kNmeaFixedSentences + systemCount + gsvSentences;
+  uint32_t bytes = sentences * kNmeaSentenceBytes;
+#if GNSS_NAV_SIG_RATE > 0
+  bytes += (8 + 16 * static_cast<uint32_t>(signals.size())) / GNSS_NAV_SIG_RATE;
+#else
+  (void)signals;
+#endif
+  return bytes;
+}
+
+// Desired receiver configuration, what was read back, and the difference.
+// Static: three sets are 3 KB, too much for the loop task stack.
+UbxConfigSet desiredConfig;
+UbxConfigSet receiverConfig;
+UbxConfigSet configChanges;
+// RAM values read back by the last verification.
+UbxConfigSet verifiedConfig;
+uint32_t verifiedAtMs = 0;
+// Values the last diff overwrote, per layer, to take back a named profile
+// that fails verification.
+UbxConfigSet undoConfig;
+// RAM keys of the named profile in effect, and of the one being applied.
+// A key no profile asks for any more goes back to its default.
+uint32_t appliedProfileKeys[kUbxProfileMaxItems];
+size_t appliedProfileKeyCount = 0;
+uint32_t pendingProfileKeys[kUbxProfileMaxItems];
+size_t pendingProfileKeyCount = 0;
+
+// Keys the receiver NAKed on the last write; verification leaves them out.
+uint32_t rejectedKeys[UbxConfigSet::kCapacity];
+size_t rejectedKeyCount = 0;
+
+bool wasRejected(uint32_t key) {
+  for (size_t i = 0; i < rejectedKeyCount; ++i) {
+    if (rejectedKeys[i] == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Waits for a CFG-VALGET answer; a NAK (unknown key) ends the wait early
+// and sets `nak`.
+bool waitForValget(UbxFrame &frame, bool &nak) {
+  nak = false;
+  unsigned long start = millis();
+  while (millis() - start < kUbxResponseTimeoutMs) {
+    if (!readUbxFrame(frame, kUbxResponseTimeoutMs - (millis() - start))) {
+      return false;
+    }
+    if (frame.msgClass == 0x06 && frame.msgId == 0x8B) {
+      return true;
+    }
+    if (frame.msgClass == 0x05 && frame.msgId == 0x00 &&
+        frame.payloadStored >= 2 && frame.payload[0] == 0x06 &&
+        frame.payload[1] == 0x8B) {
+      nak = true;
+      return false;
+    }
+  }
+  return false;
+}
+
+// Reads every key of `keys` that belongs to one layer, kUbxValgetChunk keys
+// a request. Keys the layer does not hold are simply absent from `out`.
+// With `defaults` the firmware default values are read instead, filed
+// under the same layer.
+bool readUbxConfig(const UbxConfigSet &keys, uint8_t layer, UbxConfigSet &out,
+                   bool defaults = false) {
+  out.clear();
+  uint8_t payload[4 + 4 * kUbxValgetChunk];
+  static UbxFrame frame;
+  // One VALGET from item `next` on; false with `nak` set when the firmware
+  // does not know one of its keys.
+  auto request = [&](size_t &next, size_t maxKeys, bool &nak) {
+    nak = false;
+    size_t length =
+        keys.encodeValget(layer, next, maxKeys, payload, sizeof(payload));
+    if (defaults) {
+      payload[1] = kUbxValgetDefaultLayer;
+    }
+    return sendUbxMessage(0x06, 0x8B, payload, length) &&
+           waitForValget(frame, nak) &&
+           frame.payloadStored >= frame.payloadSize &&
+           out.addValgetPayload(frame.payload, frame.payloadStored, layer);
+  };
+  size_t next = 0;
+  bool complete = true;
+  while (true) {
+    size_t chunkStart = next;
+    size_t probe = next;
+    if (keys.encodeValget(layer, probe, 1, payload, sizeof(payload)) == 0) {
+      break;
+    }
+    bool nak = false;
+    if (request(next, kUbxValgetChunk, nak)) {
+      continue;
+    }
+    if (!nak) {
+      complete = false;
+      continue;
+    }
+    // One unknown key NAKs the whole chunk; the others are read one at a
+    // time, and the unknown ones stay absent like keys the layer lacks.
+    for (size_t single = chunkStart; single < next;) {
+      size_t at = single;
+      if (keys.encodeValget(layer, at, 1, payload, sizeof(payload)) == 0 ||
+          at > next) {
+        break;
+      }
+      bool keyNak = false;
+      if (!request(single, 1, keyNak) && !keyNak) {
+        complete = false;
+      }
+    }
+  }
+  return complete;
+}
+
+bool sendUbxValset(const uint8_t *payload, size_t length) {
+  return sendUbxMessage(0x06, 0x8A, payload, length) &&
+         waitForUbxAck(0x06, 0x8A, kUbxAckTimeoutMs);
+}
+
+// One CFG-VALSET per distinct layer combination. A VALSET is all or
+// nothing, so a NAK (a key this firmware lacks) is retried key by key to
+// keep the rest.
+bool writeUbxConfig(const UbxConfigSet &changes) {
+  static uint8_t payload[4 + UbxConfigSet::kCapacity * 12];
+  bool allOk = true;
+  rejectedKeyCount = 0;
+  for (uint8_t layers = 1; layers <= kUbxLayerAll; ++layers) {
+    size_t length = changes.encodeValset(layers, payload, sizeof(payload));
+    if (length == 0 || sendUbxValset(payload, length)) {
+      continue;
+    }
+    for (size_t i = 0; i < changes.size(); ++i) {
+      const UbxConfigItem &item = changes[i];
+      if (item.layers != layers) {
+        continue;
+      }
+      length = changes.encodeValsetItem(i, payload, sizeof(payload));
+      if (length == 0 || !sendUbxValset(payload, length)) {
+        logPrintf("[gps] UBX key 0x%08lX rejected\n",
+                  static_cast<unsigned long>(item.key));
+        if (rejectedKeyCount < UbxConfigSet::kCapacity) {
+          rejectedKeys[rejectedKeyCount++] = item.key;
+        }
+        // NAV-SIG output is optional, see addRuntimeConfig().
+        allOk = allOk && item.key == kUbxKeyMsgoutNavSigUart1;
+      }
+    }
+  }
+  return allOk;
+}
+
+// UBX-NAV-TIMELS: lsChange and the seconds left to it when the receiver
+// knows of a scheduled leap second from the navigation message.
+void handleTimeLs(const uint8_t *payload, size_t length) {
+  if (length < kNavTimeLsSize || payload[4] != 0) {
+    return;
+  }
+  int8_t change = static_cast<int8_t>(payload[11]);
+  int32_t timeToEvent = static_cast<int32_t>(
+      static_cast<uint32_t>(payload[12]) |
+      static_cast<uint32_t>(payload[13]) << 8 |
+      static_cast<uint32_t>(payload[14]) << 16 |
+      static_cast<uint32_t>(payload[15]) << 24);
+  bool timeValid = (payload[23] & 0x02) != 0;
+  UtcTimestamp now = gnssTimebase().now();
+  if (!timeValid || change == 0 || timeToEvent <= 0 || !now.valid) {
+    gnssTimebase().onLeapSecond(0, 0);
+    return;
+  }
+  uint32_t eventUnixS = static_cast<uint32_t>(now.unixUs / 1000000LL) +
+                        static_cast<uint32_t>(timeToEvent);
+  gnssTimebase().onLeapSecond(change > 0 ? 1 : -1, eventUnixS);
+}
+
+// Poll answers arrive through the signal parser tap while NMEA is parsed.
+void handleMonitorFrame(uint8_t msgClass, uint8_t msgId,
+                        const uint8_t *payload, size_t length) {
+  if (msgClass == kUbxClassMon && msgId == kUbxIdMonRf) {
+    rfMonitor.onMonRf(payload, length, millis());
+  } else if (msgClass == kUbxClassSec && msgId == kUbxIdSecSig) {
+    rfMonitor.onSecSig(payload, length, millis());
+  } else if (msgClass == kUbxClassNav && msgId == kUbxIdNavTimeLs) {
+    handleTimeLs(payload, length);
+  }
+}
 } // namespace
 
 GpsController &gpsController() {
@@ -542,42 +939,87 @@ void GpsController::begin() {
   state = GpsRuntimeState{};
   state.bootMillis = millis();
   gpsSerialBaudValue = loadStoredGpsBaud();
+  baudCeiling = loadStoredBaudCeiling();
+  baudNegotiated = false;
+  receiverAnswered = false;
   receiverTypeValue = loadStoredReceiverType();
   currentProfile = loadStoredUbxProfile();
   currentSettingsProfile = loadStoredUbxSettingsProfile();
+  measRateHz = loadStoredMeasurementRate();
   loadStoredCustomCommands();
+  ubxProfileStore().begin();
   prevFix = 255;
   prevHdop10 = -1;
   prevStrong = prevMedium = prevWeak = 255;
+  prevRfFlags = 255;
 
   pinMode(GPS_EN, OUTPUT);
   digitalWrite(GPS_EN, HIGH);
 
   initTempSensorOnce();
+  navExtrapolator.setOutageWindow(NAV_OUTAGE_BRIDGE_S * 1000UL);
+  signalParser.setFrameHandler(handleMonitorFrame);
+  rxTaskId = taskScheduler().addPeriodic(
+      "gps-rx", [](uint32_t) { gpsController().serviceReceiver(); },
+      kGpsRxPollIntervalMs, TaskPriority::High);
+  publishTaskId = taskScheduler().addPeriodic(
+      "gps-pub",
+      [](uint32_t now) { gpsController().processNavigationUpdate(now); },
+      OUTPUT_INTERVAL_MS, TaskPriority::High);
+#if NAV_OUTPUT_RATE_HZ > 0
+  outputTaskId = taskScheduler().addPeriodic(
+      "nav-out", [](uint32_t) { gpsController().publishExtrapolatedNav(); },
+      kNavOutputPeriodMs, TaskPriority::High);
+#endif
+#if RF_MONITOR_PERIOD_S > 0
+  taskScheduler().addPeriodic(
+      "rf-poll", [](uint32_t) { gpsController().pollRfMonitor(); },
+      RF_MONITOR_PERIOD_S * 1000UL, TaskPriority::Low);
+#endif
+  applyOutputRate();
   applyUbxProfile(currentProfile);
 }
 
-void GpsController::loop() {
+void GpsController::serviceReceiver() {
   bool passthrough = isSerialPassthroughMode();
   if (passthrough != state.passthroughActive) {
     state.passthroughActive = passthrough;
     if (state.passthroughActive) {
       configureGpsSerial(false, true);
       setStatus(STATUS_READY);
+      taskScheduler().setPeriod(rxTaskId, kPassthroughPollIntervalMs);
     } else {
       configureGpsSerial(true, true);
       resetNavigationState();
+      taskScheduler().setPeriod(rxTaskId, kGpsRxPollIntervalMs);
     }
   }
 
   if (state.passthroughActive) {
     processPassthroughIO();
-    delay(1);
     return;
   }
 
-  processNavigationUpdate();
-  delay(1);
+  if (gpsSerial.available() > 0) {
+    powerManager().noteGnssActivity();
+  }
+  int64_t rxUs = esp_timer_get_time();
+  // read() returns with a whole NMEA packet, so the rows need not outlive
+  // the call.
+  uint8_t rows[kParserSatelliteRows][7] = {};
+  uint32_t nowS = millis() / 1000;
+  signalParser.setTime(nowS);
+  bool parsed = gpsParser.read(rows);
+  signalParser.table().expire(nowS, kSatelliteMaxAgeS);
+  if (parsed) {
+    state.navDataFresh = true;
+    navRxUs = rxUs;
+    updateSatelliteTable(rows, kParserSatelliteRows);
+    taskScheduler().trigger(publishTaskId);
+  }
+  if (gpsParser.errTim == 0 && gpsParser.errDat == 0) {
+    gnssTimebase().onUtcSecond(gpsParser.Unix, rxUs);
+  }
 }
 
 bool GpsController::setBaud(uint32_t baud) {
@@ -587,12 +1029,51 @@ bool GpsController::setBaud(uint32_t baud) {
   if (baud == gpsSerialBaudValue)
     return false;
 
-  gpsSerialBaudValue = baud;
-  configureGpsSerial(parserEnabled, true);
+  // A fixed rate that does not fit the new baud even at 1 Hz would lose
+  // sentences every epoch; one that fits at a lower rate is lowered below.
+  uint8_t fitRate = maxMeasurementRateAt(baud);
+  if (measRateHz > 0 && fitRate == 0) {
+    logPrintf("[gps] %lu baud cannot carry the NMEA output, kept %lu\n",
+              static_cast<unsigned long>(baud),
+              static_cast<unsigned long>(gpsSerialBaudValue));
+    return false;
+  }
+
+  if (receiverTypeValue == GnssReceiverType::Ublox &&
+      !state.passthroughActive) {
+    CpuBoostGuard boost;
+    uint32_t previous = gpsSerialBaudValue;
+    configureGpsSerial(false, true);
+    bool switched = switchReceiverBaud(baud);
+    // A receiver that answers at the old rate refused the change. One that
+    // does not answer at all was never in sync, so only the host moves.
+    bool refused = !switched && probeUbxLink();
+    gpsSerialBaudValue = refused ? previous : baud;
+    configureGpsSerial(true, true);
+    resetNavigationState();
+    if (refused) {
+      return false;
+    }
+  } else {
+    gpsSerialBaudValue = baud;
+    configureGpsSerial(parserEnabled, true);
+  }
   logPrintf("[gps] Serial baud updated to %lu\n",
             static_cast<unsigned long>(gpsSerialBaudValue));
   updateGpsBaudCharacteristic(gpsSerialBaudValue);
   persistGpsBaud(gpsSerialBaudValue);
+  // A rate chosen by hand caps autobaud from now on.
+  baudCeiling = gpsSerialBaudValue;
+  persistBaudCeiling(baudCeiling);
+  if (measRateHz > fitRate) {
+    logPrintf("[gps] %u Hz output does not fit %lu baud, lowering to %u Hz\n",
+              static_cast<unsigned>(measRateHz),
+              static_cast<unsigned long>(gpsSerialBaudValue),
+              static_cast<unsigned>(fitRate));
+    if (!setMeasurementRate(fitRate)) {
+      logPrintln("[gps] Measurement rate not lowered");
+    }
+  }
   return true;
 }
 
@@ -618,6 +1099,7 @@ bool GpsController::applyUbxProfile(UbxConfigProfile profile) {
     logPrintln("[gps] Cannot apply UBX profile while in passthrough mode");
     return false;
   }
+  CpuBoostGuard boost;
   configureGpsSerial(false, true);
   bool success = runUbxStartupSequence();
   if (!state.passthroughActive) {
@@ -665,6 +1147,88 @@ bool GpsController::setUbxSettingsProfile(UbxSettingsProfile profile) {
   return success;
 }
 
+bool GpsController::applyNamedProfileChange() {
+  rollbackArmed = true;
+  rolledBack = false;
+  applyUbxProfile(currentProfile);
+  rollbackArmed = false;
+  return !rolledBack;
+}
+
+bool GpsController::selectNamedProfile(const char *name, std::string &error) {
+  UbxProfileStore &store = ubxProfileStore();
+  if (name[0] != '\0' && !store.find(name)) {
+    error = "no such profile";
+    return false;
+  }
+  if (state.passthroughActive) {
+    error = "passthrough mode";
+    return false;
+  }
+  char previous[kUbxProfileNameMax + 1];
+  strncpy(previous, store.activeName(), sizeof(previous));
+  store.setActive(name);
+  if (!applyNamedProfileChange()) {
+    store.setActive(previous);
+    error = "verification failed, rolled back";
+    return false;
+  }
+  store.persistActive();
+  logPrintf("[gps] UBX named profile -> %s\n", name[0] ? name : "none");
+  return true;
+}
+
+bool GpsController::storeNamedProfile(const UbxNamedProfile &profile,
+                                      std::string &error) {
+  UbxProfileStore &store = ubxProfileStore();
+  const UbxNamedProfile *existing = store.find(profile.name);
+  if (!existing && store.size() >= UbxProfileStore::kCapacity) {
+    error = "no free slot";
+    return false;
+  }
+  if (!existing || strcmp(store.activeName(), profile.name) != 0) {
+    store.save(profile);
+    logPrintf("[gps] UBX profile %s saved (%u keys)\n", profile.name,
+              static_cast<unsigned>(profile.itemCount));
+    return true;
+  }
+  if (state.passthroughActive) {
+    error = "passthrough mode";
+    return false;
+  }
+  // Staged in RAM only, so a failed change leaves NVS untouched. The copy
+  // is static to keep a whole profile off the caller's stack.
+  static UbxNamedProfile previous;
+  previous = *existing;
+  store.stage(profile);
+  if (!applyNamedProfileChange()) {
+    store.stage(previous);
+    error = "verification failed, rolled back";
+    return false;
+  }
+  store.persist(profile.name);
+  logPrintf("[gps] Active UBX profile %s updated (%u keys)\n", profile.name,
+            static_cast<unsigned>(profile.itemCount));
+  return true;
+}
+
+bool GpsController::deleteNamedProfile(const char *name, std::string &error) {
+  UbxProfileStore &store = ubxProfileStore();
+  if (!store.find(name)) {
+    error = "no such profile";
+    return false;
+  }
+  if (strcmp(store.activeName(), name) == 0) {
+    // Deleting the active profile deselects it first, which must stick.
+    if (!selectNamedProfile("", error)) {
+      return false;
+    }
+  }
+  store.remove(name);
+  logPrintf("[gps] UBX profile %s deleted\n", name);
+  return true;
+}
+
 bool GpsController::setReceiverType(GnssReceiverType type) {
   if (type != GnssReceiverType::Ublox &&
       type != GnssReceiverType::GenericNmea) {
@@ -723,8 +1287,12 @@ void GpsController::configureGpsSerial(bool enableParser, bool forceReinit) {
   delay(10);
 
   gpsSerial.begin(gpsSerialBaudValue, SERIAL_8N1, GPS_RX, GPS_TX);
+  // RX bursts pull the receiver job forward instead of waiting for its poll.
+  gpsSerial.onReceive(
+      []() { taskScheduler().trigger(gpsController().rxTaskId); });
 
   gpsParser = iarduino_GPS_NMEA();
+  gpsSerial.tapEnabled = enableParser;
   if (enableParser) {
     gpsParser.begin(gpsSerial, true);
     gpsParser.timeOut(1500);
@@ -733,7 +1301,112 @@ void GpsController::configureGpsSerial(bool enableParser, bool forceReinit) {
   parserEnabled = enableParser;
 }
 
+bool GpsController::collectUbxConfig(const UbxCommandSequence &sequence,
+                                     const char *label) {
+  bool allOk = true;
+  for (size_t i = 0; i < sequence.length; ++i) {
+    const UbxBinaryCommand &command = sequence.commands[i];
+    if (desiredConfig.addValsetFrame(command.data, command.size)) {
+      continue;
+    }
+    // Anything but a well-formed VALSET (legacy CFG-MSG, CFG-CFG, ...)
+    // cannot be diffed and goes out as it is.
+    if (!command.data || command.size < 8 ||
+        !sendUbxCommandExpectAck(command)) {
+      logPrintf("[gps] UBX %s: command %u failed\n", label,
+                static_cast<unsigned>(i));
+      allOk = false;
+    }
+    delay(kUbxInterCommandDelayMs);
+  }
+  return allOk;
+}
+
+void GpsController::addRuntimeConfig() {
+  if (measRateHz > 0) {
+    desiredConfig.set(kUbxKeyRateMeas, 1000u / measRateHz, kUbxLayerRam);
+    desiredConfig.set(kUbxKeyRateNav, 1, kUbxLayerRam);
+  }
+  // Opt-in: NAV-SIG is ~8 + 16 bytes a signal every epoch, which a dual
+  // band receiver at 9600 baud cannot afford. A NAK is not fatal, per
+  // signal data then comes from GSV alone.
+  if (GNSS_NAV_SIG_RATE > 0) {
+    desiredConfig.set(kUbxKeyMsgoutNavSigUart1, GNSS_NAV_SIG_RATE,
+                      kUbxLayerRam);
+  }
+}
+
+bool GpsController::addNamedProfileConfig() {
+  pendingProfileKeyCount = 0;
+  const UbxNamedProfile *profile = ubxProfileStore().active();
+  if (!profile) {
+    return true;
+  }
+  bool ok = true;
+  for (size_t i = 0; i < profile->itemCount; ++i) {
+    const UbxKeyValue &item = profile->items[i];
+    ok = desiredConfig.set(item.key, item.value, profile->layers) && ok;
+    if (profile->layers & kUbxLayerRam) {
+      pendingProfileKeys[pendingProfileKeyCount++] = item.key;
+    }
+  }
+  if (!ok) {
+    logPrintf("[gps] UBX profile %s does not fit, %u keys at most\n",
+              profile->name, static_cast<unsigned>(UbxConfigSet::kCapacity));
+  }
+  return ok;
+}
+
+void GpsController::addDroppedProfileDefaults() {
+  UbxConfigSet &dropped = configChanges;
+  dropped.clear();
+  for (size_t i = 0; i < appliedProfileKeyCount; ++i) {
+    if (!desiredConfig.find(appliedProfileKeys[i], kUbxLayerRam)) {
+      dropped.set(appliedProfileKeys[i], 0, kUbxLayerRam);
+    }
+  }
+  if (dropped.size() == 0) {
+    return;
+  }
+  readUbxConfig(dropped, kUbxLayerRam, receiverConfig, true);
+  for (size_t i = 0; i < receiverConfig.size(); ++i) {
+    desiredConfig.set(receiverConfig[i].key, receiverConfig[i].value,
+                      kUbxLayerRam);
+  }
+}
+
+bool GpsController::applyUbxConfigDiff() {
+  configChanges.clear();
+  undoConfig.clear();
+  for (uint8_t layer = kUbxLayerRam; layer <= kUbxLayerFlash; layer <<= 1) {
+    // A failed read leaves keys out, which only makes them count as
+    // changed: the worst case is the old full write.
+    readUbxConfig(desiredConfig, layer, receiverConfig);
+    desiredConfig.diffLayer(receiverConfig, layer, configChanges);
+    // A key the layer did not hold cannot be put back without CFG-VALDEL
+    // and keeps the new value on undo.
+    for (size_t i = 0; i < configChanges.size(); ++i) {
+      const UbxConfigItem &change = configChanges[i];
+      const UbxConfigItem *old =
+          (change.layers & layer) ? receiverConfig.find(change.key, layer)
+                                  : nullptr;
+      if (old) {
+        undoConfig.set(change.key, old->value, layer);
+      }
+    }
+  }
+  bool ok = writeUbxConfig(configChanges);
+  state.ubxKeysTotal = static_cast<uint8_t>(desiredConfig.size());
+  state.ubxKeysChanged = static_cast<uint8_t>(configChanges.size());
+  logPrintf("[gps] UBX config: %u of %u key(s) changed%s\n",
+            static_cast<unsigned>(configChanges.size()),
+            static_cast<unsigned>(desiredConfig.size()),
+            ok ? "" : ", some rejected");
+  return ok;
+}
+
 bool GpsController::runUbxStartupSequence() {
+  uint32_t startMs = millis();
   const char *profileLabel = ubxProfileName(currentProfile);
   const char *settingsLabel = ubxSettingsProfileName(currentSettingsProfile);
   UbxConfigProfile verifyProfile = currentProfile;
@@ -749,38 +1422,60 @@ bool GpsController::runUbxStartupSequence() {
     delay(kUbxStartupDelayMs);
   }
   drainGpsSerialInput();
+  // Autobaud runs once after boot; later only a receiver that answered
+  // before is looked for again, so an absent one does not stall every
+  // reconfiguration with the full scan.
+  if (!baudNegotiated || receiverAnswered) {
+    negotiateBaud();
+  }
 
   bool disableOk = runUbxSequence(kUbxDisableNmeaSequence, "disable NMEA");
   bool linkOk = probeUbxLink();
+  receiverAnswered = linkOk;
   if (currentSettingsProfile == UbxSettingsProfile::CustomRam &&
       !customSettingsLoaded) {
     logPrintln("[gps] Custom UBX settings selected, but no command is stored "
                "(fallback)");
   }
-  bool settingsOk = runUbxSequence(ubxSettingsSequence(currentSettingsProfile),
-                                   settingsLabel);
+  desiredConfig.clear();
+  bool settingsOk = collectUbxConfig(
+      ubxSettingsSequence(currentSettingsProfile), settingsLabel);
   if (currentProfile == UbxConfigProfile::Custom && !customProfileLoaded) {
     logPrintln("[gps] Custom UBX profile selected, but no command is stored "
                "(fallback)");
     verifyProfile = kDefaultUbxProfile;
   }
   bool profileOk =
-      runUbxSequence(ubxProfileSequence(currentProfile), profileLabel);
+      collectUbxConfig(ubxProfileSequence(currentProfile), profileLabel);
+  bool namedOk = addNamedProfileConfig();
+  addRuntimeConfig();
+  addDroppedProfileDefaults();
+  bool applyOk = applyUbxConfigDiff();
   bool verifyOk = verifyUbxProfile(verifyProfile);
+  if (rollbackArmed && !(namedOk && applyOk && verifyOk)) {
+    logPrintf("[gps] UBX profile change failed, restoring %u key(s)\n",
+              static_cast<unsigned>(undoConfig.size()));
+    writeUbxConfig(undoConfig);
+    rolledBack = true;
+  } else {
+    memcpy(appliedProfileKeys, pendingProfileKeys,
+           pendingProfileKeyCount * sizeof(pendingProfileKeys[0]));
+    appliedProfileKeyCount = pendingProfileKeyCount;
+  }
   bool enableOk = runUbxSequence(kUbxEnableNmeaSequence, "enable NMEA");
 
   drainGpsSerialInput();
 
   state.ubxLinkOk = linkOk && verifyOk;
-  state.ubxConfigured = state.ubxLinkOk && settingsOk && profileOk;
-
-  bool success =
-      disableOk && linkOk && settingsOk && profileOk && verifyOk && enableOk;
-  if (success) {
-    logPrintln("[gps] UBX startup sequence completed");
-  } else {
-    logPrintln("[gps] UBX startup sequence failed");
-  }
+  state.ubxConfigured =
+      state.ubxLinkOk && settingsOk && profileOk && namedOk && applyOk;
+  state.ubxConfigMs = millis() - startMs;
+
+  bool success = disableOk && linkOk && settingsOk && profileOk && namedOk &&
+                 applyOk && verifyOk && enableOk;
+  logPrintf("[gps] UBX startup sequence %s in %lu ms\n",
+            success ? "completed" : "failed",
+            static_cast<unsigned long>(state.ubxConfigMs));
   return success;
 }
 
@@ -805,6 +1500,157 @@ void GpsController::persistGpsBaud(uint32_t baud) {
   }
 }
 
+// 0 when no rate was set by hand and GPS_AUTOBAUD_TARGET applies.
+uint32_t GpsController::loadStoredBaudCeiling() {
+  Preferences prefs;
+  uint32_t stored = 0;
+  if (prefs.begin(kGpsPrefsNamespace, true)) {
+    stored = prefs.getUInt(kGpsBaudCeilingKey, 0);
+    prefs.end();
+  }
+  if (stored < GPS_BAUD_MIN || stored > GPS_BAUD_MAX) {
+    stored = 0;
+  }
+  return stored;
+}
+
+void GpsController::persistBaudCeiling(uint32_t baud) {
+  Preferences prefs;
+  if (prefs.begin(kGpsPrefsNamespace, false)) {
+    prefs.putUInt(kGpsBaudCeilingKey, baud);
+    prefs.end();
+  }
+}
+
+void GpsController::setHostBaud(uint32_t baud) {
+  gpsSerialBaudValue = baud;
+  configureGpsSerial(false, true);
+}
+
+bool GpsController::detectReceiverBaud() {
+  uint32_t original = gpsSerialBaudValue;
+  // The current rate goes first; a MON-VER poll on each rate covers a
+  // receiver whose NMEA output is switched off.
+  for (size_t i = 0; i <= sizeof(kAutobaudProbeRates) / sizeof(uint32_t);
+       ++i) {
+    uint32_t baud = i == 0 ? original : kAutobaudProbeRates[i - 1];
+    if (i > 0 && baud == original) {
+      continue;
+    }
+    if (baud != gpsSerialBaudValue) {
+      setHostBaud(baud);
+    }
+    sendUbxCommand(kUbxPingCommand);
+    if (listenForGpsSync(kAutobaudListenMs)) {
+      if (baud != original) {
+        logPrintf("[gps] Receiver found at %lu baud\n",
+                  static_cast<unsigned long>(baud));
+      }
+      return true;
+    }
+  }
+  setHostBaud(original);
+  return false;
+}
+
+bool GpsController::switchReceiverBaud(uint32_t baud) {
+  uint32_t previous = gpsSerialBaudValue;
+  // The ACK goes out at the old rate or gets cut by the switch, so the ping
+  // at the new rate is the real check.
+  if (!sendUartBaudrate(baud)) {
+    return false;
+  }
+  delay(kBaudSwitchSettleMs);
+  setHostBaud(baud);
+  for (uint8_t attempt = 0; attempt < kBaudVerifyAttempts; ++attempt) {
+    drainGpsSerialInput();
+    if (probeUbxLink()) {
+      logPrintf("[gps] Receiver switched to %lu baud\n",
+                static_cast<unsigned long>(baud));
+      return true;
+    }
+  }
+  logPrintf("[gps] No answer at %lu baud, back to %lu\n",
+            static_cast<unsigned long>(baud),
+            static_cast<unsigned long>(previous));
+  // In case the receiver did switch but garbles at this rate.
+  sendUartBaudrate(previous);
+  delay(kBaudSwitchSettleMs);
+  setHostBaud(previous);
+  drainGpsSerialInput();
+  return false;
+}
+
+bool GpsController::negotiateBaud() {
+#if GPS_AUTOBAUD_TARGET > 0
+  uint32_t startMs = millis();
+  uint32_t initial = gpsSerialBaudValue;
+  bool afterBoot = !baudNegotiated;
+  baudNegotiated = true;
+  // A receiver that answers where it was left needs neither the scan nor,
+  // past the first run, another climb.
+  if (probeUbxLink()) {
+    if (!afterBoot) {
+      return true;
+    }
+  } else if (!detectReceiverBaud()) {
+    logPrintln("[gps] Autobaud: no NMEA or UBX at any rate");
+    return false;
+  }
+  uint32_t ceiling = baudCeiling > 0 ? baudCeiling : GPS_AUTOBAUD_TARGET;
+  if (gpsSerialBaudValue > ceiling && !switchReceiverBaud(ceiling)) {
+    logPrintf("[gps] Autobaud: receiver kept %lu baud\n",
+              static_cast<unsigned long>(gpsSerialBaudValue));
+  }
+  // The ceiling itself first, as a rate set by hand need not be a target.
+  constexpr size_t kTargetCount =
+      sizeof(kAutobaudTargets) / sizeof(kAutobaudTargets[0]);
+  for (size_t i = 0; i <= kTargetCount; ++i) {
+    uint32_t target = i == 0 ? ceiling : kAutobaudTargets[i - 1];
+    if ((i > 0 && target == ceiling) || target > ceiling ||
+        target > GPS_BAUD_MAX || target <= gpsSerialBaudValue) {
+      continue;
+    }
+    if (switchReceiverBaud(target)) {
+      break;
+    }
+    if (!detectReceiverBaud()) {
+      logPrintln("[gps] Autobaud: receiver lost after a failed switch");
+      return false;
+    }
+  }
+  if (gpsSerialBaudValue != initial) {
+    persistGpsBaud(gpsSerialBaudValue);
+    updateGpsBaudCharacteristic(gpsSerialBaudValue);
+  }
+  logPrintf("[gps] Autobaud: %lu baud in %lu ms\n",
+            static_cast<unsigned long>(gpsSerialBaudValue),
+            static_cast<unsigned long>(millis() - startMs));
+#endif
+  return true;
+}
+
+uint8_t GpsController::loadStoredMeasurementRate() {
+  Preferences prefs;
+  uint8_t stored = GNSS_MEAS_RATE_HZ;
+  if (prefs.begin(kGpsPrefsNamespace, true)) {
+    stored = prefs.getUChar(kGpsMeasRateKey, stored);
+    prefs.end();
+  }
+  if (stored > GNSS_MEAS_RATE_MAX_HZ) {
+    stored = GNSS_MEAS_RATE_HZ;
+  }
+  return stored;
+}
+
+void GpsController::persistMeasurementRate(uint8_t rateHz) {
+  Preferences prefs;
+  if (prefs.begin(kGpsPrefsNamespace, false)) {
+    prefs.putUChar(kGpsMeasRateKey, rateHz);
+    prefs.end();
+  }
+}
+
 GnssReceiverType GpsController::loadStoredReceiverType() {
   Preferences prefs;
   uint8_t stored = static_cast<uint8_t>(kDefaultReceiverType);
@@ -900,19 +1746,142 @@ void GpsController::loadStoredCustomCommands() {
   prefs.end();
 }
 
+void GpsController::updateSatelliteTable(const uint8_t (*rows)[7],
+                                         size_t rowCount) {
+  uint32_t nowS = millis() / 1000;
+  for (size_t i = 0; i < rowCount; ++i) {
+    if (rows[i][0] == 0) {
+      continue;
+    }
+    SatelliteRecord record;
+    record.svId = rows[i][0];
+    record.cno = rows[i][1];
+    record.gnssId = rows[i][2];
+    record.used = rows[i][3] != 0;
+    record.elevation = rows[i][4];
+    record.azimuth = static_cast<uint16_t>(rows[i][5] + rows[i][6]);
+    state.satellites.update(record, nowS);
+  }
+  state.satellites.expire(nowS, kSatelliteMaxAgeS);
+}
+
 void GpsController::resetNavigationState() {
-  state.navUpdateCounter = 0;
+  state.lastStatusMs = 0;
   state.firstFixCaptured = false;
   state.ttffSeconds = -1;
   state.signalLevels = {};
-  state.activeSignalCount = 0;
-  state.satDebugCount = 0;
+  state.satellites.clear();
   state.visibleSatellites = 0;
   state.activeSatellites = 0;
-  state.lastBleUpdate = millis();
+  taskScheduler().postpone(publishTaskId, OUTPUT_INTERVAL_MS);
   prevFix = 255;
   prevHdop10 = -1;
   prevStrong = prevMedium = prevWeak = 255;
+  prevRfFlags = 255;
+  navFilter.reset();
+  stationaryDetector.reset(millis());
+}
+
+void GpsController::applyNavFilter(NavDataSample &sample, int64_t nowUs) {
+  uint32_t startUs = micros();
+  if (navFilter.initialized()) {
+    int64_t gapUs = nowUs - navFilterUpdatedUs;
+    if (gapUs > kNavFilterMaxGapUs) {
+      navFilter.reset();
+    } else {
+      navFilter.predict(static_cast<float>(gapUs) * 1e-6f);
+    }
+  }
+  navFilterUpdatedUs = nowUs;
+
+  if (state.navDataFresh || !navFilter.initialized()) {
+    NavMeasurement measurement;
+    measurement.latitude = sample.latitude;
+    measurement.longitude = sample.longitude;
+    measurement.altitude = sample.altitude;
+    measurement.speed = sample.speed;
+    measurement.heading = sample.heading;
+    measurement.horizontalAccuracy = sample.horizontalAccuracy;
+    measurement.hasVelocity = gpsParser.errSpd == 0 && gpsParser.errCrs == 0;
+    navFilter.update(measurement);
+  }
+
+  NavEstimate estimate = navFilter.estimate();
+  if (estimate.valid) {
+    sample.latitude = estimate.latitude;
+    sample.longitude = estimate.longitude;
+    sample.altitude = estimate.altitude;
+    sample.speed = estimate.speed;
+    sample.heading = estimate.heading;
+    sample.horizontalAccuracy = estimate.horizontalAccuracy;
+    sample.verticalAccuracy = estimate.verticalAccuracy;
+    sample.speedAccuracy = estimate.speedAccuracy;
+    sample.headingAccuracy = estimate.headingAccuracy;
+    sample.filtered = true;
+  }
+
+  uint32_t elapsedUs = micros() - startUs;
+  navFilterStatsValue.runs++;
+  navFilterTotalUs += elapsedUs;
+  if (elapsedUs > navFilterStatsValue.maxUs) {
+    navFilterStatsValue.maxUs = elapsedUs;
+  }
+}
+
+void GpsController::publishNav(const NavDataSample &sample) {
+  for (size_t i = 0; i < navPublisherCount; ++i) {
+    if (navPublishers[i]) {
+      navPublishers[i]->publishNavData(sample);
+    }
+  }
+}
+
+void GpsController::publishExtrapolatedNav() {
+  if (state.passthroughActive || navPublisherCount == 0) {
+    return;
+  }
+  bool fixLost = gpsParser.errPos != 0;
+  // A frozen position needs no prediction between epochs.
+  if (stationaryDetector.holding() && !fixLost) {
+    return;
+  }
+  int64_t nowUs = esp_timer_get_time();
+  // A measured fix just went out; do not shadow it with a prediction.
+  if (nowUs - measuredPublishedUs < kNavOutputPeriodUs / 2) {
+    return;
+  }
+  NavDataSample sample;
+  if (!navExtrapolator.extrapolate(nowUs, sample, fixLost)) {
+    return;
+  }
+  UtcTimestamp utcNow = gnssTimebase().utcAt(nowUs);
+  if (utcNow.valid) {
+    sample.utcEpochUs = utcNow.unixUs;
+  }
+  sample.ppsAgeUs = gnssTimebase().ppsAgeUs(nowUs);
+  sample.ppsLocked = utcNow.ppsLocked;
+  publishNav(sample);
+}
+
+ExtrapolationStats GpsController::extrapolationStats() const {
+  return navExtrapolator.stats();
+}
+
+StationaryStats GpsController::stationaryStats() const {
+  return stationaryDetector.stats(millis());
+}
+
+NavFilterStats GpsController::navFilterStats() const {
+  NavFilterStats stats = navFilterStatsValue;
+#if NAV_FILTER_ENABLED
+  stats.enabled = true;
+#endif
+  if (stats.runs > 0) {
+    stats.avgUs = static_cast<uint32_t>(navFilterTotalUs / stats.runs);
+  }
+  stats.resets = navFilter.resetCount();
+  stats.rejected = navFilter.rejectedCount();
+  return stats;
 }
 
 void GpsController::processPassthroughIO() {
@@ -930,17 +1899,17 @@ void GpsController::processPassthroughIO() {
   }
 }
 
-void GpsController::processNavigationUpdate() {
-  gpsParser.read(state.satelliteInfo);
-
-  unsigned long now = millis();
-  if (now - state.lastBleUpdate <= OUTPUT_INTERVAL_MS) {
+void GpsController::processNavigationUpdate(uint32_t now) {
+  if (state.passthroughActive) {
     return;
   }
-  state.lastBleUpdate = now;
 
   uint8_t fix = (gpsParser.errPos == 0) ? 1 : 0;
   uint8_t activeSatellites = gpsParser.satellites[GPS_ACTIVE];
+  if (state.navDataFresh) {
+    rfMonitor.onSatellites(state.satellites, now);
+  }
+  uint8_t rfFlags = rfMonitor.flags();
 
   uint8_t systemStatus = determineSystemStatus(fix, activeSatellites);
   if (systemStatus != getStatusIndicatorState()) {
@@ -953,8 +1922,9 @@ void GpsController::processNavigationUpdate() {
       state.ttffSeconds =
           static_cast<int32_t>((now - state.bootMillis) / 1000UL);
     }
-    float latDecimal = gpsParser.latitude;
-    float lonDecimal = gpsParser.longitude;
+    double latDecimal = gpsParser.latitude;
+    double lonDecimal = gpsParser.longitude;
+    refinePosition(latDecimal, lonDecimal);
 
     float heading = gpsParser.course;
     if (heading < 0.0f) {
@@ -962,74 +1932,83 @@ void GpsController::processNavigationUpdate() {
     }
     float speedMs = static_cast<float>(gpsParser.speed) * (1000.0f / 3600.0f);
 
-    if (navPublisherCount > 0) {
-      NavDataSample navSample;
-      navSample.latitude = latDecimal;
-      navSample.longitude = lonDecimal;
-      navSample.heading = heading;
-      navSample.speed = speedMs;
-      navSample.altitude = gpsParser.altitude;
-      for (size_t i = 0; i < navPublisherCount; ++i) {
-        if (navPublishers[i]) {
-          navPublishers[i]->publishNavData(navSample);
-        }
-      }
+    NavDataSample navSample;
+    navSample.latitude = latDecimal;
+    navSample.longitude = lonDecimal;
+    navSample.heading = heading;
+    navSample.speed = speedMs;
+    navSample.altitude = gpsParser.altitude;
+    navSample.horizontalAccuracy = horizontalAccuracyFromHdop(gpsParser.HDOP);
+    int64_t nowUs = esp_timer_get_time();
+    UtcTimestamp utcNow = gnssTimebase().utcAt(nowUs);
+    if (gpsParser.errTim == 0 && gpsParser.errDat == 0) {
+      navSample.utcEpochUs = static_cast<int64_t>(gpsParser.Unix) * 1000000LL;
+    } else if (utcNow.valid) {
+      navSample.utcEpochUs = utcNow.unixUs;
+    }
+    navSample.ppsAgeUs = gnssTimebase().ppsAgeUs(nowUs);
+    navSample.ppsLocked = utcNow.ppsLocked;
+#if NAV_FILTER_ENABLED
+    applyNavFilter(navSample, nowUs);
+#endif
+    bool fresh = state.navDataFresh;
+    state.navDataFresh = false;
+#if STATIONARY_WINDOW_S > 0
+    if (fresh) {
+      stationaryDetector.update(navSample, now);
+    }
+#endif
+
+#if NAV_OUTPUT_RATE_HZ > 0
+    // Between epochs the nav-out job extrapolates; only new fixes go out here.
+    if (fresh) {
+      int64_t ppsUs =
+          navSample.ppsAgeUs != kNoPpsAge ? nowUs - navSample.ppsAgeUs : 0;
+      navExtrapolator.onMeasurement(navSample, navRxUs, ppsUs);
+      navSample.sequence = fixHistory().append(navSample, now);
+      publishNav(navSample);
+      measuredPublishedUs = nowUs;
+      powerManager().noteFixDelivered();
     }
-    state.navUpdateCounter++;
+#else
+    if (fresh) {
+      int64_t ppsUs =
+          navSample.ppsAgeUs != kNoPpsAge ? nowUs - navSample.ppsAgeUs : 0;
+      navExtrapolator.onMeasurement(navSample, navRxUs, ppsUs);
+    }
+    // Repeats of the same epoch keep its sequence; while the position is
+    // frozen they are not worth sending at all.
+    if (fresh || !stationaryDetector.holding()) {
+      navSample.sequence = fresh ? fixHistory().append(navSample, now)
+                                 : fixHistory().latestSequence();
+      publishNav(navSample);
+      powerManager().noteFixDelivered();
+    }
+#endif
+  } else {
+    if (navFilter.initialized()) {
+      navFilter.reset();
+    }
+    stationaryDetector.reset(now);
+#if NAV_OUTPUT_RATE_HZ == 0
+    // Without the nav-out job the outage bridge is published from here.
+    publishExtrapolatedNav();
+#endif
   }
 
-  uint8_t strong = 0, medium = 0, weak = 0;
-  state.activeSignalCount = 0;
-  state.satDebugCount = 0;
   state.visibleSatellites = gpsParser.satellites[GPS_VISIBLE];
   state.activeSatellites = activeSatellites;
 
-  for (size_t i = 0; i < kMaxTrackedSatellites; i++) {
-    uint8_t id = state.satelliteInfo[i][0];
-    uint8_t snr = state.satelliteInfo[i][1];
-    uint8_t constellation = state.satelliteInfo[i][2];
-    uint8_t active = state.satelliteInfo[i][3];
-    uint8_t elevation = state.satelliteInfo[i][4];
-    uint16_t azLow = static_cast<uint16_t>(state.satelliteInfo[i][5]);
-    uint16_t azHigh = static_cast<uint16_t>(state.satelliteInfo[i][6]);
-    uint16_t azimuth = azLow;
-    if (azHigh != 0) {
-      azimuth = static_cast<uint16_t>(azLow + azHigh);
-    }
-    if (azimuth > 360) {
-      azimuth = 360;
-    }
-
-    if (id && state.satDebugCount < kMaxTrackedSatellites) {
-      SatelliteDebugEntry entry;
-      entry.id = id;
-      entry.snr = snr;
-      entry.constellation = constellation;
-      entry.active = active;
-      entry.elevation = elevation;
-      entry.azimuth = azimuth;
-      state.satDebug[state.satDebugCount++] = entry;
-    }
-
-    if (!id || !active)
-      continue;
-
-    if (state.activeSignalCount < kMaxTrackedSatellites) {
-      state.activeSignalDb[state.activeSignalCount++] = snr;
-    }
-    if (snr > 30)
-      strong++;
-    else if (snr >= 20)
-      medium++;
-    else
-      weak++;
-  }
-
+  SignalLevelCounts levels = state.satellites.signalLevels();
+  uint8_t strong = levels.strong;
+  uint8_t medium = levels.medium;
+  uint8_t weak = levels.weak;
   state.signalLevels.weak = weak;
   state.signalLevels.medium = medium;
   state.signalLevels.strong = strong;
 
-  char signalsJson[64];
+  // One "n," per used satellite.
+  char signalsJson[2 * kSatelliteTableSize + 2];
   int pos = 0;
   signalsJson[pos++] = '[';
   bool first = true;
@@ -1054,11 +2033,12 @@ void GpsController::processNavigationUpdate() {
                   ? pos
                   : static_cast<int>(sizeof(signalsJson)) - 1] = '\0';
 
-  if (state.navUpdateCounter >= 5) {
+  if (now - state.lastStatusMs >= kStatusIntervalMs) {
+    state.lastStatusMs = now;
     int hdop10 = static_cast<int>(gpsParser.HDOP * 10.0f + 0.5f);
     bool changed = (prevFix != fix) || (prevHdop10 != hdop10) ||
                    (prevStrong != strong) || (prevMedium != medium) ||
-                   (prevWeak != weak);
+                   (prevWeak != weak) || (prevRfFlags != rfFlags);
     if (changed) {
       if (statusPublisherCount > 0) {
         SystemStatusSample statusSample;
@@ -1067,6 +2047,7 @@ void GpsController::processNavigationUpdate() {
         statusSample.satellites = activeSatellites;
         statusSample.ttffSeconds = state.ttffSeconds;
         statusSample.signalsJson = String(signalsJson);
+        statusSample.rfFlags = rfFlags;
         for (size_t i = 0; i < statusPublisherCount; ++i) {
           if (statusPublishers[i]) {
             statusPublishers[i]->publishSystemStatus(statusSample);
@@ -1078,8 +2059,8 @@ void GpsController::processNavigationUpdate() {
       prevStrong = strong;
       prevMedium = medium;
       prevWeak = weak;
+      prevRfFlags = rfFlags;
     }
-    state.navUpdateCounter = 0;
   }
 }
 
@@ -1091,6 +2072,9 @@ uint8_t GpsController::determineSystemStatus(uint8_t fix,
   if (!state.ubxLinkOk) {
     return STATUS_NO_MODEM;
   }
+  if (rfMonitor.flags() != 0) {
+    return STATUS_INTERFERENCE;
+  }
   if (!fix || activeSatellites < 4) {
     return STATUS_NO_FIX;
   }
@@ -1114,55 +2098,157 @@ GpsDebugSnapshot GpsController::debugSnapshot() const {
     snapshot.tempC = state.lastTempC;
   }
 
-  size_t signalCount = state.activeSignalCount;
-  if (signalCount > kMaxTrackedSatellites) {
-    signalCount = kMaxTrackedSatellites;
+  snapshot.satellites = state.satellites;
+  const SignalTable &signals = signalParser.table();
+  signals.summarize(snapshot.bands);
+  snapshot.signalCount = static_cast<uint8_t>(signals.size());
+  snapshot.visibleCount = state.visibleSatellites;
+  snapshot.activeCount = state.activeSatellites;
+  return snapshot;
+}
+
+uint8_t GpsController::maxMeasurementRate() const {
+  return maxMeasurementRateAt(gpsSerialBaudValue);
+}
+
+uint8_t GpsController::maxMeasurementRateAt(uint32_t baud) const {
+  uint32_t budget = baud / 10 * kUartBudgetPercent / 100;
+  uint32_t epochBytes =
+      estimateEpochBytes(state.satellites, signalParser.table());
+  uint32_t rate = budget / epochBytes;
+  return static_cast<uint8_t>(rate > GNSS_MEAS_RATE_MAX_HZ
+                                  ? GNSS_MEAS_RATE_MAX_HZ
+                                  : rate);
+}
+
+bool GpsController::setMeasurementRate(uint8_t rateHz) {
+  if (rateHz > GNSS_MEAS_RATE_MAX_HZ) {
+    return false;
+  }
+  if (state.passthroughActive) {
+    logPrintln("[gps] Cannot change measurement rate in passthrough mode");
+    return false;
+  }
+  uint8_t maxRate = maxMeasurementRate();
+  if (rateHz > maxRate) {
+    logPrintf("[gps] %u Hz exceeds the UART budget at %lu baud (max %u Hz)\n",
+              static_cast<unsigned>(rateHz),
+              static_cast<unsigned long>(gpsSerialBaudValue),
+              static_cast<unsigned>(maxRate));
+    return false;
   }
-  for (size_t i = 0; i < signalCount; ++i) {
-    snapshot.signalDb[i] = state.activeSignalDb[i];
+  if (rateHz != measRateHz) {
+    logPrintf("[gps] Measurement rate -> %u Hz\n",
+              static_cast<unsigned>(rateHz));
+    measRateHz = rateHz;
+    persistMeasurementRate(rateHz);
   }
-  snapshot.signalCount = signalCount;
+  applyOutputRate();
+  // 0 restores the settings profile value, so the whole sequence reruns.
+  return applyUbxProfile(currentProfile);
+}
 
-  size_t satCount = state.satDebugCount;
-  if (satCount > kMaxTrackedSatellites) {
-    satCount = kMaxTrackedSatellites;
+void GpsController::applyOutputRate() {
+  uint32_t periodMs = OUTPUT_INTERVAL_MS;
+  if (measRateHz > 0 && 1000u / measRateHz < periodMs) {
+    periodMs = 1000u / measRateHz;
   }
-  for (size_t i = 0; i < satCount; ++i) {
-    snapshot.satellites[i] = state.satDebug[i];
+  taskScheduler().setPeriod(publishTaskId, periodMs);
+  updateBleNavRate(measRateHz);
+}
+
+const UbxConfigSet &GpsController::verifiedUbxConfig() const {
+  return verifiedConfig;
+}
+
+UbxConfigStats GpsController::ubxConfigStats() const {
+  UbxConfigStats stats;
+  stats.linkOk = state.ubxLinkOk;
+  stats.configured = state.ubxConfigured;
+  stats.configMs = state.ubxConfigMs;
+  stats.keysChanged = state.ubxKeysChanged;
+  stats.keysTotal = state.ubxKeysTotal;
+  stats.verifyMismatches = state.ubxVerifyMismatches;
+  stats.verifiedAgeMs = verifiedAtMs == 0 ? 0 : millis() - verifiedAtMs;
+  return stats;
+}
+
+RfMonitorStats GpsController::rfMonitorStats() const {
+  return rfMonitor.snapshot();
+}
+
+void GpsController::pollRfMonitor() {
+  // Fire and forget: answers are picked out of the NMEA stream, so nothing
+  // here waits on the receiver. Generic receivers only get C/N0 checks.
+  if (receiverTypeValue != GnssReceiverType::Ublox ||
+      state.passthroughActive || !parserEnabled) {
+    return;
   }
-  snapshot.satelliteCount = satCount;
-  snapshot.visibleCount = state.visibleSatellites;
-  snapshot.activeCount = state.activeSatellites;
-  return snapshot;
+  rfMonitor.onPoll();
+  sendUbxMessage(kUbxClassMon, kUbxIdMonRf, nullptr, 0);
+  if (rfMonitor.wantsSecSig()) {
+    sendUbxMessage(kUbxClassSec, kUbxIdSecSig, nullptr, 0);
+  }
+  // Leap second warnings for the NTP server ride on the same poll.
+  sendUbxMessage(kUbxClassNav, kUbxIdNavTimeLs, nullptr, 0);
+}
+
+const SignalTable &GpsController::signalTable() const {
+  return signalParser.table();
+}
+
+uint32_t GpsController::navSigFrames() const {
+  return signalParser.navSigFrames();
 }
 
 bool GpsController::verifyUbxProfile(UbxConfigProfile profile) {
-  size_t entryCount = 0;
-  const UbxKeyValue *entries = ubxProfileValidationTargets(profile, entryCount);
-  if (!entries || entryCount == 0) {
-    return true;
+  // Everything just written to RAM plus the profile's own targets, read
+  // back in one batched VALGET and kept for /api/state. The diff is done
+  // with by now, so its set holds the expectations. Keys the receiver
+  // rejected on write (an optional one like NAV-SIG output on firmware
+  // without it) were already reported and would only fail here again.
+  UbxConfigSet &expected = configChanges;
+  expected.clear();
+  for (size_t i = 0; i < desiredConfig.size(); ++i) {
+    if ((desiredConfig[i].layers & kUbxLayerRam) &&
+        !wasRejected(desiredConfig[i].key)) {
+      expected.set(desiredConfig[i].key, desiredConfig[i].value,
+                   kUbxLayerRam);
+    }
   }
-  bool allGood = true;
-  for (size_t i = 0; i < entryCount; ++i) {
-    uint8_t value = 0;
-    if (!requestUbxConfigValue(entries[i].key, value, kUbxValgetLayerRam)) {
-      logPrintf("[gps] UBX verify failed to read key 0x%08lX\n",
-                static_cast<unsigned long>(entries[i].key));
-      allGood = false;
-      continue;
+  size_t targetCount = 0;
+  const UbxKeyValue *targets =
+      ubxProfileValidationTargets(profile, targetCount);
+  for (size_t i = 0; i < targetCount; ++i) {
+    if (!wasRejected(targets[i].key)) {
+      expected.set(targets[i].key, targets[i].value, kUbxLayerRam);
     }
-    if (value != entries[i].value) {
-      logPrintf("[gps] UBX verify mismatch key 0x%08lX expected %u got %u\n",
-                static_cast<unsigned long>(entries[i].key),
-                static_cast<unsigned>(entries[i].value),
-                static_cast<unsigned>(value));
-      allGood = false;
+  }
+  if (expected.size() == 0) {
+    return true;
+  }
+  bool readOk = readUbxConfig(expected, kUbxLayerRam, verifiedConfig);
+  verifiedAtMs = millis();
+  uint8_t mismatches = 0;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const UbxConfigItem *got = verifiedConfig.find(expected[i].key);
+    if (!got || got->value != expected[i].value) {
+      logPrintf("[gps] UBX verify key 0x%08lX expected %lu got %s%lu\n",
+                static_cast<unsigned long>(expected[i].key),
+                static_cast<unsigned long>(expected[i].value),
+                got ? "" : "none ",
+                static_cast<unsigned long>(got ? got->value : 0));
+      mismatches++;
     }
   }
-  if (allGood) {
-    logPrintf("[gps] UBX verify OK for %s\n", ubxProfileName(profile));
+  state.ubxVerifyMismatches = mismatches;
+  if (readOk && mismatches == 0) {
+    logPrintf("[gps] UBX verify OK for %s (%u keys)\n",
+              ubxProfileName(profile),
+              static_cast<unsigned>(expected.size()));
+    return true;
   }
-  return allGood;
+  return false;
 }
 
 namespace {
@@ -1201,6 +2287,12 @@ std::string currentCustomCommandHex(bool settings) {
 
 uint32_t getGpsSerialBaud() { return gpsController().baud(); }
 
+uint8_t getGpsMeasurementRate() { return gpsController().measurementRate(); }
+
+bool setGpsMeasurementRate(uint8_t rateHz) {
+  return gpsController().setMeasurementRate(rateHz);
+}
+
 bool setGpsSerialBaud(uint32_t baud) { return gpsController().setBaud(baud); }
 
 UbxConfigProfile getGpsUbxProfile() { return gpsController().ubxProfile(); }
@@ -1244,3 +2336,47 @@ std::string getGpsCustomProfileCommand() {
 std::string getGpsCustomSettingsCommand() {
   return currentCustomCommandHex(true);
 }
+
+std::string getGpsNamedProfilesJson(bool withItems) {
+  const UbxProfileStore &store = ubxProfileStore();
+  std::string json = "{\"active\":\"";
+  json += store.activeName();
+  json += "\",\"profiles\":[";
+  // Room for a full profile of 8-byte values written as hex strings.
+  static char buffer[64 + kUbxProfileMaxItems * 32];
+  for (size_t i = 0; i < store.size(); ++i) {
+    size_t length = 0;
+    if (i > 0) {
+      buffer[length++] = ',';
+    }
+    if (withItems) {
+      formatUbxProfileJson(store[i], buffer, sizeof(buffer), length);
+    } else {
+      length += snprintf(buffer + length, sizeof(buffer) - length,
+                         "{\"name\":\"%s\",\"keys\":%u}", store[i].name,
+                         static_cast<unsigned>(store[i].itemCount));
+    }
+    json.append(buffer, length);
+  }
+  json += "]}";
+  return json;
+}
+
+bool saveGpsNamedProfile(const std::string &json, std::string &error) {
+  // Static: a parsed profile is too large for the loop task's stack.
+  static UbxNamedProfile profile;
+  const char *parseError = nullptr;
+  if (!parseUbxProfileJson(json.data(), json.size(), profile, parseError)) {
+    error = parseError;
+    return false;
+  }
+  return gpsController().storeNamedProfile(profile, error);
+}
+
+bool selectGpsNamedProfile(const std::string &name, std::string &error) {
+  return gpsController().selectNamedProfile(name.c_str(), error);
+}
+
+bool deleteGpsNamedProfile(const std::string &name, std::string &error) {
+  return gpsController().deleteNamedProfile(name.c_str(), error);
+}
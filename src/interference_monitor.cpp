@@ -0,0 +1,258 @@
+#include "interference_monitor.h"
+
+#include <math.h>
+
+namespace {
+constexpr size_t kMonRfHeaderSize = 4;
+constexpr size_t kMonRfBlockSize = 24;
+constexpr size_t kSecSigV1Size = 12;
+constexpr size_t kSecSigV2MinSize = 4;
+// RF readings older than this no longer count (polls stopped, link busy).
+constexpr uint32_t kRfMaxAgeMs = 30000;
+constexpr uint8_t kMaxUnansweredSecSig = 3;
+
+constexpr uint8_t kJamIndicatorAlert = 180; // ~70% of the CW scale
+constexpr float kNoiseRiseRatio = 1.25f;
+constexpr float kAgcCutRatio = 0.8f;
+constexpr float kCnoDropDb = 6.0f;
+
+// Mean and spread over the strongest few satellites: the weak tail moves
+// with elevation and foliage, the top does not under open sky.
+constexpr size_t kTopSatellites = 6;
+constexpr uint8_t kMinSatellites = 4;
+constexpr float kSpoofMinCno = 45.0f;
+constexpr float kSpoofMaxSpreadDb = 1.5f;
+constexpr float kSpoofExcessDb = 6.0f;
+
+// EWMA weights; C/N0 per epoch, noise and AGC per MON-RF frame.
+constexpr float kCnoBaselineAlpha = 1.0f / 64.0f;
+constexpr float kRfBaselineAlpha = 1.0f / 16.0f;
+constexpr uint16_t kBaselineEpochs = 30;
+// Per elevation bin, one sample per satellite and epoch. Slow, so a
+// spoofer has to hold for minutes before it becomes the normal level.
+constexpr float kElevationAlpha = 1.0f / 256.0f;
+constexpr uint16_t kElevationMinSamples = 120;
+
+uint16_t readU16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+
+uint16_t blend(uint16_t baseline, uint16_t value) {
+  if (baseline == 0) {
+    return value;
+  }
+  float next = baseline + (static_cast<float>(value) - baseline) *
+                              kRfBaselineAlpha;
+  return static_cast<uint16_t>(next + 0.5f);
+}
+} // namespace
+
+void InterferenceMonitor::reset() { *this = InterferenceMonitor(); }
+
+void InterferenceMonitor::onPoll() {
+  if (stats.secSigUnsupported || stats.secSigValid) {
+    return;
+  }
+  if (++unansweredSecSig >= kMaxUnansweredSecSig) {
+    stats.secSigUnsupported = true;
+  }
+}
+
+void InterferenceMonitor::onMonRf(const uint8_t *payload, size_t length,
+                                  uint32_t nowMs) {
+  if (length < kMonRfHeaderSize + kMonRfBlockSize) {
+    return;
+  }
+  uint8_t blocks = payload[1];
+  if (length < kMonRfHeaderSize + blocks * kMonRfBlockSize) {
+    blocks = static_cast<uint8_t>((length - kMonRfHeaderSize) /
+                                  kMonRfBlockSize);
+  }
+  uint8_t jammingState = kRfStateUnknown;
+  uint8_t jamIndicator = 0;
+  for (uint8_t i = 0; i < blocks; ++i) {
+    const uint8_t *block = payload + kMonRfHeaderSize + i * kMonRfBlockSize;
+    uint8_t state = block[1] & 0x03;
+    if (state > jammingState) {
+      jammingState = state;
+    }
+    if (block[16] > jamIndicator) {
+      jamIndicator = block[16];
+    }
+  }
+  // Noise and AGC baselines are kept for the first (L1) block.
+  const uint8_t *first = payload + kMonRfHeaderSize;
+  stats.antennaStatus = first[2];
+  stats.noisePerMs = readU16(first + 12);
+  stats.agcCount = readU16(first + 14);
+  stats.jammingState = jammingState;
+  stats.jamIndicator = jamIndicator;
+  stats.monRfValid = true;
+  stats.monRfFrames++;
+  monRfAtMs = nowMs;
+  if ((stats.flags & kRfFlagJamming) == 0) {
+    stats.noiseBaseline = blend(stats.noiseBaseline, stats.noisePerMs);
+    stats.agcBaseline = blend(stats.agcBaseline, stats.agcCount);
+  }
+  evaluate(nowMs);
+}
+
+void InterferenceMonitor::onSecSig(const uint8_t *payload, size_t length,
+                                   uint32_t nowMs) {
+  if (length < kSecSigV2MinSize) {
+    return;
+  }
+  if (payload[0] == 1 && length >= kSecSigV1Size) {
+    stats.secJammingState = (payload[4] >> 1) & 0x03;
+    stats.spoofingState = (payload[8] >> 1) & 0x07;
+  } else if (payload[0] >= 2) {
+    stats.secJammingState = (payload[1] >> 1) & 0x03;
+    stats.spoofingState = (payload[1] >> 4) & 0x07;
+  } else {
+    return;
+  }
+  stats.secSigValid = true;
+  stats.secSigUnsupported = false;
+  unansweredSecSig = 0;
+  secSigAtMs = nowMs;
+  evaluate(nowMs);
+}
+
+void InterferenceMonitor::learnElevation(uint8_t elevation, uint8_t cno) {
+  size_t bin = elevation / 10;
+  if (bin >= kElevationBins) {
+    bin = kElevationBins - 1;
+  }
+  if (elevationSamples[bin] == 0) {
+    elevationCno[bin] = cno;
+  } else {
+    elevationCno[bin] += (cno - elevationCno[bin]) * kElevationAlpha;
+  }
+  if (elevationSamples[bin] < kElevationMinSamples) {
+    elevationSamples[bin]++;
+  }
+}
+
+void InterferenceMonitor::onSatellites(const SatelliteTable &table,
+                                       uint32_t nowMs) {
+  bool learn = (stats.flags & kRfFlagJamming) == 0;
+  uint8_t top[kTopSatellites] = {};
+  uint8_t topElevation[kTopSatellites] = {};
+  size_t count = 0;
+  SatelliteRecord sat;
+  for (size_t i = 0; i < table.capacity(); ++i) {
+    if (!table.at(i, sat) || sat.cno == 0) {
+      continue;
+    }
+    // Insertion into a short descending list.
+    size_t pos = count < kTopSatellites ? count++ : kTopSatellites;
+    while (pos > 0 && top[pos - 1] < sat.cno) {
+      if (pos < kTopSatellites) {
+        top[pos] = top[pos - 1];
+        topElevation[pos] = topElevation[pos - 1];
+      }
+      pos--;
+    }
+    if (pos < kTopSatellites) {
+      top[pos] = sat.cno;
+      topElevation[pos] = sat.elevation;
+    }
+  }
+  // Compared before this epoch is learned, so it cannot vouch for itself.
+  float excessSum = 0.0f;
+  size_t excessCount = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size_t bin = topElevation[i] / 10;
+    if (bin >= kElevationBins) {
+      bin = kElevationBins - 1;
+    }
+    if (elevationSamples[bin] >= kElevationMinSamples) {
+      excessSum += top[i] - elevationCno[bin];
+      excessCount++;
+    }
+  }
+  stats.cnoExcessValid = excessCount >= kMinSatellites;
+  stats.cnoExcess = stats.cnoExcessValid ? excessSum / excessCount : 0.0f;
+  if (learn) {
+    for (size_t i = 0; i < table.capacity(); ++i) {
+      if (table.at(i, sat) && sat.cno != 0) {
+        learnElevation(sat.elevation, sat.cno);
+      }
+    }
+  }
+  trackedCount = static_cast<uint8_t>(count);
+  if (count < kMinSatellites) {
+    // Nothing usable in view: counts as a full drop for the jamming check.
+    stats.cnoMean = 0.0f;
+    stats.cnoSpread = 0.0f;
+  } else {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+      sum += top[i];
+    }
+    float mean = sum / count;
+    float sumSq = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+      float d = top[i] - mean;
+      sumSq += d * d;
+    }
+    stats.cnoMean = mean;
+    stats.cnoSpread = sqrtf(sumSq / count);
+    if (learn) {
+      stats.cnoBaseline = cnoEpochs == 0
+                              ? mean
+                              : stats.cnoBaseline +
+                                    (mean - stats.cnoBaseline) *
+                                        kCnoBaselineAlpha;
+      if (cnoEpochs < kBaselineEpochs) {
+        cnoEpochs++;
+      }
+    }
+  }
+  evaluate(nowMs);
+}
+
+void InterferenceMonitor::evaluate(uint32_t nowMs) {
+  bool rfFresh = stats.monRfValid && nowMs - monRfAtMs <= kRfMaxAgeMs;
+  bool secFresh = stats.secSigValid && nowMs - secSigAtMs <= kRfMaxAgeMs;
+
+  bool jamming = false;
+  if (rfFresh) {
+    jamming = stats.jammingState >= kRfStateWarning ||
+              stats.jamIndicator >= kJamIndicatorAlert;
+  }
+  if (secFresh && stats.secJammingState >= kRfStateWarning) {
+    jamming = true;
+  }
+  bool cnoDrop = cnoEpochs >= kBaselineEpochs &&
+                 stats.cnoMean <= stats.cnoBaseline - kCnoDropDb;
+  if (cnoDrop && rfFresh && stats.noiseBaseline > 0) {
+    bool noiseRise = stats.noisePerMs >= stats.noiseBaseline * kNoiseRiseRatio;
+    bool agcCut = stats.agcCount <= stats.agcBaseline * kAgcCutRatio;
+    jamming = jamming || noiseRise || agcCut;
+  }
+
+  bool spoofing = secFresh && stats.spoofingState >= 2;
+  bool uniform = trackedCount >= kTopSatellites &&
+                 stats.cnoMean >= kSpoofMinCno &&
+                 stats.cnoSpread <= kSpoofMaxSpreadDb;
+  bool aboveSky = stats.cnoExcessValid && stats.cnoExcess >= kSpoofExcessDb;
+  if (!secFresh && uniform && aboveSky) {
+    spoofing = true;
+  }
+
+  auto track = [&](bool active, uint8_t bit, uint32_t &seenMs,
+                   uint32_t &events) {
+    if (active) {
+      if ((stats.flags & bit) == 0) {
+        events++;
+      }
+      stats.flags |= bit;
+      seenMs = nowMs;
+    } else if ((stats.flags & bit) != 0 && nowMs - seenMs >= kClearHoldMs) {
+      stats.flags &= static_cast<uint8_t>(~bit);
+    }
+  };
+  track(jamming, kRfFlagJamming, jammingSeenMs, stats.jammingEvents);
+  track(spoofing, kRfFlagSpoofing, spoofingSeenMs, stats.spoofingEvents);
+}
@@ -1,6 +1,8 @@
 #include "led_status.h"
 
+#include "gnss_timebase.h"
 #include "logger.h"
+#include "power_manager.h"
 
 StatusIndicator &statusIndicator() {
   static StatusIndicator instance;
@@ -49,7 +51,6 @@ void StatusIndicator::begin() {
   ledState = false;
   ppsDetected = false;
   patternStartTime = bootStartTime;
-  lastLedTick = 0;
   lastPinHigh = true;
 
   logPrintln("[led] Initialising status LED (GPIO8)");
@@ -79,6 +80,9 @@ void StatusIndicator::setStatus(uint8_t status) {
     case STATUS_READY:
       logPrintln("[led] Mode set: ready (off)");
       break;
+    case STATUS_INTERFERENCE:
+      logPrintln("[led] Mode set: RF interference (fast blink)");
+      break;
     default:
       logPrintf("[led] Unknown status %d\n", status);
       break;
@@ -96,12 +100,7 @@ void StatusIndicator::writeLedOn(bool on) {
 }
 
 void StatusIndicator::update() {
-  unsigned long now = millis();
-  if (now - lastLedTick < 10) {
-    return;
-  }
-  lastLedTick = now;
-  unsigned long currentTime = now;
+  unsigned long currentTime = millis();
 
   switch (currentStatusValue) {
   case STATUS_BOOTING:
@@ -158,6 +157,13 @@ void StatusIndicator::update() {
   case STATUS_READY:
     writeLedOn(false);
     break;
+
+  case STATUS_INTERFERENCE: {
+    unsigned long patternTime =
+        (currentTime - patternStartTime) % 200;
+
+    writeLedOn(patternTime < 100);
+  } break;
   }
 }
 
@@ -252,4 +258,8 @@ void updateModeLED(bool passthroughActive, bool otaInProgress,
 
 uint8_t getStatusIndicatorState() { return statusIndicator().status(); }
 
-void IRAM_ATTR onPPSInterrupt() { statusIndicator().onPpsPulse(); }
+void IRAM_ATTR onPPSInterrupt() {
+  gnssTimebase().onPpsEdge();
+  statusIndicator().onPpsPulse();
+  powerManager().notePpsEdge();
+}
@@ -0,0 +1,161 @@
+#include "nav_extrapolator.h"
+
+#include <math.h>
+
+namespace {
+constexpr double kMetersPerDegLat = 111320.0;
+constexpr double kDegToRad = M_PI / 180.0;
+// u-blox starts NMEA output at least this long after the epoch.
+constexpr int64_t kMinOutputLatencyUs = 10000;
+constexpr int64_t kNmeaLatencyUs = 50000;
+constexpr int64_t kPpsValidUs = 2000000;
+constexpr int64_t kMinPeriodUs = 20000;
+constexpr int64_t kMaxPeriodUs = 2500000;
+// Beyond two epochs the fix is stale; only the outage bridge goes on.
+constexpr uint32_t kMaxHorizonEpochs = 2;
+// Unmodelled acceleration behind the growth of the position error.
+constexpr float kAssumedAccelMs2 = 0.5f;
+} // namespace
+
+void NavExtrapolator::reset() {
+  haveBase = false;
+  lastArrivalUs = 0;
+}
+
+void NavExtrapolator::setOutageWindow(uint32_t windowMs) {
+  outageWindowUs = static_cast<int64_t>(windowMs) * 1000;
+}
+
+int64_t NavExtrapolator::alignEpoch(int64_t arrivalUs, int64_t ppsUs) const {
+  if (ppsUs == 0 || arrivalUs - ppsUs < 0 || arrivalUs - ppsUs > kPpsValidUs) {
+    return arrivalUs - kNmeaLatencyUs;
+  }
+  // Measurements sit on a grid anchored at the top of the second, which
+  // the PPS edge marks; take the latest grid point before the output.
+  int64_t sincePps = arrivalUs - ppsUs - kMinOutputLatencyUs;
+  if (sincePps < 0) {
+    sincePps = 0;
+  }
+  return ppsUs + (sincePps / periodUs) * static_cast<int64_t>(periodUs);
+}
+
+void NavExtrapolator::predict(int64_t localUs, double &latitude,
+                              double &longitude) const {
+  float dt = static_cast<float>(localUs - baseEpochUs) * 1e-6f;
+  double metersPerDegLon = kMetersPerDegLat * cos(base.latitude * kDegToRad);
+  latitude = base.latitude + velNorth * dt / kMetersPerDegLat;
+  longitude = base.longitude;
+  if (metersPerDegLon > 1.0) {
+    longitude += velEast * dt / metersPerDegLon;
+  }
+}
+
+void NavExtrapolator::onMeasurement(const NavDataSample &sample,
+                                    int64_t arrivalUs, int64_t ppsUs) {
+  if (lastArrivalUs != 0) {
+    int64_t interval = arrivalUs - lastArrivalUs;
+    if (interval >= kMinPeriodUs && interval <= kMaxPeriodUs) {
+      periodUs = static_cast<uint32_t>(periodUs + (interval - periodUs) / 4);
+    }
+  }
+  lastArrivalUs = arrivalUs;
+
+  int64_t epoch = alignEpoch(arrivalUs, ppsUs);
+  if (haveBase && epoch - baseEpochUs > static_cast<int64_t>(periodUs / 2)) {
+    double lat = 0.0;
+    double lon = 0.0;
+    predict(epoch, lat, lon);
+    double metersPerDegLon = kMetersPerDegLat * cos(lat * kDegToRad);
+    float dNorth =
+        static_cast<float>((sample.latitude - lat) * kMetersPerDegLat);
+    float dEast =
+        static_cast<float>((sample.longitude - lon) * metersPerDegLon);
+    float error = sqrtf(dNorth * dNorth + dEast * dEast);
+    int64_t gap = epoch - baseEpochUs;
+    if (gap > static_cast<int64_t>(periodUs) * kMaxHorizonEpochs) {
+      // A fix ending an outage grades the bridge, not the epoch predictor.
+      lastOutage = static_cast<float>(gap) * 1e-6f;
+      lastOutageError = error;
+      outageCount++;
+      if (error > maxOutageError) {
+        maxOutageError = error;
+      }
+    } else {
+      lastError = error;
+      errorSumSq += error * error;
+      scoredCount++;
+      if (error > maxError) {
+        maxError = error;
+      }
+    }
+  }
+
+  base = sample;
+  baseEpochUs = epoch;
+  float headingRad = static_cast<float>(sample.heading * kDegToRad);
+  velEast = sample.speed * sinf(headingRad);
+  velNorth = sample.speed * cosf(headingRad);
+  haveBase = true;
+}
+
+bool NavExtrapolator::extrapolate(int64_t localUs, NavDataSample &out,
+                                  bool fixLost) {
+  if (!haveBase || (fixLost && outageWindowUs == 0)) {
+    return false;
+  }
+  int64_t dt = localUs - baseEpochUs;
+  int64_t horizon = static_cast<int64_t>(periodUs) * kMaxHorizonEpochs;
+  bool outage = fixLost || dt > horizon;
+  if (dt < 0) {
+    return false;
+  }
+  if (outage && dt > outageWindowUs) {
+    // Past the window the fix is gone for good; do not score a resumption
+    // against it either.
+    if (outageWindowUs > 0) {
+      haveBase = false;
+    }
+    return false;
+  }
+  double lat = 0.0;
+  double lon = 0.0;
+  predict(localUs, lat, lon);
+  out = base;
+  out.latitude = lat;
+  out.longitude = lon;
+  if (out.utcEpochUs != 0) {
+    out.utcEpochUs += dt;
+  }
+  float dtSeconds = static_cast<float>(dt) * 1e-6f;
+  if (out.horizontalAccuracy > 0.0f) {
+    out.horizontalAccuracy += out.speedAccuracy * dtSeconds;
+  }
+  out.extrapolated = true;
+  extrapolatedCount++;
+  if (outage) {
+    out.horizontalAccuracy +=
+        0.5f * kAssumedAccelMs2 * dtSeconds * dtSeconds;
+    out.speedAccuracy += kAssumedAccelMs2 * dtSeconds;
+    out.estimated = true;
+    estimatedCount++;
+  }
+  return true;
+}
+
+ExtrapolationStats NavExtrapolator::stats() const {
+  ExtrapolationStats result;
+  result.epochPeriodMs = periodUs / 1000;
+  result.extrapolated = extrapolatedCount;
+  result.scored = scoredCount;
+  result.lastErrorM = lastError;
+  result.maxErrorM = maxError;
+  result.estimated = estimatedCount;
+  result.outages = outageCount;
+  result.lastOutageS = lastOutage;
+  result.lastOutageErrorM = lastOutageError;
+  result.maxOutageErrorM = maxOutageError;
+  if (scoredCount > 0) {
+    result.rmsErrorM = static_cast<float>(sqrt(errorSumSq / scoredCount));
+  }
+  return result;
+}
@@ -0,0 +1,204 @@
+#include "nav_kalman.h"
+
+#include <math.h>
+
+namespace {
+constexpr double kMetersPerDegLat = 111320.0;
+constexpr double kDegToRad = M_PI / 180.0;
+constexpr float kUereMeters = 5.0f;
+constexpr float kMinHorizontalAccuracy = 3.0f;
+constexpr float kVerticalAccuracyScale = 1.5f;
+// White-acceleration process noise: a car or a walker, not a jet.
+constexpr float kHorizontalAccelVariance = 1.0f; // (m/s^2)^2
+constexpr float kVerticalAccelVariance = 0.25f;
+// NMEA carries no speed accuracy; this is typical for Doppler velocity.
+constexpr float kVelocityVariance = 0.25f; // (m/s)^2
+constexpr float kMinHeadingSpeed = 0.5f;
+constexpr float kGateChi2 = 16.0f;
+constexpr uint8_t kMaxConsecutiveRejects = 3;
+constexpr float kRecenterMeters = 5000.0f;
+
+inline float square(float value) { return value * value; }
+} // namespace
+
+float horizontalAccuracyFromHdop(float hdop) {
+  if (hdop <= 0.0f) {
+    return 0.0f;
+  }
+  float accuracy = hdop * kUereMeters;
+  return accuracy < kMinHorizontalAccuracy ? kMinHorizontalAccuracy
+                                           : accuracy;
+}
+
+void NavKalmanFilter::reset() {
+  if (isInitialized) {
+    resets++;
+  }
+  isInitialized = false;
+  consecutiveRejects = 0;
+}
+
+void NavKalmanFilter::initialize(const NavMeasurement &m) {
+  originLat = m.latitude;
+  originLon = m.longitude;
+  metersPerDegLon = kMetersPerDegLat * cos(originLat * kDegToRad);
+
+  float r = square(m.horizontalAccuracy > kMinHorizontalAccuracy
+                       ? m.horizontalAccuracy
+                       : kMinHorizontalAccuracy);
+  float headingRad = static_cast<float>(m.heading * kDegToRad);
+  float speed = m.hasVelocity ? m.speed : 0.0f;
+  float velVariance = m.hasVelocity ? kVelocityVariance : 100.0f;
+
+  east = Axis{0.0f, speed * sinf(headingRad), r, 0.0f, velVariance};
+  north = Axis{0.0f, speed * cosf(headingRad), r, 0.0f, velVariance};
+  up = Axis{m.altitude, 0.0f, square(kVerticalAccuracyScale) * r, 0.0f, 1.0f};
+  lastHeading = m.heading;
+  consecutiveRejects = 0;
+  isInitialized = true;
+}
+
+void NavKalmanFilter::toLocal(double latitude, double longitude, float &e,
+                              float &n) const {
+  double dLon = longitude - originLon;
+  if (dLon > 180.0) {
+    dLon -= 360.0;
+  } else if (dLon < -180.0) {
+    dLon += 360.0;
+  }
+  e = static_cast<float>(dLon * metersPerDegLon);
+  n = static_cast<float>((latitude - originLat) * kMetersPerDegLat);
+}
+
+void NavKalmanFilter::recenter() {
+  if (fabsf(east.pos) < kRecenterMeters && fabsf(north.pos) < kRecenterMeters) {
+    return;
+  }
+  originLat += north.pos / kMetersPerDegLat;
+  originLon += east.pos / metersPerDegLon;
+  metersPerDegLon = kMetersPerDegLat * cos(originLat * kDegToRad);
+  east.pos = 0.0f;
+  north.pos = 0.0f;
+}
+
+void NavKalmanFilter::predictAxis(Axis &a, float dt, float q) {
+  float dt2 = dt * dt;
+  a.pos += a.vel * dt;
+  a.p00 += dt * (2.0f * a.p01 + dt * a.p11) + q * dt2 * dt2 * 0.25f;
+  a.p01 += dt * a.p11 + q * dt2 * dt * 0.5f;
+  a.p11 += q * dt2;
+}
+
+bool NavKalmanFilter::updatePosition(Axis &a, float z, float r, float gate) {
+  float y = z - a.pos;
+  float s = a.p00 + r;
+  if (gate > 0.0f && y * y > gate * s) {
+    return false;
+  }
+  float k0 = a.p00 / s;
+  float k1 = a.p01 / s;
+  a.pos += k0 * y;
+  a.vel += k1 * y;
+  a.p11 -= k1 * a.p01;
+  a.p01 -= k0 * a.p01;
+  a.p00 -= k0 * a.p00;
+  return true;
+}
+
+void NavKalmanFilter::updateVelocity(Axis &a, float z, float r) {
+  float y = z - a.vel;
+  float s = a.p11 + r;
+  float k0 = a.p01 / s;
+  float k1 = a.p11 / s;
+  a.pos += k0 * y;
+  a.vel += k1 * y;
+  a.p00 -= k0 * a.p01;
+  a.p01 -= k1 * a.p01;
+  a.p11 -= k1 * a.p11;
+}
+
+void NavKalmanFilter::predict(float dt) {
+  if (!isInitialized || dt <= 0.0f) {
+    return;
+  }
+  predictAxis(east, dt, kHorizontalAccelVariance);
+  predictAxis(north, dt, kHorizontalAccelVariance);
+  predictAxis(up, dt, kVerticalAccelVariance);
+}
+
+void NavKalmanFilter::update(const NavMeasurement &m) {
+  if (!isInitialized) {
+    initialize(m);
+    return;
+  }
+
+  float e = 0.0f;
+  float n = 0.0f;
+  toLocal(m.latitude, m.longitude, e, n);
+  float r = square(m.horizontalAccuracy > kMinHorizontalAccuracy
+                       ? m.horizontalAccuracy
+                       : kMinHorizontalAccuracy);
+
+  // Gate on the joint east/north innovation; a run of outliers means the
+  // filter has lost the track (tunnel exit, cold restart) and re-seeds.
+  float d2 = square(e - east.pos) / (east.p00 + r) +
+             square(n - north.pos) / (north.p00 + r);
+  if (d2 > kGateChi2) {
+    rejected++;
+    if (++consecutiveRejects >= kMaxConsecutiveRejects) {
+      reset();
+      initialize(m);
+    }
+    return;
+  }
+  consecutiveRejects = 0;
+
+  updatePosition(east, e, r, 0.0f);
+  updatePosition(north, n, r, 0.0f);
+  updatePosition(up, m.altitude, square(kVerticalAccuracyScale) * r, 0.0f);
+  if (m.hasVelocity) {
+    float headingRad = static_cast<float>(m.heading * kDegToRad);
+    updateVelocity(east, m.speed * sinf(headingRad), kVelocityVariance);
+    updateVelocity(north, m.speed * cosf(headingRad), kVelocityVariance);
+    if (m.speed >= kMinHeadingSpeed) {
+      lastHeading = m.heading;
+    }
+  }
+  recenter();
+}
+
+NavEstimate NavKalmanFilter::estimate() const {
+  NavEstimate result;
+  if (!isInitialized) {
+    return result;
+  }
+  result.valid = true;
+  result.latitude = originLat + north.pos / kMetersPerDegLat;
+  result.longitude = originLon + east.pos / metersPerDegLon;
+  if (result.longitude > 180.0) {
+    result.longitude -= 360.0;
+  } else if (result.longitude < -180.0) {
+    result.longitude += 360.0;
+  }
+  result.altitude = up.pos;
+  result.velocityEast = east.vel;
+  result.velocityNorth = north.vel;
+  result.speed = sqrtf(square(east.vel) + square(north.vel));
+  if (result.speed >= kMinHeadingSpeed) {
+    float heading = static_cast<float>(atan2f(east.vel, north.vel) / kDegToRad);
+    result.heading = heading < 0.0f ? heading + 360.0f : heading;
+  } else {
+    result.heading = lastHeading;
+  }
+  result.horizontalAccuracy = sqrtf(east.p00 + north.p00);
+  result.verticalAccuracy = sqrtf(up.p00);
+  result.speedAccuracy = sqrtf(0.5f * (east.p11 + north.p11));
+  float headingAccuracy = 180.0f;
+  if (result.speed > 0.1f) {
+    headingAccuracy =
+        static_cast<float>(atanf(result.speedAccuracy / result.speed) /
+                           kDegToRad);
+  }
+  result.headingAccuracy = headingAccuracy;
+  return result;
+}
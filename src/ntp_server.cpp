@@ -0,0 +1,191 @@
+#include "ntp_server.h"
+
+#include "gnss_timebase.h"
+#include "logger.h"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <lwip/sockets.h>
+
+namespace {
+constexpr size_t kNtpPacketSize = 48;
+constexpr uint32_t kNtpTaskStack = 3072;
+constexpr UBaseType_t kNtpTaskPriority = 1;
+constexpr uint32_t kNtpUnixOffset = 2208988800UL; // 1900 -> 1970
+constexpr uint8_t kNtpVersion = 4;
+constexpr uint8_t kModeClient = 3;
+constexpr uint8_t kModeServer = 4;
+constexpr uint8_t kLeapNone = 0;
+constexpr uint8_t kLeapInsert = 1;
+constexpr uint8_t kLeapDelete = 2;
+constexpr uint8_t kLeapUnsynced = 3;
+// RFC 5905 clients act on LI during the day that ends with the leap.
+constexpr int64_t kLeapWarningUs = 86400LL * 1000000LL;
+constexpr uint8_t kStratumPrimary = 1;
+// NMEA arrival time is tens of milliseconds off, far from what a primary
+// server promises, so without PPS the server ranks itself one step lower
+// and clients prefer any real stratum 1 they can reach.
+constexpr uint8_t kStratumNmea = 2;
+constexpr uint8_t kStratumUnsynced = 16;
+constexpr int8_t kPrecisionLog2 = -20; // ~1 us esp_timer resolution
+// Root dispersion budgets: NMEA arrival jitter without PPS, plus the
+// oscillator error growing while the clock coasts between edges.
+constexpr uint32_t kNmeaDispersionUs = 50000;
+constexpr uint32_t kPpsDispersionFloorUs = 5;
+// With no fresh anchor (PPS edge or NMEA second) for this long the GNSS
+// time is treated as lost rather than served from the coasting clock.
+constexpr int64_t kMaxAnchorAgeUs = 60000000LL;
+
+TaskHandle_t gNtpTask = nullptr;
+volatile uint32_t gServed = 0;
+volatile uint32_t gUnsynced = 0;
+volatile uint32_t gIgnored = 0;
+
+void writeU32(uint8_t *dst, uint32_t value) {
+  dst[0] = static_cast<uint8_t>(value >> 24);
+  dst[1] = static_cast<uint8_t>(value >> 16);
+  dst[2] = static_cast<uint8_t>(value >> 8);
+  dst[3] = static_cast<uint8_t>(value);
+}
+
+void writeTimestamp(uint8_t *dst, int64_t unixUs) {
+  int64_t seconds = unixUs / 1000000LL;
+  int64_t micros = unixUs % 1000000LL;
+  uint32_t fraction =
+      static_cast<uint32_t>((static_cast<uint64_t>(micros) << 32) / 1000000ULL);
+  writeU32(dst, static_cast<uint32_t>(seconds + kNtpUnixOffset));
+  writeU32(dst + 4, fraction);
+}
+
+// NTP short format: 16.16 fixed-point seconds.
+uint32_t toShortFormat(uint32_t micros) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(micros) << 16) /
+                               1000000ULL);
+}
+
+int64_t anchorAgeUs(const TimebaseStats &stats, int64_t nowUtcUs) {
+  int64_t age = nowUtcUs - stats.referenceUtcUs;
+  return age > 0 ? age : 0;
+}
+
+uint32_t rootDispersionUs(const TimebaseStats &stats, int64_t nowUtcUs) {
+  // 15 ppm frequency tolerance (RFC 5905 PHI) accrued since the last
+  // anchor, on top of the PPS jitter or the NMEA arrival budget.
+  uint32_t coast =
+      static_cast<uint32_t>(anchorAgeUs(stats, nowUtcUs) * 15 / 1000000);
+  uint32_t base = stats.ppsLocked ? stats.jitterUs + kPpsDispersionFloorUs
+                                  : kNmeaDispersionUs;
+  return base + coast;
+}
+
+uint8_t leapIndicator(const TimebaseStats &stats, int64_t nowUtcUs) {
+  int64_t leftUs =
+      static_cast<int64_t>(stats.leapEventUnixS) * 1000000LL - nowUtcUs;
+  if (stats.leapChange == 0 || leftUs <= 0 || leftUs > kLeapWarningUs) {
+    return kLeapNone;
+  }
+  return stats.leapChange > 0 ? kLeapInsert : kLeapDelete;
+}
+
+void handleRequest(int sock, uint8_t *packet, int length, int64_t rxLocalUs,
+                   const sockaddr_in &from) {
+  uint8_t mode = packet[0] & 0x07;
+  uint8_t version = (packet[0] >> 3) & 0x07;
+  if (length < static_cast<int>(kNtpPacketSize) || mode != kModeClient ||
+      version < 1 || version > kNtpVersion) {
+    gIgnored = gIgnored + 1;
+    return;
+  }
+
+  UtcTimestamp rx = gnssTimebase().utcAt(rxLocalUs);
+  TimebaseStats stats = gnssTimebase().stats();
+  bool synced = rx.valid && stats.source != TimeSource::None &&
+                anchorAgeUs(stats, rx.unixUs) <= kMaxAnchorAgeUs;
+
+  uint8_t originate[8];
+  memcpy(originate, packet + 40, sizeof(originate));
+  uint8_t poll = packet[2];
+  memset(packet, 0, kNtpPacketSize);
+
+  uint8_t leap = synced ? leapIndicator(stats, rx.unixUs) : kLeapUnsynced;
+  packet[0] = static_cast<uint8_t>((leap << 6) | (version << 3) | kModeServer);
+  packet[1] = !synced        ? kStratumUnsynced
+              : rx.ppsLocked ? kStratumPrimary
+                             : kStratumNmea;
+  packet[2] = poll;
+  packet[3] = static_cast<uint8_t>(kPrecisionLog2);
+  memcpy(packet + 24, originate, sizeof(originate));
+  if (!synced) {
+    // LI=3 / stratum 16 tells clients to pick another source for now.
+    gUnsynced = gUnsynced + 1;
+    sendto(sock, packet, kNtpPacketSize, 0,
+           reinterpret_cast<const sockaddr *>(&from), sizeof(from));
+    return;
+  }
+
+  // Root delay stays zero: the reference clock is attached directly.
+  writeU32(packet + 8, toShortFormat(rootDispersionUs(stats, rx.unixUs)));
+  memcpy(packet + 12, rx.ppsLocked ? "PPS" : "GPS", 4);
+  writeTimestamp(packet + 16, stats.referenceUtcUs);
+  writeTimestamp(packet + 32, rx.unixUs);
+  writeTimestamp(packet + 40, gnssTimebase().now().unixUs);
+  gServed = gServed + 1;
+  sendto(sock, packet, kNtpPacketSize, 0,
+         reinterpret_cast<const sockaddr *>(&from), sizeof(from));
+}
+
+void ntpTask(void *) {
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) {
+    logPrintln("[ntp] Failed to create socket");
+    gNtpTask = nullptr;
+    vTaskDelete(nullptr);
+    return;
+  }
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(kNtpServerPort);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    logPrintln("[ntp] Failed to bind UDP/123");
+    close(sock);
+    gNtpTask = nullptr;
+    vTaskDelete(nullptr);
+    return;
+  }
+  logPrintf("[ntp] NTP server listening on UDP/%u\n", kNtpServerPort);
+
+  uint8_t packet[kNtpPacketSize + 16];
+  for (;;) {
+    sockaddr_in from = {};
+    socklen_t fromLength = sizeof(from);
+    int length = recvfrom(sock, packet, sizeof(packet), 0,
+                          reinterpret_cast<sockaddr *>(&from), &fromLength);
+    int64_t rxLocalUs = esp_timer_get_time();
+    if (length <= 0) {
+      continue;
+    }
+    handleRequest(sock, packet, length, rxLocalUs, from);
+  }
+}
+} // namespace
+
+void initNtpServer() {
+  if (gNtpTask) {
+    return;
+  }
+  if (xTaskCreate(ntpTask, "ntp", kNtpTaskStack, nullptr, kNtpTaskPriority,
+                  &gNtpTask) != pdPASS) {
+    gNtpTask = nullptr;
+    logPrintln("[ntp] Failed to start NTP task");
+  }
+}
+
+NtpServerStats ntpServerStats() {
+  NtpServerStats stats;
+  stats.running = gNtpTask != nullptr;
+  stats.served = gServed;
+  stats.unsynced = gUnsynced;
+  stats.ignored = gIgnored;
+  return stats;
+}
@@ -8,6 +8,7 @@
 #include <ElegantOTA.h>
 
 #include "logger.h"
+#include "power_manager.h"
 #include "wifi_manager.h"
 
 namespace {
@@ -100,6 +101,9 @@ void applyOtaAuthGuard() {
 }
 
 void resetOtaProgressState() {
+  if (gOtaInProgress) {
+    powerManager().releaseCpuBoost();
+  }
   gOtaInProgress = false;
   gOtaStartAt = 0;
   gOtaReceivedBytes = false;
@@ -122,6 +126,9 @@ void startOtaServer() {
 
   ElegantOTA.begin(gOtaServer);
   ElegantOTA.onStart([]() {
+    if (!gOtaInProgress) {
+      powerManager().boostCpu();
+    }
     gOtaInProgress = true;
     gOtaStartAt = millis();
     gOtaReceivedBytes = false;
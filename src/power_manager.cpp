@@ -0,0 +1,433 @@
+#include "power_manager.h"
+
+#include "gps_config.h"
+#include "logger.h"
+#include "ota_service.h"
+#include "task_scheduler.h"
+#include "wifi_manager.h"
+
+#include <Preferences.h>
+#include <driver/gpio.h>
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+namespace {
+constexpr const char *kPowerPrefsNamespace = "power";
+constexpr const char *kPowerProfileKey = "profile";
+constexpr PowerProfile kDefaultPowerProfile = PowerProfile::AlwaysOn;
+// Idle work (BLE at 1 Hz, NMEA parsing) fits at 80 MHz; bursts are boosted
+// to 160 MHz. The floor stays at 80 MHz so APB-clocked UART baud rates and
+// the radios are unaffected by frequency switches.
+constexpr uint32_t kCpuMaxFreqMhz = 160;
+constexpr uint32_t kCpuBaseFreqMhz = 80;
+constexpr uint32_t kBusyTickPeriodMs = 50;
+constexpr uint32_t kIdleTickPeriodMs = 500;
+// The receiver emits NMEA tens of milliseconds after the epoch; wake a
+// little before it and keep RX awake until the burst has gone quiet.
+constexpr int64_t kEpochGuardUs = 30000;
+constexpr int64_t kRxHoldMinUs = 250000;
+constexpr int64_t kRxQuietUs = 40000;
+constexpr int64_t kBurstGapUs = 200000;
+constexpr int64_t kPpsValidUs = 3000000;
+constexpr int64_t kMinEpochUs = 40000;
+constexpr int64_t kMaxEpochUs = 2000000;
+constexpr int64_t kFixLatencyWindowUs = 1500000;
+// Datasheet figures for the C3 alone; radios and the GNSS module are extra.
+constexpr float kActiveCurrentMa = 20.0f;
+constexpr float kLightSleepCurrentMa = 0.13f;
+
+portMUX_TYPE gPowerMux = portMUX_INITIALIZER_UNLOCKED;
+const char *const kLockNames[kPowerLockCount] = {"gnss_rx", "ble", "wifi"};
+#if CONFIG_PM_ENABLE
+esp_pm_lock_handle_t gLocks[kPowerLockCount] = {};
+esp_pm_lock_handle_t gCpuBoostLock = nullptr;
+#endif
+
+bool wifiNeedsRadio() {
+  return wifiManagerIsApActive() || wifiManagerIsConnected() ||
+         otaUpdatesEnabled();
+}
+} // namespace
+
+PowerManager &powerManager() {
+  static PowerManager instance;
+  return instance;
+}
+
+const char *powerProfileName(PowerProfile profile) {
+  switch (profile) {
+  case PowerProfile::AlwaysOn:
+    return "always-on";
+  case PowerProfile::LightSleep:
+    return "light-sleep";
+  }
+  return "unknown";
+}
+
+// Automatic light sleep is entered from the FreeRTOS idle hook, which only
+// exists with tickless idle. The stock Arduino-ESP32 libraries are built
+// without it (and without CONFIG_PM_ENABLE), so the profile needs a custom
+// framework build.
+bool lightSleepAvailable() {
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  return true;
+#else
+  return false;
+#endif
+}
+
+void PowerManager::begin() {
+#if CONFIG_PM_ENABLE
+  for (size_t i = 0; i < kPowerLockCount; ++i) {
+    if (!gLocks[i] && esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0,
+                                         kLockNames[i],
+                                         &gLocks[i]) != ESP_OK) {
+      logPrintf("[pwr] Failed to create PM lock %s\n", kLockNames[i]);
+      gLocks[i] = nullptr;
+    }
+  }
+  if (!gCpuBoostLock && esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "cpu_boost",
+                                           &gCpuBoostLock) != ESP_OK) {
+    logPrintln("[pwr] Failed to create CPU boost lock");
+    gCpuBoostLock = nullptr;
+  }
+#endif
+  cpuStatsSinceUs = esp_timer_get_time();
+  currentProfile = loadStoredProfile();
+  applyProfile(currentProfile);
+
+  tickTaskId = taskScheduler().addPeriodic(
+      "power", [](uint32_t) { powerManager().tick(); }, kIdleTickPeriodMs,
+      TaskPriority::Low);
+  guardTaskId = taskScheduler().addPeriodic(
+      "epoch-guard",
+      [](uint32_t) {
+        if (powerManager().lightSleepActive) {
+          powerManager().acquire(PowerLock::GnssRx);
+        }
+      },
+      static_cast<uint32_t>(epochUs / 1000), TaskPriority::High);
+}
+
+bool PowerManager::setProfile(PowerProfile profile) {
+  if (static_cast<size_t>(profile) >= kPowerProfileCount) {
+    profile = kDefaultPowerProfile;
+  }
+  if (profile == PowerProfile::LightSleep && !lightSleepAvailable()) {
+    logPrintln("[pwr] Light sleep is not available in this build "
+               "(needs CONFIG_PM_ENABLE and tickless idle)");
+    return false;
+  }
+  if (profile == currentProfile) {
+    return false;
+  }
+  currentProfile = profile;
+  persistProfile(profile);
+  applyProfile(profile);
+  return true;
+}
+
+void PowerManager::applyProfile(PowerProfile profile) {
+  bool wantSleep = profile == PowerProfile::LightSleep;
+
+#if CONFIG_PM_ENABLE
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t config = {};
+#else
+  esp_pm_config_esp32c3_t config = {};
+#endif
+  config.max_freq_mhz = kCpuMaxFreqMhz;
+  config.min_freq_mhz = kCpuBaseFreqMhz;
+  config.light_sleep_enable = wantSleep;
+  esp_err_t err = esp_pm_configure(&config);
+  if (err != ESP_OK) {
+    logPrintf("[pwr] esp_pm_configure failed (%d)\n", static_cast<int>(err));
+    wantSleep = false;
+  }
+#endif
+
+  gpio_num_t rxPin = static_cast<gpio_num_t>(GPS_RX);
+  if (wantSleep) {
+    // UART wake-up is not routed for GPIO-matrix pins on the C3, so a low
+    // level (start bit) on RX wakes the core for unexpected traffic.
+    gpio_wakeup_enable(rxPin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+  } else {
+    gpio_wakeup_disable(rxPin);
+  }
+
+  lightSleepActive = wantSleep;
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&gPowerMux);
+  statsSinceUs = now;
+  awakeSinceUs = now;
+  awakeUs = 0;
+  fixLatencySumUs = 0;
+  fixLatencyMaxUs = 0;
+  fixLatencySamples = 0;
+  portEXIT_CRITICAL(&gPowerMux);
+
+  logPrintf("[pwr] Power profile -> %s\n", powerProfileName(profile));
+}
+
+// Boosts nest and come from both the loop task and the NimBLE task (UBX
+// reconfiguration from a BLE write), so the depth lives under gPowerMux.
+void PowerManager::boostCpu() {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&gPowerMux);
+  bool first = boostDepth++ == 0;
+  if (first) {
+    boostSinceUs = now;
+    boostCount++;
+  }
+  portEXIT_CRITICAL(&gPowerMux);
+  if (first) {
+    applyCpuBoost(true);
+  }
+}
+
+void PowerManager::releaseCpuBoost() {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&gPowerMux);
+  bool last = boostDepth > 0 && --boostDepth == 0;
+  if (last) {
+    boostedUs += now - boostSinceUs;
+  }
+  portEXIT_CRITICAL(&gPowerMux);
+  if (last) {
+    applyCpuBoost(false);
+  }
+}
+
+// The first boost and last release of two tasks may reach here in either
+// order. The PM lock counts acquisitions itself; a plain frequency switch
+// is checked against the depth afterwards, so a stale write is undone by
+// the task that made it.
+void PowerManager::applyCpuBoost(bool boosted) {
+#if CONFIG_PM_ENABLE
+  if (gCpuBoostLock) {
+    if (boosted) {
+      esp_pm_lock_acquire(gCpuBoostLock);
+    } else {
+      esp_pm_lock_release(gCpuBoostLock);
+    }
+  }
+#else
+  while (true) {
+    setCpuFrequencyMhz(boosted ? kCpuMaxFreqMhz : kCpuBaseFreqMhz);
+    portENTER_CRITICAL(&gPowerMux);
+    bool wanted = boostDepth > 0;
+    portEXIT_CRITICAL(&gPowerMux);
+    if (wanted == boosted) {
+      break;
+    }
+    boosted = wanted;
+  }
+#endif
+}
+
+void PowerManager::acquire(PowerLock lock) { setHeld(lock, true); }
+
+void PowerManager::release(PowerLock lock) { setHeld(lock, false); }
+
+void PowerManager::setHeld(PowerLock lock, bool held) {
+  size_t index = static_cast<size_t>(lock);
+  if (index >= kPowerLockCount) {
+    return;
+  }
+  uint8_t bit = static_cast<uint8_t>(1u << index);
+  int64_t now = esp_timer_get_time();
+
+  portENTER_CRITICAL(&gPowerMux);
+  uint8_t before = heldMask;
+  if (((before & bit) != 0) == held) {
+    portEXIT_CRITICAL(&gPowerMux);
+    return;
+  }
+  uint8_t after = held ? (before | bit) : (before & ~bit);
+  heldMask = after;
+  if (before == 0 && after != 0) {
+    awakeSinceUs = now;
+  } else if (before != 0 && after == 0) {
+    awakeUs += now - awakeSinceUs;
+  }
+  portEXIT_CRITICAL(&gPowerMux);
+
+  if (lock == PowerLock::GnssRx && held) {
+    gnssHeldSinceUs = now;
+    taskScheduler().setPeriod(tickTaskId, kBusyTickPeriodMs);
+  }
+#if CONFIG_PM_ENABLE
+  if (gLocks[index]) {
+    if (held) {
+      esp_pm_lock_acquire(gLocks[index]);
+    } else {
+      esp_pm_lock_release(gLocks[index]);
+    }
+  }
+#endif
+}
+
+void PowerManager::noteGnssActivity() {
+  int64_t now = esp_timer_get_time();
+  if (now - lastActivityUs > kBurstGapUs) {
+    burstStartUs = now;
+  }
+  lastActivityUs = now;
+  if (lightSleepActive &&
+      !(heldMask & (1u << static_cast<uint8_t>(PowerLock::GnssRx)))) {
+    acquire(PowerLock::GnssRx);
+  }
+}
+
+void IRAM_ATTR PowerManager::notePpsEdge() {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&gPowerMux);
+  lastPpsUs = now;
+  ppsAwaitingFix = true;
+  portEXIT_CRITICAL_ISR(&gPowerMux);
+}
+
+void PowerManager::noteFixDelivered() {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&gPowerMux);
+  bool pending = ppsAwaitingFix;
+  int64_t pps = lastPpsUs;
+  ppsAwaitingFix = false;
+  portEXIT_CRITICAL(&gPowerMux);
+  if (!pending) {
+    return;
+  }
+  int64_t latency = now - pps;
+  if (latency < 0 || latency > kFixLatencyWindowUs) {
+    return;
+  }
+  fixLatencySumUs += static_cast<uint64_t>(latency);
+  fixLatencySamples++;
+  if (static_cast<uint32_t>(latency) > fixLatencyMaxUs) {
+    fixLatencyMaxUs = static_cast<uint32_t>(latency);
+  }
+}
+
+void PowerManager::tick() {
+  int64_t now = esp_timer_get_time();
+  setHeld(PowerLock::Wifi, wifiNeedsRadio());
+
+  portENTER_CRITICAL(&gPowerMux);
+  int64_t pps = lastPpsUs;
+  portEXIT_CRITICAL(&gPowerMux);
+
+  int64_t anchor = (pps != 0 && now - pps < kPpsValidUs) ? pps : burstStartUs;
+  if (anchor != 0 && anchor != epochAnchorUs) {
+    if (epochAnchorUs != 0) {
+      int64_t interval = anchor - epochAnchorUs;
+      if (interval >= kMinEpochUs && interval <= kMaxEpochUs) {
+        epochUs = static_cast<uint32_t>((epochUs * 3 + interval) / 4);
+      }
+    }
+    epochAnchorUs = anchor;
+    armEpochGuard();
+  }
+
+  bool rxHeld = heldMask & (1u << static_cast<uint8_t>(PowerLock::GnssRx));
+  if (!rxHeld) {
+    return;
+  }
+  if (!lightSleepActive) {
+    release(PowerLock::GnssRx);
+  } else if (now - gnssHeldSinceUs >= kRxHoldMinUs &&
+             now - lastActivityUs >= kRxQuietUs) {
+    release(PowerLock::GnssRx);
+  } else {
+    return;
+  }
+  taskScheduler().setPeriod(tickTaskId, kIdleTickPeriodMs);
+}
+
+void PowerManager::armEpochGuard() {
+  if (!lightSleepActive || guardTaskId < 0) {
+    return;
+  }
+  int64_t now = esp_timer_get_time();
+  int64_t target = epochAnchorUs + epochUs - kEpochGuardUs;
+  while (target <= now) {
+    target += epochUs;
+  }
+  taskScheduler().setPeriod(guardTaskId, epochUs / 1000);
+  taskScheduler().postpone(guardTaskId,
+                           static_cast<uint32_t>((target - now) / 1000));
+}
+
+PowerStats PowerManager::stats() const {
+  PowerStats result;
+  result.profile = currentProfile;
+  result.lightSleepActive = lightSleepActive;
+  result.lightSleepAvailable = lightSleepAvailable();
+  result.epochMs = epochUs / 1000;
+
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&gPowerMux);
+  int64_t elapsed = now - statsSinceUs;
+  int64_t awake = awakeUs + (heldMask ? now - awakeSinceUs : 0);
+  portEXIT_CRITICAL(&gPowerMux);
+
+  uint16_t permille = 1000;
+  if (lightSleepActive && elapsed > 0) {
+    int64_t value = awake * 1000 / elapsed;
+    permille = static_cast<uint16_t>(value > 1000 ? 1000 : value);
+  }
+  result.awakePermille = permille;
+  result.estimatedCurrentMa =
+      kLightSleepCurrentMa +
+      (kActiveCurrentMa - kLightSleepCurrentMa) * (permille / 1000.0f);
+
+  result.fixLatencySamples = fixLatencySamples;
+  result.fixLatencyMaxMs = fixLatencyMaxUs / 1000;
+  if (fixLatencySamples > 0) {
+    result.fixLatencyAvgMs =
+        static_cast<uint32_t>(fixLatencySumUs / fixLatencySamples / 1000);
+  }
+  return result;
+}
+
+CpuFreqStats PowerManager::cpuStats() const {
+  CpuFreqStats result;
+  result.maxMhz = kCpuMaxFreqMhz;
+  result.baseMhz = kCpuBaseFreqMhz;
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&gPowerMux);
+  result.boosts = boostCount;
+  int64_t boosted = boostedUs + (boostDepth > 0 ? now - boostSinceUs : 0);
+  portEXIT_CRITICAL(&gPowerMux);
+  int64_t total = now - cpuStatsSinceUs;
+  result.boostMs = static_cast<uint32_t>(boosted / 1000);
+  result.baseMs =
+      total > boosted ? static_cast<uint32_t>((total - boosted) / 1000) : 0;
+  return result;
+}
+
+PowerProfile PowerManager::loadStoredProfile() {
+  Preferences prefs;
+  uint8_t stored = static_cast<uint8_t>(kDefaultPowerProfile);
+  if (prefs.begin(kPowerPrefsNamespace, true)) {
+    stored = prefs.getUChar(kPowerProfileKey, stored);
+    prefs.end();
+  }
+  // A light-sleep choice saved by a build that had it is not carried over.
+  if (stored >= kPowerProfileCount ||
+      (stored == static_cast<uint8_t>(PowerProfile::LightSleep) &&
+       !lightSleepAvailable())) {
+    stored = static_cast<uint8_t>(kDefaultPowerProfile);
+  }
+  return static_cast<PowerProfile>(stored);
+}
+
+void PowerManager::persistProfile(PowerProfile profile) {
+  Preferences prefs;
+  if (prefs.begin(kPowerPrefsNamespace, false)) {
+    prefs.putUChar(kPowerProfileKey, static_cast<uint8_t>(profile));
+    prefs.end();
+  }
+}
@@ -0,0 +1,158 @@
+#include "satellite_table.h"
+
+namespace {
+constexpr uint8_t kMaxCno = 0x7F;
+constexpr uint8_t kMaxElevation = 90;
+constexpr uint16_t kFullCircle = 360;
+// Same thresholds as the status LED and BLE signal histogram.
+constexpr uint8_t kStrongCno = 30;
+constexpr uint8_t kMediumCno = 20;
+} // namespace
+
+void SatelliteTable::clear() {
+  for (size_t i = 0; i < kSatelliteTableSize; ++i) {
+    keys[i] = 0;
+  }
+  count = 0;
+}
+
+size_t SatelliteTable::home(uint16_t key) {
+  // Fibonacci hashing; svIds are dense per constellation.
+  return static_cast<uint16_t>(key * 40503u) >> 10;
+}
+
+size_t SatelliteTable::slotOf(uint16_t key) const {
+  size_t start = home(key);
+  size_t slot = start;
+  while (keys[slot] != 0) {
+    if (keys[slot] == key) {
+      return slot;
+    }
+    slot = (slot + 1) % kSatelliteTableSize;
+    if (slot == start) {
+      break;
+    }
+  }
+  return kSatelliteTableSize;
+}
+
+bool SatelliteTable::update(const SatelliteRecord &record, uint32_t nowS) {
+  if (record.svId == 0) {
+    return false;
+  }
+  uint16_t key = static_cast<uint16_t>(record.gnssId << 8 | record.svId);
+  size_t slot = home(key);
+  while (keys[slot] != 0 && keys[slot] != key) {
+    slot = (slot + 1) % kSatelliteTableSize;
+    if (slot == home(key)) {
+      return false; // full
+    }
+  }
+  if (keys[slot] == 0) {
+    // Keep one slot free so probing always terminates.
+    if (count + 1u >= kSatelliteTableSize) {
+      return false;
+    }
+    keys[slot] = key;
+    count++;
+  }
+  uint8_t cno = record.cno > kMaxCno ? kMaxCno : record.cno;
+  uint8_t elevation =
+      record.elevation > kMaxElevation ? kMaxElevation : record.elevation;
+  uint16_t azimuth = record.azimuth % kFullCircle;
+  signal[slot] = static_cast<uint8_t>(cno | (record.used ? kUsedFlag : 0));
+  position[slot] =
+      static_cast<uint16_t>(elevation << kElevationShift | azimuth);
+  seen[slot] = static_cast<uint8_t>(nowS);
+  return true;
+}
+
+void SatelliteTable::removeSlot(size_t slot) {
+  keys[slot] = 0;
+  count--;
+  // Backward-shift: pull later members of the probe chain into the hole.
+  size_t hole = slot;
+  size_t next = (slot + 1) % kSatelliteTableSize;
+  while (keys[next] != 0) {
+    size_t want = home(keys[next]);
+    bool movable = hole <= next ? (want <= hole || want > next)
+                                : (want <= hole && want > next);
+    if (movable) {
+      keys[hole] = keys[next];
+      signal[hole] = signal[next];
+      position[hole] = position[next];
+      seen[hole] = seen[next];
+      keys[next] = 0;
+      hole = next;
+    }
+    next = (next + 1) % kSatelliteTableSize;
+  }
+}
+
+bool SatelliteTable::remove(uint8_t gnssId, uint8_t svId) {
+  size_t slot = slotOf(static_cast<uint16_t>(gnssId << 8 | svId));
+  if (slot == kSatelliteTableSize) {
+    return false;
+  }
+  removeSlot(slot);
+  return true;
+}
+
+void SatelliteTable::expire(uint32_t nowS, uint8_t maxAgeS) {
+  uint8_t now = static_cast<uint8_t>(nowS);
+  size_t slot = 0;
+  while (slot < kSatelliteTableSize) {
+    if (keys[slot] != 0 && static_cast<uint8_t>(now - seen[slot]) > maxAgeS) {
+      // The shift may move an unchecked entry into this slot.
+      removeSlot(slot);
+      continue;
+    }
+    slot++;
+  }
+}
+
+size_t SatelliteTable::usedCount() const {
+  size_t used = 0;
+  for (size_t i = 0; i < kSatelliteTableSize; ++i) {
+    if (keys[i] != 0 && (signal[i] & kUsedFlag) != 0) {
+      used++;
+    }
+  }
+  return used;
+}
+
+SignalLevelCounts SatelliteTable::signalLevels() const {
+  SignalLevelCounts levels;
+  for (size_t i = 0; i < kSatelliteTableSize; ++i) {
+    if (keys[i] == 0 || (signal[i] & kUsedFlag) == 0) {
+      continue;
+    }
+    uint8_t cno = signal[i] & kCnoMask;
+    if (cno > kStrongCno) {
+      levels.strong++;
+    } else if (cno >= kMediumCno) {
+      levels.medium++;
+    } else {
+      levels.weak++;
+    }
+  }
+  return levels;
+}
+
+bool SatelliteTable::find(uint8_t gnssId, uint8_t svId,
+                          SatelliteRecord &out) const {
+  return at(slotOf(static_cast<uint16_t>(gnssId << 8 | svId)), out);
+}
+
+bool SatelliteTable::at(size_t slot, SatelliteRecord &out) const {
+  if (slot >= kSatelliteTableSize || keys[slot] == 0) {
+    return false;
+  }
+  out.gnssId = static_cast<uint8_t>(keys[slot] >> 8);
+  out.svId = static_cast<uint8_t>(keys[slot]);
+  out.cno = signal[slot] & kCnoMask;
+  out.used = (signal[slot] & kUsedFlag) != 0;
+  out.elevation = static_cast<uint8_t>(position[slot] >> kElevationShift);
+  out.azimuth = position[slot] & kAzimuthMask;
+  return true;
+}
@@ -0,0 +1,138 @@
+#include "sky_view.h"
+
+namespace {
+constexpr uint8_t kGnssMask = 0x0F;
+constexpr uint8_t kRemovedBit = 0x20;
+constexpr uint8_t kAzimuthHighBit = 0x40;
+constexpr uint8_t kUsedBit = 0x80;
+
+void writeRecord(uint8_t *out, const SatelliteRecord &sat, bool removed) {
+  uint8_t first = sat.gnssId & kGnssMask;
+  if (removed) {
+    first |= kRemovedBit;
+  } else {
+    if (sat.azimuth > 0xFF) {
+      first |= kAzimuthHighBit;
+    }
+    if (sat.used) {
+      first |= kUsedBit;
+    }
+  }
+  out[0] = first;
+  out[1] = sat.svId;
+  out[2] = removed ? 0 : sat.elevation;
+  out[3] = removed ? 0 : static_cast<uint8_t>(sat.azimuth & 0xFF);
+  out[4] = removed ? 0 : sat.cno;
+}
+
+void writeHeader(uint8_t *out, uint8_t flags, uint8_t sequence,
+                 uint8_t count) {
+  out[0] = kSkyViewVersion;
+  out[1] = flags;
+  out[2] = sequence;
+  out[3] = count;
+}
+
+bool changed(const SatelliteRecord &now, const SatelliteRecord &was) {
+  if (now.used != was.used || now.elevation != was.elevation ||
+      now.azimuth != was.azimuth) {
+    return true;
+  }
+  uint8_t delta = now.cno > was.cno ? now.cno - was.cno : was.cno - now.cno;
+  return delta >= SkyViewEncoder::kCnoDeadbandDb;
+}
+} // namespace
+
+void SkyViewEncoder::requestKeyframe() { resetPending = true; }
+
+size_t SkyViewEncoder::nextFrame(const SatelliteTable &current, uint8_t *out,
+                                 size_t maxLength) {
+  if (maxLength < kSkyViewHeaderSize + kSkyViewRecordSize) {
+    return 0;
+  }
+  uint8_t flags = 0;
+  if (resetPending) {
+    // Everything current is then "new" to the client.
+    sent.clear();
+    resetPending = false;
+    flags |= kSkyViewFlagReset;
+  }
+  size_t length = kSkyViewHeaderSize;
+  uint8_t count = 0;
+  bool full = false;
+
+  SatelliteRecord sat;
+  SatelliteRecord was;
+  // Removals go first: they free the slots in `sent` that new satellites
+  // need once the table runs near capacity.
+  size_t slot = 0;
+  while (slot < sent.capacity()) {
+    if (!sent.at(slot, was) || current.find(was.gnssId, was.svId, sat)) {
+      slot++;
+      continue;
+    }
+    if (length + kSkyViewRecordSize > maxLength) {
+      full = true;
+      break;
+    }
+    writeRecord(out + length, was, true);
+    length += kSkyViewRecordSize;
+    count++;
+    // The backward shift may pull an unchecked entry into this slot.
+    sent.remove(was.gnssId, was.svId);
+  }
+  for (size_t i = 0; !full && i < current.capacity(); ++i) {
+    if (!current.at(i, sat)) {
+      continue;
+    }
+    if (sent.find(sat.gnssId, sat.svId, was) && !changed(sat, was)) {
+      continue;
+    }
+    if (length + kSkyViewRecordSize > maxLength) {
+      full = true;
+      break;
+    }
+    // A record the encoder cannot remember would never be taken back.
+    if (!sent.update(sat, 0)) {
+      full = true;
+      break;
+    }
+    writeRecord(out + length, sat, false);
+    length += kSkyViewRecordSize;
+    count++;
+  }
+
+  if (count == 0 && (flags & kSkyViewFlagReset) == 0) {
+    return 0;
+  }
+  if (full) {
+    flags |= kSkyViewFlagMore;
+  }
+  writeHeader(out, flags, sequence++, count);
+  frames++;
+  bytes += length;
+  return length;
+}
+
+size_t SkyViewEncoder::snapshot(const SatelliteTable &current, uint8_t *out,
+                                size_t maxLength) {
+  if (maxLength < kSkyViewHeaderSize) {
+    return 0;
+  }
+  size_t length = kSkyViewHeaderSize;
+  uint8_t count = 0;
+  SatelliteRecord sat;
+  for (size_t i = 0; i < current.capacity(); ++i) {
+    if (!current.at(i, sat)) {
+      continue;
+    }
+    if (length + kSkyViewRecordSize > maxLength) {
+      break;
+    }
+    writeRecord(out + length, sat, false);
+    length += kSkyViewRecordSize;
+    count++;
+  }
+  writeHeader(out, kSkyViewFlagReset, 0, count);
+  return length;
+}
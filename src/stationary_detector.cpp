@@ -0,0 +1,166 @@
+#include "stationary_detector.h"
+
+#include <math.h>
+
+namespace {
+constexpr float kMetersPerDegLat = 111195.0f;
+constexpr float kDegToRad = static_cast<float>(M_PI / 180.0);
+// Slower than this for the whole window is a candidate for a hold; one fix
+// faster than the release speed ends it.
+constexpr float kHoldSpeedMs = 0.3f;
+constexpr float kReleaseSpeedMs = 1.0f;
+// Window scatter must stay within the fix accuracy, but not below this.
+constexpr float kMinSpreadM = 2.0f;
+constexpr float kUnknownAccuracyM = 5.0f;
+// A fix this far from the frozen position (or 2x accuracy) releases it.
+constexpr float kMinReleaseM = 8.0f;
+constexpr uint8_t kMinWindowFixes = 3;
+} // namespace
+
+void StationaryDetector::reset(uint32_t nowMs) {
+  if (held) {
+    release(nowMs);
+  }
+  count = 0;
+  head = 0;
+  slow = false;
+  haveOrigin = false;
+}
+
+void StationaryDetector::release(uint32_t nowMs) {
+  heldTotalMs += nowMs - heldSinceMs;
+  held = false;
+  count = 0;
+  head = 0;
+  slow = false;
+  haveOrigin = false;
+}
+
+bool StationaryDetector::update(NavDataSample &sample, uint32_t nowMs) {
+  if (!haveOrigin) {
+    originLatitude = sample.latitude;
+    originLongitude = sample.longitude;
+    metersPerDegLon = kMetersPerDegLat *
+                      cosf(static_cast<float>(sample.latitude) * kDegToRad);
+    haveOrigin = true;
+  }
+  // Offsets from a nearby origin are small, so float is plenty for them.
+  float north =
+      static_cast<float>(sample.latitude - originLatitude) * kMetersPerDegLat;
+  float east =
+      static_cast<float>(sample.longitude - originLongitude) * metersPerDegLon;
+
+  if (held) {
+    float dEast = east - heldEast;
+    float dNorth = north - heldNorth;
+    float distance = sqrtf(dEast * dEast + dNorth * dNorth);
+    if (sample.speed < kReleaseSpeedMs && distance < releaseRadius) {
+      sample.latitude = heldLatitude;
+      sample.longitude = heldLongitude;
+      sample.altitude = heldAltitude;
+      sample.heading = heldHeading;
+      sample.speed = 0.0f;
+      sample.stationary = true;
+      heldFixCount++;
+      return true;
+    }
+    release(nowMs);
+    return update(sample, nowMs);
+  }
+
+  if (sample.speed >= kHoldSpeedMs) {
+    heldHeading = sample.heading;
+    count = 0;
+    head = 0;
+    slow = false;
+    haveOrigin = false;
+    return false;
+  }
+
+  Entry &entry = entries[head];
+  entry.timeMs = nowMs;
+  entry.east = east;
+  entry.north = north;
+  entry.altitude = sample.altitude;
+  head = static_cast<uint8_t>((head + 1) % kWindowSize);
+  if (count < kWindowSize) {
+    count++;
+  }
+  if (!slow) {
+    slow = true;
+    slowSinceMs = nowMs;
+  }
+  if (nowMs - slowSinceMs < windowMs || count < kMinWindowFixes) {
+    return false;
+  }
+  float accuracy = sample.horizontalAccuracy > 0.0f
+                       ? sample.horizontalAccuracy
+                       : kUnknownAccuracyM;
+  if (!tryHold(nowMs, accuracy)) {
+    return false;
+  }
+  return update(sample, nowMs);
+}
+
+bool StationaryDetector::tryHold(uint32_t nowMs, float accuracy) {
+  float sumEast = 0.0f;
+  float sumNorth = 0.0f;
+  float sumAltitude = 0.0f;
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < count; ++i) {
+    const Entry &entry = entries[i];
+    if (nowMs - entry.timeMs > windowMs) {
+      continue;
+    }
+    sumEast += entry.east;
+    sumNorth += entry.north;
+    sumAltitude += entry.altitude;
+    used++;
+  }
+  if (used < kMinWindowFixes) {
+    return false;
+  }
+  float meanEast = sumEast / used;
+  float meanNorth = sumNorth / used;
+  float sumSq = 0.0f;
+  for (uint8_t i = 0; i < count; ++i) {
+    const Entry &entry = entries[i];
+    if (nowMs - entry.timeMs > windowMs) {
+      continue;
+    }
+    float dEast = entry.east - meanEast;
+    float dNorth = entry.north - meanNorth;
+    sumSq += dEast * dEast + dNorth * dNorth;
+  }
+  float spread = sqrtf(sumSq / used);
+  float limit = accuracy > kMinSpreadM ? accuracy : kMinSpreadM;
+  if (spread > limit) {
+    return false;
+  }
+
+  held = true;
+  heldSinceMs = nowMs;
+  heldEast = meanEast;
+  heldNorth = meanNorth;
+  heldLatitude = originLatitude + meanNorth / kMetersPerDegLat;
+  heldLongitude = originLongitude;
+  if (metersPerDegLon > 1.0f) {
+    heldLongitude += meanEast / metersPerDegLon;
+  }
+  heldAltitude = sumAltitude / used;
+  releaseRadius = 2.0f * accuracy > kMinReleaseM ? 2.0f * accuracy
+                                                  : kMinReleaseM;
+  lastSpread = spread;
+  holdCount++;
+  return true;
+}
+
+StationaryStats StationaryDetector::stats(uint32_t nowMs) const {
+  StationaryStats result;
+  result.holding = held;
+  result.holds = holdCount;
+  result.heldFixes = heldFixCount;
+  result.heldMs = heldTotalMs + (held ? nowMs - heldSinceMs : 0);
+  result.spreadM = lastSpread;
+  return result;
+}
@@ -0,0 +1,261 @@
+#include "task_scheduler.h"
+
+#include "logger.h"
+
+namespace {
+constexpr uint32_t kMaxIdleMs = 1000;
+constexpr uint32_t kLoadWindowMs = 1000;
+portMUX_TYPE gTriggerMux = portMUX_INITIALIZER_UNLOCKED;
+
+inline bool deadlineReached(uint32_t deadline, uint32_t now) {
+  return static_cast<int32_t>(deadline - now) <= 0;
+}
+} // namespace
+
+TaskScheduler &taskScheduler() {
+  static TaskScheduler instance;
+  return instance;
+}
+
+void TaskScheduler::begin() {
+  waiter = xTaskGetCurrentTaskHandle();
+  windowStartMs = millis();
+  windowBusyUs = 0;
+  loadPermille = 0;
+}
+
+int8_t TaskScheduler::addPeriodic(const char *name, TaskCallback callback,
+                                  uint32_t periodMs, TaskPriority priority,
+                                  uint32_t firstDelayMs) {
+  if (periodMs == 0) {
+    periodMs = 1;
+  }
+  return allocate(name, callback, firstDelayMs, periodMs, priority);
+}
+
+int8_t TaskScheduler::addOneShot(const char *name, TaskCallback callback,
+                                 uint32_t delayMs, TaskPriority priority) {
+  return allocate(name, callback, delayMs, 0, priority);
+}
+
+int8_t TaskScheduler::allocate(const char *name, TaskCallback callback,
+                               uint32_t delayMs, uint32_t periodMs,
+                               TaskPriority priority) {
+  if (!callback) {
+    return kInvalidTaskId;
+  }
+  for (size_t i = 0; i < kMaxScheduledTasks; ++i) {
+    Task &task = tasks[i];
+    if (task.used) {
+      continue;
+    }
+    task = Task{};
+    task.name = name;
+    task.callback = callback;
+    task.periodMs = periodMs;
+    task.priority = priority;
+    task.deadline = millis() + delayMs;
+    task.used = true;
+    wake();
+    return static_cast<int8_t>(i);
+  }
+  logPrintf("[sched] No free slot for task '%s'\n", name ? name : "?");
+  return kInvalidTaskId;
+}
+
+void TaskScheduler::cancel(int8_t id) {
+  if (id < 0 || static_cast<size_t>(id) >= kMaxScheduledTasks) {
+    return;
+  }
+  tasks[id].used = false;
+  portENTER_CRITICAL(&gTriggerMux);
+  triggeredMask &= ~(1UL << id);
+  portEXIT_CRITICAL(&gTriggerMux);
+}
+
+void TaskScheduler::setPeriod(int8_t id, uint32_t periodMs) {
+  if (id < 0 || static_cast<size_t>(id) >= kMaxScheduledTasks ||
+      !tasks[id].used || tasks[id].periodMs == 0) {
+    return;
+  }
+  if (periodMs == 0) {
+    periodMs = 1;
+  }
+  if (tasks[id].periodMs == periodMs) {
+    return;
+  }
+  Task &task = tasks[id];
+  uint32_t now = millis();
+  uint32_t candidate = now + periodMs;
+  if (static_cast<int32_t>(candidate - task.deadline) < 0) {
+    task.deadline = candidate;
+  }
+  task.periodMs = periodMs;
+  wake();
+}
+
+void TaskScheduler::postpone(int8_t id, uint32_t delayMs) {
+  if (id < 0 || static_cast<size_t>(id) >= kMaxScheduledTasks ||
+      !tasks[id].used) {
+    return;
+  }
+  tasks[id].deadline = millis() + delayMs;
+}
+
+void TaskScheduler::trigger(int8_t id) {
+  if (id < 0 || static_cast<size_t>(id) >= kMaxScheduledTasks) {
+    return;
+  }
+  portENTER_CRITICAL(&gTriggerMux);
+  triggeredMask |= (1UL << id);
+  portEXIT_CRITICAL(&gTriggerMux);
+  wake();
+}
+
+void IRAM_ATTR TaskScheduler::triggerFromIsr(int8_t id) {
+  if (id < 0 || static_cast<size_t>(id) >= kMaxScheduledTasks) {
+    return;
+  }
+  portENTER_CRITICAL_ISR(&gTriggerMux);
+  triggeredMask |= (1UL << id);
+  portEXIT_CRITICAL_ISR(&gTriggerMux);
+  wakeFromIsr();
+}
+
+void TaskScheduler::wake() {
+  if (waiter && waiter != xTaskGetCurrentTaskHandle()) {
+    xTaskNotifyGive(waiter);
+  }
+}
+
+void IRAM_ATTR TaskScheduler::wakeFromIsr() {
+  if (!waiter) {
+    return;
+  }
+  BaseType_t higherPriorityWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(waiter, &higherPriorityWoken);
+  portYIELD_FROM_ISR(higherPriorityWoken);
+}
+
+uint32_t TaskScheduler::dispatch() {
+  uint32_t now = millis();
+
+  portENTER_CRITICAL(&gTriggerMux);
+  uint32_t triggered = triggeredMask;
+  triggeredMask = 0;
+  portEXIT_CRITICAL(&gTriggerMux);
+
+  uint32_t dueMask = triggered;
+  for (size_t i = 0; i < kMaxScheduledTasks; ++i) {
+    if (tasks[i].used && deadlineReached(tasks[i].deadline, now)) {
+      dueMask |= (1UL << i);
+    }
+  }
+
+  // Every due job runs once per pass, highest priority first, so a busy
+  // high-priority job cannot starve the rest of the table.
+  for (uint8_t prio = static_cast<uint8_t>(TaskPriority::High);
+       prio <= static_cast<uint8_t>(TaskPriority::Low); ++prio) {
+    for (size_t i = 0; i < kMaxScheduledTasks; ++i) {
+      if (!(dueMask & (1UL << i)) || !tasks[i].used ||
+          static_cast<uint8_t>(tasks[i].priority) != prio) {
+        continue;
+      }
+      runTask(i, now);
+    }
+  }
+
+  now = millis();
+  uint32_t waitMs = kMaxIdleMs;
+  for (size_t i = 0; i < kMaxScheduledTasks; ++i) {
+    if (!tasks[i].used) {
+      continue;
+    }
+    if (deadlineReached(tasks[i].deadline, now)) {
+      return 0;
+    }
+    uint32_t remaining = tasks[i].deadline - now;
+    if (remaining < waitMs) {
+      waitMs = remaining;
+    }
+  }
+  return waitMs;
+}
+
+void TaskScheduler::runTask(size_t index, uint32_t now) {
+  Task &task = tasks[index];
+  uint32_t late = deadlineReached(task.deadline, now) ? now - task.deadline : 0;
+  if (late > task.maxLateMs) {
+    task.maxLateMs = late;
+  }
+
+  if (task.periodMs > 0) {
+    task.deadline += task.periodMs;
+    if (deadlineReached(task.deadline, now)) {
+      // Overran by more than a period: skip the missed slots.
+      task.deadline = now + task.periodMs;
+    }
+  } else {
+    task.used = false;
+  }
+
+  TaskCallback callback = task.callback;
+  uint32_t startUs = micros();
+  callback(now);
+  uint32_t elapsedUs = micros() - startUs;
+
+  if (task.callback == callback) {
+    task.runs++;
+    if (elapsedUs > task.maxRunUs) {
+      task.maxRunUs = elapsedUs;
+    }
+  }
+  accountBusy(elapsedUs);
+}
+
+void TaskScheduler::accountBusy(uint32_t busyUs) {
+  windowBusyUs += busyUs;
+  uint32_t now = millis();
+  uint32_t elapsed = now - windowStartMs;
+  if (elapsed < kLoadWindowMs) {
+    return;
+  }
+  uint32_t permille = windowBusyUs / elapsed;
+  loadPermille = static_cast<uint16_t>(permille > 1000 ? 1000 : permille);
+  windowBusyUs = 0;
+  windowStartMs = now;
+}
+
+void TaskScheduler::idle(uint32_t maxWaitMs) {
+  if (maxWaitMs == 0) {
+    return;
+  }
+  if (maxWaitMs > kMaxIdleMs) {
+    maxWaitMs = kMaxIdleMs;
+  }
+  if (!waiter) {
+    delay(1);
+    return;
+  }
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(maxWaitMs));
+  wakeups++;
+}
+
+SchedulerStats TaskScheduler::stats() const {
+  SchedulerStats result;
+  result.loadPermille = loadPermille;
+  result.wakeups = wakeups;
+  for (size_t i = 0; i < kMaxScheduledTasks; ++i) {
+    const Task &task = tasks[i];
+    if (!task.used || result.taskCount >= kMaxScheduledTasks) {
+      continue;
+    }
+    ScheduledTaskStats &entry = result.tasks[result.taskCount++];
+    entry.name = task.name;
+    entry.periodMs = task.periodMs;
+    entry.runs = task.runs;
+    entry.maxRunUs = task.maxRunUs;
+    entry.maxLateMs = task.maxLateMs;
+  }
+  return result;
+}
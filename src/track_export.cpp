@@ -0,0 +1,288 @@
+#include "track_export.h"
+
+#include "track_recorder.h"
+
+#include <LittleFS.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+constexpr double kKnotsPerCms = 0.0194384;
+
+const char kGpxHeader[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<gpx version=\"1.1\" creator=\"ublox-gps-ble\" "
+    "xmlns=\"http://www.topografix.com/GPX/1/1\">\n";
+const char kGpxFooter[] = "</trkseg></trk>\n</gpx>\n";
+
+bool hasUtc(const TrackFix &fix) {
+  return (fix.flags & kTrackFlagLocalTime) == 0;
+}
+
+void utcParts(const TrackFix &fix, tm &parts, unsigned &milliseconds) {
+  time_t seconds = static_cast<time_t>(fix.timeMs / 1000);
+  milliseconds = static_cast<unsigned>(fix.timeMs % 1000);
+  gmtime_r(&seconds, &parts);
+}
+
+// ddmm.mmmmm / dddmm.mmmmm plus hemisphere, as NMEA wants it.
+int formatNmeaAngle(char *out, size_t size, int32_t e7, bool latitude) {
+  char hemisphere = latitude ? (e7 < 0 ? 'S' : 'N') : (e7 < 0 ? 'W' : 'E');
+  uint32_t magnitude = static_cast<uint32_t>(e7 < 0 ? -static_cast<int64_t>(e7)
+                                                    : e7);
+  uint32_t degrees = magnitude / 10000000UL;
+  uint32_t minutesE5 = (magnitude % 10000000UL) * 60UL / 100UL;
+  return snprintf(out, size, latitude ? "%02lu%02lu.%05lu,%c"
+                                      : "%03lu%02lu.%05lu,%c",
+                  static_cast<unsigned long>(degrees),
+                  static_cast<unsigned long>(minutesE5 / 100000UL),
+                  static_cast<unsigned long>(minutesE5 % 100000UL),
+                  hemisphere);
+}
+
+// Appends "*CS\r\n" to a sentence starting with '$'.
+size_t finishSentence(char *sentence, size_t length, size_t size) {
+  uint8_t checksum = 0;
+  for (size_t i = 1; i < length; ++i) {
+    checksum ^= static_cast<uint8_t>(sentence[i]);
+  }
+  int added = snprintf(sentence + length, size - length, "*%02X\r\n",
+                       checksum);
+  return added > 0 ? length + static_cast<size_t>(added) : length;
+}
+} // namespace
+
+bool parseTrackExportName(const char *name, uint32_t &id,
+                          TrackExportFormat &format) {
+  char *end = nullptr;
+  unsigned long value = strtoul(name, &end, 10);
+  if (end == name) {
+    return false;
+  }
+  if (strcmp(end, ".gpx") == 0) {
+    format = TrackExportFormat::Gpx;
+  } else if (strcmp(end, ".nmea") == 0) {
+    format = TrackExportFormat::Nmea;
+  } else if (strcmp(end, ".bin") == 0) {
+    format = TrackExportFormat::Binary;
+  } else {
+    return false;
+  }
+  id = static_cast<uint32_t>(value);
+  return true;
+}
+
+const char *trackExportContentType(TrackExportFormat format) {
+  switch (format) {
+  case TrackExportFormat::Gpx:
+    return "application/gpx+xml";
+  case TrackExportFormat::Nmea:
+    return "text/plain";
+  case TrackExportFormat::Binary:
+    return "application/octet-stream";
+  }
+  return "application/octet-stream";
+}
+
+const char *trackExportExtension(TrackExportFormat format) {
+  switch (format) {
+  case TrackExportFormat::Gpx:
+    return "gpx";
+  case TrackExportFormat::Nmea:
+    return "nmea";
+  case TrackExportFormat::Binary:
+    return "trk";
+  }
+  return "bin";
+}
+
+bool TrackExportStream::open(uint32_t id, TrackExportFormat format) {
+  close();
+  file = LittleFS.open(trackFilePath(id), FILE_READ);
+  if (!file) {
+    return false;
+  }
+  if (format != TrackExportFormat::Binary) {
+    uint8_t header[kTrackFileHeaderSize];
+    if (file.read(header, sizeof(header)) != sizeof(header) ||
+        !readTrackFileHeader(header, sizeof(header), nullptr)) {
+      file.close();
+      return false;
+    }
+  }
+  opened = true;
+  trackId = id;
+  formatValue = format;
+  stage = Stage::Header;
+  payloadLength = 0;
+  payloadOffset = 0;
+  lineLength = 0;
+  lineOffset = 0;
+  fixCount = 0;
+  return true;
+}
+
+void TrackExportStream::close() {
+  if (file) {
+    file.close();
+  }
+  opened = false;
+}
+
+size_t TrackExportStream::read(uint8_t *out, size_t capacity) {
+  if (!opened) {
+    return 0;
+  }
+  if (formatValue == TrackExportFormat::Binary) {
+    return file.read(out, capacity);
+  }
+  size_t written = 0;
+  while (written < capacity) {
+    if (lineOffset == lineLength) {
+      if (stage == Stage::Done) {
+        break;
+      }
+      formatNext();
+      continue;
+    }
+    size_t chunk = lineLength - lineOffset;
+    if (chunk > capacity - written) {
+      chunk = capacity - written;
+    }
+    memcpy(out + written, line + lineOffset, chunk);
+    lineOffset += chunk;
+    written += chunk;
+  }
+  return written;
+}
+
+bool TrackExportStream::loadBlock() {
+  uint8_t header[kTrackBlockHeaderSize];
+  while (file.read(header, sizeof(header)) == sizeof(header)) {
+    TrackBlockHeader block;
+    if (!readTrackBlockHeader(header, block)) {
+      // Lost framing; step one byte past the bad sync and look again.
+      file.seek(file.position() - sizeof(header) + 1);
+      continue;
+    }
+    if (file.read(payload, block.payloadLength) != block.payloadLength) {
+      return false;
+    }
+    if (trackCrc32(payload, block.payloadLength) != block.crc) {
+      continue;
+    }
+    payloadLength = block.payloadLength;
+    payloadOffset = 0;
+    decoder.beginBlock();
+    return true;
+  }
+  return false;
+}
+
+bool TrackExportStream::nextFix(TrackFix &fix) {
+  for (;;) {
+    if (payloadOffset < payloadLength &&
+        decoder.decode(payload, payloadLength, payloadOffset, fix)) {
+      return true;
+    }
+    if (!loadBlock()) {
+      return false;
+    }
+  }
+}
+
+void TrackExportStream::formatNext() {
+  lineLength = 0;
+  lineOffset = 0;
+  switch (stage) {
+  case Stage::Header:
+    stage = Stage::Fixes;
+    if (formatValue == TrackExportFormat::Gpx) {
+      int length = snprintf(line, sizeof(line),
+                            "%s<trk><name>track %lu</name><trkseg>\n",
+                            kGpxHeader, static_cast<unsigned long>(trackId));
+      lineLength = length > 0 ? static_cast<size_t>(length) : 0;
+    }
+    return;
+  case Stage::Fixes: {
+    TrackFix fix;
+    if (nextFix(fix)) {
+      formatFix(fix);
+      fixCount++;
+    } else {
+      stage = Stage::Footer;
+    }
+    return;
+  }
+  case Stage::Footer:
+    stage = Stage::Done;
+    if (formatValue == TrackExportFormat::Gpx) {
+      lineLength = strlen(kGpxFooter);
+      memcpy(line, kGpxFooter, lineLength);
+    }
+    return;
+  case Stage::Done:
+    return;
+  }
+}
+
+void TrackExportStream::formatFix(const TrackFix &fix) {
+  tm parts = {};
+  unsigned milliseconds = 0;
+  if (hasUtc(fix)) {
+    utcParts(fix, parts, milliseconds);
+  }
+
+  if (formatValue == TrackExportFormat::Gpx) {
+    int length = snprintf(line, sizeof(line),
+                          "<trkpt lat=\"%.7f\" lon=\"%.7f\"><ele>%.1f</ele>",
+                          fix.latitudeE7 / 1e7, fix.longitudeE7 / 1e7,
+                          fix.altitudeDm / 10.0);
+    if (length > 0 && hasUtc(fix)) {
+      length += snprintf(line + length, sizeof(line) - length,
+                         "<time>%04d-%02d-%02dT%02d:%02d:%02d.%03uZ</time>",
+                         parts.tm_year + 1900, parts.tm_mon + 1,
+                         parts.tm_mday, parts.tm_hour, parts.tm_min,
+                         parts.tm_sec, milliseconds);
+    }
+    if (length > 0) {
+      length += snprintf(line + length, sizeof(line) - length, "</trkpt>\n");
+    }
+    lineLength = length > 0 ? static_cast<size_t>(length) : 0;
+    return;
+  }
+
+  char time[16] = "";
+  char date[8] = "";
+  if (hasUtc(fix)) {
+    snprintf(time, sizeof(time), "%02d%02d%02d.%02u", parts.tm_hour,
+             parts.tm_min, parts.tm_sec, milliseconds / 10);
+    snprintf(date, sizeof(date), "%02d%02d%02d", parts.tm_mday,
+             parts.tm_mon + 1, parts.tm_year % 100);
+  }
+  char latitude[20];
+  char longitude[20];
+  formatNmeaAngle(latitude, sizeof(latitude), fix.latitudeE7, true);
+  formatNmeaAngle(longitude, sizeof(longitude), fix.longitudeE7, false);
+
+  int length = snprintf(line, sizeof(line),
+                        "$GPRMC,%s,A,%s,%s,%.2f,%.2f,%s,,,A", time, latitude,
+                        longitude, fix.speedCms * kKnotsPerCms,
+                        fix.headingCdeg / 100.0, date);
+  if (length <= 0) {
+    return;
+  }
+  size_t total = finishSentence(line, static_cast<size_t>(length),
+                                sizeof(line));
+  // Satellite count and HDOP are not stored; GGA leaves them empty.
+  length = snprintf(line + total, sizeof(line) - total,
+                    "$GPGGA,%s,%s,%s,1,,,%.1f,M,,M,,", time, latitude,
+                    longitude, fix.altitudeDm / 10.0);
+  if (length > 0) {
+    total = total + finishSentence(line + total, static_cast<size_t>(length),
+                                   sizeof(line) - total);
+  }
+  lineLength = total;
+}
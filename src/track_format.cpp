@@ -0,0 +1,224 @@
+#include "track_format.h"
+
+#include <string.h>
+
+namespace {
+constexpr uint32_t kCrc32Polynomial = 0xEDB88320UL; // zlib / IEEE 802.3
+constexpr int32_t kFullTurnCdeg = 36000;
+
+size_t putUvarint(uint8_t *out, uint64_t value) {
+  size_t length = 0;
+  while (value >= 0x80) {
+    out[length++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[length++] = static_cast<uint8_t>(value);
+  return length;
+}
+
+size_t putSvarint(uint8_t *out, int64_t value) {
+  uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^
+                    static_cast<uint64_t>(value >> 63);
+  return putUvarint(out, zigzag);
+}
+
+bool getUvarint(const uint8_t *data, size_t length, size_t &offset,
+                uint64_t &value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 64; shift += 7) {
+    if (offset >= length) {
+      return false;
+    }
+    uint8_t byte = data[offset++];
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool getSvarint(const uint8_t *data, size_t length, size_t &offset,
+                int64_t &value) {
+  uint64_t zigzag = 0;
+  if (!getUvarint(data, length, offset, zigzag)) {
+    return false;
+  }
+  value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+  return true;
+}
+
+void putU16(uint8_t *out, uint16_t value) {
+  out[0] = static_cast<uint8_t>(value);
+  out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void putU32(uint8_t *out, uint32_t value) {
+  putU16(out, static_cast<uint16_t>(value));
+  putU16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+uint16_t getU16(const uint8_t *data) {
+  return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t getU32(const uint8_t *data) {
+  return getU16(data) | (static_cast<uint32_t>(getU16(data + 2)) << 16);
+}
+
+int32_t headingDelta(uint16_t from, uint16_t to) {
+  int32_t delta = static_cast<int32_t>(to) - static_cast<int32_t>(from);
+  if (delta >= kFullTurnCdeg / 2) {
+    delta -= kFullTurnCdeg;
+  } else if (delta < -kFullTurnCdeg / 2) {
+    delta += kFullTurnCdeg;
+  }
+  return delta;
+}
+} // namespace
+
+uint32_t trackCrc32(const uint8_t *data, size_t length, uint32_t crc) {
+  crc = ~crc;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (kCrc32Polynomial & (0U - (crc & 1U)));
+    }
+  }
+  return ~crc;
+}
+
+void writeTrackFileHeader(uint8_t *out, uint32_t trackId) {
+  memcpy(out, kTrackFileMagic, sizeof(kTrackFileMagic));
+  out[4] = kTrackFormatVersion;
+  out[5] = 0;
+  putU16(out + 6, 0);
+  putU32(out + 8, trackId);
+}
+
+bool readTrackFileHeader(const uint8_t *data, size_t length,
+                         uint32_t *trackId) {
+  if (length < kTrackFileHeaderSize ||
+      memcmp(data, kTrackFileMagic, sizeof(kTrackFileMagic)) != 0 ||
+      data[4] != kTrackFormatVersion) {
+    return false;
+  }
+  if (trackId) {
+    *trackId = getU32(data + 8);
+  }
+  return true;
+}
+
+void writeTrackBlockHeader(uint8_t *out, uint16_t payloadLength,
+                           uint16_t recordCount, uint32_t crc) {
+  out[0] = kTrackBlockSync0;
+  out[1] = kTrackBlockSync1;
+  putU16(out + 2, payloadLength);
+  putU16(out + 4, recordCount);
+  putU32(out + 6, crc);
+}
+
+bool readTrackBlockHeader(const uint8_t *data, TrackBlockHeader &header) {
+  if (data[0] != kTrackBlockSync0 || data[1] != kTrackBlockSync1) {
+    return false;
+  }
+  header.payloadLength = getU16(data + 2);
+  header.recordCount = getU16(data + 4);
+  header.crc = getU32(data + 6);
+  return header.payloadLength <= kTrackBlockPayloadSize;
+}
+
+size_t TrackEncoder::encode(const TrackFix &fix, uint8_t *out) {
+  // Time running backwards or switching clocks cannot be a delta.
+  bool key = !haveReference || fix.timeMs < reference.timeMs ||
+             ((fix.flags ^ reference.flags) & kTrackFlagLocalTime) != 0;
+  size_t length = 0;
+  uint8_t type = key ? kTrackRecordKey : kTrackRecordDelta;
+  out[length++] = static_cast<uint8_t>(type | (fix.flags << 4));
+  if (key) {
+    length += putUvarint(out + length, static_cast<uint64_t>(fix.timeMs));
+    length += putSvarint(out + length, fix.latitudeE7);
+    length += putSvarint(out + length, fix.longitudeE7);
+    length += putSvarint(out + length, fix.altitudeDm);
+    length += putUvarint(out + length, fix.speedCms);
+    length += putUvarint(out + length, fix.headingCdeg);
+  } else {
+    length += putUvarint(out + length,
+                         static_cast<uint64_t>(fix.timeMs - reference.timeMs));
+    length += putSvarint(out + length, static_cast<int64_t>(fix.latitudeE7) -
+                                           reference.latitudeE7);
+    length += putSvarint(out + length, static_cast<int64_t>(fix.longitudeE7) -
+                                           reference.longitudeE7);
+    length += putSvarint(out + length, static_cast<int64_t>(fix.altitudeDm) -
+                                           reference.altitudeDm);
+    length += putSvarint(out + length, static_cast<int64_t>(fix.speedCms) -
+                                           reference.speedCms);
+    length += putSvarint(out + length,
+                         headingDelta(reference.headingCdeg, fix.headingCdeg));
+  }
+  length += putUvarint(out + length, fix.accuracyDm);
+  reference = fix;
+  haveReference = true;
+  return length;
+}
+
+bool TrackDecoder::decode(const uint8_t *data, size_t length, size_t &offset,
+                          TrackFix &fix) {
+  if (offset >= length) {
+    return false;
+  }
+  uint8_t head = data[offset++];
+  uint8_t type = head & 0x0F;
+  uint64_t time = 0;
+  int64_t lat = 0;
+  int64_t lon = 0;
+  int64_t alt = 0;
+  int64_t heading = 0;
+  uint64_t accuracy = 0;
+  if (type == kTrackRecordKey) {
+    uint64_t speed = 0;
+    uint64_t absHeading = 0;
+    if (!getUvarint(data, length, offset, time) ||
+        !getSvarint(data, length, offset, lat) ||
+        !getSvarint(data, length, offset, lon) ||
+        !getSvarint(data, length, offset, alt) ||
+        !getUvarint(data, length, offset, speed) ||
+        !getUvarint(data, length, offset, absHeading) ||
+        !getUvarint(data, length, offset, accuracy)) {
+      return false;
+    }
+    fix.timeMs = static_cast<int64_t>(time);
+    fix.latitudeE7 = static_cast<int32_t>(lat);
+    fix.longitudeE7 = static_cast<int32_t>(lon);
+    fix.altitudeDm = static_cast<int32_t>(alt);
+    fix.speedCms = static_cast<uint32_t>(speed);
+    fix.headingCdeg = static_cast<uint16_t>(absHeading % kFullTurnCdeg);
+  } else if (type == kTrackRecordDelta && haveReference) {
+    int64_t speed = 0;
+    if (!getUvarint(data, length, offset, time) ||
+        !getSvarint(data, length, offset, lat) ||
+        !getSvarint(data, length, offset, lon) ||
+        !getSvarint(data, length, offset, alt) ||
+        !getSvarint(data, length, offset, speed) ||
+        !getSvarint(data, length, offset, heading) ||
+        !getUvarint(data, length, offset, accuracy)) {
+      return false;
+    }
+    fix = reference;
+    fix.timeMs += static_cast<int64_t>(time);
+    fix.latitudeE7 = static_cast<int32_t>(fix.latitudeE7 + lat);
+    fix.longitudeE7 = static_cast<int32_t>(fix.longitudeE7 + lon);
+    fix.altitudeDm = static_cast<int32_t>(fix.altitudeDm + alt);
+    fix.speedCms = static_cast<uint32_t>(fix.speedCms + speed);
+    int32_t turned = static_cast<int32_t>(fix.headingCdeg + heading);
+    fix.headingCdeg = static_cast<uint16_t>(
+        ((turned % kFullTurnCdeg) + kFullTurnCdeg) % kFullTurnCdeg);
+  } else {
+    return false;
+  }
+  fix.accuracyDm = static_cast<uint16_t>(accuracy);
+  fix.flags = static_cast<uint8_t>(head >> 4);
+  reference = fix;
+  haveReference = true;
+  return true;
+}
@@ -0,0 +1,541 @@
+#include "track_recorder.h"
+
+#include "gps_config.h"
+#include "logger.h"
+#include "task_scheduler.h"
+
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <math.h>
+
+namespace {
+constexpr const char *kTrackPrefsNamespace = "track";
+constexpr const char *kTrackNextIdKey = "next";
+constexpr const char *kTrackEnabledKey = "enabled";
+constexpr const char *kTrackPolicyKey = "policy";
+constexpr size_t kTrackBufferCount = 2;
+constexpr uint32_t kTrackWriterStack = 4096;
+constexpr UBaseType_t kTrackWriterPriority = 1;
+constexpr uint32_t kTrackTickPeriodMs = 1000;
+// A receiver that lost the sky this long ago has ended the trip.
+constexpr uint32_t kTrackSplitGapMs = 10UL * 60UL * 1000UL;
+// LittleFS is copy-on-write; leave it spare blocks to work with.
+constexpr size_t kTrackReserveBytes = 4 * kTrackBlockSize;
+// Below walking pace the course over ground is noise.
+constexpr float kMinTurnSpeedMs = 1.0f;
+constexpr double kMetersPerDegLat = 111320.0;
+constexpr double kDegToRad = M_PI / 180.0;
+
+struct TrackBlockBuffer {
+  uint8_t data[kTrackBlockSize];
+  size_t length = kTrackBlockHeaderSize;
+  uint16_t records = 0;
+  uint32_t trackId = 0;
+  volatile bool busy = false;
+};
+
+TrackBlockBuffer gBuffers[kTrackBufferCount];
+QueueHandle_t gWriteQueue = nullptr;
+TaskHandle_t gWriterTask = nullptr;
+// Written by the writer task only.
+volatile uint32_t gBlocksWritten = 0;
+volatile uint32_t gBytesWritten = 0;
+volatile uint32_t gFixesWritten = 0;
+volatile uint32_t gWriteErrors = 0;
+volatile uint32_t gTracksDeleted = 0;
+volatile uint32_t gLastWriteUs = 0;
+volatile uint32_t gMaxWriteUs = 0;
+volatile uint32_t gTotalWriteUs = 0;
+volatile uint32_t gUsedBytes = 0;
+uint32_t gTotalBytes = 0;
+
+// Core 2.x returns the bare name, older cores the full path.
+bool parseTrackId(const char *name, uint32_t &id) {
+  const char *slash = strrchr(name, '/');
+  const char *base = slash ? slash + 1 : name;
+  char *end = nullptr;
+  unsigned long value = strtoul(base, &end, 10);
+  if (end == base || strcmp(end, ".trk") != 0) {
+    return false;
+  }
+  id = static_cast<uint32_t>(value);
+  return true;
+}
+
+bool findTrackRange(uint32_t &oldest, uint32_t &newest) {
+  File dir = LittleFS.open(kTrackDirectory);
+  if (!dir || !dir.isDirectory()) {
+    return false;
+  }
+  bool found = false;
+  for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+    uint32_t id = 0;
+    if (entry.isDirectory() || !parseTrackId(entry.name(), id)) {
+      continue;
+    }
+    if (!found || id < oldest) {
+      oldest = id;
+    }
+    if (!found || id > newest) {
+      newest = id;
+    }
+    found = true;
+  }
+  return found;
+}
+
+void ensureSpace(uint32_t keepId, size_t needed) {
+  while (gTotalBytes - LittleFS.usedBytes() < needed + kTrackReserveBytes) {
+    uint32_t oldest = 0;
+    uint32_t newest = 0;
+    if (!findTrackRange(oldest, newest) || oldest == keepId) {
+      return;
+    }
+    String path = trackFilePath(oldest);
+    if (!LittleFS.remove(path)) {
+      return;
+    }
+    gTracksDeleted = gTracksDeleted + 1;
+    logPrintf("[trk] Flash full, removed %s\n", path.c_str());
+  }
+}
+
+void writeBlock(TrackBlockBuffer &block) {
+  int64_t started = esp_timer_get_time();
+  // CRC is computed here rather than in the scheduler loop.
+  size_t payload = block.length - kTrackBlockHeaderSize;
+  writeTrackBlockHeader(block.data, static_cast<uint16_t>(payload),
+                        block.records,
+                        trackCrc32(block.data + kTrackBlockHeaderSize,
+                                   payload));
+  ensureSpace(block.trackId, block.length + kTrackFileHeaderSize);
+
+  String path = trackFilePath(block.trackId);
+  File file = LittleFS.open(path, FILE_APPEND);
+  bool ok = static_cast<bool>(file);
+  if (ok && file.size() == 0) {
+    uint8_t header[kTrackFileHeaderSize];
+    writeTrackFileHeader(header, block.trackId);
+    ok = file.write(header, sizeof(header)) == sizeof(header);
+  }
+  if (ok) {
+    ok = file.write(block.data, block.length) == block.length;
+  }
+  if (file) {
+    file.close();
+  }
+
+  uint32_t elapsed = static_cast<uint32_t>(esp_timer_get_time() - started);
+  gLastWriteUs = elapsed;
+  if (elapsed > gMaxWriteUs) {
+    gMaxWriteUs = elapsed;
+  }
+  if (!ok) {
+    gWriteErrors = gWriteErrors + 1;
+    logPrintf("[trk] Write to %s failed\n", path.c_str());
+    return;
+  }
+  gTotalWriteUs = gTotalWriteUs + elapsed;
+  gBlocksWritten = gBlocksWritten + 1;
+  gBytesWritten = gBytesWritten + block.length;
+  gFixesWritten = gFixesWritten + block.records;
+  gUsedBytes = LittleFS.usedBytes();
+}
+
+void writerTask(void *) {
+  for (;;) {
+    uint8_t index = 0;
+    if (xQueueReceive(gWriteQueue, &index, portMAX_DELAY) != pdTRUE ||
+        index >= kTrackBufferCount) {
+      continue;
+    }
+    TrackBlockBuffer &block = gBuffers[index];
+    writeBlock(block);
+    block.length = kTrackBlockHeaderSize;
+    block.records = 0;
+    block.busy = false;
+  }
+}
+
+TrackSamplingPolicy defaultPolicy() {
+  TrackSamplingPolicy policy;
+  policy.minIntervalMs = TRACK_MIN_INTERVAL_MS;
+  policy.maxIntervalMs = TRACK_MAX_INTERVAL_MS;
+  policy.minDistanceM = TRACK_MIN_DISTANCE_M;
+  policy.minTurnDeg = TRACK_MIN_TURN_DEG;
+  policy.flushIntervalS = TRACK_FLUSH_INTERVAL_S;
+  return policy;
+}
+
+bool policyValid(const TrackSamplingPolicy &policy) {
+  return policy.flushIntervalS > 0 && policy.minTurnDeg <= 180 &&
+         (policy.maxIntervalMs == 0 ||
+          policy.maxIntervalMs >= policy.minIntervalMs);
+}
+
+TrackFix toTrackFix(const NavDataSample &sample, uint32_t nowMs) {
+  TrackFix fix;
+  if (sample.utcEpochUs != 0) {
+    fix.timeMs = sample.utcEpochUs / 1000;
+  } else {
+    fix.timeMs = nowMs;
+    fix.flags |= kTrackFlagLocalTime;
+  }
+  if (sample.ppsLocked) {
+    fix.flags |= kTrackFlagPpsLocked;
+  }
+  if (sample.filtered) {
+    fix.flags |= kTrackFlagFiltered;
+  }
+  fix.latitudeE7 = static_cast<int32_t>(lround(sample.latitude * 1e7));
+  fix.longitudeE7 = static_cast<int32_t>(lround(sample.longitude * 1e7));
+  fix.altitudeDm = static_cast<int32_t>(lroundf(sample.altitude * 10.0f));
+  fix.speedCms = static_cast<uint32_t>(lroundf(fmaxf(sample.speed, 0.0f) *
+                                               100.0f));
+  long heading = lroundf(sample.heading * 100.0f) % 36000;
+  fix.headingCdeg = static_cast<uint16_t>(heading < 0 ? heading + 36000
+                                                      : heading);
+  fix.accuracyDm = static_cast<uint16_t>(
+      lroundf(fminf(sample.horizontalAccuracy, 6000.0f) * 10.0f));
+  return fix;
+}
+} // namespace
+
+String trackFilePath(uint32_t id) {
+  char path[24];
+  snprintf(path, sizeof(path), "%s/%05lu.trk", kTrackDirectory,
+           static_cast<unsigned long>(id));
+  return String(path);
+}
+
+size_t listTrackFiles(TrackFileInfo *out, size_t capacity) {
+  File dir = LittleFS.open(kTrackDirectory);
+  if (!dir || !dir.isDirectory()) {
+    return 0;
+  }
+  size_t count = 0;
+  for (File entry = dir.openNextFile(); entry && count < capacity;
+       entry = dir.openNextFile()) {
+    uint32_t id = 0;
+    if (entry.isDirectory() || !parseTrackId(entry.name(), id)) {
+      continue;
+    }
+    out[count].id = id;
+    out[count].size = static_cast<uint32_t>(entry.size());
+    count++;
+  }
+  // Directory order is not creation order.
+  for (size_t i = 1; i < count; ++i) {
+    TrackFileInfo item = out[i];
+    size_t j = i;
+    for (; j > 0 && out[j - 1].id > item.id; --j) {
+      out[j] = out[j - 1];
+    }
+    out[j] = item;
+  }
+  return count;
+}
+
+TrackRecorder &trackRecorder() {
+  static TrackRecorder instance;
+  return instance;
+}
+
+void TrackRecorder::begin() {
+  policyValue = defaultPolicy();
+  enabledValue = TRACK_LOG_ENABLED != 0;
+  loadStoredSettings();
+
+  // The default partition table's "spiffs" data partition hosts LittleFS.
+  if (!LittleFS.begin(true)) {
+    logPrintln("[trk] LittleFS mount failed, track logging disabled");
+    return;
+  }
+  if (!LittleFS.exists(kTrackDirectory)) {
+    LittleFS.mkdir(kTrackDirectory);
+  }
+  gTotalBytes = LittleFS.totalBytes();
+  gUsedBytes = LittleFS.usedBytes();
+
+  gWriteQueue = xQueueCreate(kTrackBufferCount, sizeof(uint8_t));
+  if (!gWriteQueue ||
+      xTaskCreate(writerTask, "trk-write", kTrackWriterStack, nullptr,
+                  kTrackWriterPriority, &gWriterTask) != pdPASS) {
+    gWriterTask = nullptr;
+    logPrintln("[trk] Failed to start track writer task");
+    return;
+  }
+  mounted = true;
+  logPrintf("[trk] LittleFS %lu/%lu bytes used, logging %s\n",
+            static_cast<unsigned long>(gUsedBytes),
+            static_cast<unsigned long>(gTotalBytes),
+            enabledValue ? "on" : "off");
+
+  taskScheduler().addPeriodic(
+      "track", [](uint32_t now) { trackRecorder().tick(now); },
+      kTrackTickPeriodMs, TaskPriority::Low);
+}
+
+void TrackRecorder::publishNavData(const NavDataSample &sample) {
+  // Extrapolated positions are derived data; only epochs go to flash.
+  if (!mounted || !enabledValue || sample.extrapolated) {
+    return;
+  }
+  fixesSeen++;
+  uint32_t now = millis();
+  if (trackOpen && now - lastLoggedMs > kTrackSplitGapMs) {
+    startNewTrack();
+  }
+  if (!shouldLog(sample, now)) {
+    return;
+  }
+  if (!trackOpen) {
+    trackId = allocateTrackId();
+    trackOpen = true;
+    logPrintf("[trk] Recording %s\n", trackFilePath(trackId).c_str());
+  }
+  append(toTrackFix(sample, now), now);
+  lastLogged = sample;
+  lastLoggedMs = now;
+  haveLogged = true;
+}
+
+bool TrackRecorder::shouldLog(const NavDataSample &sample,
+                              uint32_t nowMs) const {
+  if (!haveLogged) {
+    return true;
+  }
+  const TrackSamplingPolicy &policy = policyValue;
+  uint32_t elapsed = nowMs - lastLoggedMs;
+  if (elapsed < policy.minIntervalMs) {
+    return false;
+  }
+  if (policy.maxIntervalMs == 0 && policy.minDistanceM == 0 &&
+      policy.minTurnDeg == 0) {
+    return true;
+  }
+  if (policy.maxIntervalMs != 0 && elapsed >= policy.maxIntervalMs) {
+    return true;
+  }
+  if (policy.minDistanceM != 0) {
+    double north = (sample.latitude - lastLogged.latitude) * kMetersPerDegLat;
+    double east = (sample.longitude - lastLogged.longitude) *
+                  kMetersPerDegLat * cos(sample.latitude * kDegToRad);
+    if (north * north + east * east >=
+        static_cast<double>(policy.minDistanceM) * policy.minDistanceM) {
+      return true;
+    }
+  }
+  if (policy.minTurnDeg != 0 && sample.speed >= kMinTurnSpeedMs) {
+    float turn = fabsf(sample.heading - lastLogged.heading);
+    if (turn > 180.0f) {
+      turn = 360.0f - turn;
+    }
+    if (turn >= policy.minTurnDeg) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TrackRecorder::append(const TrackFix &fix, uint32_t nowMs) {
+  TrackBlockBuffer *block = &gBuffers[activeIndex];
+  if (block->busy) {
+    fixesDropped++;
+    return;
+  }
+  if (block->records == 0) {
+    block->trackId = trackId;
+    blockOpenedMs = nowMs;
+    encoder.beginBlock();
+  }
+  // Encode on a copy: a fix that does not fit must not move the reference.
+  uint8_t record[kTrackMaxRecordSize];
+  TrackEncoder attempt = encoder;
+  size_t size = attempt.encode(fix, record);
+  if (block->length + size > kTrackBlockSize) {
+    if (!submitActive()) {
+      fixesDropped++;
+      return;
+    }
+    block = &gBuffers[activeIndex];
+    block->trackId = trackId;
+    blockOpenedMs = nowMs;
+    attempt = encoder;
+    size = attempt.encode(fix, record);
+  }
+  memcpy(block->data + block->length, record, size);
+  block->length += size;
+  block->records++;
+  encoder = attempt;
+  if (fixesLogged == 0) {
+    firstLoggedMs = nowMs;
+  }
+  fixesLogged++;
+}
+
+bool TrackRecorder::submitActive() {
+  TrackBlockBuffer &block = gBuffers[activeIndex];
+  if (block.records == 0 || block.busy) {
+    return true;
+  }
+  uint8_t next = static_cast<uint8_t>((activeIndex + 1) % kTrackBufferCount);
+  if (gBuffers[next].busy) {
+    return false;
+  }
+  block.busy = true;
+  uint8_t index = activeIndex;
+  if (xQueueSend(gWriteQueue, &index, 0) != pdTRUE) {
+    block.busy = false;
+    return false;
+  }
+  activeIndex = next;
+  encoder.beginBlock();
+  return true;
+}
+
+void TrackRecorder::tick(uint32_t nowMs) {
+  const TrackBlockBuffer &block = gBuffers[activeIndex];
+  if (block.records == 0 || block.busy) {
+    return;
+  }
+  if (nowMs - blockOpenedMs >= policyValue.flushIntervalS * 1000UL) {
+    submitActive();
+  }
+}
+
+void TrackRecorder::flush(uint32_t timeoutMs) {
+  if (!mounted) {
+    return;
+  }
+  uint32_t started = millis();
+  while (!submitActive() && millis() - started < timeoutMs) {
+    delay(10);
+  }
+  for (;;) {
+    bool pending = false;
+    for (const TrackBlockBuffer &block : gBuffers) {
+      pending = pending || block.busy;
+    }
+    if (!pending || millis() - started >= timeoutMs) {
+      return;
+    }
+    delay(10);
+  }
+}
+
+void TrackRecorder::startNewTrack() {
+  submitActive();
+  trackOpen = false;
+  haveLogged = false;
+}
+
+void TrackRecorder::setEnabled(bool enabled) {
+  if (enabled == enabledValue) {
+    return;
+  }
+  if (!enabled) {
+    startNewTrack();
+  }
+  enabledValue = enabled;
+  persistSettings();
+  logPrintf("[trk] Track logging %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool TrackRecorder::setPolicy(const TrackSamplingPolicy &policy) {
+  if (!policyValid(policy)) {
+    return false;
+  }
+  policyValue = policy;
+  persistSettings();
+  return true;
+}
+
+TrackRecorderStats TrackRecorder::stats() const {
+  TrackRecorderStats result;
+  result.mounted = mounted;
+  result.enabled = enabledValue;
+  result.trackId = trackOpen ? trackId : 0;
+  result.fixesSeen = fixesSeen;
+  result.fixesLogged = fixesLogged;
+  result.fixesDropped = fixesDropped;
+  result.blocksWritten = gBlocksWritten;
+  result.bytesWritten = gBytesWritten;
+  result.writeErrors = gWriteErrors;
+  result.tracksDeleted = gTracksDeleted;
+  result.lastWriteUs = gLastWriteUs;
+  result.maxWriteUs = gMaxWriteUs;
+  result.totalBytes = gTotalBytes;
+  result.usedBytes = gUsedBytes;
+  if (fixesLogged > 1 && lastLoggedMs != firstLoggedMs) {
+    result.fixesPerSecond = (fixesLogged - 1) * 1000.0f /
+                            static_cast<float>(lastLoggedMs - firstLoggedMs);
+  }
+  uint32_t fixesWritten = gFixesWritten;
+  if (fixesWritten > 0) {
+    result.bytesPerFix =
+        static_cast<float>(result.bytesWritten) / fixesWritten;
+  }
+  uint32_t totalWriteUs = gTotalWriteUs;
+  if (totalWriteUs > 0) {
+    // What the flash would sustain if the writer never went idle.
+    result.writeBytesPerSecond = static_cast<uint32_t>(
+        static_cast<uint64_t>(result.bytesWritten) * 1000000ULL /
+        totalWriteUs);
+    if (result.bytesPerFix > 0.0f) {
+      result.capacityFixesPerSecond = static_cast<uint32_t>(
+          result.writeBytesPerSecond / result.bytesPerFix);
+    }
+  }
+  return result;
+}
+
+uint32_t TrackRecorder::allocateTrackId() {
+  Preferences prefs;
+  uint32_t next = 1;
+  if (prefs.begin(kTrackPrefsNamespace, true)) {
+    next = prefs.getUInt(kTrackNextIdKey, next);
+    prefs.end();
+  }
+  // NVS may have been erased while the files survived; never append to an
+  // older track.
+  uint32_t oldest = 0;
+  uint32_t newest = 0;
+  if (findTrackRange(oldest, newest) && newest >= next) {
+    next = newest + 1;
+  }
+  if (prefs.begin(kTrackPrefsNamespace, false)) {
+    prefs.putUInt(kTrackNextIdKey, next + 1);
+    prefs.end();
+  }
+  return next;
+}
+
+void TrackRecorder::loadStoredSettings() {
+  Preferences prefs;
+  if (!prefs.begin(kTrackPrefsNamespace, true)) {
+    return;
+  }
+  enabledValue = prefs.getUChar(kTrackEnabledKey, TRACK_LOG_ENABLED) != 0;
+  TrackSamplingPolicy stored;
+  if (prefs.getBytesLength(kTrackPolicyKey) == sizeof(stored) &&
+      prefs.getBytes(kTrackPolicyKey, &stored, sizeof(stored)) ==
+          sizeof(stored) &&
+      policyValid(stored)) {
+    policyValue = stored;
+  }
+  prefs.end();
+}
+
+void TrackRecorder::persistSettings() {
+  Preferences prefs;
+  if (prefs.begin(kTrackPrefsNamespace, false)) {
+    prefs.putUChar(kTrackEnabledKey, enabledValue ? 1 : 0);
+    prefs.putBytes(kTrackPolicyKey, &policyValue, sizeof(policyValue));
+    prefs.end();
+  }
+}
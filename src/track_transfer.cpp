@@ -0,0 +1,493 @@
+#include "track_transfer.h"
+
+#include "logger.h"
+#include "task_scheduler.h"
+#include "track_recorder.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <NimBLEDevice.h>
+#include <stdlib.h>
+#include <string>
+
+namespace {
+
+constexpr uint32_t kIdlePeriodMs = 1000;
+constexpr uint32_t kActivePeriodMs = 10;
+constexpr uint8_t kDefaultWindow = 8;
+constexpr uint8_t kMaxWindow = 32;
+// Each notification holds several mbufs; bursting past this only gets
+// notifications dropped by the host and retransmitted.
+constexpr uint8_t kMaxNotifiesPerTick = 4;
+constexpr unsigned long kAckTimeoutMs = 1500;
+constexpr unsigned long kStallTimeoutMs = 30000;
+constexpr uint32_t kFlushTimeoutMs = 500;
+constexpr size_t kOffsetSize = 4;
+constexpr uint16_t kAttHeaderSize = 3;
+constexpr uint16_t kMaxAttMtu = 517;
+constexpr uint16_t kMinAttMtu = 23;
+constexpr size_t kMaxListedTracks = 16;
+// Connection interval in 1.25 ms units while streaming, and the relaxed
+// one gps_ble.cpp requests on connect.
+constexpr uint16_t kFastIntervalMin = 6;
+constexpr uint16_t kFastIntervalMax = 12;
+constexpr uint16_t kIdleIntervalMin = 24;
+constexpr uint16_t kIdleIntervalMax = 48;
+constexpr uint16_t kSupervisionTimeout = 400;
+constexpr uint16_t kMaxLinkLayerOctets = 251;
+constexpr uint16_t kNoConnection = 0xFFFF;
+
+struct PendingCommands {
+  bool stop = false;
+  bool linkLost = false;
+  bool start = false;
+  uint32_t startId = 0;
+  uint32_t startOffset = 0;
+  uint8_t startWindow = kDefaultWindow;
+  uint16_t connHandle = kNoConnection;
+  bool ack = false;
+  uint32_t ackOffset = 0;
+  bool resend = false;
+  uint32_t resendOffset = 0;
+};
+
+struct TransferState {
+  bool active = false;
+  File file;
+  uint32_t trackId = 0;
+  uint32_t size = 0;
+  uint32_t startOffset = 0;
+  uint32_t sent = 0;
+  uint32_t acked = 0;
+  bool eofSent = false;
+  uint16_t connHandle = kNoConnection;
+  uint16_t mtu = 0;
+  uint16_t chunkSize = 0;
+  uint8_t window = kDefaultWindow;
+  unsigned long startedAt = 0;
+  unsigned long lastAckAt = 0;
+  unsigned long lastProgressAt = 0;
+};
+
+// What a read of the control characteristic reports.
+struct StatusSnapshot {
+  bool active = false;
+  uint32_t trackId = 0;
+  uint32_t size = 0;
+  uint32_t acked = 0;
+  uint16_t chunkSize = 0;
+  uint8_t window = kDefaultWindow;
+  uint32_t bytesPerSecond = 0;
+};
+
+// Commands arrive on the NimBLE host task; the scheduler job applies them.
+// The same lock guards the status copy the job leaves for reads, so the
+// host task never formats gState while the job changes it.
+portMUX_TYPE gCommandMux = portMUX_INITIALIZER_UNLOCKED;
+PendingCommands gPending;
+StatusSnapshot gPublished;
+
+NimBLECharacteristic *gCtrlChar = nullptr;
+NimBLECharacteristic *gDataChar = nullptr;
+int8_t gTaskId = kInvalidTaskId;
+TransferState gState;
+TrackTransferStats gStats;
+uint8_t gChunk[kOffsetSize + kMaxAttMtu - kAttHeaderSize];
+
+uint32_t currentBytesPerSecond() {
+  if (!gState.active) {
+    return gStats.lastBytesPerSecond;
+  }
+  unsigned long elapsed = millis() - gState.startedAt;
+  if (elapsed == 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(
+      static_cast<uint64_t>(gState.acked - gState.startOffset) * 1000ULL /
+      elapsed);
+}
+
+StatusSnapshot takeStatus() {
+  StatusSnapshot status;
+  status.active = gState.active;
+  status.trackId = gState.trackId;
+  status.size = gState.size;
+  status.acked = gState.acked;
+  status.chunkSize = gState.chunkSize;
+  status.window = gState.window;
+  status.bytesPerSecond = currentBytesPerSecond();
+  return status;
+}
+
+void publishStatus() {
+  StatusSnapshot status = takeStatus();
+  portENTER_CRITICAL(&gCommandMux);
+  gPublished = status;
+  portEXIT_CRITICAL(&gCommandMux);
+}
+
+int formatStatus(char *out, size_t size, const char *state,
+                 const StatusSnapshot &status) {
+  return snprintf(out, size,
+                  "{\"st\":\"%s\",\"id\":%lu,\"size\":%lu,\"off\":%lu,"
+                  "\"chunk\":%u,\"win\":%u,\"bps\":%lu}",
+                  state, static_cast<unsigned long>(status.trackId),
+                  static_cast<unsigned long>(status.size),
+                  static_cast<unsigned long>(status.acked), status.chunkSize,
+                  status.window,
+                  static_cast<unsigned long>(status.bytesPerSecond));
+}
+
+void notifyStatus(const char *state) {
+  if (!gCtrlChar) {
+    return;
+  }
+  char status[160];
+  int length = formatStatus(status, sizeof(status), state, takeStatus());
+  if (length > 0) {
+    gCtrlChar->setValue(reinterpret_cast<uint8_t *>(status), length);
+    gCtrlChar->notify();
+  }
+}
+
+void setLinkProfile(uint16_t connHandle, bool fast) {
+  NimBLEServer *server = NimBLEDevice::getServer();
+  if (!server || connHandle == kNoConnection) {
+    return;
+  }
+  if (fast) {
+    server->updateConnParams(connHandle, kFastIntervalMin, kFastIntervalMax, 0,
+                             kSupervisionTimeout);
+    server->setDataLen(connHandle, kMaxLinkLayerOctets);
+    ble_gap_set_prefered_le_phy(connHandle, BLE_GAP_LE_PHY_2M_MASK,
+                                BLE_GAP_LE_PHY_2M_MASK,
+                                BLE_GAP_LE_PHY_CODED_ANY);
+  } else {
+    server->updateConnParams(connHandle, kIdleIntervalMin, kIdleIntervalMax, 0,
+                             kSupervisionTimeout);
+  }
+}
+
+void finishTransfer(const char *state, bool restoreLink) {
+  if (!gState.active) {
+    return;
+  }
+  unsigned long elapsed = millis() - gState.startedAt;
+  uint32_t delivered = gState.acked - gState.startOffset;
+  if (elapsed > 0) {
+    gStats.lastBytesPerSecond = currentBytesPerSecond();
+    if (gStats.lastBytesPerSecond > gStats.bestBytesPerSecond) {
+      gStats.bestBytesPerSecond = gStats.lastBytesPerSecond;
+    }
+  }
+  if (gState.acked == gState.size) {
+    gStats.completed++;
+  }
+  logPrintf("[trk] BLE transfer of track %lu %s: %lu bytes in %lu ms\n",
+            static_cast<unsigned long>(gState.trackId), state,
+            static_cast<unsigned long>(delivered),
+            static_cast<unsigned long>(elapsed));
+  gState.file.close();
+  gState.active = false;
+  if (restoreLink && gState.connHandle != kNoConnection) {
+    setLinkProfile(gState.connHandle, false);
+  }
+  taskScheduler().setPeriod(gTaskId, kIdlePeriodMs);
+  notifyStatus(state);
+}
+
+void startTransfer(uint32_t trackId, uint32_t offset, uint8_t window,
+                   uint16_t connHandle) {
+  if (gState.active) {
+    finishTransfer("stopped", false);
+  }
+  if (trackId == trackRecorder().stats().trackId) {
+    trackRecorder().flush(kFlushTimeoutMs);
+  }
+  gState.trackId = trackId;
+  gState.file = LittleFS.open(trackFilePath(trackId), FILE_READ);
+  if (!gState.file) {
+    gState.size = 0;
+    gState.acked = 0;
+    notifyStatus("missing");
+    return;
+  }
+  gState.size = static_cast<uint32_t>(gState.file.size());
+  if (offset > gState.size) {
+    offset = gState.size;
+  }
+  NimBLEServer *server = NimBLEDevice::getServer();
+  uint16_t mtu = server && connHandle != kNoConnection
+                     ? server->getPeerMTU(connHandle)
+                     : kMinAttMtu;
+  if (mtu < kMinAttMtu) {
+    mtu = kMinAttMtu;
+  } else if (mtu > kMaxAttMtu) {
+    mtu = kMaxAttMtu;
+  }
+  gState.mtu = mtu;
+  gState.chunkSize = mtu - kAttHeaderSize - kOffsetSize;
+  gState.window = window;
+  gState.connHandle = connHandle;
+  gState.startOffset = offset;
+  gState.sent = offset;
+  gState.acked = offset;
+  gState.eofSent = false;
+  gState.file.seek(offset);
+  gState.startedAt = millis();
+  gState.lastAckAt = gState.startedAt;
+  gState.lastProgressAt = gState.startedAt;
+  gState.active = true;
+  setLinkProfile(connHandle, true);
+  taskScheduler().setPeriod(gTaskId, kActivePeriodMs);
+  logPrintf("[trk] BLE transfer of track %lu from %lu (MTU %u, window %u)\n",
+            static_cast<unsigned long>(trackId),
+            static_cast<unsigned long>(offset), mtu, window);
+  notifyStatus("run");
+}
+
+void rewindTo(uint32_t offset) {
+  if (offset < gState.acked || offset > gState.sent) {
+    return;
+  }
+  gState.sent = offset;
+  gState.eofSent = false;
+  gState.file.seek(offset);
+  gStats.retransmits++;
+}
+
+void applyAck(uint32_t offset, unsigned long now) {
+  if (offset > gState.sent) {
+    return;
+  }
+  gState.lastAckAt = now;
+  if (offset > gState.acked) {
+    gState.acked = offset;
+    gState.lastProgressAt = now;
+  }
+}
+
+void applyPendingCommands() {
+  portENTER_CRITICAL(&gCommandMux);
+  PendingCommands commands = gPending;
+  gPending = PendingCommands();
+  portEXIT_CRITICAL(&gCommandMux);
+
+  unsigned long now = millis();
+  if (commands.linkLost) {
+    gState.connHandle = kNoConnection;
+  }
+  if (commands.stop) {
+    finishTransfer("stopped", !commands.start);
+  }
+  if (commands.start) {
+    startTransfer(commands.startId, commands.startOffset,
+                  commands.startWindow, commands.connHandle);
+  }
+  if (!gState.active) {
+    return;
+  }
+  if (commands.ack) {
+    applyAck(commands.ackOffset, now);
+  }
+  if (commands.resend) {
+    rewindTo(commands.resendOffset);
+  }
+}
+
+void sendChunks() {
+  uint32_t windowBytes =
+      static_cast<uint32_t>(gState.window) * gState.chunkSize;
+  for (uint8_t i = 0; i < kMaxNotifiesPerTick; ++i) {
+    if (gState.sent - gState.acked >= windowBytes || gState.eofSent) {
+      return;
+    }
+    uint32_t offset = gState.sent;
+    gChunk[0] = static_cast<uint8_t>(offset);
+    gChunk[1] = static_cast<uint8_t>(offset >> 8);
+    gChunk[2] = static_cast<uint8_t>(offset >> 16);
+    gChunk[3] = static_cast<uint8_t>(offset >> 24);
+    size_t length = 0;
+    if (offset < gState.size) {
+      size_t wanted = gState.size - offset;
+      if (wanted > gState.chunkSize) {
+        wanted = gState.chunkSize;
+      }
+      length = gState.file.read(gChunk + kOffsetSize, wanted);
+      if (length != wanted) {
+        finishTransfer("error", true);
+        return;
+      }
+    } else {
+      // Offset-only notification marks the end of the file.
+      gState.eofSent = true;
+    }
+    gDataChar->notify(gChunk, kOffsetSize + length);
+    gState.sent += length;
+  }
+}
+
+void serviceTransfer() {
+  applyPendingCommands();
+  if (!gState.active) {
+    return;
+  }
+  unsigned long now = millis();
+  if (gState.acked == gState.size && gState.eofSent) {
+    finishTransfer("done", true);
+    return;
+  }
+  if (now - gState.lastProgressAt > kStallTimeoutMs) {
+    finishTransfer("timeout", true);
+    return;
+  }
+  // No acknowledgement for a while: assume the tail of the window was lost.
+  if ((gState.sent > gState.acked || gState.eofSent) &&
+      now - gState.lastAckAt > kAckTimeoutMs) {
+    rewindTo(gState.acked);
+    gState.lastAckAt = now;
+  }
+  sendChunks();
+}
+
+void transferTick() {
+  serviceTransfer();
+  publishStatus();
+}
+
+bool parseNumber(const char *&cursor, uint32_t &value) {
+  char *end = nullptr;
+  unsigned long parsed = strtoul(cursor, &end, 10);
+  if (end == cursor) {
+    return false;
+  }
+  value = static_cast<uint32_t>(parsed);
+  cursor = end;
+  return true;
+}
+
+class TrackTransferCallbacks : public NimBLECharacteristicCallbacks {
+  void onWrite(NimBLECharacteristic *characteristic,
+               ble_gap_conn_desc *desc) override {
+    std::string value = characteristic->getValue();
+    if (value.empty()) {
+      return;
+    }
+    const char *cursor = value.c_str() + 1;
+    uint32_t first = 0;
+    bool hasFirst = parseNumber(cursor, first);
+
+    portENTER_CRITICAL(&gCommandMux);
+    switch (value[0]) {
+    case 'G':
+    case 'g':
+      if (hasFirst) {
+        uint32_t offset = 0;
+        uint32_t window = kDefaultWindow;
+        if (*cursor == ',' && parseNumber(++cursor, offset) &&
+            *cursor == ',') {
+          parseNumber(++cursor, window);
+        }
+        gPending.start = true;
+        gPending.startId = first;
+        gPending.startOffset = offset;
+        gPending.startWindow = static_cast<uint8_t>(
+            window == 0 ? 1 : (window > kMaxWindow ? kMaxWindow : window));
+        gPending.connHandle = desc ? desc->conn_handle : kNoConnection;
+        gPending.ack = false;
+        gPending.resend = false;
+      }
+      break;
+    case 'A':
+    case 'a':
+      if (hasFirst) {
+        gPending.ack = true;
+        gPending.ackOffset = first;
+      }
+      break;
+    case 'R':
+    case 'r':
+      if (hasFirst) {
+        gPending.resend = true;
+        gPending.resendOffset = first;
+      }
+      break;
+    case 'S':
+    case 's':
+      gPending.stop = true;
+      gPending.start = false;
+      break;
+    default:
+      break;
+    }
+    portEXIT_CRITICAL(&gCommandMux);
+  }
+
+  void onRead(NimBLECharacteristic *characteristic) override {
+    portENTER_CRITICAL(&gCommandMux);
+    StatusSnapshot snapshot = gPublished;
+    portEXIT_CRITICAL(&gCommandMux);
+    char status[160];
+    int length = formatStatus(status, sizeof(status),
+                              snapshot.active ? "run" : "idle", snapshot);
+    if (length <= 0) {
+      return;
+    }
+    // Newest tracks last; older ones stay reachable by id.
+    TrackFileInfo tracks[kMaxListedTracks];
+    size_t count = listTrackFiles(tracks, kMaxListedTracks);
+    std::string value(status, length - 1);
+    value += ",\"tracks\":[";
+    for (size_t i = 0; i < count; ++i) {
+      char entry[32];
+      snprintf(entry, sizeof(entry), "%s[%lu,%lu]", i > 0 ? "," : "",
+               static_cast<unsigned long>(tracks[i].id),
+               static_cast<unsigned long>(tracks[i].size));
+      value += entry;
+    }
+    value += "]}";
+    characteristic->setValue(value);
+  }
+} gTransferCallbacks;
+
+} // namespace
+
+void initTrackTransferService(NimBLEService *service) {
+  if (!service)
+    return;
+
+  gCtrlChar = service->createCharacteristic(
+      TRACK_TRANSFER_CTRL_UUID, NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::WRITE |
+                                    NIMBLE_PROPERTY::NOTIFY);
+  gDataChar = service->createCharacteristic(TRACK_TRANSFER_DATA_UUID,
+                                            NIMBLE_PROPERTY::NOTIFY);
+  if (!gCtrlChar || !gDataChar) {
+    logPrintln("[trk] Failed to create track transfer characteristics");
+    return;
+  }
+  gCtrlChar->setCallbacks(&gTransferCallbacks);
+
+  gTaskId = taskScheduler().addPeriodic(
+      "trk-ble", [](uint32_t) { transferTick(); }, kIdlePeriodMs,
+      TaskPriority::Low);
+}
+
+void trackTransferHandleDisconnect() {
+  portENTER_CRITICAL(&gCommandMux);
+  gPending.stop = true;
+  gPending.linkLost = true;
+  gPending.start = false;
+  portEXIT_CRITICAL(&gCommandMux);
+}
+
+TrackTransferStats trackTransferStats() {
+  TrackTransferStats stats = gStats;
+  stats.active = gState.active;
+  stats.trackId = gState.trackId;
+  stats.size = gState.size;
+  stats.acked = gState.acked;
+  stats.mtu = gState.mtu;
+  stats.chunkSize = gState.chunkSize;
+  stats.window = gState.window;
+  return stats;
+}
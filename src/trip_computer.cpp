@@ -0,0 +1,160 @@
+#include "trip_computer.h"
+
+namespace {
+// Mean-radius metres per degree (6371 km sphere, as haversine uses).
+constexpr int64_t kMetersPerDegree = 111195;
+constexpr int64_t kE7PerDegree = 10000000;
+constexpr int64_t kE7HalfTurn = 180 * kE7PerDegree;
+// Start above walking pace, stop below a slow walk; in between GNSS speed
+// is mostly noise.
+constexpr uint16_t kStartSpeedCms = 100;
+constexpr uint16_t kStopSpeedCms = 50;
+// Slow for this long before the trip counts a stop.
+constexpr uint32_t kStopHoldMs = 5000;
+// Longer gaps (tunnel, power loss) count as elapsed but not moving time.
+constexpr uint32_t kMaxMovingGapMs = 10000;
+// While stopped a step must clear max(this, 2 * accuracy) to count.
+constexpr uint32_t kMinStationaryStepMm = 10000;
+// Altitude is smoothed (1/8 per fix) before the hysteresis band.
+constexpr int32_t kAltitudeSmoothingShift = 3;
+constexpr int32_t kElevationHysteresisCm = 300;
+
+// round(32767 * cos(d)) for d = 0..90 degrees.
+const uint16_t kCosQ15[91] = {
+    32767, 32762, 32747, 32722, 32687, 32642, 32587, 32523, 32448, 32364,
+    32269, 32165, 32051, 31927, 31794, 31650, 31498, 31335, 31163, 30982,
+    30791, 30591, 30381, 30162, 29934, 29697, 29451, 29196, 28932, 28659,
+    28377, 28087, 27788, 27481, 27165, 26841, 26509, 26169, 25821, 25465,
+    25101, 24730, 24351, 23964, 23571, 23170, 22762, 22347, 21925, 21497,
+    21062, 20621, 20173, 19720, 19260, 18794, 18323, 17846, 17364, 16876,
+    16384, 15886, 15383, 14876, 14364, 13848, 13328, 12803, 12275, 11743,
+    11207, 10668, 10126, 9580,  9032,  8481,  7927,  7371,  6813,  6252,
+    5690,  5126,  4560,  3993,  3425,  2856,  2286,  1715,  1144,  572,
+    0,
+};
+
+int32_t cosQ15(int64_t latitudeE7) {
+  if (latitudeE7 < 0) {
+    latitudeE7 = -latitudeE7;
+  }
+  if (latitudeE7 >= 90 * kE7PerDegree) {
+    return 0;
+  }
+  int64_t degree = latitudeE7 / kE7PerDegree;
+  int64_t fraction = latitudeE7 % kE7PerDegree;
+  int32_t low = kCosQ15[degree];
+  int32_t high = kCosQ15[degree + 1];
+  return low - static_cast<int32_t>((low - high) * fraction / kE7PerDegree);
+}
+
+uint32_t isqrt64(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return static_cast<uint32_t>(root);
+}
+} // namespace
+
+uint32_t TripComputer::stepMm(int32_t latitudeE7A, int32_t longitudeE7A,
+                              int32_t latitudeE7B, int32_t longitudeE7B) {
+  int64_t deltaLat = static_cast<int64_t>(latitudeE7B) - latitudeE7A;
+  int64_t deltaLon = static_cast<int64_t>(longitudeE7B) - longitudeE7A;
+  if (deltaLon > kE7HalfTurn) {
+    deltaLon -= 2 * kE7HalfTurn;
+  } else if (deltaLon < -kE7HalfTurn) {
+    deltaLon += 2 * kE7HalfTurn;
+  }
+  int64_t midLatitude = (static_cast<int64_t>(latitudeE7A) + latitudeE7B) / 2;
+  int64_t northMm = deltaLat * kMetersPerDegree / 10000;
+  int64_t eastMm =
+      ((deltaLon * kMetersPerDegree / 10000) * cosQ15(midLatitude)) >> 15;
+  uint64_t squared = static_cast<uint64_t>(northMm * northMm) +
+                     static_cast<uint64_t>(eastMm * eastMm);
+  return isqrt64(squared);
+}
+
+void TripComputer::reset() { *this = TripComputer(); }
+
+void TripComputer::restore(const TripTotals &totals) {
+  reset();
+  value = totals;
+}
+
+void TripComputer::update(const TripFix &fix) {
+  if (!haveFix) {
+    haveFix = true;
+    lastTimeMs = fix.timeMs;
+    anchorLatitudeE7 = fix.latitudeE7;
+    anchorLongitudeE7 = fix.longitudeE7;
+    elevationReferenceCm = fix.altitudeCm;
+    smoothedAltitudeCm = fix.altitudeCm;
+    return;
+  }
+
+  uint32_t dt = fix.timeMs - lastTimeMs;
+  lastTimeMs = fix.timeMs;
+  value.elapsedMs += dt;
+
+  if (fix.speedCms >= kStartSpeedCms ||
+      (isMoving && fix.speedCms >= kStopSpeedCms)) {
+    isMoving = true;
+    slowing = false;
+  } else if (isMoving) {
+    if (!slowing) {
+      slowing = true;
+      slowSinceMs = fix.timeMs;
+    } else if (fix.timeMs - slowSinceMs >= kStopHoldMs) {
+      isMoving = false;
+      slowing = false;
+      value.stops++;
+    }
+  }
+
+  if (isMoving && dt <= kMaxMovingGapMs) {
+    value.movingMs += dt;
+    if (fix.speedCms > value.maxSpeedCms) {
+      value.maxSpeedCms = fix.speedCms;
+    }
+  }
+
+  uint32_t step = stepMm(anchorLatitudeE7, anchorLongitudeE7, fix.latitudeE7,
+                         fix.longitudeE7);
+  uint32_t threshold = static_cast<uint32_t>(fix.accuracyCm) * 20;
+  if (threshold < kMinStationaryStepMm) {
+    threshold = kMinStationaryStepMm;
+  }
+  if (isMoving || step > threshold) {
+    value.distanceMm += step;
+    anchorLatitudeE7 = fix.latitudeE7;
+    anchorLongitudeE7 = fix.longitudeE7;
+  }
+
+  smoothedAltitudeCm +=
+      (fix.altitudeCm - smoothedAltitudeCm) / (1 << kAltitudeSmoothingShift);
+  int32_t climb = smoothedAltitudeCm - elevationReferenceCm;
+  if (climb >= kElevationHysteresisCm) {
+    value.elevationGainCm += static_cast<uint32_t>(climb);
+    elevationReferenceCm = smoothedAltitudeCm;
+  } else if (climb <= -kElevationHysteresisCm) {
+    value.elevationLossCm += static_cast<uint32_t>(-climb);
+    elevationReferenceCm = smoothedAltitudeCm;
+  }
+}
+
+uint32_t TripComputer::averageSpeedCms() const {
+  if (value.movingMs == 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(value.distanceMm * 100 / value.movingMs);
+}
@@ -0,0 +1,141 @@
+#include "trip_meter.h"
+
+#include "gps_config.h"
+#include "logger.h"
+#include "task_scheduler.h"
+
+#include <Preferences.h>
+#include <math.h>
+
+namespace {
+constexpr const char *kTripPrefsNamespace = "trip";
+constexpr const char *kTripTotalsKey = "totals";
+constexpr uint32_t kTripTickPeriodMs = 1000;
+constexpr uint32_t kCheckpointIntervalMs =
+    static_cast<uint32_t>(TRIP_CHECKPOINT_INTERVAL_S) * 1000UL;
+constexpr uint32_t kMinCheckpointSpacingMs = 60000;
+
+// Written from the BLE host task, consumed by the trip tick.
+volatile bool gResetRequested = false;
+
+uint16_t toCentiUnits(float value) {
+  float scaled = value * 100.0f;
+  if (!(scaled > 0.0f)) {
+    return 0;
+  }
+  return scaled >= 65535.0f ? 65535 : static_cast<uint16_t>(lroundf(scaled));
+}
+} // namespace
+
+void TripMeter::begin() {
+  Preferences prefs;
+  if (prefs.begin(kTripPrefsNamespace, true)) {
+    TripTotals stored;
+    if (prefs.getBytesLength(kTripTotalsKey) == sizeof(stored) &&
+        prefs.getBytes(kTripTotalsKey, &stored, sizeof(stored)) ==
+            sizeof(stored)) {
+      computer.restore(stored);
+    }
+    prefs.end();
+  }
+  started = true;
+  lastCheckpointMs = millis();
+  logPrintf("[trip] Resumed at %lu m\n",
+            static_cast<unsigned long>(computer.totals().distanceMm / 1000));
+
+  taskScheduler().addPeriodic(
+      "trip", [](uint32_t now) { tripMeter().tick(now); }, kTripTickPeriodMs,
+      TaskPriority::Low);
+}
+
+void TripMeter::publishNavData(const NavDataSample &sample) {
+  // Without NAV_OUTPUT_RATE_HZ an epoch is republished until the next one.
+  if (!started || sample.extrapolated ||
+      (sample.sequence != 0 && sample.sequence == lastSequence)) {
+    return;
+  }
+  lastSequence = sample.sequence;
+  uint32_t now = millis();
+  TripFix fix;
+  fix.timeMs = now;
+  fix.latitudeE7 = static_cast<int32_t>(lround(sample.latitude * 1e7));
+  fix.longitudeE7 = static_cast<int32_t>(lround(sample.longitude * 1e7));
+  fix.altitudeCm = static_cast<int32_t>(lroundf(sample.altitude * 100.0f));
+  fix.speedCms = toCentiUnits(sample.speed);
+  fix.accuracyCm = toCentiUnits(sample.horizontalAccuracy);
+
+  bool wasMoving = computer.moving();
+  TripTotals before = computer.totals();
+  computer.update(fix);
+  const TripTotals &after = computer.totals();
+  if (after.elapsedMs != before.elapsedMs) {
+    revision++;
+  }
+  // Parked time alone is not worth a flash write; it rides along with the
+  // next checkpoint.
+  if (after.distanceMm != before.distanceMm ||
+      after.movingMs != before.movingMs || after.stops != before.stops) {
+    dirty = true;
+  }
+  maybeCheckpoint(now, wasMoving && !computer.moving());
+}
+
+void TripMeter::tick(uint32_t nowMs) {
+  if (gResetRequested) {
+    gResetRequested = false;
+    applyReset();
+  }
+  maybeCheckpoint(nowMs, false);
+}
+
+void TripMeter::maybeCheckpoint(uint32_t nowMs, bool stopped) {
+  if (!dirty) {
+    return;
+  }
+  uint32_t sinceLast = nowMs - lastCheckpointMs;
+  if (sinceLast >= kCheckpointIntervalMs ||
+      (stopped && sinceLast >= kMinCheckpointSpacingMs)) {
+    checkpoint();
+  }
+}
+
+void TripMeter::checkpoint() {
+  if (!started || !dirty) {
+    return;
+  }
+  Preferences prefs;
+  if (prefs.begin(kTripPrefsNamespace, false)) {
+    const TripTotals &totals = computer.totals();
+    prefs.putBytes(kTripTotalsKey, &totals, sizeof(totals));
+    prefs.end();
+    checkpoints++;
+  }
+  dirty = false;
+  lastCheckpointMs = millis();
+}
+
+void TripMeter::requestReset() { gResetRequested = true; }
+
+void TripMeter::applyReset() {
+  computer.reset();
+  dirty = true;
+  revision++;
+  checkpoint();
+  logPrintln("[trip] Trip reset");
+}
+
+TripMeterStats TripMeter::stats() const {
+  TripMeterStats stats;
+  stats.totals = computer.totals();
+  stats.moving = computer.moving();
+  stats.averageSpeedCms = computer.averageSpeedCms();
+  stats.checkpoints = checkpoints;
+  stats.checkpointAgeS = (millis() - lastCheckpointMs) / 1000;
+  stats.revision = revision;
+  return stats;
+}
+
+TripMeter &tripMeter() {
+  static TripMeter meter;
+  return meter;
+}
@@ -1,79 +1,82 @@
 #include "ubx_command_set.h"
 
+#include "ubx_valset_builder.h"
+
 #include <string.h>
 
 namespace {
 constexpr uint8_t kMonVerRequest[] = {0xB5, 0x62, 0x0A, 0x04, 0x00,
                                       0x00, 0x0E, 0x34};
 
-constexpr uint8_t kDisableNmeaCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x0E, 0x00, 0x00, 0x01, 0x00,
-    0x00, 0x02, 0x00, 0x73, 0x10, 0x00, 0x02, 0x00, 0x74,
-    0x10, 0x00, 0xAA, 0x25};
-
-constexpr uint8_t kEnableNmeaCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x0E, 0x00, 0x00, 0x01, 0x00,
-    0x00, 0x02, 0x00, 0x74, 0x10, 0x01, 0x02, 0x00, 0x73,
-    0x10, 0x01, 0xAC, 0x31};
-
-constexpr uint8_t kDefaultRamCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x2F, 0x00, 0x00, 0x01, 0x00, 0x00,
-    0x06, 0x00, 0x36, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x21, 0x00, 0x11, 0x20, 0x04, 0x01, 0x00, 0x23,
-    0x10, 0x01, 0x0D, 0x00, 0x41, 0x10, 0x01, 0x01, 0x00, 0x41,
-    0x20, 0x08, 0x02, 0x00, 0x41, 0x20, 0x08, 0x01, 0x00, 0x21,
-    0x30, 0x96, 0x00, 0xF3, 0xCB};
-
-constexpr uint8_t kDefaultBbrCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x2F, 0x00, 0x00, 0x02, 0x00, 0x00,
-    0x06, 0x00, 0x36, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x21, 0x00, 0x11, 0x20, 0x04, 0x01, 0x00, 0x23,
-    0x10, 0x01, 0x0D, 0x00, 0x41, 0x10, 0x01, 0x01, 0x00, 0x41,
-    0x20, 0x08, 0x02, 0x00, 0x41, 0x20, 0x08, 0x01, 0x00, 0x21,
-    0x30, 0x96, 0x00, 0xF4, 0xF9};
-
-constexpr uint8_t kGnssFullSystemsCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x4A, 0x00, 0x01, 0x01, 0x00, 0x00,
-    0x01, 0x00, 0x31, 0x10, 0x01, 0x05, 0x00, 0x31, 0x10, 0x01,
-    0x07, 0x00, 0x31, 0x10, 0x01, 0x0D, 0x00, 0x31, 0x10, 0x00,
-    0x0F, 0x00, 0x31, 0x10, 0x01, 0x12, 0x00, 0x31, 0x10, 0x01,
-    0x14, 0x00, 0x31, 0x10, 0x01, 0x18, 0x00, 0x31, 0x10, 0x01,
-    0x1F, 0x00, 0x31, 0x10, 0x01, 0x20, 0x00, 0x31, 0x10, 0x01,
-    0x21, 0x00, 0x31, 0x10, 0x01, 0x22, 0x00, 0x31, 0x10, 0x01,
-    0x24, 0x00, 0x31, 0x10, 0x01, 0x25, 0x00, 0x31, 0x10, 0x01,
-    0xA9, 0xC3};
-
-constexpr uint8_t kGnssGlonassBeiDouGalileoCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x4A, 0x00, 0x01, 0x01, 0x00, 0x00,
-    0x01, 0x00, 0x31, 0x10, 0x00, 0x05, 0x00, 0x31, 0x10, 0x01,
-    0x07, 0x00, 0x31, 0x10, 0x01, 0x0D, 0x00, 0x31, 0x10, 0x00,
-    0x0F, 0x00, 0x31, 0x10, 0x01, 0x12, 0x00, 0x31, 0x10, 0x00,
-    0x14, 0x00, 0x31, 0x10, 0x01, 0x18, 0x00, 0x31, 0x10, 0x01,
-    0x1F, 0x00, 0x31, 0x10, 0x00, 0x20, 0x00, 0x31, 0x10, 0x01,
-    0x21, 0x00, 0x31, 0x10, 0x01, 0x22, 0x00, 0x31, 0x10, 0x01,
-    0x24, 0x00, 0x31, 0x10, 0x00, 0x25, 0x00, 0x31, 0x10, 0x01,
-    0xA5, 0x38};
-
-constexpr uint8_t kGnssGlonassOnlyCmd[] = {
-    0xB5, 0x62, 0x06, 0x8A, 0x4A, 0x00, 0x01, 0x01, 0x00, 0x00,
-    0x01, 0x00, 0x31, 0x10, 0x00, 0x05, 0x00, 0x31, 0x10, 0x00,
-    0x07, 0x00, 0x31, 0x10, 0x00, 0x0D, 0x00, 0x31, 0x10, 0x00,
-    0x0F, 0x00, 0x31, 0x10, 0x00, 0x12, 0x00, 0x31, 0x10, 0x00,
-    0x14, 0x00, 0x31, 0x10, 0x01, 0x18, 0x00, 0x31, 0x10, 0x01,
-    0x1F, 0x00, 0x31, 0x10, 0x00, 0x20, 0x00, 0x31, 0x10, 0x00,
-    0x21, 0x00, 0x31, 0x10, 0x00, 0x22, 0x00, 0x31, 0x10, 0x00,
-    0x24, 0x00, 0x31, 0x10, 0x00, 0x25, 0x00, 0x31, 0x10, 0x01,
-    0x9F, 0x65};
+// CFG-UART1INPROT-NMEA / CFG-UART1OUTPROT-NMEA.
+constexpr UbxKeyValue kDisableNmeaItems[] = {{0x10730002u, 0},
+                                             {0x10740002u, 0}};
+constexpr UbxKeyValue kEnableNmeaItems[] = {{0x10740002u, 1},
+                                            {0x10730002u, 1}};
+
+constexpr UbxKeyValue kDefaultSettingsItems[] = {
+    {0x50360006u, 0},
+    {0x20110021u, 4},   // CFG-NAVSPG-DYNMODEL: automotive
+    {0x10230001u, 1},   // CFG-ANA-USE_ANA
+    {0x1041000Du, 1},   // CFG-ITFM-ENABLE
+    {0x20410001u, 8},   // CFG-ITFM-BBTHRESHOLD
+    {0x20410002u, 8},   // CFG-ITFM-CWTHRESHOLD
+    {0x30210001u, 150}, // CFG-RATE-MEAS, ms
+};
+
+// CFG-SIGNAL-* enable flags (group 0x31), in key order.
+constexpr UbxKeyValue kFullSystemsItems[] = {
+    {0x10310001u, 1}, {0x10310005u, 1}, {0x10310007u, 1}, {0x1031000Du, 0},
+    {0x1031000Fu, 1}, {0x10310012u, 1}, {0x10310014u, 1}, {0x10310018u, 1},
+    {0x1031001Fu, 1}, {0x10310020u, 1}, {0x10310021u, 1}, {0x10310022u, 1},
+    {0x10310024u, 1}, {0x10310025u, 1}};
+
+constexpr UbxKeyValue kGlonassBeiDouGalileoItems[] = {
+    {0x10310001u, 0}, {0x10310005u, 1}, {0x10310007u, 1}, {0x1031000Du, 0},
+    {0x1031000Fu, 1}, {0x10310012u, 0}, {0x10310014u, 1}, {0x10310018u, 1},
+    {0x1031001Fu, 0}, {0x10310020u, 1}, {0x10310021u, 1}, {0x10310022u, 1},
+    {0x10310024u, 0}, {0x10310025u, 1}};
+
+constexpr UbxKeyValue kGlonassOnlyItems[] = {
+    {0x10310001u, 0}, {0x10310005u, 0}, {0x10310007u, 0}, {0x1031000Du, 0},
+    {0x1031000Fu, 0}, {0x10310012u, 0}, {0x10310014u, 1}, {0x10310018u, 1},
+    {0x1031001Fu, 0}, {0x10310020u, 0}, {0x10310021u, 0}, {0x10310022u, 0},
+    {0x10310024u, 0}, {0x10310025u, 1}};
+
+constexpr uint8_t kLayerRam = 0x01;
+constexpr uint8_t kLayerBbr = 0x02;
+
+typedef UbxValsetFrame<kDisableNmeaItems, ubxItemCount(kDisableNmeaItems),
+                       kLayerRam>
+    DisableNmeaFrame;
+typedef UbxValsetFrame<kEnableNmeaItems, ubxItemCount(kEnableNmeaItems),
+                       kLayerRam>
+    EnableNmeaFrame;
+typedef UbxValsetFrame<kDefaultSettingsItems,
+                       ubxItemCount(kDefaultSettingsItems), kLayerRam>
+    DefaultRamFrame;
+typedef UbxValsetFrame<kDefaultSettingsItems,
+                       ubxItemCount(kDefaultSettingsItems), kLayerBbr>
+    DefaultBbrFrame;
+typedef UbxValsetFrame<kFullSystemsItems, ubxItemCount(kFullSystemsItems),
+                       kLayerRam>
+    FullSystemsFrame;
+typedef UbxValsetFrame<kGlonassBeiDouGalileoItems,
+                       ubxItemCount(kGlonassBeiDouGalileoItems), kLayerRam>
+    GlonassBeiDouGalileoFrame;
+typedef UbxValsetFrame<kGlonassOnlyItems, ubxItemCount(kGlonassOnlyItems),
+                       kLayerRam>
+    GlonassOnlyFrame;
 
 const UbxBinaryCommand kDisableNmeaCommands[] = {
-    {kDisableNmeaCmd, sizeof(kDisableNmeaCmd)}};
+    {DisableNmeaFrame::data, DisableNmeaFrame::size}};
 
 const UbxBinaryCommand kEnableNmeaCommands[] = {
-    {kEnableNmeaCmd, sizeof(kEnableNmeaCmd)}};
+    {EnableNmeaFrame::data, EnableNmeaFrame::size}};
 
 const UbxBinaryCommand kDefaultSettingCommands[] = {
-    {kDefaultRamCmd, sizeof(kDefaultRamCmd)},
-    {kDefaultBbrCmd, sizeof(kDefaultBbrCmd)}};
+    {DefaultRamFrame::data, DefaultRamFrame::size},
+    {DefaultBbrFrame::data, DefaultBbrFrame::size}};
 
 uint8_t gCustomSettingsBuffer[kMaxUbxCustomCommandSize] = {};
 uint8_t gCustomProfileBuffer[kMaxUbxCustomCommandSize] = {};
@@ -83,31 +86,13 @@ UbxCommandSequence gCustomSettingsSequence = {&gCustomSettingsCommand, 0};
 UbxCommandSequence gCustomProfileSequence = {&gCustomProfileCommand, 0};
 
 const UbxBinaryCommand kFullSystemsCommands[] = {
-    {kGnssFullSystemsCmd, sizeof(kGnssFullSystemsCmd)}};
+    {FullSystemsFrame::data, FullSystemsFrame::size}};
 
 const UbxBinaryCommand kGlonassBeiDouGalileoCommands[] = {
-    {kGnssGlonassBeiDouGalileoCmd, sizeof(kGnssGlonassBeiDouGalileoCmd)}};
+    {GlonassBeiDouGalileoFrame::data, GlonassBeiDouGalileoFrame::size}};
 
 const UbxBinaryCommand kGlonassOnlyCommands[] = {
-    {kGnssGlonassOnlyCmd, sizeof(kGnssGlonassOnlyCmd)}};
-
-constexpr UbxKeyValue kGlonassBeiDouGalileoValidation[] = {
-    {0x10310001u, 0}, {0x10310005u, 1}, {0x10310007u, 1}, {0x1031000Du, 0},
-    {0x1031000Fu, 1}, {0x10310012u, 0}, {0x10310014u, 1}, {0x10310018u, 1},
-    {0x1031001Fu, 0}, {0x10310020u, 1}, {0x10310021u, 1}, {0x10310022u, 1},
-    {0x10310024u, 0}, {0x10310025u, 1}};
-
-constexpr UbxKeyValue kGlonassOnlyValidation[] = {
-    {0x10310001u, 0}, {0x10310005u, 0}, {0x10310007u, 0}, {0x1031000Du, 0},
-    {0x1031000Fu, 0}, {0x10310012u, 0}, {0x10310014u, 1}, {0x10310018u, 1},
-    {0x1031001Fu, 0}, {0x10310020u, 0}, {0x10310021u, 0}, {0x10310022u, 0},
-    {0x10310024u, 0}, {0x10310025u, 1}};
-
-constexpr UbxKeyValue kFullProfileValidation[] = {
-    {0x10310001u, 1}, {0x10310005u, 1}, {0x10310007u, 1}, {0x1031000Du, 0},
-    {0x1031000Fu, 1}, {0x10310012u, 1}, {0x10310014u, 1}, {0x10310018u, 1},
-    {0x1031001Fu, 1}, {0x10310020u, 1}, {0x10310021u, 1}, {0x10310022u, 1},
-    {0x10310024u, 1}, {0x10310025u, 1}};
+    {GlonassOnlyFrame::data, GlonassOnlyFrame::size}};
 
 const UbxCommandSequence kFullProfileSequence = {kFullSystemsCommands,
                                                  sizeof(kFullSystemsCommands) /
@@ -127,15 +112,14 @@ struct UbxProfileDescriptor {
   size_t validationCount;
 };
 
+// Validation targets are the very items the frame was built from.
 constexpr UbxProfileDescriptor kProfileTable[] = {
-    {"Full systems", &kFullProfileSequence, kFullProfileValidation,
-     sizeof(kFullProfileValidation) / sizeof(kFullProfileValidation[0])},
+    {"Full systems", &kFullProfileSequence, FullSystemsFrame::items,
+     FullSystemsFrame::itemCount},
     {"GLONASS+BeiDou+Galileo", &kGlonassBeiDouGalileoSequence,
-     kGlonassBeiDouGalileoValidation,
-     sizeof(kGlonassBeiDouGalileoValidation) /
-         sizeof(kGlonassBeiDouGalileoValidation[0])},
-    {"GLONASS only", &kGlonassOnlySequence, kGlonassOnlyValidation,
-     sizeof(kGlonassOnlyValidation) / sizeof(kGlonassOnlyValidation[0])}};
+     GlonassBeiDouGalileoFrame::items, GlonassBeiDouGalileoFrame::itemCount},
+    {"GLONASS only", &kGlonassOnlySequence, GlonassOnlyFrame::items,
+     GlonassOnlyFrame::itemCount}};
 
 constexpr size_t kUbxBuiltinProfileCount =
     sizeof(kProfileTable) / sizeof(kProfileTable[0]);
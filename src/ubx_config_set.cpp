@@ -0,0 +1,234 @@
+#include "ubx_config_set.h"
+
+#include "ubx_command_set.h"
+
+namespace {
+constexpr size_t kUbxHeaderSize = 6;
+constexpr size_t kUbxFrameOverhead = 8;
+constexpr size_t kValPayloadHeader = 4;
+
+uint64_t maskToSize(uint64_t value, size_t size) {
+  return size >= 8 ? value : value & ((1ULL << (8 * size)) - 1);
+}
+
+uint64_t readLe(const uint8_t *p, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    value |= static_cast<uint64_t>(p[i]) << (8 * i);
+  }
+  return value;
+}
+
+void writeLe(uint8_t *p, uint64_t value, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    p[i] = static_cast<uint8_t>((value >> (8 * i)) & 0xFFu);
+  }
+}
+
+// Walks key/value pairs; false on a key with no valid size or a pair that
+// runs past the end.
+template <typename Visit>
+bool walkItems(const uint8_t *data, size_t length, Visit visit) {
+  size_t offset = 0;
+  while (offset < length) {
+    if (length - offset < 4) {
+      return false;
+    }
+    uint32_t key = static_cast<uint32_t>(readLe(data + offset, 4));
+    size_t size = ubxKeyValueSize(key);
+    if (size == 0 || length - offset - 4 < size) {
+      return false;
+    }
+    visit(key, readLe(data + offset + 4, size));
+    offset += 4 + size;
+  }
+  return true;
+}
+} // namespace
+
+bool UbxConfigSet::set(uint32_t key, uint64_t value, uint8_t layers) {
+  size_t size = ubxKeyValueSize(key);
+  layers &= kUbxLayerAll;
+  if (size == 0 || layers == 0) {
+    return false;
+  }
+  value = maskToSize(value, size);
+  // The layers move away from items holding another value for the key.
+  for (size_t i = count; i-- > 0;) {
+    if (items[i].key == key && items[i].value != value) {
+      items[i].layers &= static_cast<uint8_t>(~layers);
+      if (items[i].layers == 0) {
+        removeAt(i);
+      }
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (items[i].key == key && items[i].value == value) {
+      items[i].layers |= layers;
+      return true;
+    }
+  }
+  if (count >= kCapacity) {
+    return false;
+  }
+  items[count].key = key;
+  items[count].value = value;
+  items[count].layers = layers;
+  count++;
+  return true;
+}
+
+const UbxConfigItem *UbxConfigSet::find(uint32_t key, uint8_t layers) const {
+  for (size_t i = 0; i < count; ++i) {
+    if (items[i].key == key && (items[i].layers & layers) != 0) {
+      return &items[i];
+    }
+  }
+  return nullptr;
+}
+
+bool UbxConfigSet::addValsetFrame(const uint8_t *frame, size_t size) {
+  if (!frame || size < kUbxFrameOverhead + kValPayloadHeader ||
+      frame[0] != 0xB5 || frame[1] != 0x62 || frame[2] != 0x06 ||
+      frame[3] != 0x8A) {
+    return false;
+  }
+  size_t payloadLength = frame[4] | frame[5] << 8;
+  if (payloadLength + kUbxFrameOverhead != size) {
+    return false;
+  }
+  uint8_t ckA = 0;
+  uint8_t ckB = 0;
+  for (size_t i = 2; i < size - 2; ++i) {
+    ckA = static_cast<uint8_t>(ckA + frame[i]);
+    ckB = static_cast<uint8_t>(ckB + ckA);
+  }
+  if (ckA != frame[size - 2] || ckB != frame[size - 1]) {
+    return false;
+  }
+  const uint8_t *payload = frame + kUbxHeaderSize;
+  uint8_t layers = payload[1] & kUbxLayerAll;
+  if (payload[0] > 1 || layers == 0) {
+    return false;
+  }
+  const uint8_t *data = payload + kValPayloadHeader;
+  size_t dataLength = payloadLength - kValPayloadHeader;
+  size_t itemCount = 0;
+  bool valid = walkItems(data, dataLength,
+                         [&](uint32_t, uint64_t) { itemCount++; });
+  if (!valid || count + itemCount > kCapacity) {
+    return false;
+  }
+  walkItems(data, dataLength, [&](uint32_t key, uint64_t value) {
+    set(key, value, layers);
+  });
+  return true;
+}
+
+bool UbxConfigSet::addValgetPayload(const uint8_t *payload, size_t length,
+                                    uint8_t layer) {
+  if (!payload || length < kValPayloadHeader || payload[0] != 1) {
+    return false;
+  }
+  bool complete = true;
+  bool valid = walkItems(payload + kValPayloadHeader,
+                         length - kValPayloadHeader,
+                         [&](uint32_t key, uint64_t value) {
+                           complete = set(key, value, layer) && complete;
+                         });
+  return valid && complete;
+}
+
+size_t UbxConfigSet::encodeValget(uint8_t layer, size_t &next, size_t maxKeys,
+                                  uint8_t *out, size_t capacity) const {
+  if (!out || capacity < kValPayloadHeader + 4) {
+    return 0;
+  }
+  out[0] = 0; // version
+  out[1] = ubxValgetLayer(layer);
+  out[2] = 0; // position
+  out[3] = 0;
+  size_t length = kValPayloadHeader;
+  size_t keys = 0;
+  while (next < count && keys < maxKeys && length + 4 <= capacity) {
+    const UbxConfigItem &item = items[next++];
+    if ((item.layers & layer) == 0) {
+      continue;
+    }
+    writeLe(out + length, item.key, 4);
+    length += 4;
+    keys++;
+  }
+  return keys == 0 ? 0 : length;
+}
+
+size_t UbxConfigSet::encodeValset(uint8_t layers, uint8_t *out,
+                                  size_t capacity) const {
+  if (!out || capacity < kValPayloadHeader) {
+    return 0;
+  }
+  out[0] = 0; // version
+  out[1] = layers;
+  out[2] = 0;
+  out[3] = 0;
+  size_t length = kValPayloadHeader;
+  for (size_t i = 0; i < count; ++i) {
+    if (items[i].layers != layers) {
+      continue;
+    }
+    size_t size = ubxKeyValueSize(items[i].key);
+    if (length + 4 + size > capacity) {
+      return 0;
+    }
+    writeLe(out + length, items[i].key, 4);
+    writeLe(out + length + 4, items[i].value, size);
+    length += 4 + size;
+  }
+  return length == kValPayloadHeader ? 0 : length;
+}
+
+size_t UbxConfigSet::encodeValsetItem(size_t index, uint8_t *out,
+                                      size_t capacity) const {
+  if (index >= count || !out) {
+    return 0;
+  }
+  const UbxConfigItem &item = items[index];
+  size_t size = ubxKeyValueSize(item.key);
+  if (capacity < kValPayloadHeader + 4 + size) {
+    return 0;
+  }
+  out[0] = 0; // version
+  out[1] = item.layers;
+  out[2] = 0;
+  out[3] = 0;
+  writeLe(out + kValPayloadHeader, item.key, 4);
+  writeLe(out + kValPayloadHeader + 4, item.value, size);
+  return kValPayloadHeader + 4 + size;
+}
+
+void UbxConfigSet::diffLayer(const UbxConfigSet &current, uint8_t layer,
+                             UbxConfigSet &changes) const {
+  for (size_t i = 0; i < count; ++i) {
+    if ((items[i].layers & layer) == 0) {
+      continue;
+    }
+    const UbxConfigItem *now = current.find(items[i].key, layer);
+    if (!now || now->value != items[i].value) {
+      changes.set(items[i].key, items[i].value, layer);
+    }
+  }
+}
+
+void UbxConfigSet::removeAt(size_t index) {
+  for (size_t i = index + 1; i < count; ++i) {
+    items[i - 1] = items[i];
+  }
+  count--;
+}
+
+uint8_t ubxValgetLayer(uint8_t layerBit) {
+  if (layerBit & kUbxLayerRam) {
+    return 0;
+  }
+  return (layerBit & kUbxLayerBbr) ? 1 : 2;
+}
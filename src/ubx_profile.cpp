@@ -0,0 +1,381 @@
+#include "ubx_profile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+constexpr uint8_t kBlobVersion = 1;
+
+// Just enough JSON for the profile object: no escapes, no nesting beyond
+// the items map.
+struct JsonCursor {
+  const char *p;
+  const char *end;
+
+  void skipSpace() {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+      ++p;
+    }
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (p < end && *p == c) {
+      ++p;
+      return true;
+    }
+    return false;
+  }
+
+  bool peek(char c) {
+    skipSpace();
+    return p < end && *p == c;
+  }
+
+  bool readString(char *out, size_t capacity) {
+    if (!consume('"')) {
+      return false;
+    }
+    size_t n = 0;
+    while (p < end && *p != '"') {
+      if (*p == '\\' || n + 1 >= capacity) {
+        return false;
+      }
+      out[n++] = *p++;
+    }
+    if (p >= end) {
+      return false;
+    }
+    ++p;
+    out[n] = '\0';
+    return true;
+  }
+
+  // Decimal; the sign comes back apart so the caller can check the range.
+  bool readNumber(uint64_t &magnitude, bool &negative) {
+    skipSpace();
+    negative = p < end && *p == '-';
+    if (negative) {
+      ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9') {
+      return false;
+    }
+    uint64_t result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      uint64_t next = result * 10 + static_cast<uint64_t>(*p - '0');
+      if (next / 10 != result) {
+        return false;
+      }
+      result = next;
+      ++p;
+    }
+    magnitude = result;
+    return true;
+  }
+};
+
+bool parseHex(const char *text, uint64_t &value) {
+  if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+    text += 2;
+  }
+  size_t digits = 0;
+  uint64_t result = 0;
+  for (; *text; ++text, ++digits) {
+    char c = *text;
+    int digit = c >= '0' && c <= '9'   ? c - '0'
+                : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                       : -1;
+    if (digit < 0 || digits >= 16) {
+      return false;
+    }
+    result = result << 4 | static_cast<uint64_t>(digit);
+  }
+  value = result;
+  return digits > 0;
+}
+
+// Key IDs carry the value size but not its type, so a value fits when it
+// is within the unsigned range of that size or, when negative, the signed
+// one. L keys take 0 or 1.
+bool fitKeyValue(uint32_t key, uint64_t magnitude, bool negative,
+                 uint64_t &value, const char *&error) {
+  if (((key >> 28) & 0x07u) == 1) {
+    if (negative || magnitude > 1) {
+      error = "L key takes 0 or 1";
+      return false;
+    }
+    value = magnitude;
+    return true;
+  }
+  size_t bits = 8 * ubxKeyValueSize(key);
+  uint64_t mask = bits < 64 ? (1ULL << bits) - 1 : ~0ULL;
+  uint64_t limit = negative ? 1ULL << (bits - 1) : mask;
+  if (magnitude > limit) {
+    error = "value out of range for the key size";
+    return false;
+  }
+  value = (negative ? ~magnitude + 1 : magnitude) & mask;
+  return true;
+}
+
+bool parseItems(JsonCursor &cursor, UbxNamedProfile &out,
+                const char *&error) {
+  if (!cursor.consume('{')) {
+    error = "items must be an object";
+    return false;
+  }
+  if (cursor.consume('}')) {
+    return true;
+  }
+  do {
+    char keyText[12];
+    uint64_t key = 0;
+    if (!cursor.readString(keyText, sizeof(keyText)) ||
+        !parseHex(keyText, key) || key > 0xFFFFFFFFULL ||
+        ubxKeyValueSize(static_cast<uint32_t>(key)) == 0) {
+      error = "bad key ID";
+      return false;
+    }
+    if (!cursor.consume(':')) {
+      error = "expected ':'";
+      return false;
+    }
+    uint64_t magnitude = 0;
+    bool negative = false;
+    bool valueOk = false;
+    if (cursor.peek('"')) {
+      char valueText[24];
+      valueOk = cursor.readString(valueText, sizeof(valueText)) &&
+                parseHex(valueText, magnitude);
+    } else {
+      valueOk = cursor.readNumber(magnitude, negative);
+    }
+    if (!valueOk) {
+      error = "bad value";
+      return false;
+    }
+    uint64_t value = 0;
+    if (!fitKeyValue(static_cast<uint32_t>(key), magnitude, negative, value,
+                     error)) {
+      return false;
+    }
+    size_t slot = 0;
+    while (slot < out.itemCount && out.items[slot].key != key) {
+      slot++;
+    }
+    if (slot >= kUbxProfileMaxItems) {
+      error = "too many items";
+      return false;
+    }
+    out.items[slot].key = static_cast<uint32_t>(key);
+    out.items[slot].value = value;
+    if (slot == out.itemCount) {
+      out.itemCount++;
+    }
+  } while (cursor.consume(','));
+  if (!cursor.consume('}')) {
+    error = "expected '}' after items";
+    return false;
+  }
+  return true;
+}
+
+void writeLe(uint8_t *p, uint64_t value, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    p[i] = static_cast<uint8_t>((value >> (8 * i)) & 0xFFu);
+  }
+}
+
+uint64_t readLe(const uint8_t *p, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    value |= static_cast<uint64_t>(p[i]) << (8 * i);
+  }
+  return value;
+}
+} // namespace
+
+bool isValidUbxProfileName(const char *name) {
+  size_t length = 0;
+  for (; name[length]; ++length) {
+    char c = name[length];
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+              (c >= '0' && c <= '9') || c == '_' || c == '-';
+    if (!ok || length >= kUbxProfileNameMax) {
+      return false;
+    }
+  }
+  return length > 0;
+}
+
+bool parseUbxProfileJson(const char *text, size_t length,
+                         UbxNamedProfile &out, const char *&error) {
+  out = UbxNamedProfile();
+  JsonCursor cursor = {text, text + length};
+  if (!cursor.consume('{')) {
+    error = "expected a JSON object";
+    return false;
+  }
+  bool haveName = false;
+  if (!cursor.consume('}')) {
+    do {
+      char field[12];
+      if (!cursor.readString(field, sizeof(field)) || !cursor.consume(':')) {
+        error = "bad field";
+        return false;
+      }
+      if (strcmp(field, "name") == 0) {
+        if (!cursor.readString(out.name, sizeof(out.name)) ||
+            !isValidUbxProfileName(out.name)) {
+          error = "name must be 1-15 of A-Z a-z 0-9 _ -";
+          return false;
+        }
+        haveName = true;
+      } else if (strcmp(field, "layers") == 0) {
+        uint64_t layers = 0;
+        bool negative = false;
+        if (!cursor.readNumber(layers, negative) || negative || layers == 0 ||
+            layers > 7) {
+          error = "layers must be 1..7";
+          return false;
+        }
+        out.layers = static_cast<uint8_t>(layers);
+      } else if (strcmp(field, "items") == 0) {
+        if (!parseItems(cursor, out, error)) {
+          return false;
+        }
+      } else {
+        error = "unknown field";
+        return false;
+      }
+    } while (cursor.consume(','));
+    if (!cursor.consume('}')) {
+      error = "expected '}'";
+      return false;
+    }
+  }
+  cursor.skipSpace();
+  if (cursor.p != cursor.end) {
+    error = "data after the object";
+    return false;
+  }
+  if (!haveName) {
+    error = "missing name";
+    return false;
+  }
+  if (out.itemCount == 0) {
+    error = "no items";
+    return false;
+  }
+  return true;
+}
+
+size_t formatUbxItemJson(uint32_t key, uint64_t value, bool comma, char *out,
+                         size_t capacity) {
+  int written;
+  // Values wider than 32 bits (rare) go out as hex strings.
+  if (value > 0xFFFFFFFFULL) {
+    written = snprintf(out, capacity, "%s\"%08lX\":\"0x%08lX%08lX\"",
+                       comma ? "," : "", static_cast<unsigned long>(key),
+                       static_cast<unsigned long>(value >> 32),
+                       static_cast<unsigned long>(value & 0xFFFFFFFFULL));
+  } else {
+    written = snprintf(out, capacity, "%s\"%08lX\":%lu", comma ? "," : "",
+                       static_cast<unsigned long>(key),
+                       static_cast<unsigned long>(value));
+  }
+  if (written < 0 || static_cast<size_t>(written) >= capacity) {
+    return 0;
+  }
+  return static_cast<size_t>(written);
+}
+
+bool formatUbxProfileJson(const UbxNamedProfile &profile, char *out,
+                          size_t capacity, size_t &length) {
+  if (length >= capacity) {
+    return false;
+  }
+  int written = snprintf(out + length, capacity - length,
+                         "{\"name\":\"%s\",\"layers\":%u,\"items\":{",
+                         profile.name, static_cast<unsigned>(profile.layers));
+  if (written < 0 || static_cast<size_t>(written) >= capacity - length) {
+    return false;
+  }
+  length += static_cast<size_t>(written);
+  for (size_t i = 0; i < profile.itemCount; ++i) {
+    size_t item = formatUbxItemJson(profile.items[i].key,
+                                    profile.items[i].value, i > 0,
+                                    out + length, capacity - length);
+    if (item == 0) {
+      return false;
+    }
+    length += item;
+  }
+  if (capacity - length < 3) {
+    return false;
+  }
+  out[length++] = '}';
+  out[length++] = '}';
+  out[length] = '\0';
+  return true;
+}
+
+size_t encodeUbxProfile(const UbxNamedProfile &profile, uint8_t *out,
+                        size_t capacity) {
+  size_t nameLength = strlen(profile.name);
+  size_t length = 4 + nameLength;
+  for (size_t i = 0; i < profile.itemCount; ++i) {
+    length += 4 + ubxKeyValueSize(profile.items[i].key);
+  }
+  if (!out || length > capacity) {
+    return 0;
+  }
+  out[0] = kBlobVersion;
+  out[1] = profile.layers;
+  out[2] = static_cast<uint8_t>(nameLength);
+  memcpy(out + 3, profile.name, nameLength);
+  size_t offset = 3 + nameLength;
+  out[offset++] = profile.itemCount;
+  for (size_t i = 0; i < profile.itemCount; ++i) {
+    size_t size = ubxKeyValueSize(profile.items[i].key);
+    writeLe(out + offset, profile.items[i].key, 4);
+    writeLe(out + offset + 4, profile.items[i].value, size);
+    offset += 4 + size;
+  }
+  return offset;
+}
+
+bool decodeUbxProfile(const uint8_t *data, size_t length,
+                      UbxNamedProfile &out) {
+  out = UbxNamedProfile();
+  if (!data || length < 4 || data[0] != kBlobVersion || data[1] == 0 ||
+      data[1] > 7 || data[2] > kUbxProfileNameMax ||
+      length < 4u + data[2]) {
+    return false;
+  }
+  out.layers = data[1];
+  memcpy(out.name, data + 3, data[2]);
+  out.name[data[2]] = '\0';
+  size_t offset = 3 + data[2];
+  uint8_t count = data[offset++];
+  if (count > kUbxProfileMaxItems || !isValidUbxProfileName(out.name)) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; ++i) {
+    if (length - offset < 4) {
+      return false;
+    }
+    uint32_t key = static_cast<uint32_t>(readLe(data + offset, 4));
+    size_t size = ubxKeyValueSize(key);
+    if (size == 0 || length - offset - 4 < size) {
+      return false;
+    }
+    out.items[i].key = key;
+    out.items[i].value = readLe(data + offset + 4, size);
+    offset += 4 + size;
+  }
+  out.itemCount = count;
+  return offset == length;
+}
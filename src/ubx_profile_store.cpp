@@ -0,0 +1,150 @@
+#include "ubx_profile_store.h"
+
+#include "logger.h"
+
+#include <Preferences.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+constexpr const char *kProfilePrefsNamespace = "ubxprof";
+constexpr const char *kActiveKey = "active";
+
+void slotKey(size_t index, char (&key)[8]) {
+  snprintf(key, sizeof(key), "p%u", static_cast<unsigned>(index));
+}
+} // namespace
+
+UbxProfileStore &ubxProfileStore() {
+  static UbxProfileStore instance;
+  return instance;
+}
+
+void UbxProfileStore::begin() {
+  count = 0;
+  activeNameValue[0] = '\0';
+  Preferences prefs;
+  if (!prefs.begin(kProfilePrefsNamespace, true)) {
+    return;
+  }
+  uint8_t blob[kUbxProfileBlobMax];
+  bool damaged = false;
+  for (size_t i = 0; i < kCapacity; ++i) {
+    char key[8];
+    slotKey(i, key);
+    size_t length = prefs.getBytesLength(key);
+    if (length == 0) {
+      break;
+    }
+    if (length > sizeof(blob) || prefs.getBytes(key, blob, length) != length ||
+        !decodeUbxProfile(blob, length, profiles[count])) {
+      logPrintf("[gps] Stored UBX profile %s is damaged, skipping\n", key);
+      damaged = true;
+      continue;
+    }
+    count++;
+  }
+  prefs.getString(kActiveKey, activeNameValue, sizeof(activeNameValue));
+  prefs.end();
+  if (damaged) {
+    persistSlots(0);
+  }
+  if (activeNameValue[0] != '\0' && !active()) {
+    logPrintf("[gps] Active UBX profile %s is gone\n", activeNameValue);
+    activeNameValue[0] = '\0';
+  }
+  logPrintf("[gps] %u named UBX profile(s), active: %s\n",
+            static_cast<unsigned>(count),
+            activeNameValue[0] ? activeNameValue : "none");
+}
+
+const UbxNamedProfile *UbxProfileStore::find(const char *name) const {
+  for (size_t i = 0; i < count; ++i) {
+    if (strcmp(profiles[i].name, name) == 0) {
+      return &profiles[i];
+    }
+  }
+  return nullptr;
+}
+
+bool UbxProfileStore::save(const UbxNamedProfile &profile) {
+  size_t index = 0;
+  while (index < count && strcmp(profiles[index].name, profile.name) != 0) {
+    index++;
+  }
+  if (index >= kCapacity) {
+    return false;
+  }
+  profiles[index] = profile;
+  if (index == count) {
+    count++;
+  }
+  persistSlots(index);
+  return true;
+}
+
+bool UbxProfileStore::remove(const char *name) {
+  const UbxNamedProfile *profile = find(name);
+  if (!profile) {
+    return false;
+  }
+  size_t index = static_cast<size_t>(profile - profiles);
+  for (size_t i = index + 1; i < count; ++i) {
+    profiles[i - 1] = profiles[i];
+  }
+  count--;
+  persistSlots(index);
+  return true;
+}
+
+bool UbxProfileStore::stage(const UbxNamedProfile &profile) {
+  const UbxNamedProfile *existing = find(profile.name);
+  if (!existing) {
+    return false;
+  }
+  profiles[existing - profiles] = profile;
+  return true;
+}
+
+void UbxProfileStore::persist(const char *name) {
+  const UbxNamedProfile *profile = find(name);
+  if (profile) {
+    size_t index = static_cast<size_t>(profile - profiles);
+    persistSlots(index, index + 1);
+  }
+}
+
+void UbxProfileStore::setActive(const char *name) {
+  strncpy(activeNameValue, name, kUbxProfileNameMax);
+  activeNameValue[kUbxProfileNameMax] = '\0';
+}
+
+void UbxProfileStore::persistActive() {
+  Preferences prefs;
+  if (prefs.begin(kProfilePrefsNamespace, false)) {
+    prefs.putString(kActiveKey, activeNameValue);
+    prefs.end();
+  }
+}
+
+// Slots stay packed: everything from `from` up to `to` is rewritten and the
+// slot freed by a removal is cleared.
+void UbxProfileStore::persistSlots(size_t from, size_t to) {
+  Preferences prefs;
+  if (!prefs.begin(kProfilePrefsNamespace, false)) {
+    logPrintln("[gps] Failed to open UBX profile storage");
+    return;
+  }
+  uint8_t blob[kUbxProfileBlobMax];
+  for (size_t i = from; i < to; ++i) {
+    char key[8];
+    slotKey(i, key);
+    if (i < count) {
+      size_t length = encodeUbxProfile(profiles[i], blob, sizeof(blob));
+      prefs.putBytes(key, blob, length);
+    } else if (prefs.isKey(key)) {
+      prefs.remove(key);
+    }
+  }
+  prefs.end();
+}
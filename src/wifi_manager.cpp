@@ -1,8 +1,22 @@
 #include "wifi_manager.h"
 
+#include "fix_history.h"
+#include "geofence_monitor.h"
+#include "gnss_timebase.h"
 #include "gps_config.h"
+#include "gps_controller.h"
+#include "gps_serial_control.h"
 #include "logger.h"
+#include "nav_kalman.h"
+#include "ntp_server.h"
 #include "ota_service.h"
+#include "power_manager.h"
+#include "task_scheduler.h"
+#include "track_export.h"
+#include "track_recorder.h"
+#include "track_transfer.h"
+#include "trip_meter.h"
+#include "ubx_profile_store.h"
 #include "web_index.h"
 #include "web_portal.h"
 #include "build_version.h"
@@ -14,6 +28,7 @@
 #include <WiFi.h>
 #include <cstring>
 #include <pb_encode.h>
+#include <uri/UriBraces.h>
 
 #include "location.pb.h"
 
@@ -73,13 +88,24 @@ void ensureApSsid() {
 
 struct NavSnapshot {
   bool valid = false;
-  float latitude = 0.0f;
-  float longitude = 0.0f;
+  double latitude = 0.0;
+  double longitude = 0.0;
   float heading = 0.0f;
   float speed = 0.0f;
   float altitude = 0.0f;
   unsigned long updatedAt = 0;
   int64_t timestampMs = 0;
+  uint32_t ppsAgeUs = kNoPpsAge;
+  bool ppsLocked = false;
+  float horizontalAccuracy = 0.0f;
+  float verticalAccuracy = 0.0f;
+  float speedAccuracy = 0.0f;
+  float headingAccuracy = 0.0f;
+  bool filtered = false;
+  bool extrapolated = false;
+  bool estimated = false;
+  bool stationary = false;
+  uint32_t sequence = 0;
 };
 
 struct StatusSnapshot {
@@ -107,8 +133,27 @@ static WifiManagerPublisher gWifiPublisher;
 constexpr uint16_t kGnssServerPort = 8887;
 constexpr size_t kMaxTcpClients = 4;
 constexpr unsigned long kHeartbeatTimeoutMs = 4000;
-constexpr unsigned long kBroadcastIntervalMs = 1000;
+constexpr uint32_t kBroadcastIntervalMs = 1000;
+// While the position is frozen it is re-sent only at this period.
+constexpr unsigned long kStationaryHeartbeatMs =
+    STATIONARY_HEARTBEAT_S * 1000UL;
+constexpr uint32_t kServiceIntervalMs = 10;
+// With no AP and no station link there is nothing to serve; only the AP
+// button and reconnect attempts need polling.
+constexpr uint32_t kIdleServiceIntervalMs = 100;
+int8_t serviceTaskId = kInvalidTaskId;
 constexpr uint8_t kHeartbeatByte = 0x01;
+// 0x02 followed by a big-endian uint32 sequence asks for every stored fix
+// after it; they go out ahead of live updates, a burst per service pass.
+constexpr uint8_t kCatchUpByte = 0x02;
+constexpr size_t kCatchUpArgumentSize = 4;
+constexpr size_t kReplayBurst = 16;
+// Trip totals ride the stream as their own frame every few seconds.
+constexpr unsigned long kTripFrameIntervalMs = 5000;
+unsigned long lastTripFrameAt = 0;
+unsigned long lastNavBroadcastAt = 0;
+// Geofence events go out once each, in order, to every live client.
+uint32_t lastGeofenceEventSent = 0;
 
 WiFiServer gnssTcpServer(kGnssServerPort);
 
@@ -116,7 +161,10 @@ struct TcpClientSlot {
   WiFiClient client;
   bool active = false;
   unsigned long lastHeartbeat = 0;
-  unsigned long lastSend = 0;
+  uint8_t commandBytes = 0; // catch-up argument bytes still expected
+  uint32_t commandValue = 0;
+  bool replaying = false;
+  uint32_t replayAfter = 0;
 };
 
 TcpClientSlot tcpClients[kMaxTcpClients];
@@ -126,7 +174,36 @@ size_t pbPayloadSize = 0;
 bool pbPayloadValid = false;
 bool pbPayloadDirty = true;
 bool pendingBroadcast = true;
-unsigned long pbPayloadBuiltAt = 0;
+
+// Track downloads are streamed from the service task a slice at a time so
+// a long export never blocks the scheduler loop (and with it NMEA intake).
+constexpr size_t kTrackChunkSize = 1024;
+constexpr size_t kTrackChunkPrefix = 6; // "400\r\n" for a full chunk
+constexpr uint32_t kTrackSendBudgetMs = 8;
+constexpr uint32_t kTrackFlushTimeoutMs = 500;
+constexpr size_t kMaxListedTracks = 64;
+
+struct TrackDownload {
+  WiFiClient client;
+  bool active = false;
+  uint32_t trackId = 0;
+  unsigned long startedAt = 0;
+  uint32_t bytes = 0;
+};
+
+struct TrackDownloadStats {
+  uint32_t completed = 0;
+  uint32_t aborted = 0;
+  uint32_t lastBytes = 0;
+  uint32_t lastMs = 0;
+  float lastKBps = 0.0f;
+  float bestKBps = 0.0f;
+};
+
+TrackDownload trackDownload;
+TrackDownloadStats trackDownloadStats;
+TrackExportStream trackExport;
+uint8_t trackChunk[kTrackChunkPrefix + kTrackChunkSize + 2];
 
 const char kWaitingStatus[] = "Ожидается фиксация...";
 const char kReadyStatus[] = "Готово";
@@ -146,6 +223,16 @@ void markPayloadDirty() {
   pendingBroadcast = true;
 }
 
+// A frozen position only needs the stationary heartbeat.
+void broadcastTick(uint32_t now) {
+  if (navSnapshot.stationary &&
+      now - lastNavBroadcastAt < kStationaryHeartbeatMs) {
+    return;
+  }
+  lastNavBroadcastAt = now;
+  markPayloadDirty();
+}
+
 void disconnectClient(TcpClientSlot &slot, const char *reason) {
   if (!slot.active)
     return;
@@ -157,7 +244,35 @@ void disconnectClient(TcpClientSlot &slot, const char *reason) {
   }
   slot.active = false;
   slot.lastHeartbeat = 0;
-  slot.lastSend = 0;
+  slot.commandBytes = 0;
+  slot.replaying = false;
+}
+
+void fillLocationUpdate(gnss_LocationUpdate &loc, const NavSnapshot &nav,
+                        unsigned long now) {
+  loc.timestamp =
+      nav.timestampMs != 0 ? nav.timestampMs : static_cast<int64_t>(now);
+  loc.latitude = nav.latitude;
+  loc.longitude = nav.longitude;
+  loc.altitude = nav.altitude;
+  loc.speed = nav.speed;
+  loc.bearing = nav.heading;
+  float ageSeconds =
+      (now >= nav.updatedAt) ? ((now - nav.updatedAt) / 1000.0f) : 0.0f;
+  loc.location_age = ageSeconds;
+  if (nav.ppsAgeUs != kNoPpsAge) {
+    loc.pps_age_us = nav.ppsAgeUs;
+  }
+  loc.accuracy = nav.horizontalAccuracy;
+  loc.vertical_accuracy = nav.verticalAccuracy;
+  loc.speed_accuracy = nav.speedAccuracy;
+  loc.bearing_accuracy = nav.headingAccuracy;
+  loc.extrapolated = nav.extrapolated;
+  loc.estimated = nav.estimated;
+  loc.stationary = nav.stationary;
+  loc.sequence = nav.sequence;
+  loc.provider.funcs.encode = encodeStringCallback;
+  loc.provider.arg = const_cast<char *>(kProviderGps);
 }
 
 bool buildServerPayload(unsigned long now) {
@@ -168,29 +283,11 @@ bool buildServerPayload(unsigned long now) {
   if (haveFix) {
     response.which_response = gnss_ServerResponse_location_update_tag;
     gnss_LocationUpdate &loc = response.response.location_update;
-    loc.timestamp = navSnapshot.timestampMs != 0 ? navSnapshot.timestampMs
-                                                 : static_cast<int64_t>(now);
-    loc.latitude = navSnapshot.latitude;
-    loc.longitude = navSnapshot.longitude;
-    loc.altitude = navSnapshot.altitude;
-    loc.speed = navSnapshot.speed;
-    loc.bearing = navSnapshot.heading;
+    fillLocationUpdate(loc, navSnapshot, now);
     loc.satellites = statusSnapshot.satellites;
-    float ageSeconds = (now >= navSnapshot.updatedAt)
-                           ? ((now - navSnapshot.updatedAt) / 1000.0f)
-                           : 0.0f;
-    loc.location_age = ageSeconds;
-    if (statusSnapshot.hdop > 0.0f) {
-      float accuracyMeters = statusSnapshot.hdop * 5.0f;
-      if (accuracyMeters < 3.0f) {
-        accuracyMeters = 3.0f;
-      }
-      loc.accuracy = accuracyMeters;
-    } else {
-      loc.accuracy = 0.0f;
+    if (navSnapshot.horizontalAccuracy <= 0.0f) {
+      loc.accuracy = horizontalAccuracyFromHdop(statusSnapshot.hdop);
     }
-    loc.provider.funcs.encode = encodeStringCallback;
-    loc.provider.arg = const_cast<char *>(kProviderGps);
   } else {
     response.which_response = gnss_ServerResponse_status_tag;
     const char *statusPtr = kWaitingStatus;
@@ -214,13 +311,11 @@ bool buildServerPayload(unsigned long now) {
   pbPayloadSize = stream.bytes_written;
   pbPayloadValid = true;
   pbPayloadDirty = false;
-  pbPayloadBuiltAt = now;
   return true;
 }
 
 bool ensurePayload(unsigned long now) {
-  if (!pbPayloadValid || pbPayloadDirty ||
-      (now - pbPayloadBuiltAt) >= kBroadcastIntervalMs) {
+  if (!pbPayloadValid || pbPayloadDirty) {
     if (!buildServerPayload(now)) {
       return false;
     }
@@ -228,15 +323,8 @@ bool ensurePayload(unsigned long now) {
   return pbPayloadValid;
 }
 
-bool sendPayloadToClient(TcpClientSlot &slot, unsigned long now) {
-  if (!ensurePayload(now)) {
-    return false;
-  }
-  if (!slot.client.connected()) {
-    return false;
-  }
-
-  uint32_t length = static_cast<uint32_t>(pbPayloadSize);
+bool writeFrame(TcpClientSlot &slot, const uint8_t *payload, size_t size) {
+  uint32_t length = static_cast<uint32_t>(size);
   uint8_t header[4];
   header[0] = static_cast<uint8_t>((length >> 24) & 0xFF);
   header[1] = static_cast<uint8_t>((length >> 16) & 0xFF);
@@ -248,16 +336,135 @@ bool sendPayloadToClient(TcpClientSlot &slot, unsigned long now) {
     logPrintln("[wifi] Failed to write payload header");
     return false;
   }
-  written = slot.client.write(pbPayloadBuffer, pbPayloadSize);
-  if (written != pbPayloadSize) {
+  written = slot.client.write(payload, size);
+  if (written != size) {
     logPrintln("[wifi] Failed to write payload body");
     return false;
   }
   slot.client.flush();
-  slot.lastSend = now;
   return true;
 }
 
+bool sendPayloadToClient(TcpClientSlot &slot, unsigned long now) {
+  if (!ensurePayload(now)) {
+    return false;
+  }
+  if (!slot.client.connected()) {
+    return false;
+  }
+  return writeFrame(slot, pbPayloadBuffer, pbPayloadSize);
+}
+
+// Sends the next burst of a catch-up; false only when the link failed.
+bool sendReplayToClient(TcpClientSlot &slot, unsigned long now) {
+  uint8_t buffer[sizeof(pbPayloadBuffer)];
+  for (size_t i = 0; i < kReplayBurst; ++i) {
+    HistoryFix fix;
+    if (!fixHistory().next(slot.replayAfter, fix)) {
+      slot.replaying = false;
+      // Catch-up is over; bring the client to the live state right away.
+      pendingBroadcast = true;
+      return true;
+    }
+    NavSnapshot nav;
+    NavDataSample sample = historyFixToSample(fix);
+    nav.latitude = sample.latitude;
+    nav.longitude = sample.longitude;
+    nav.heading = sample.heading;
+    nav.speed = sample.speed;
+    nav.altitude = sample.altitude;
+    nav.updatedAt = fix.recordedMs;
+    nav.timestampMs = fix.utcMs;
+    nav.horizontalAccuracy = sample.horizontalAccuracy;
+    nav.verticalAccuracy = sample.verticalAccuracy;
+    nav.speedAccuracy = sample.speedAccuracy;
+    nav.headingAccuracy = sample.headingAccuracy;
+    nav.sequence = fix.sequence;
+
+    gnss_ServerResponse response = gnss_ServerResponse_init_zero;
+    response.which_response = gnss_ServerResponse_location_update_tag;
+    fillLocationUpdate(response.response.location_update, nav, now);
+    response.response.location_update.replayed = true;
+    pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    if (!pb_encode(&stream, gnss_ServerResponse_fields, &response)) {
+      logPrintf("[wifi] Failed to encode replayed fix: %s\n",
+                PB_GET_ERROR(&stream));
+      slot.replaying = false;
+      return true;
+    }
+    if (!writeFrame(slot, buffer, stream.bytes_written)) {
+      return false;
+    }
+    slot.replayAfter = fix.sequence;
+    fixHistory().noteReplayed();
+  }
+  return true;
+}
+
+size_t buildTripPayload(uint8_t *buffer, size_t capacity) {
+  TripMeterStats trip = tripMeter().stats();
+  gnss_ServerResponse response = gnss_ServerResponse_init_zero;
+  response.which_response = gnss_ServerResponse_trip_tag;
+  gnss_TripSummary &summary = response.response.trip;
+  summary.distance = trip.totals.distanceMm / 1000.0;
+  summary.moving_time = trip.totals.movingMs / 1000.0f;
+  summary.elapsed_time = trip.totals.elapsedMs / 1000.0f;
+  summary.max_speed = trip.totals.maxSpeedCms / 100.0f;
+  summary.average_speed = trip.averageSpeedCms / 100.0f;
+  summary.elevation_gain = trip.totals.elevationGainCm / 100.0f;
+  summary.elevation_loss = trip.totals.elevationLossCm / 100.0f;
+  summary.stops = trip.totals.stops;
+  summary.moving = trip.moving;
+  pb_ostream_t stream = pb_ostream_from_buffer(buffer, capacity);
+  if (!pb_encode(&stream, gnss_ServerResponse_fields, &response)) {
+    logPrintf("[wifi] Failed to encode trip summary: %s\n",
+              PB_GET_ERROR(&stream));
+    return 0;
+  }
+  return stream.bytes_written;
+}
+
+size_t buildGeofencePayload(const GeofenceEvent &event, uint8_t *buffer,
+                            size_t capacity) {
+  gnss_ServerResponse response = gnss_ServerResponse_init_zero;
+  response.which_response = gnss_ServerResponse_geofence_event_tag;
+  gnss_GeofenceEvent &message = response.response.geofence_event;
+  message.fence_id = event.fenceId;
+  message.entered = event.entered;
+  message.timestamp = event.utcMs;
+  message.sequence = event.sequence;
+  message.fix_sequence = event.fixSequence;
+  pb_ostream_t stream = pb_ostream_from_buffer(buffer, capacity);
+  if (!pb_encode(&stream, gnss_ServerResponse_fields, &response)) {
+    logPrintf("[wifi] Failed to encode geofence event: %s\n",
+              PB_GET_ERROR(&stream));
+    return 0;
+  }
+  return stream.bytes_written;
+}
+
+void handleClientByte(TcpClientSlot &slot, uint8_t value,
+                      unsigned long now) {
+  if (slot.commandBytes > 0) {
+    slot.commandValue = (slot.commandValue << 8) | value;
+    if (--slot.commandBytes == 0) {
+      slot.replaying = true;
+      slot.replayAfter = slot.commandValue;
+      slot.lastHeartbeat = now;
+      fixHistory().noteCatchUp();
+      logPrintf("[wifi] TCP catch-up after #%lu\n",
+                static_cast<unsigned long>(slot.commandValue));
+    }
+    return;
+  }
+  if (value == kHeartbeatByte) {
+    slot.lastHeartbeat = now;
+  } else if (value == kCatchUpByte) {
+    slot.commandBytes = kCatchUpArgumentSize;
+    slot.commandValue = 0;
+  }
+}
+
 void handleNewTcpClients(unsigned long now) {
   while (true) {
     WiFiClient incoming = gnssTcpServer.available();
@@ -284,7 +491,6 @@ void handleNewTcpClients(unsigned long now) {
     tcpClients[freeIndex].client.setNoDelay(true);
     tcpClients[freeIndex].active = true;
     tcpClients[freeIndex].lastHeartbeat = now;
-    tcpClients[freeIndex].lastSend = 0;
     pendingBroadcast = true;
 
     logPrintln("[wifi] TCP client connected");
@@ -295,6 +501,23 @@ void serviceTcpClients(unsigned long now) {
   handleNewTcpClients(now);
 
   bool forceBroadcast = pendingBroadcast;
+  bool boosted = false;
+  uint8_t tripPayload[64];
+  size_t tripPayloadSize = 0;
+  if (gnssStreamingEnabled && now - lastTripFrameAt >= kTripFrameIntervalMs) {
+    lastTripFrameAt = now;
+    tripPayloadSize = buildTripPayload(tripPayload, sizeof(tripPayload));
+  }
+  uint8_t geofencePayload[48];
+  size_t geofencePayloadSize = 0;
+  GeofenceEvent geofenceEvent;
+  if (geofenceMonitor().nextEvent(lastGeofenceEventSent, geofenceEvent)) {
+    lastGeofenceEventSent = geofenceEvent.sequence;
+    if (gnssStreamingEnabled) {
+      geofencePayloadSize = buildGeofencePayload(
+          geofenceEvent, geofencePayload, sizeof(geofencePayload));
+    }
+  }
 
   for (auto &slot : tcpClients) {
     if (!slot.active) {
@@ -311,9 +534,7 @@ void serviceTcpClients(unsigned long now) {
       if (byteValue < 0) {
         break;
       }
-      if (byteValue == kHeartbeatByte) {
-        slot.lastHeartbeat = now;
-      }
+      handleClientByte(slot, static_cast<uint8_t>(byteValue), now);
     }
 
     if ((now - slot.lastHeartbeat) > kHeartbeatTimeoutMs) {
@@ -321,18 +542,47 @@ void serviceTcpClients(unsigned long now) {
       continue;
     }
 
-    bool needSend =
-        forceBroadcast || ((now - slot.lastSend) >= kBroadcastIntervalMs);
-    if (!needSend) {
+    if (slot.replaying) {
+      if (!boosted) {
+        powerManager().boostCpu();
+        boosted = true;
+      }
+      if (!sendReplayToClient(slot, now)) {
+        disconnectClient(slot, "send failed");
+      }
+      // Live updates wait until the catch-up reaches the newest fix.
+      continue;
+    }
+
+    if (tripPayloadSize > 0 &&
+        !writeFrame(slot, tripPayload, tripPayloadSize)) {
+      disconnectClient(slot, "send failed");
       continue;
     }
 
+    if (geofencePayloadSize > 0 &&
+        !writeFrame(slot, geofencePayload, geofencePayloadSize)) {
+      disconnectClient(slot, "send failed");
+      continue;
+    }
+
+    if (!forceBroadcast) {
+      continue;
+    }
+
+    if (!boosted) {
+      powerManager().boostCpu();
+      boosted = true;
+    }
     if (!sendPayloadToClient(slot, now)) {
       disconnectClient(slot, "send failed");
       continue;
     }
   }
 
+  if (boosted) {
+    powerManager().releaseCpuBoost();
+  }
   if (forceBroadcast) {
     pendingBroadcast = false;
   }
@@ -437,6 +687,7 @@ void startMdns() {
   }
   MDNS.addService("http", "tcp", 80);
   MDNS.addService("gnss", "tcp", kGnssServerPort);
+  MDNS.addService("ntp", "udp", kNtpServerPort);
   mdnsStarted = true;
   logPrintln("[wifi] mDNS responder started as gps.local");
 }
@@ -478,7 +729,7 @@ String htmlEscape(const String &value) {
   return escaped;
 }
 
-String floatToString(float value, uint8_t decimals = 2) {
+String floatToString(double value, uint8_t decimals = 2) {
   char buf[24];
   dtostrf(value, 0, decimals, buf);
   return String(buf);
@@ -604,6 +855,7 @@ void sendRedirect() {
 }
 
 void handleStatus() {
+  CpuBoostGuard boost;
   String json = "{";
   json += "\"ap\":";
   json += apActive ? "true" : "false";
@@ -643,6 +895,7 @@ void handleStatus() {
 }
 
 void handleDeviceState() {
+  CpuBoostGuard boost;
   ensureApSsid();
   String json = "{";
 
@@ -697,9 +950,422 @@ void handleDeviceState() {
     json += floatToString(navSnapshot.heading, 1);
     json += ",\"age\":";
     json += (millis() - navSnapshot.updatedAt) / 1000;
+    json += ",\"utcMs\":";
+    json += String(navSnapshot.timestampMs);
+    json += ",\"ppsAgeUs\":";
+    if (navSnapshot.ppsAgeUs != kNoPpsAge) {
+      json += navSnapshot.ppsAgeUs;
+    } else {
+      json += "null";
+    }
+    json += ",\"ppsLocked\":";
+    json += navSnapshot.ppsLocked ? "true" : "false";
+    json += ",\"filtered\":";
+    json += navSnapshot.filtered ? "true" : "false";
+    json += ",\"extrapolated\":";
+    json += navSnapshot.extrapolated ? "true" : "false";
+    json += ",\"estimated\":";
+    json += navSnapshot.estimated ? "true" : "false";
+    json += ",\"stationary\":";
+    json += navSnapshot.stationary ? "true" : "false";
+    json += ",\"sequence\":";
+    json += navSnapshot.sequence;
+    json += ",\"hAcc\":";
+    json += floatToString(navSnapshot.horizontalAccuracy, 2);
+    json += ",\"vAcc\":";
+    json += floatToString(navSnapshot.verticalAccuracy, 2);
+    json += ",\"sAcc\":";
+    json += floatToString(navSnapshot.speedAccuracy, 2);
+    json += ",\"headingAcc\":";
+    json += floatToString(navSnapshot.headingAccuracy, 1);
+  }
+  json += "}";
+
+  TripMeterStats trip = tripMeter().stats();
+  json += ",\"trip\":{\"distanceM\":";
+  json += floatToString(trip.totals.distanceMm / 1000.0f, 1);
+  json += ",\"movingS\":";
+  json += trip.totals.movingMs / 1000;
+  json += ",\"elapsedS\":";
+  json += trip.totals.elapsedMs / 1000;
+  json += ",\"maxSpeed\":";
+  json += floatToString(trip.totals.maxSpeedCms / 100.0f, 2);
+  json += ",\"avgSpeed\":";
+  json += floatToString(trip.averageSpeedCms / 100.0f, 2);
+  json += ",\"gainM\":";
+  json += floatToString(trip.totals.elevationGainCm / 100.0f, 1);
+  json += ",\"lossM\":";
+  json += floatToString(trip.totals.elevationLossCm / 100.0f, 1);
+  json += ",\"stops\":";
+  json += trip.totals.stops;
+  json += ",\"moving\":";
+  json += trip.moving ? "true" : "false";
+  json += ",\"checkpoints\":";
+  json += trip.checkpoints;
+  json += ",\"checkpointAgeS\":";
+  json += trip.checkpointAgeS;
+  json += "}";
+
+  GeofenceStats geofence = geofenceMonitor().stats();
+  json += ",\"geofence\":{\"fences\":";
+  json += geofence.fences;
+  json += ",\"vertices\":";
+  json += geofence.vertices;
+  json += ",\"gridCells\":";
+  json += geofence.gridCells;
+  json += ",\"inside\":";
+  json += geofence.inside;
+  json += ",\"events\":";
+  json += geofence.events;
+  json += ",\"candidates\":";
+  json += geofence.lastCandidates;
+  json += ",\"evalUs\":";
+  json += geofence.lastEvalUs;
+  json += ",\"maxEvalUs\":";
+  json += geofence.maxEvalUs;
+  json += "}";
+
+  FixHistoryStats history = fixHistory().stats();
+  json += ",\"history\":{\"capacity\":";
+  json += history.capacity;
+  json += ",\"stored\":";
+  json += history.stored;
+  json += ",\"oldest\":";
+  json += history.oldestSequence;
+  json += ",\"latest\":";
+  json += history.latestSequence;
+  json += ",\"catchUps\":";
+  json += history.catchUps;
+  json += ",\"replayed\":";
+  json += history.replayedFixes;
+  json += "}";
+
+  TimebaseStats time = gnssTimebase().stats();
+  UtcTimestamp utcNow = gnssTimebase().now();
+  json += ",\"time\":{";
+  json += "\"source\":\"";
+  json += timeSourceName(time.source);
+  json += "\",\"ppsLocked\":";
+  json += time.ppsLocked ? "true" : "false";
+  json += ",\"utcMs\":";
+  if (utcNow.valid) {
+    json += String(utcNow.unixUs / 1000);
+  } else {
+    json += "null";
+  }
+  json += ",\"ppsEdges\":";
+  json += time.ppsEdges;
+  json += ",\"disciplined\":";
+  json += time.disciplinedEdges;
+  json += ",\"driftPpb\":";
+  json += time.driftPpb;
+  json += ",\"residualUs\":";
+  json += time.lastResidualUs;
+  json += ",\"jitterUs\":";
+  json += time.jitterUs;
+  json += ",\"leap\":";
+  json += static_cast<int>(time.leapChange);
+  json += ",\"leapAt\":";
+  json += time.leapEventUnixS;
+  NtpServerStats ntp = ntpServerStats();
+  json += ",\"ntp\":{\"running\":";
+  json += ntp.running ? "true" : "false";
+  json += ",\"served\":";
+  json += ntp.served;
+  json += ",\"unsynced\":";
+  json += ntp.unsynced;
+  json += ",\"ignored\":";
+  json += ntp.ignored;
+  json += "}}";
+
+  TrackRecorderStats track = trackRecorder().stats();
+  json += ",\"track\":{";
+  json += "\"mounted\":";
+  json += track.mounted ? "true" : "false";
+  json += ",\"enabled\":";
+  json += track.enabled ? "true" : "false";
+  json += ",\"trackId\":";
+  json += track.trackId;
+  json += ",\"fixesSeen\":";
+  json += track.fixesSeen;
+  json += ",\"fixesLogged\":";
+  json += track.fixesLogged;
+  json += ",\"dropped\":";
+  json += track.fixesDropped;
+  json += ",\"fixesPerSec\":";
+  json += floatToString(track.fixesPerSecond, 2);
+  json += ",\"bytesPerFix\":";
+  json += floatToString(track.bytesPerFix, 1);
+  json += ",\"blocks\":";
+  json += track.blocksWritten;
+  json += ",\"bytesWritten\":";
+  json += track.bytesWritten;
+  json += ",\"writeErrors\":";
+  json += track.writeErrors;
+  json += ",\"lastWriteUs\":";
+  json += track.lastWriteUs;
+  json += ",\"maxWriteUs\":";
+  json += track.maxWriteUs;
+  json += ",\"writeBps\":";
+  json += track.writeBytesPerSecond;
+  json += ",\"capacityFixesPerSec\":";
+  json += track.capacityFixesPerSecond;
+  json += ",\"tracksDeleted\":";
+  json += track.tracksDeleted;
+  json += ",\"fsUsed\":";
+  json += track.usedBytes;
+  json += ",\"fsTotal\":";
+  json += track.totalBytes;
+  json += ",\"download\":{\"active\":";
+  json += trackDownload.active ? "true" : "false";
+  json += ",\"completed\":";
+  json += trackDownloadStats.completed;
+  json += ",\"aborted\":";
+  json += trackDownloadStats.aborted;
+  json += ",\"lastBytes\":";
+  json += trackDownloadStats.lastBytes;
+  json += ",\"lastMs\":";
+  json += trackDownloadStats.lastMs;
+  json += ",\"lastKBps\":";
+  json += floatToString(trackDownloadStats.lastKBps, 1);
+  json += ",\"bestKBps\":";
+  json += floatToString(trackDownloadStats.bestKBps, 1);
+  TrackTransferStats bleTransfer = trackTransferStats();
+  json += "},\"ble\":{\"active\":";
+  json += bleTransfer.active ? "true" : "false";
+  json += ",\"trackId\":";
+  json += bleTransfer.trackId;
+  json += ",\"acked\":";
+  json += bleTransfer.acked;
+  json += ",\"size\":";
+  json += bleTransfer.size;
+  json += ",\"mtu\":";
+  json += bleTransfer.mtu;
+  json += ",\"chunk\":";
+  json += bleTransfer.chunkSize;
+  json += ",\"window\":";
+  json += bleTransfer.window;
+  json += ",\"retransmits\":";
+  json += bleTransfer.retransmits;
+  json += ",\"completed\":";
+  json += bleTransfer.completed;
+  json += ",\"lastBps\":";
+  json += bleTransfer.lastBytesPerSecond;
+  json += ",\"bestBps\":";
+  json += bleTransfer.bestBytesPerSecond;
+  json += "}}";
+
+  SchedulerStats perf = taskScheduler().stats();
+  json += ",\"perf\":{";
+  json += "\"load\":";
+  json += floatToString(perf.loadPermille / 10.0f, 1);
+  json += ",\"wakeups\":";
+  json += perf.wakeups;
+  json += ",\"tasks\":[";
+  for (size_t i = 0; i < perf.taskCount; ++i) {
+    const ScheduledTaskStats &task = perf.tasks[i];
+    if (i > 0) {
+      json += ",";
+    }
+    json += "{\"name\":\"";
+    json += task.name ? task.name : "";
+    json += "\",\"period\":";
+    json += task.periodMs;
+    json += ",\"runs\":";
+    json += task.runs;
+    json += ",\"maxUs\":";
+    json += task.maxRunUs;
+    json += ",\"lateMs\":";
+    json += task.maxLateMs;
+    json += "}";
+  }
+  json += "]";
+  CpuFreqStats cpu = powerManager().cpuStats();
+  json += ",\"cpu\":{\"maxMhz\":";
+  json += cpu.maxMhz;
+  json += ",\"baseMhz\":";
+  json += cpu.baseMhz;
+  json += ",\"boostMs\":";
+  json += cpu.boostMs;
+  json += ",\"baseMs\":";
+  json += cpu.baseMs;
+  json += ",\"boosts\":";
+  json += cpu.boosts;
+  json += "}";
+  NavFilterStats filter = gpsController().navFilterStats();
+  json += ",\"kalman\":{\"enabled\":";
+  json += filter.enabled ? "true" : "false";
+  json += ",\"runs\":";
+  json += filter.runs;
+  json += ",\"avgUs\":";
+  json += filter.avgUs;
+  json += ",\"maxUs\":";
+  json += filter.maxUs;
+  json += ",\"resets\":";
+  json += filter.resets;
+  json += ",\"rejected\":";
+  json += filter.rejected;
+  json += "}";
+  ExtrapolationStats extrapolation = gpsController().extrapolationStats();
+  json += ",\"extrapolation\":{\"epochMs\":";
+  json += extrapolation.epochPeriodMs;
+  json += ",\"samples\":";
+  json += extrapolation.extrapolated;
+  json += ",\"scored\":";
+  json += extrapolation.scored;
+  json += ",\"lastErrM\":";
+  json += floatToString(extrapolation.lastErrorM, 2);
+  json += ",\"rmsErrM\":";
+  json += floatToString(extrapolation.rmsErrorM, 2);
+  json += ",\"maxErrM\":";
+  json += floatToString(extrapolation.maxErrorM, 2);
+  json += ",\"estimated\":";
+  json += extrapolation.estimated;
+  json += ",\"outages\":";
+  json += extrapolation.outages;
+  json += ",\"lastOutageS\":";
+  json += floatToString(extrapolation.lastOutageS, 1);
+  json += ",\"lastOutageErrM\":";
+  json += floatToString(extrapolation.lastOutageErrorM, 1);
+  json += ",\"maxOutageErrM\":";
+  json += floatToString(extrapolation.maxOutageErrorM, 1);
+  json += "}";
+  StationaryStats stationary = gpsController().stationaryStats();
+  json += ",\"stationary\":{\"holding\":";
+  json += stationary.holding ? "true" : "false";
+  json += ",\"holds\":";
+  json += stationary.holds;
+  json += ",\"heldFixes\":";
+  json += stationary.heldFixes;
+  json += ",\"heldS\":";
+  json += stationary.heldMs / 1000;
+  json += ",\"spreadM\":";
+  json += floatToString(stationary.spreadM, 2);
+  json += "}}";
+
+  PowerStats power = powerManager().stats();
+  json += ",\"power\":{";
+  json += "\"profile\":\"";
+  json += powerProfileName(power.profile);
+  json += "\",\"lightSleep\":";
+  json += power.lightSleepActive ? "true" : "false";
+  json += ",\"lightSleepAvailable\":";
+  json += power.lightSleepAvailable ? "true" : "false";
+  json += ",\"awake\":";
+  json += floatToString(power.awakePermille / 10.0f, 1);
+  json += ",\"currentMa\":";
+  json += floatToString(power.estimatedCurrentMa, 2);
+  json += ",\"epochMs\":";
+  json += power.epochMs;
+  json += ",\"fixLatencyMs\":{\"avg\":";
+  json += power.fixLatencyAvgMs;
+  json += ",\"max\":";
+  json += power.fixLatencyMaxMs;
+  json += ",\"samples\":";
+  json += power.fixLatencySamples;
+  json += "}}";
+
+  // Per-band tracked signal count and mean C/N0.
+  const SignalTable &signalTable = gpsController().signalTable();
+  json += ",\"bands\":{\"tracked\":";
+  json += static_cast<unsigned>(signalTable.size());
+  json += ",\"navSig\":";
+  json += gpsController().navSigFrames();
+  SignalBandSummary bands[kGnssBandCount];
+  signalTable.summarize(bands);
+  for (size_t i = 1; i < kGnssBandCount; ++i) {
+    if (bands[i].tracked == 0) {
+      continue;
+    }
+    json += ",\"";
+    json += gnssBandName(static_cast<GnssBand>(i));
+    json += "\":{\"n\":";
+    json += static_cast<unsigned>(bands[i].tracked);
+    json += ",\"used\":";
+    json += static_cast<unsigned>(bands[i].used);
+    json += ",\"cno\":";
+    json += static_cast<unsigned>(bands[i].cno);
+    json += "}";
   }
   json += "}";
 
+  RfMonitorStats rf = gpsController().rfMonitorStats();
+  json += ",\"rf\":{\"jamming\":";
+  json += (rf.flags & kRfFlagJamming) ? "true" : "false";
+  json += ",\"spoofing\":";
+  json += (rf.flags & kRfFlagSpoofing) ? "true" : "false";
+  json += ",\"jamEvents\":";
+  json += rf.jammingEvents;
+  json += ",\"spoofEvents\":";
+  json += rf.spoofingEvents;
+  json += ",\"cno\":";
+  json += floatToString(rf.cnoMean, 1);
+  json += ",\"cnoBase\":";
+  json += floatToString(rf.cnoBaseline, 1);
+  json += ",\"cnoSpread\":";
+  json += floatToString(rf.cnoSpread, 1);
+  if (rf.cnoExcessValid) {
+    json += ",\"cnoExcess\":";
+    json += floatToString(rf.cnoExcess, 1);
+  }
+  if (rf.monRfValid) {
+    json += ",\"jamState\":";
+    json += rf.jammingState;
+    json += ",\"jamInd\":";
+    json += rf.jamIndicator;
+    json += ",\"agc\":";
+    json += rf.agcCount;
+    json += ",\"agcBase\":";
+    json += rf.agcBaseline;
+    json += ",\"noise\":";
+    json += rf.noisePerMs;
+    json += ",\"noiseBase\":";
+    json += rf.noiseBaseline;
+    json += ",\"antenna\":";
+    json += rf.antennaStatus;
+  }
+  if (rf.secSigValid) {
+    json += ",\"spoofState\":";
+    json += rf.spoofingState;
+  }
+  json += "}";
+
+  json += ",\"rate\":{\"hz\":";
+  json += gpsController().measurementRate();
+  json += ",\"maxHz\":";
+  json += gpsController().maxMeasurementRate();
+  json += ",\"baud\":";
+  json += gpsController().baud();
+  json += "}";
+
+  UbxConfigStats ubx = gpsController().ubxConfigStats();
+  json += ",\"ubx\":{\"link\":";
+  json += ubx.linkOk ? "true" : "false";
+  json += ",\"configured\":";
+  json += ubx.configured ? "true" : "false";
+  json += ",\"configMs\":";
+  json += ubx.configMs;
+  json += ",\"changed\":";
+  json += ubx.keysChanged;
+  json += ",\"keys\":";
+  json += ubx.keysTotal;
+  json += ",\"mismatch\":";
+  json += ubx.verifyMismatches;
+  json += ",\"verifiedAgeMs\":";
+  json += ubx.verifiedAgeMs;
+  json += ",\"profile\":\"";
+  json += ubxProfileStore().activeName();
+  // Key IDs in hex as u-center shows them, same format as the profiles.
+  json += "\",\"verified\":{";
+  const UbxConfigSet &verified = gpsController().verifiedUbxConfig();
+  for (size_t i = 0; i < verified.size(); ++i) {
+    char item[48];
+    formatUbxItemJson(verified[i].key, verified[i].value, i > 0, item,
+                      sizeof(item));
+    json += item;
+  }
+  json += "}}";
+
   json += ",\"fix\":{";
   json += "\"valid\":";
   json += statusSnapshot.valid ? "true" : "false";
@@ -777,6 +1443,70 @@ void handleConfigure() {
                  "Данные сохранены. Устройство начнет подключение.");
 }
 
+void handleTripReset() {
+  tripMeter().requestReset();
+  webServer.send(200, "text/plain", "Поездка сброшена");
+}
+
+void handleGeofenceList() {
+  webServer.send(200, "text/plain", geofenceMonitor().storedText());
+}
+
+void handleGeofenceUpload() {
+  String error;
+  if (!geofenceMonitor().replace(webServer.arg("plain"), error)) {
+    webServer.send(400, "text/plain", "Ошибка в списке зон: " + error);
+    return;
+  }
+  GeofenceStats stats = geofenceMonitor().stats();
+  webServer.send(200, "text/plain",
+                 "Загружено зон: " + String(stats.fences));
+}
+
+void handleGeofenceClear() {
+  String error;
+  geofenceMonitor().replace(String(), error);
+  webServer.send(200, "text/plain", "Геозоны удалены");
+}
+
+void handleUbxProfileList() {
+  webServer.send(200, "application/json",
+                 getGpsNamedProfilesJson(true).c_str());
+}
+
+void handleUbxProfileUpload() {
+  String body = webServer.arg("plain");
+  std::string error;
+  if (!saveGpsNamedProfile(std::string(body.c_str(), body.length()),
+                           error)) {
+    webServer.send(400, "text/plain",
+                   String("Профиль не принят: ") + error.c_str());
+    return;
+  }
+  webServer.send(200, "text/plain", "Профиль сохранен");
+}
+
+void handleUbxProfileDelete() {
+  std::string error;
+  if (!deleteGpsNamedProfile(webServer.arg("name").c_str(), error)) {
+    webServer.send(400, "text/plain",
+                   String("Профиль не удален: ") + error.c_str());
+    return;
+  }
+  webServer.send(200, "text/plain", "Профиль удален");
+}
+
+// Empty name switches the named profile off.
+void handleUbxProfileSelect() {
+  std::string error;
+  if (!selectGpsNamedProfile(webServer.arg("name").c_str(), error)) {
+    webServer.send(409, "text/plain",
+                   String("Профиль не применен: ") + error.c_str());
+    return;
+  }
+  webServer.send(200, "text/plain", "Профиль применен");
+}
+
 void handleConnectivityCheck() {
   if (apActive) {
     sendRedirect();
@@ -785,6 +1515,140 @@ void handleConnectivityCheck() {
   }
 }
 
+void handleTrackList() {
+  TrackFileInfo tracks[kMaxListedTracks];
+  size_t count = listTrackFiles(tracks, kMaxListedTracks);
+  TrackRecorderStats recorder = trackRecorder().stats();
+  String json = "{\"recording\":";
+  json += recorder.trackId;
+  json += ",\"fsUsed\":";
+  json += recorder.usedBytes;
+  json += ",\"fsTotal\":";
+  json += recorder.totalBytes;
+  json += ",\"tracks\":[";
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      json += ",";
+    }
+    json += "{\"id\":";
+    json += tracks[i].id;
+    json += ",\"size\":";
+    json += tracks[i].size;
+    json += "}";
+  }
+  json += "]}";
+  webServer.send(200, "application/json", json);
+}
+
+void finishTrackDownload(bool completed) {
+  unsigned long elapsed = millis() - trackDownload.startedAt;
+  trackExport.close();
+  trackDownload.client.stop();
+  trackDownload.active = false;
+  if (!completed) {
+    trackDownloadStats.aborted++;
+    logPrintf("[wifi] Track %lu download aborted after %lu bytes\n",
+              static_cast<unsigned long>(trackDownload.trackId),
+              static_cast<unsigned long>(trackDownload.bytes));
+    return;
+  }
+  trackDownloadStats.completed++;
+  trackDownloadStats.lastBytes = trackDownload.bytes;
+  trackDownloadStats.lastMs = elapsed;
+  // bytes per millisecond is (decimal) kilobytes per second.
+  trackDownloadStats.lastKBps =
+      elapsed > 0 ? static_cast<float>(trackDownload.bytes) / elapsed : 0.0f;
+  if (trackDownloadStats.lastKBps > trackDownloadStats.bestKBps) {
+    trackDownloadStats.bestKBps = trackDownloadStats.lastKBps;
+  }
+  logPrintf("[wifi] Track %lu sent: %lu bytes in %lu ms\n",
+            static_cast<unsigned long>(trackDownload.trackId),
+            static_cast<unsigned long>(trackDownload.bytes),
+            static_cast<unsigned long>(elapsed));
+}
+
+void serviceTrackDownload() {
+  if (!trackDownload.active) {
+    return;
+  }
+  if (!trackDownload.client.connected()) {
+    finishTrackDownload(false);
+    return;
+  }
+  CpuBoostGuard boost;
+  unsigned long started = millis();
+  do {
+    uint8_t *data = trackChunk + kTrackChunkPrefix;
+    size_t length = trackExport.read(data, kTrackChunkSize);
+    if (length == 0) {
+      static const char kLastChunk[] = "0\r\n\r\n";
+      trackDownload.client.write(
+          reinterpret_cast<const uint8_t *>(kLastChunk),
+          sizeof(kLastChunk) - 1);
+      finishTrackDownload(true);
+      return;
+    }
+    // Chunk framing goes around the data in place: one write per chunk.
+    char sizeLine[kTrackChunkPrefix + 1];
+    int prefix = snprintf(sizeLine, sizeof(sizeLine), "%X\r\n",
+                          static_cast<unsigned>(length));
+    uint8_t *frame = data - prefix;
+    memcpy(frame, sizeLine, prefix);
+    data[length] = '\r';
+    data[length + 1] = '\n';
+    size_t frameLength = prefix + length + 2;
+    if (trackDownload.client.write(frame, frameLength) != frameLength) {
+      finishTrackDownload(false);
+      return;
+    }
+    trackDownload.bytes += length;
+  } while (millis() - started < kTrackSendBudgetMs);
+}
+
+void handleTrackDownload() {
+  uint32_t id = 0;
+  TrackExportFormat format = TrackExportFormat::Gpx;
+  String name = webServer.pathArg(0);
+  if (!parseTrackExportName(name.c_str(), id, format)) {
+    webServer.send(404, "text/plain", "Неизвестный формат трека");
+    return;
+  }
+  if (trackDownload.active) {
+    webServer.sendHeader("Retry-After", "5");
+    webServer.send(503, "text/plain", "Уже идет выгрузка другого трека");
+    return;
+  }
+  if (id == trackRecorder().stats().trackId) {
+    trackRecorder().flush(kTrackFlushTimeoutMs);
+  }
+  if (!trackExport.open(id, format)) {
+    webServer.send(404, "text/plain", "Трек не найден");
+    return;
+  }
+
+  // The response is written straight to the socket and continued from
+  // serviceTrackDownload(); the copy keeps the connection alive after
+  // WebServer lets go of it.
+  trackDownload.client = webServer.client();
+  char header[256];
+  int length = snprintf(
+      header, sizeof(header),
+      "HTTP/1.1 200 OK\r\nContent-Type: %s\r\n"
+      "Content-Disposition: attachment; filename=\"%05lu.%s\"\r\n"
+      "Cache-Control: no-store\r\nTransfer-Encoding: chunked\r\n"
+      "Connection: close\r\n\r\n",
+      trackExportContentType(format), static_cast<unsigned long>(id),
+      trackExportExtension(format));
+  trackDownload.client.write(reinterpret_cast<const uint8_t *>(header),
+                             length);
+  trackDownload.active = true;
+  trackDownload.trackId = id;
+  trackDownload.startedAt = millis();
+  trackDownload.bytes = 0;
+  logPrintf("[wifi] Streaming track %lu as %s\n",
+            static_cast<unsigned long>(id), trackExportExtension(format));
+}
+
 void handleNotFound() {
   if (apActive) {
     sendRedirect();
@@ -798,6 +1662,17 @@ void setupWebRoutes() {
   webServer.on("/", HTTP_ANY, handleRoot);
   webServer.on("/status", HTTP_GET, handleStatus);
   webServer.on("/api/state", HTTP_GET, handleDeviceState);
+  webServer.on("/api/tracks", HTTP_GET, handleTrackList);
+  webServer.on(UriBraces("/api/tracks/{}"), HTTP_GET, handleTrackDownload);
+  webServer.on("/api/trip/reset", HTTP_POST, handleTripReset);
+  webServer.on("/api/geofences", HTTP_GET, handleGeofenceList);
+  webServer.on("/api/geofences", HTTP_POST, handleGeofenceUpload);
+  webServer.on("/api/geofences", HTTP_DELETE, handleGeofenceClear);
+  webServer.on("/api/ubx/profiles", HTTP_GET, handleUbxProfileList);
+  webServer.on("/api/ubx/profiles", HTTP_POST, handleUbxProfileUpload);
+  webServer.on("/api/ubx/profiles", HTTP_DELETE, handleUbxProfileDelete);
+  webServer.on("/api/ubx/profiles/select", HTTP_POST,
+               handleUbxProfileSelect);
   webServer.on("/networks", HTTP_GET, handleNetworks);
   webServer.on("/configure", HTTP_POST, handleConfigure);
   webServer.on("/generate_204", HTTP_GET, handleConnectivityCheck);
@@ -825,6 +1700,14 @@ void initWifiManager(ApStateCallback callback) {
 
   gnssTcpServer.begin();
   logPrintf("[wifi] GNSS TCP server listening on port %u\n", kGnssServerPort);
+  initNtpServer();
+
+  serviceTaskId = taskScheduler().addPeriodic(
+      "wifi", [](uint32_t) { updateWifiManager(); }, kServiceIntervalMs,
+      TaskPriority::Normal);
+  // Periodic re-send keeps location_age fresh for idle TCP clients.
+  taskScheduler().addPeriodic("tcp-bcast", broadcastTick, kBroadcastIntervalMs,
+                              TaskPriority::Low);
 
   loadCredentials();
   if (storedCreds.valid) {
@@ -946,6 +1829,11 @@ void updateWifiManager() {
   }
 
   serviceTcpClients(now);
+  serviceTrackDownload();
+
+  bool radioBusy = apActive || status == WL_CONNECTED;
+  taskScheduler().setPeriod(serviceTaskId, radioBusy ? kServiceIntervalMs
+                                                     : kIdleServiceIntervalMs);
 }
 
 void wifiManagerHandleBleRequest(bool enable) {
@@ -1016,6 +1904,8 @@ void WifiManagerPublisher::publishNavData(const NavDataSample &sample) {
   if (!gnssStreamingEnabled) {
     return;
   }
+  bool held = sample.stationary && navSnapshot.valid &&
+              navSnapshot.stationary;
   navSnapshot.valid = true;
   navSnapshot.latitude = sample.latitude;
   navSnapshot.longitude = sample.longitude;
@@ -1024,7 +1914,22 @@ void WifiManagerPublisher::publishNavData(const NavDataSample &sample) {
   navSnapshot.altitude = sample.altitude;
   unsigned long now = millis();
   navSnapshot.updatedAt = now;
-  navSnapshot.timestampMs = static_cast<int64_t>(now);
+  navSnapshot.timestampMs = sample.utcEpochUs / 1000;
+  navSnapshot.ppsAgeUs = sample.ppsAgeUs;
+  navSnapshot.ppsLocked = sample.ppsLocked;
+  navSnapshot.horizontalAccuracy = sample.horizontalAccuracy;
+  navSnapshot.verticalAccuracy = sample.verticalAccuracy;
+  navSnapshot.speedAccuracy = sample.speedAccuracy;
+  navSnapshot.headingAccuracy = sample.headingAccuracy;
+  navSnapshot.filtered = sample.filtered;
+  navSnapshot.extrapolated = sample.extrapolated;
+  navSnapshot.estimated = sample.estimated;
+  navSnapshot.stationary = sample.stationary;
+  navSnapshot.sequence = sample.sequence;
+  if (held && now - lastNavBroadcastAt < kStationaryHeartbeatMs) {
+    return;
+  }
+  lastNavBroadcastAt = now;
   markPayloadDirty();
 }
 
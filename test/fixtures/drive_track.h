@@ -0,0 +1,1032 @@
+#ifndef DRIVE_TRACK_H
+#define DRIVE_TRACK_H
+
+// Generated by tools/make_test_track.py; do not edit.
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct TrackRow {
+  uint32_t timeMs;
+  int32_t truthLatitudeE7;
+  int32_t truthLongitudeE7;
+  int32_t truthAltitudeCm;
+  int32_t latitudeE7;
+  int32_t longitudeE7;
+  int32_t altitudeCm;
+  uint16_t speedCms;
+  uint16_t courseCdeg;
+  uint8_t hdop10;
+  bool fix;
+};
+
+constexpr uint32_t kTrackOutlierMs = 280000;
+constexpr uint32_t kTrackTunnelStartMs = 330000;
+constexpr uint32_t kTrackTunnelEndMs = 350000;
+
+static const TrackRow kTrack[] = {
+    {0, 557512000, 376184000, 15000,
+     557512017, 376184174, 14967, 2, 32446, 10, true},
+    {1000, 557512000, 376184000, 15000,
+     557512091, 376184041, 15124, 2, 11761, 9, true},
+    {2000, 557512000, 376184000, 15000,
+     557511957, 376184391, 14973, 16, 30232, 10, true},
+    {3000, 557512000, 376184000, 15000,
+     557511988, 376184060, 14711, 13, 19232, 10, true},
+    {4000, 557512000, 376184000, 15000,
+     557511858, 376184018, 15335, 3, 3432, 11, true},
+    {5000, 557512000, 376184000, 15000,
+     557511928, 376184108, 14596, 9, 2242, 10, true},
+    {6000, 557512000, 376184000, 15000,
+     557512069, 376183802, 14724, 6, 34204, 11, true},
+    {7000, 557512000, 376184000, 15000,
+     557511799, 376184057, 15231, 5, 32968, 10, true},
+    {8000, 557512000, 376184000, 15000,
+     557511720, 376183966, 14785, 10, 3119, 11, true},
+    {9000, 557512000, 376184000, 15000,
+     557511797, 376183968, 15093, 11, 35367, 11, true},
+    {10000, 557512000, 376184000, 15000,
+     557511623, 376184134, 15079, 10, 27267, 11, true},
+    {11000, 557512000, 376184000, 15000,
+     557511905, 376183839, 15332, 9, 96, 11, true},
+    {12000, 557512000, 376184000, 15000,
+     557511914, 376184009, 15020, 12, 15319, 11, true},
+    {13000, 557512000, 376184000, 15000,
+     557511985, 376183981, 15228, 6, 28266, 12, true},
+    {14000, 557512000, 376184000, 15000,
+     557511906, 376184051, 15508, 1, 24671, 11, true},
+    {15000, 557512000, 376184000, 15000,
+     557511874, 376183888, 15865, 1, 13084, 12, true},
+    {16000, 557512000, 376184000, 15000,
+     557512001, 376183729, 15320, 13, 29351, 11, true},
+    {17000, 557512000, 376184000, 15000,
+     557511922, 376183780, 15254, 0, 15111, 12, true},
+    {18000, 557512000, 376184000, 15000,
+     557511909, 376183753, 15387, 1, 22642, 11, true},
+    {19000, 557512000, 376184000, 15000,
+     557511918, 376183907, 15668, 11, 11768, 11, true},
+    {20000, 557512000, 376184000, 15000,
+     557511791, 376183864, 15475, 5, 32043, 11, true},
+    {21000, 557512000, 376184000, 15000,
+     557511968, 376183931, 15271, 17, 26311, 11, true},
+    {22000, 557512000, 376184000, 15000,
+     557511778, 376183934, 15370, 2, 30324, 12, true},
+    {23000, 557512000, 376184000, 15000,
+     557511861, 376183672, 15319, 1, 30130, 12, true},
+    {24000, 557512000, 376184000, 15000,
+     557512153, 376183486, 15190, 24, 9727, 12, true},
+    {25000, 557512000, 376184000, 15000,
+     557511899, 376183536, 15695, 4, 26480, 11, true},
+    {26000, 557512000, 376184000, 15000,
+     557511856, 376183362, 15646, 15, 18713, 12, true},
+    {27000, 557512000, 376184000, 15000,
+     557511817, 376183617, 15496, 0, 17789, 12, true},
+    {28000, 557512000, 376184000, 15000,
+     557511811, 376183475, 15556, 5, 18853, 11, true},
+    {29000, 557512000, 376184000, 15000,
+     557511871, 376183279, 16363, 27, 16015, 12, true},
+    {30000, 557512000, 376184000, 15000,
+     557511852, 376183556, 15661, 7, 33098, 12, true},
+    {31000, 557512000, 376184000, 15000,
+     557511855, 376183341, 15891, 2, 35062, 13, true},
+    {32000, 557512000, 376184000, 15000,
+     557511857, 376183552, 15846, 8, 15961, 12, true},
+    {33000, 557512000, 376184000, 15000,
+     557511765, 376183724, 15865, 3, 11736, 12, true},
+    {34000, 557512000, 376184000, 15000,
+     557511692, 376184122, 15704, 0, 16072, 11, true},
+    {35000, 557512000, 376184000, 15000,
+     557511682, 376183755, 16149, 12, 11876, 11, true},
+    {36000, 557512000, 376184000, 15000,
+     557511823, 376183978, 15939, 15, 15136, 12, true},
+    {37000, 557512000, 376184000, 15000,
+     557511736, 376183923, 15891, 11, 24942, 11, true},
+    {38000, 557512000, 376184000, 15000,
+     557511654, 376183838, 15967, 0, 17790, 13, true},
+    {39000, 557512000, 376184000, 15000,
+     557511715, 376184122, 15469, 17, 4722, 12, true},
+    {40000, 557512000, 376184000, 15000,
+     557511914, 376184041, 15592, 6, 29440, 11, true},
+    {41000, 557512000, 376184000, 15000,
+     557511794, 376184053, 15590, 6, 1041, 12, true},
+    {42000, 557512000, 376184000, 15000,
+     557511862, 376183936, 15634, 13, 28045, 12, true},
+    {43000, 557512000, 376184000, 15000,
+     557511832, 376183992, 15200, 15, 4017, 13, true},
+    {44000, 557512000, 376184000, 15000,
+     557511864, 376184154, 15930, 24, 29710, 12, true},
+    {45000, 557512000, 376184000, 15000,
+     557511819, 376184026, 15338, 6, 34125, 12, true},
+    {46000, 557512000, 376184000, 15000,
+     557511782, 376183543, 15500, 11, 19127, 12, true},
+    {47000, 557512000, 376184000, 15000,
+     557511614, 376183900, 15390, 1, 11069, 13, true},
+    {48000, 557512000, 376184000, 15000,
+     557511809, 376184035, 15102, 2, 30240, 13, true},
+    {49000, 557512000, 376184000, 15000,
+     557511773, 376183788, 15354, 9, 12294, 12, true},
+    {50000, 557512000, 376184000, 15000,
+     557511558, 376183943, 15516, 3, 4251, 13, true},
+    {51000, 557512000, 376184000, 15000,
+     557511834, 376183888, 15093, 22, 9893, 13, true},
+    {52000, 557512000, 376184000, 15000,
+     557511731, 376183959, 15164, 10, 205, 12, true},
+    {53000, 557512000, 376184000, 15000,
+     557511685, 376184233, 15779, 1, 2721, 12, true},
+    {54000, 557512000, 376184000, 15000,
+     557511591, 376184133, 15827, 5, 28445, 13, true},
+    {55000, 557512000, 376184000, 15000,
+     557511710, 376184070, 15797, 17, 6520, 12, true},
+    {56000, 557512000, 376184000, 15000,
+     557511710, 376184325, 15510, 5, 35885, 14, true},
+    {57000, 557512000, 376184000, 15000,
+     557511956, 376184257, 15465, 1, 4754, 14, true},
+    {58000, 557512000, 376184000, 15000,
+     557511584, 376183745, 15071, 13, 3029, 12, true},
+    {59000, 557512000, 376184000, 15000,
+     557511817, 376183941, 15389, 3, 27533, 14, true},
+    {60000, 557512000, 376184000, 15000,
+     557512030, 376183960, 15488, 5, 15461, 13, true},
+    {61000, 557512000, 376184112, 15000,
+     557512091, 376184065, 15278, 149, 9121, 14, true},
+    {62000, 557512000, 376184447, 15000,
+     557511910, 376183979, 15410, 276, 9063, 13, true},
+    {63000, 557512000, 376185006, 15000,
+     557511993, 376184869, 15224, 409, 8959, 13, true},
+    {64000, 557512000, 376185788, 15000,
+     557511799, 376185670, 14733, 552, 8931, 12, true},
+    {65000, 557512000, 376186793, 15000,
+     557512064, 376186614, 15340, 698, 8954, 13, true},
+    {66000, 557512000, 376188022, 15000,
+     557511984, 376188184, 15142, 846, 9034, 14, true},
+    {67000, 557512000, 376189475, 15000,
+     557512017, 376189637, 15203, 974, 9011, 12, true},
+    {68000, 557512000, 376191151, 15000,
+     557511811, 376191329, 15120, 1124, 8955, 13, true},
+    {69000, 557512000, 376193050, 15000,
+     557511932, 376192971, 15238, 1252, 8970, 13, true},
+    {70000, 557512000, 376195173, 15000,
+     557511966, 376194996, 14919, 1407, 9010, 14, true},
+    {71000, 557512000, 376197408, 15017,
+     557511939, 376197490, 15582, 1403, 9019, 12, true},
+    {72000, 557512000, 376199643, 15033,
+     557511945, 376199745, 14829, 1402, 9003, 13, true},
+    {73000, 557512000, 376201877, 15050,
+     557512106, 376201828, 14894, 1396, 9140, 13, true},
+    {74000, 557512000, 376204112, 15067,
+     557512069, 376203761, 15269, 1390, 8951, 13, true},
+    {75000, 557512000, 376206347, 15083,
+     557511928, 376206382, 15433, 1417, 9025, 14, true},
+    {76000, 557512000, 376208581, 15100,
+     557511937, 376208584, 14968, 1393, 9045, 13, true},
+    {77000, 557512000, 376210816, 15117,
+     557511976, 376210627, 14802, 1405, 9088, 13, true},
+    {78000, 557512000, 376213051, 15133,
+     557512153, 376212908, 14780, 1406, 8954, 14, true},
+    {79000, 557512000, 376215285, 15150,
+     557512193, 376215199, 15253, 1396, 9001, 13, true},
+    {80000, 557512000, 376217520, 15167,
+     557511967, 376217198, 15240, 1417, 8961, 13, true},
+    {81000, 557512000, 376219754, 15183,
+     557511912, 376219750, 15162, 1398, 8995, 14, true},
+    {82000, 557512000, 376221989, 15200,
+     557511992, 376221905, 14939, 1400, 9030, 14, true},
+    {83000, 557512000, 376224224, 15217,
+     557511982, 376224533, 15438, 1395, 8954, 13, true},
+    {84000, 557512000, 376226458, 15233,
+     557511739, 376226531, 14867, 1395, 8943, 14, true},
+    {85000, 557512000, 376228693, 15250,
+     557511793, 376228554, 14701, 1390, 9100, 13, true},
+    {86000, 557512000, 376230928, 15267,
+     557511990, 376230661, 14955, 1398, 8974, 14, true},
+    {87000, 557512000, 376233162, 15283,
+     557512056, 376233001, 15007, 1404, 8996, 12, true},
+    {88000, 557512000, 376235397, 15300,
+     557512087, 376235320, 15106, 1400, 9034, 12, true},
+    {89000, 557512000, 376237632, 15317,
+     557512117, 376237584, 15273, 1407, 9017, 12, true},
+    {90000, 557512000, 376239866, 15333,
+     557511928, 376240063, 15248, 1398, 8985, 13, true},
+    {91000, 557512000, 376242101, 15350,
+     557511891, 376242057, 15231, 1402, 8949, 13, true},
+    {92000, 557512000, 376244336, 15367,
+     557512005, 376244078, 15339, 1401, 9045, 13, true},
+    {93000, 557512000, 376246570, 15383,
+     557511986, 376246740, 15177, 1402, 8969, 14, true},
+    {94000, 557512000, 376248805, 15400,
+     557512052, 376248984, 14915, 1391, 9009, 13, true},
+    {95000, 557512000, 376251040, 15417,
+     557511934, 376251119, 15567, 1405, 9069, 12, true},
+    {96000, 557512000, 376253274, 15433,
+     557511886, 376253405, 14715, 1392, 8916, 13, true},
+    {97000, 557512000, 376255509, 15450,
+     557511996, 376256088, 14838, 1388, 8977, 13, true},
+    {98000, 557512000, 376257744, 15467,
+     557512003, 376257923, 14290, 1396, 9055, 13, true},
+    {99000, 557512000, 376259978, 15483,
+     557512031, 376259854, 14326, 1400, 8986, 13, true},
+    {100000, 557512000, 376262213, 15500,
+     557511888, 376262393, 15100, 1402, 9072, 12, true},
+    {101000, 557512000, 376264448, 15517,
+     557511913, 376264758, 15290, 1392, 9052, 12, true},
+    {102000, 557512000, 376266682, 15533,
+     557511962, 376266868, 15420, 1402, 9019, 12, true},
+    {103000, 557512000, 376268917, 15550,
+     557511958, 376269108, 15416, 1397, 8923, 12, true},
+    {104000, 557512000, 376271152, 15567,
+     557511883, 376271425, 15572, 1388, 9019, 12, true},
+    {105000, 557512000, 376273386, 15583,
+     557512141, 376273422, 15419, 1399, 9006, 13, true},
+    {106000, 557512000, 376275621, 15600,
+     557512042, 376275916, 15204, 1398, 9046, 11, true},
+    {107000, 557512000, 376277855, 15617,
+     557512147, 376278337, 15195, 1394, 8954, 11, true},
+    {108000, 557512000, 376280090, 15633,
+     557512085, 376280069, 15559, 1409, 8970, 11, true},
+    {109000, 557512000, 376282325, 15650,
+     557511988, 376282800, 15078, 1409, 9031, 12, true},
+    {110000, 557512000, 376284559, 15667,
+     557511921, 376284697, 15247, 1384, 9012, 12, true},
+    {111000, 557512000, 376286794, 15683,
+     557512171, 376286618, 15610, 1412, 8986, 12, true},
+    {112000, 557512000, 376289029, 15700,
+     557512005, 376289296, 15385, 1386, 9009, 12, true},
+    {113000, 557512000, 376291263, 15717,
+     557512091, 376291385, 15446, 1393, 8901, 12, true},
+    {114000, 557512000, 376293498, 15733,
+     557512064, 376293659, 15529, 1404, 9094, 11, true},
+    {115000, 557512000, 376295733, 15750,
+     557511847, 376295964, 15284, 1407, 8964, 12, true},
+    {116000, 557512000, 376297967, 15767,
+     557511990, 376298219, 15878, 1401, 8972, 11, true},
+    {117000, 557512000, 376300202, 15783,
+     557512007, 376300391, 15916, 1396, 8991, 11, true},
+    {118000, 557512000, 376302437, 15800,
+     557511977, 376302604, 15908, 1406, 8872, 11, true},
+    {119000, 557512000, 376304671, 15817,
+     557511896, 376304949, 16029, 1394, 8952, 12, true},
+    {120000, 557512000, 376306906, 15833,
+     557511977, 376306954, 16016, 1400, 9042, 11, true},
+    {121000, 557512000, 376309141, 15850,
+     557511914, 376309110, 16059, 1408, 9014, 12, true},
+    {122000, 557512000, 376311375, 15867,
+     557511949, 376311445, 16323, 1402, 8894, 10, true},
+    {123000, 557512000, 376313610, 15883,
+     557512035, 376313660, 16242, 1403, 9033, 12, true},
+    {124000, 557512000, 376315845, 15900,
+     557511970, 376316092, 16063, 1397, 8976, 12, true},
+    {125000, 557512000, 376318079, 15917,
+     557511947, 376318220, 16132, 1394, 9009, 12, true},
+    {126000, 557512000, 376320314, 15933,
+     557511971, 376319963, 16201, 1394, 9015, 11, true},
+    {127000, 557512000, 376322549, 15950,
+     557512039, 376322487, 16225, 1384, 8885, 11, true},
+    {128000, 557512000, 376324783, 15967,
+     557511933, 376324722, 16374, 1401, 8927, 12, true},
+    {129000, 557512000, 376327018, 15983,
+     557511862, 376326527, 16834, 1397, 9007, 11, true},
+    {130000, 557512000, 376329253, 16000,
+     557511941, 376329168, 17046, 1404, 9008, 10, true},
+    {131000, 557512000, 376331487, 16017,
+     557511732, 376331366, 16990, 1402, 8961, 11, true},
+    {132000, 557512000, 376333722, 16033,
+     557511836, 376333539, 16598, 1398, 8874, 11, true},
+    {133000, 557512000, 376335956, 16050,
+     557511831, 376335657, 16792, 1390, 8905, 10, true},
+    {134000, 557512000, 376338191, 16067,
+     557511823, 376337932, 16916, 1396, 9022, 10, true},
+    {135000, 557512000, 376340426, 16083,
+     557511889, 376340367, 16765, 1385, 9055, 10, true},
+    {136000, 557512000, 376342660, 16100,
+     557511922, 376342687, 16595, 1389, 8953, 10, true},
+    {137000, 557512000, 376344895, 16117,
+     557511784, 376344660, 16778, 1410, 8922, 9, true},
+    {138000, 557512000, 376347130, 16133,
+     557511938, 376347156, 16755, 1391, 8946, 11, true},
+    {139000, 557512000, 376349364, 16150,
+     557511851, 376349359, 16507, 1395, 9069, 10, true},
+    {140000, 557512000, 376351599, 16167,
+     557511902, 376351683, 16625, 1400, 9029, 9, true},
+    {141000, 557512000, 376353834, 16183,
+     557511931, 376353827, 16730, 1394, 8950, 10, true},
+    {142000, 557512000, 376356068, 16200,
+     557511979, 376356186, 16859, 1395, 8990, 9, true},
+    {143000, 557512000, 376358303, 16217,
+     557511992, 376358565, 16635, 1402, 9053, 11, true},
+    {144000, 557512000, 376360538, 16233,
+     557511957, 376360603, 16644, 1391, 8915, 9, true},
+    {145000, 557512000, 376362772, 16250,
+     557511906, 376362735, 16719, 1405, 8902, 10, true},
+    {146000, 557512000, 376365007, 16267,
+     557511885, 376365045, 16716, 1409, 9098, 9, true},
+    {147000, 557512000, 376367242, 16283,
+     557511887, 376367247, 16561, 1387, 9035, 9, true},
+    {148000, 557512000, 376369476, 16300,
+     557511833, 376369423, 16619, 1390, 9015, 9, true},
+    {149000, 557512000, 376371711, 16317,
+     557511700, 376371757, 16733, 1402, 8970, 9, true},
+    {150000, 557512000, 376373946, 16333,
+     557511719, 376374003, 16665, 1414, 8946, 10, true},
+    {151000, 557512000, 376376180, 16350,
+     557511842, 376376200, 16698, 1374, 8984, 9, true},
+    {152000, 557512000, 376378415, 16367,
+     557511934, 376378733, 16712, 1408, 8914, 9, true},
+    {153000, 557512000, 376380650, 16383,
+     557511914, 376380929, 16519, 1393, 9015, 9, true},
+    {154000, 557512000, 376382884, 16400,
+     557512006, 376383135, 16460, 1395, 9005, 9, true},
+    {155000, 557512000, 376385119, 16417,
+     557512034, 376385189, 16614, 1403, 9071, 10, true},
+    {156000, 557512000, 376387354, 16433,
+     557511876, 376387456, 16649, 1405, 9060, 9, true},
+    {157000, 557512000, 376389588, 16450,
+     557512001, 376389639, 16833, 1381, 9038, 9, true},
+    {158000, 557512000, 376391823, 16467,
+     557511957, 376392042, 16806, 1403, 9018, 10, true},
+    {159000, 557512000, 376394057, 16483,
+     557512080, 376394242, 17255, 1396, 9016, 10, true},
+    {160000, 557512000, 376396292, 16500,
+     557512109, 376396322, 17111, 1418, 8903, 9, true},
+    {161000, 557512000, 376398527, 16517,
+     557511983, 376398819, 16911, 1405, 8952, 9, true},
+    {162000, 557512000, 376400761, 16533,
+     557511929, 376400880, 16745, 1388, 8944, 8, true},
+    {163000, 557512000, 376402996, 16550,
+     557512017, 376402999, 16782, 1401, 9014, 9, true},
+    {164000, 557512000, 376405231, 16567,
+     557511989, 376405180, 16576, 1399, 8943, 8, true},
+    {165000, 557512000, 376407465, 16583,
+     557511954, 376407593, 16610, 1416, 9016, 9, true},
+    {166000, 557512000, 376409700, 16600,
+     557512023, 376410023, 16603, 1406, 8944, 9, true},
+    {167000, 557512000, 376411935, 16617,
+     557512012, 376412126, 16287, 1418, 8981, 8, true},
+    {168000, 557512000, 376414169, 16633,
+     557511979, 376414568, 16435, 1396, 9036, 9, true},
+    {169000, 557512000, 376416404, 16650,
+     557511973, 376416726, 16118, 1386, 8957, 8, true},
+    {170000, 557512000, 376418639, 16667,
+     557511976, 376419000, 16554, 1396, 9113, 9, true},
+    {171000, 557512000, 376420873, 16683,
+     557512082, 376421352, 16590, 1405, 9004, 8, true},
+    {172000, 557512000, 376423108, 16700,
+     557511992, 376423415, 16468, 1404, 9046, 8, true},
+    {173000, 557512000, 376425343, 16717,
+     557512052, 376425707, 16607, 1399, 8982, 8, true},
+    {174000, 557512000, 376427577, 16733,
+     557512045, 376427866, 16880, 1421, 9010, 8, true},
+    {175000, 557512000, 376429812, 16750,
+     557511938, 376430086, 16665, 1408, 9045, 8, true},
+    {176000, 557512000, 376432047, 16767,
+     557511938, 376432339, 16703, 1402, 9067, 8, true},
+    {177000, 557512000, 376434281, 16783,
+     557511952, 376434466, 16458, 1402, 9030, 9, true},
+    {178000, 557512000, 376436516, 16800,
+     557511933, 376436746, 16989, 1405, 8972, 7, true},
+    {179000, 557512000, 376438751, 16817,
+     557511961, 376439039, 16917, 1409, 9002, 8, true},
+    {180000, 557512000, 376440985, 16833,
+     557511862, 376441372, 16791, 1383, 8999, 9, true},
+    {181000, 557512000, 376443220, 16850,
+     557511999, 376443410, 16849, 1393, 8997, 8, true},
+    {182000, 557512000, 376445455, 16867,
+     557511986, 376445689, 16976, 1399, 9046, 7, true},
+    {183000, 557512000, 376447689, 16883,
+     557511993, 376447929, 16800, 1403, 8990, 8, true},
+    {184000, 557512000, 376449924, 16900,
+     557511985, 376450320, 16810, 1390, 8964, 7, true},
+    {185000, 557512000, 376452158, 16917,
+     557512071, 376452364, 17057, 1388, 8945, 8, true},
+    {186000, 557512000, 376454393, 16933,
+     557512026, 376454836, 16828, 1393, 9109, 7, true},
+    {187000, 557512000, 376456628, 16950,
+     557511915, 376457087, 17158, 1392, 9036, 7, true},
+    {188000, 557512000, 376458862, 16967,
+     557512041, 376459242, 17545, 1400, 9008, 8, true},
+    {189000, 557512000, 376461097, 16983,
+     557512044, 376461387, 17606, 1396, 9024, 7, true},
+    {190000, 557512000, 376463332, 17000,
+     557512076, 376463468, 17545, 1406, 8997, 8, true},
+    {191000, 557512099, 376465560, 17000,
+     557512104, 376465826, 17225, 1405, 8080, 7, true},
+    {192000, 557512392, 376467733, 17000,
+     557512385, 376467809, 17326, 1395, 7139, 7, true},
+    {193000, 557512874, 376469798, 17000,
+     557512864, 376470130, 17343, 1413, 6225, 8, true},
+    {194000, 557513531, 376471703, 17000,
+     557513545, 376472013, 17319, 1393, 5408, 7, true},
+    {195000, 557514347, 376473403, 17000,
+     557514229, 376473800, 17291, 1388, 4446, 8, true},
+    {196000, 557515304, 376474855, 17000,
+     557515201, 376475319, 17313, 1403, 3630, 8, true},
+    {197000, 557516376, 376476024, 17000,
+     557516419, 376476267, 17532, 1416, 2677, 7, true},
+    {198000, 557517538, 376476880, 17000,
+     557517593, 376477069, 17369, 1397, 1721, 7, true},
+    {199000, 557518761, 376477402, 17000,
+     557518824, 376477812, 17340, 1395, 936, 6, true},
+    {200000, 557520015, 376477579, 17000,
+     557519962, 376477709, 17469, 1392, 94, 7, true},
+    {201000, 557521209, 376477580, 17000,
+     557521304, 376477893, 17223, 1261, 35958, 6, true},
+    {202000, 557522278, 376477580, 17000,
+     557522302, 376477766, 17319, 1123, 35974, 7, true},
+    {203000, 557523222, 376477581, 17000,
+     557523258, 376477834, 17514, 985, 35976, 8, true},
+    {204000, 557524039, 376477582, 17000,
+     557524046, 376477823, 17290, 850, 19, 7, true},
+    {205000, 557524731, 376477582, 17000,
+     557524736, 376477781, 17292, 693, 20, 7, true},
+    {206000, 557525297, 376477583, 17000,
+     557525286, 376477782, 17509, 556, 35952, 8, true},
+    {207000, 557525737, 376477583, 17000,
+     557525701, 376477745, 17291, 417, 35940, 7, true},
+    {208000, 557526051, 376477583, 17000,
+     557525983, 376477753, 17294, 285, 35946, 7, true},
+    {209000, 557526240, 376477583, 17000,
+     557526240, 376477820, 17470, 149, 35989, 7, true},
+    {210000, 557526303, 376477583, 17000,
+     557526263, 376477961, 16881, 7, 2492, 7, true},
+    {211000, 557526303, 376477583, 17000,
+     557526262, 376477763, 17117, 8, 33650, 7, true},
+    {212000, 557526303, 376477583, 17000,
+     557526235, 376477695, 17144, 17, 16009, 6, true},
+    {213000, 557526303, 376477583, 17000,
+     557526264, 376477665, 17154, 0, 31867, 6, true},
+    {214000, 557526303, 376477583, 17000,
+     557526242, 376477777, 17074, 4, 15525, 7, true},
+    {215000, 557526303, 376477583, 17000,
+     557526196, 376477620, 16973, 8, 9357, 6, true},
+    {216000, 557526303, 376477583, 17000,
+     557526211, 376477555, 17085, 0, 27206, 7, true},
+    {217000, 557526303, 376477583, 17000,
+     557526020, 376477705, 16839, 4, 11166, 8, true},
+    {218000, 557526303, 376477583, 17000,
+     557526173, 376477720, 16561, 5, 14002, 7, true},
+    {219000, 557526303, 376477583, 17000,
+     557526136, 376477718, 16805, 7, 3736, 7, true},
+    {220000, 557526303, 376477583, 17000,
+     557526076, 376477638, 16897, 6, 35963, 7, true},
+    {221000, 557526303, 376477583, 17000,
+     557526157, 376477667, 16371, 0, 6458, 8, true},
+    {222000, 557526303, 376477583, 17000,
+     557526138, 376477611, 16857, 2, 20753, 8, true},
+    {223000, 557526303, 376477583, 17000,
+     557526124, 376477611, 16776, 2, 34281, 8, true},
+    {224000, 557526303, 376477583, 17000,
+     557526291, 376477714, 16695, 8, 26887, 6, true},
+    {225000, 557526303, 376477583, 17000,
+     557526195, 376477631, 16412, 4, 6381, 7, true},
+    {226000, 557526303, 376477583, 17000,
+     557526311, 376477476, 16731, 12, 29058, 8, true},
+    {227000, 557526303, 376477583, 17000,
+     557526229, 376477630, 16539, 21, 31124, 7, true},
+    {228000, 557526303, 376477583, 17000,
+     557526218, 376477681, 16748, 6, 10421, 6, true},
+    {229000, 557526303, 376477583, 17000,
+     557526288, 376477687, 16676, 4, 1272, 7, true},
+    {230000, 557526303, 376477583, 17000,
+     557526290, 376477474, 16719, 7, 1782, 7, true},
+    {231000, 557526303, 376477583, 17000,
+     557526157, 376477488, 16717, 3, 14368, 8, true},
+    {232000, 557526303, 376477583, 17000,
+     557526452, 376477333, 16763, 9, 2227, 7, true},
+    {233000, 557526303, 376477583, 17000,
+     557526273, 376477517, 16750, 1, 20890, 6, true},
+    {234000, 557526303, 376477583, 17000,
+     557526393, 376477177, 16841, 1, 10801, 8, true},
+    {235000, 557526303, 376477583, 17000,
+     557526389, 376477125, 16976, 2, 33902, 8, true},
+    {236000, 557526303, 376477583, 17000,
+     557526459, 376477325, 16485, 2, 35637, 7, true},
+    {237000, 557526303, 376477583, 17000,
+     557526497, 376477295, 16825, 5, 2517, 7, true},
+    {238000, 557526303, 376477583, 17000,
+     557526473, 376477158, 16555, 13, 35550, 8, true},
+    {239000, 557526303, 376477583, 17000,
+     557526398, 376477137, 16342, 2, 12413, 8, true},
+    {240000, 557526303, 376477583, 17000,
+     557526721, 376477247, 16357, 6, 4906, 8, true},
+    {241000, 557526357, 376477583, 17000,
+     557526641, 376477108, 16368, 127, 99, 8, true},
+    {242000, 557526518, 376477584, 17000,
+     557526763, 376477295, 16637, 244, 11, 8, true},
+    {243000, 557526788, 376477584, 17000,
+     557526957, 376477450, 16601, 359, 33, 7, true},
+    {244000, 557527165, 376477584, 17000,
+     557527474, 376477354, 16520, 483, 35972, 9, true},
+    {245000, 557527650, 376477584, 17000,
+     557527928, 376477645, 16417, 609, 14, 8, true},
+    {246000, 557528243, 376477585, 17000,
+     557528425, 376477476, 16538, 717, 5, 8, true},
+    {247000, 557528944, 376477585, 17000,
+     557529304, 376477434, 16379, 845, 35945, 7, true},
+    {248000, 557529752, 376477586, 17000,
+     557529991, 376477611, 16380, 944, 35930, 8, true},
+    {249000, 557530669, 376477587, 17000,
+     557530960, 376477289, 16541, 1074, 35996, 8, true},
+    {250000, 557531693, 376477587, 17000,
+     557531988, 376477406, 16590, 1208, 35954, 8, true},
+    {251000, 557532771, 376477588, 17000,
+     557532994, 376477460, 16584, 1201, 87, 7, true},
+    {252000, 557533849, 376477589, 17000,
+     557534223, 376477312, 16379, 1202, 35947, 8, true},
+    {253000, 557534927, 376477590, 17000,
+     557535394, 376477359, 16437, 1196, 16, 8, true},
+    {254000, 557536005, 376477591, 17000,
+     557536197, 376477461, 16516, 1205, 9, 7, true},
+    {255000, 557537083, 376477592, 17000,
+     557537399, 376477471, 16620, 1202, 35899, 8, true},
+    {256000, 557538160, 376477592, 17000,
+     557538551, 376477647, 16589, 1207, 13, 8, true},
+    {257000, 557539238, 376477593, 17000,
+     557539470, 376477712, 16235, 1207, 35998, 9, true},
+    {258000, 557540316, 376477594, 17000,
+     557540631, 376477500, 16398, 1196, 35980, 9, true},
+    {259000, 557541394, 376477595, 17000,
+     557541745, 376477302, 16315, 1187, 36, 8, true},
+    {260000, 557542472, 376477596, 17000,
+     557542775, 376477757, 16505, 1204, 35940, 9, true},
+    {261000, 557543550, 376477596, 17000,
+     557543730, 376477539, 16445, 1212, 50, 8, true},
+    {262000, 557544628, 376477597, 17000,
+     557544882, 376477529, 16950, 1208, 7, 10, true},
+    {263000, 557545706, 376477598, 17000,
+     557545910, 376477568, 16571, 1203, 35, 9, true},
+    {264000, 557546784, 376477599, 17000,
+     557547126, 376477385, 16528, 1211, 35923, 9, true},
+    {265000, 557547862, 376477600, 17000,
+     557548181, 376477460, 16182, 1187, 23, 8, true},
+    {266000, 557548940, 376477600, 17000,
+     557549229, 376477666, 16697, 1188, 35992, 10, true},
+    {267000, 557550018, 376477601, 17000,
+     557550319, 376477598, 16892, 1190, 35883, 9, true},
+    {268000, 557551096, 376477602, 17000,
+     557551384, 376477583, 16530, 1192, 20, 9, true},
+    {269000, 557552174, 376477603, 17000,
+     557552675, 376477644, 16760, 1192, 8, 10, true},
+    {270000, 557553252, 376477604, 17000,
+     557553415, 376477962, 16304, 1211, 35964, 9, true},
+    {271000, 557554330, 376477605, 17000,
+     557554591, 376477841, 16187, 1199, 35961, 9, true},
+    {272000, 557555408, 376477605, 17000,
+     557555894, 376478012, 16377, 1191, 35929, 10, true},
+    {273000, 557556486, 376477606, 17000,
+     557556885, 376478036, 16223, 1200, 35949, 10, true},
+    {274000, 557557564, 376477607, 17000,
+     557557864, 376478086, 16257, 1178, 35960, 9, true},
+    {275000, 557558642, 376477608, 17000,
+     557558871, 376478023, 16536, 1187, 35982, 9, true},
+    {276000, 557559720, 376477609, 17000,
+     557560148, 376477974, 16324, 1190, 35926, 10, true},
+    {277000, 557560798, 376477609, 17000,
+     557561250, 376477867, 16410, 1190, 35998, 9, true},
+    {278000, 557561876, 376477610, 17000,
+     557562268, 376477833, 16658, 1202, 35995, 10, true},
+    {279000, 557562954, 376477611, 17000,
+     557563097, 376477909, 16543, 1210, 81, 10, true},
+    {280000, 557564032, 376477612, 17000,
+     557564267, 376483507, 16711, 1197, 27, 10, true},
+    {281000, 557565110, 376477613, 17000,
+     557565392, 376477914, 16717, 1216, 35, 11, true},
+    {282000, 557566188, 376477613, 17000,
+     557566396, 376478127, 16482, 1201, 35963, 10, true},
+    {283000, 557567266, 376477614, 17000,
+     557567425, 376477851, 16422, 1205, 35979, 9, true},
+    {284000, 557568344, 376477615, 17000,
+     557568516, 376478106, 16824, 1199, 35, 11, true},
+    {285000, 557569422, 376477616, 17000,
+     557569612, 376477804, 16945, 1201, 35980, 10, true},
+    {286000, 557570500, 376477617, 17000,
+     557570630, 376477736, 16877, 1188, 64, 11, true},
+    {287000, 557571578, 376477617, 17000,
+     557571740, 376477909, 17048, 1198, 35983, 11, true},
+    {288000, 557572656, 376477618, 17000,
+     557572814, 376477668, 16779, 1197, 6, 10, true},
+    {289000, 557573734, 376477619, 17000,
+     557573706, 376477589, 16518, 1197, 26, 10, true},
+    {290000, 557574812, 376477620, 17000,
+     557574862, 376477834, 16691, 1204, 35952, 10, true},
+    {291000, 557575890, 376477621, 17000,
+     557575913, 376477564, 16509, 1180, 35996, 10, true},
+    {292000, 557576968, 376477622, 17000,
+     557577080, 376477617, 16872, 1197, 35920, 11, true},
+    {293000, 557578045, 376477622, 17000,
+     557578152, 376477742, 16438, 1192, 78, 11, true},
+    {294000, 557579123, 376477623, 17000,
+     557579278, 376477465, 16698, 1204, 2, 10, true},
+    {295000, 557580201, 376477624, 17000,
+     557580176, 376478074, 16531, 1208, 35913, 12, true},
+    {296000, 557581279, 376477625, 17000,
+     557581464, 376477964, 16696, 1198, 41, 12, true},
+    {297000, 557582357, 376477626, 17000,
+     557582514, 376477854, 16972, 1204, 76, 11, true},
+    {298000, 557583435, 376477626, 17000,
+     557583604, 376477649, 16867, 1195, 45, 10, true},
+    {299000, 557584513, 376477627, 17000,
+     557584621, 376477955, 16368, 1190, 47, 12, true},
+    {300000, 557585591, 376477628, 17000,
+     557585706, 376477832, 16763, 1197, 41, 11, true},
+    {301000, 557586669, 376477629, 17000,
+     557586849, 376477732, 16487, 1193, 69, 10, true},
+    {302000, 557587747, 376477630, 17000,
+     557587943, 376477766, 17150, 1196, 35954, 11, true},
+    {303000, 557588825, 376477630, 17000,
+     557589096, 376477464, 16717, 1195, 30, 11, true},
+    {304000, 557589903, 376477631, 17000,
+     557590159, 376477445, 16478, 1192, 28, 11, true},
+    {305000, 557590981, 376477632, 17000,
+     557591211, 376477400, 16685, 1207, 57, 11, true},
+    {306000, 557592059, 376477633, 17000,
+     557592231, 376477299, 16659, 1197, 35934, 11, true},
+    {307000, 557593137, 376477634, 17000,
+     557593229, 376477414, 16304, 1220, 35980, 12, true},
+    {308000, 557594215, 376477635, 17000,
+     557594438, 376477613, 16938, 1203, 35934, 11, true},
+    {309000, 557595293, 376477635, 17000,
+     557595522, 376477602, 16844, 1206, 35989, 12, true},
+    {310000, 557596371, 376477636, 17000,
+     557596513, 376477451, 16915, 1207, 35977, 12, true},
+    {311000, 557597449, 376477637, 17000,
+     557597556, 376477718, 16831, 1199, 35951, 12, true},
+    {312000, 557598527, 376477638, 17000,
+     557598562, 376477572, 16874, 1196, 6, 11, true},
+    {313000, 557599605, 376477639, 17000,
+     557599522, 376477621, 16631, 1204, 1, 12, true},
+    {314000, 557600683, 376477639, 17000,
+     557600621, 376477719, 16838, 1205, 35982, 12, true},
+    {315000, 557601761, 376477640, 17000,
+     557601711, 376477694, 16679, 1189, 29, 11, true},
+    {316000, 557602839, 376477641, 17000,
+     557602738, 376477683, 17119, 1201, 44, 12, true},
+    {317000, 557603917, 376477642, 17000,
+     557603755, 376477677, 16692, 1198, 35988, 12, true},
+    {318000, 557604995, 376477643, 17000,
+     557604677, 376477120, 16505, 1194, 35984, 12, true},
+    {319000, 557606073, 376477643, 17000,
+     557605715, 376477406, 17034, 1209, 94, 11, true},
+    {320000, 557607151, 376477644, 17000,
+     557606916, 376477355, 16738, 1199, 35997, 11, true},
+    {321000, 557608229, 376477645, 17000,
+     557608135, 376477150, 16708, 1199, 35978, 13, true},
+    {322000, 557609307, 376477646, 17000,
+     557608922, 376477243, 16684, 1204, 54, 13, true},
+    {323000, 557610385, 376477647, 17000,
+     557610089, 376477101, 17132, 1202, 35992, 11, true},
+    {324000, 557611463, 376477648, 17000,
+     557611087, 376477241, 16828, 1199, 35976, 12, true},
+    {325000, 557612541, 376477648, 17000,
+     557612376, 376477324, 17071, 1206, 58, 12, true},
+    {326000, 557613619, 376477649, 17000,
+     557613297, 376477859, 17704, 1187, 35974, 12, true},
+    {327000, 557614697, 376477650, 17000,
+     557614619, 376477328, 17168, 1191, 35978, 13, true},
+    {328000, 557615775, 376477651, 17000,
+     557615811, 376477326, 16786, 1211, 30, 12, true},
+    {329000, 557616853, 376477652, 17000,
+     557616765, 376477669, 17378, 1194, 35996, 12, true},
+    {330000, 557617931, 376477652, 17000,
+     557617868, 376477485, 17100, 1192, 35956, 13, false},
+    {331000, 557619008, 376477653, 17000,
+     557619032, 376477651, 17500, 1191, 17, 13, false},
+    {332000, 557620086, 376477654, 17000,
+     557620179, 376477399, 17324, 1201, 6, 12, false},
+    {333000, 557621164, 376477655, 17000,
+     557620905, 376477701, 17481, 1194, 28, 13, false},
+    {334000, 557622242, 376477656, 17000,
+     557622213, 376477392, 17742, 1194, 35981, 14, false},
+    {335000, 557623320, 376477656, 17000,
+     557623260, 376477642, 18007, 1198, 35992, 12, false},
+    {336000, 557624398, 376477657, 17000,
+     557624309, 376477638, 17684, 1210, 35983, 13, false},
+    {337000, 557625476, 376477658, 17000,
+     557625318, 376477524, 17989, 1197, 35968, 12, false},
+    {338000, 557626554, 376477659, 17000,
+     557626498, 376477700, 17543, 1198, 68, 14, false},
+    {339000, 557627632, 376477660, 17000,
+     557627582, 376477571, 17553, 1194, 35, 13, false},
+    {340000, 557628710, 376477661, 17000,
+     557628434, 376477778, 17596, 1206, 5, 14, false},
+    {341000, 557629788, 376477661, 17000,
+     557629625, 376477881, 17256, 1190, 145, 12, false},
+    {342000, 557630866, 376477662, 17000,
+     557630770, 376477933, 17050, 1200, 14, 13, false},
+    {343000, 557631944, 376477663, 17000,
+     557631990, 376477790, 17112, 1208, 35946, 12, false},
+    {344000, 557633022, 376477664, 17000,
+     557633043, 376477838, 17120, 1200, 9, 12, false},
+    {345000, 557634100, 376477665, 17000,
+     557634153, 376478133, 17256, 1207, 35924, 12, false},
+    {346000, 557635178, 376477665, 17000,
+     557635287, 376477878, 17337, 1206, 35938, 14, false},
+    {347000, 557636256, 376477666, 17000,
+     557636352, 376477495, 17302, 1204, 35967, 12, false},
+    {348000, 557637334, 376477667, 17000,
+     557637226, 376477460, 17177, 1210, 35887, 13, false},
+    {349000, 557638412, 376477668, 17000,
+     557638295, 376477565, 17118, 1204, 0, 12, false},
+    {350000, 557639490, 376477669, 17000,
+     557639417, 376477960, 17151, 1207, 12, 13, true},
+    {351000, 557640568, 376477669, 16986,
+     557640665, 376477574, 17666, 1194, 35996, 12, true},
+    {352000, 557641646, 376477670, 16971,
+     557641524, 376477889, 17076, 1206, 70, 13, true},
+    {353000, 557642724, 376477671, 16957,
+     557642584, 376477734, 17005, 1211, 14, 13, true},
+    {354000, 557643802, 376477672, 16943,
+     557643722, 376477480, 17517, 1215, 35936, 14, true},
+    {355000, 557644880, 376477673, 16929,
+     557644790, 376477919, 17923, 1201, 35923, 14, true},
+    {356000, 557645958, 376477674, 16914,
+     557645920, 376477754, 17586, 1193, 35984, 13, true},
+    {357000, 557647036, 376477674, 16900,
+     557646834, 376477851, 17621, 1196, 42, 12, true},
+    {358000, 557648114, 376477675, 16886,
+     557647933, 376477607, 16978, 1199, 35989, 14, true},
+    {359000, 557649192, 376477676, 16871,
+     557648934, 376477629, 17387, 1190, 35932, 14, true},
+    {360000, 557650270, 376477677, 16857,
+     557650087, 376477751, 17706, 1200, 44, 12, true},
+    {361000, 557651348, 376477678, 16843,
+     557651281, 376477843, 17060, 1194, 35878, 12, true},
+    {362000, 557652426, 376477678, 16829,
+     557652180, 376477809, 17405, 1202, 21, 14, true},
+    {363000, 557653504, 376477679, 16814,
+     557653301, 376477527, 17351, 1201, 35916, 13, true},
+    {364000, 557654582, 376477680, 16800,
+     557654543, 376477534, 16599, 1209, 35961, 12, true},
+    {365000, 557655660, 376477681, 16786,
+     557655461, 376477317, 16768, 1201, 35910, 13, true},
+    {366000, 557656738, 376477682, 16771,
+     557656508, 376477369, 17779, 1208, 35909, 13, true},
+    {367000, 557657816, 376477682, 16757,
+     557657789, 376477663, 17186, 1201, 37, 12, true},
+    {368000, 557658894, 376477683, 16743,
+     557658760, 376477579, 17339, 1206, 40, 14, true},
+    {369000, 557659971, 376477684, 16729,
+     557659711, 376477669, 17226, 1190, 50, 14, true},
+    {370000, 557661049, 376477685, 16714,
+     557661158, 376477471, 17574, 1198, 28, 12, true},
+    {371000, 557662127, 376477686, 16700,
+     557662022, 376477444, 17380, 1201, 35963, 12, true},
+    {372000, 557663205, 376477686, 16686,
+     557663065, 376477379, 17164, 1194, 35981, 12, true},
+    {373000, 557664283, 376477687, 16671,
+     557664067, 376477419, 17082, 1205, 89, 12, true},
+    {374000, 557665361, 376477688, 16657,
+     557665101, 376477364, 17046, 1213, 35992, 13, true},
+    {375000, 557666439, 376477689, 16643,
+     557666141, 376477772, 17144, 1199, 9, 12, true},
+    {376000, 557667517, 376477690, 16629,
+     557667407, 376477736, 17255, 1204, 26, 13, true},
+    {377000, 557668595, 376477691, 16614,
+     557668355, 376477551, 17288, 1199, 145, 13, true},
+    {378000, 557669673, 376477691, 16600,
+     557669647, 376477540, 16900, 1196, 35998, 12, true},
+    {379000, 557670751, 376477692, 16586,
+     557670563, 376477736, 16943, 1198, 35970, 12, true},
+    {380000, 557671829, 376477693, 16571,
+     557671612, 376477490, 16827, 1204, 37, 12, true},
+    {381000, 557672907, 376477694, 16557,
+     557672624, 376476977, 16790, 1198, 35964, 13, true},
+    {382000, 557673985, 376477695, 16543,
+     557673581, 376477210, 17144, 1207, 0, 12, true},
+    {383000, 557675063, 376477695, 16529,
+     557674838, 376477008, 17018, 1193, 137, 12, true},
+    {384000, 557676141, 376477696, 16514,
+     557676008, 376477329, 16722, 1185, 35921, 12, true},
+    {385000, 557677219, 376477697, 16500,
+     557676900, 376477294, 16638, 1195, 34, 13, true},
+    {386000, 557678297, 376477698, 16486,
+     557678101, 376477094, 16733, 1205, 93, 13, true},
+    {387000, 557679375, 376477699, 16471,
+     557679208, 376477289, 16669, 1199, 14, 12, true},
+    {388000, 557680453, 376477699, 16457,
+     557680289, 376477398, 16566, 1183, 35974, 12, true},
+    {389000, 557681531, 376477700, 16443,
+     557681371, 376477515, 16505, 1179, 2, 11, true},
+    {390000, 557682609, 376477701, 16429,
+     557682569, 376477698, 16673, 1188, 35922, 11, true},
+    {391000, 557683687, 376477702, 16414,
+     557683491, 376477494, 16460, 1201, 20, 12, true},
+    {392000, 557684765, 376477703, 16400,
+     557684643, 376477548, 16599, 1198, 24, 12, true},
+    {393000, 557685843, 376477704, 16386,
+     557685673, 376477835, 16130, 1199, 35983, 12, true},
+    {394000, 557686921, 376477704, 16371,
+     557686816, 376477697, 16411, 1202, 35, 12, true},
+    {395000, 557687999, 376477705, 16357,
+     557687801, 376477702, 16334, 1188, 28, 11, true},
+    {396000, 557689077, 376477706, 16343,
+     557688980, 376477544, 16162, 1216, 35985, 12, true},
+    {397000, 557690155, 376477707, 16329,
+     557689915, 376477752, 15980, 1182, 35945, 12, true},
+    {398000, 557691233, 376477708, 16314,
+     557691065, 376477939, 16226, 1201, 111, 12, true},
+    {399000, 557692311, 376477708, 16300,
+     557692142, 376477814, 16365, 1200, 35992, 13, true},
+    {400000, 557693389, 376477709, 16286,
+     557693133, 376477873, 15782, 1203, 35913, 11, true},
+    {401000, 557694467, 376477710, 16271,
+     557694563, 376477729, 16025, 1199, 35966, 11, true},
+    {402000, 557695545, 376477711, 16257,
+     557695457, 376477815, 15779, 1193, 35992, 11, true},
+    {403000, 557696623, 376477712, 16243,
+     557696556, 376478143, 15859, 1201, 35980, 12, true},
+    {404000, 557697701, 376477712, 16229,
+     557697542, 376477739, 15862, 1200, 35989, 10, true},
+    {405000, 557698779, 376477713, 16214,
+     557698683, 376477935, 15686, 1213, 30, 11, true},
+    {406000, 557699856, 376477714, 16200,
+     557699800, 376477617, 15705, 1192, 54, 12, true},
+    {407000, 557700934, 376477715, 16186,
+     557700903, 376477847, 15861, 1180, 37, 10, true},
+    {408000, 557702012, 376477716, 16171,
+     557701872, 376477848, 16212, 1185, 35990, 10, true},
+    {409000, 557703090, 376477717, 16157,
+     557703018, 376477825, 16081, 1199, 35982, 11, true},
+    {410000, 557704168, 376477717, 16143,
+     557704226, 376477650, 15635, 1195, 35946, 10, true},
+    {411000, 557705246, 376477718, 16129,
+     557705113, 376477947, 15562, 1207, 35966, 10, true},
+    {412000, 557706324, 376477719, 16114,
+     557706235, 376477689, 15372, 1209, 88, 12, true},
+    {413000, 557707402, 376477720, 16100,
+     557707265, 376477635, 15459, 1204, 35958, 11, true},
+    {414000, 557708480, 376477721, 16086,
+     557708507, 376477448, 15433, 1188, 44, 11, true},
+    {415000, 557709558, 376477721, 16071,
+     557709399, 376477852, 15706, 1199, 122, 10, true},
+    {416000, 557710636, 376477722, 16057,
+     557710616, 376477716, 15689, 1193, 34, 10, true},
+    {417000, 557711714, 376477723, 16043,
+     557711644, 376477769, 15553, 1209, 35989, 10, true},
+    {418000, 557712792, 376477724, 16029,
+     557712920, 376478149, 15643, 1205, 61, 11, true},
+    {419000, 557713870, 376477725, 16014,
+     557713976, 376478072, 15958, 1201, 35, 10, true},
+    {420000, 557714948, 376477725, 16000,
+     557715056, 376477875, 15922, 1184, 38, 10, true},
+    {421000, 557716023, 376477877, 16000,
+     557716207, 376477641, 16008, 1190, 888, 11, true},
+    {422000, 557717071, 376478325, 16000,
+     557717143, 376478428, 16491, 1191, 1846, 10, true},
+    {423000, 557718067, 376479059, 16000,
+     557718081, 376478848, 16245, 1202, 2745, 11, true},
+    {424000, 557718986, 376480061, 16000,
+     557718853, 376480139, 16082, 1196, 3653, 10, true},
+    {425000, 557719806, 376481306, 16000,
+     557719757, 376481237, 16624, 1200, 4443, 9, true},
+    {426000, 557720506, 376482764, 16000,
+     557720365, 376482534, 16398, 1202, 5366, 10, true},
+    {427000, 557721069, 376484399, 16000,
+     557721232, 376484418, 15935, 1194, 6288, 10, true},
+    {428000, 557721482, 376486169, 16000,
+     557721571, 376486356, 16005, 1206, 7148, 9, true},
+    {429000, 557721733, 376488033, 16000,
+     557721885, 376487897, 16149, 1196, 8097, 9, true},
+    {430000, 557721818, 376489944, 16000,
+     557721917, 376489911, 15797, 1214, 8998, 10, true},
+    {431000, 557721818, 376491764, 16000,
+     557721897, 376491958, 15719, 1082, 8997, 9, true},
+    {432000, 557721818, 376493393, 16000,
+     557721829, 376493472, 16309, 965, 9072, 9, true},
+    {433000, 557721818, 376494831, 16000,
+     557721740, 376494910, 16218, 839, 8985, 10, true},
+    {434000, 557721818, 376496076, 16000,
+     557721921, 376496048, 15939, 716, 8927, 10, true},
+    {435000, 557721818, 376497130, 16000,
+     557721858, 376497093, 15748, 597, 9004, 10, true},
+    {436000, 557721818, 376497993, 16000,
+     557721796, 376498226, 16271, 481, 8949, 10, true},
+    {437000, 557721818, 376498664, 16000,
+     557721909, 376498795, 16224, 361, 9006, 10, true},
+    {438000, 557721818, 376499143, 16000,
+     557721778, 376499344, 16159, 249, 8990, 9, true},
+    {439000, 557721818, 376499430, 16000,
+     557721686, 376499643, 15926, 123, 9016, 10, true},
+    {440000, 557721818, 376499526, 16000,
+     557721801, 376499726, 15776, 8, 20243, 9, true},
+    {441000, 557721818, 376499526, 16000,
+     557721799, 376499824, 15973, 12, 16020, 8, true},
+    {442000, 557721818, 376499526, 16000,
+     557721902, 376499554, 16058, 8, 16544, 8, true},
+    {443000, 557721818, 376499526, 16000,
+     557721720, 376499872, 15902, 3, 27558, 9, true},
+    {444000, 557721818, 376499526, 16000,
+     557721856, 376499906, 15830, 8, 24727, 8, true},
+    {445000, 557721818, 376499526, 16000,
+     557721872, 376500016, 15881, 2, 18418, 9, true},
+    {446000, 557721818, 376499526, 16000,
+     557721782, 376500076, 15662, 18, 10166, 8, true},
+    {447000, 557721818, 376499526, 16000,
+     557721834, 376499949, 15811, 4, 16896, 8, true},
+    {448000, 557721818, 376499526, 16000,
+     557721908, 376499635, 15676, 20, 20391, 9, true},
+    {449000, 557721818, 376499526, 16000,
+     557721848, 376499728, 15766, 17, 28983, 8, true},
+    {450000, 557721818, 376499526, 16000,
+     557721771, 376499648, 15826, 9, 28282, 8, true},
+    {451000, 557721818, 376499526, 16000,
+     557721916, 376499611, 15935, 8, 1806, 9, true},
+    {452000, 557721818, 376499526, 16000,
+     557721897, 376499662, 16121, 4, 15284, 8, true},
+    {453000, 557721818, 376499526, 16000,
+     557721850, 376499802, 15904, 5, 1713, 9, true},
+    {454000, 557721818, 376499526, 16000,
+     557721850, 376499736, 16153, 5, 29779, 8, true},
+    {455000, 557721818, 376499526, 16000,
+     557721903, 376499672, 16220, 16, 17408, 9, true},
+    {456000, 557721818, 376499526, 16000,
+     557721770, 376499666, 16022, 12, 23007, 8, true},
+    {457000, 557721818, 376499526, 16000,
+     557721783, 376499496, 15954, 2, 24020, 8, true},
+    {458000, 557721818, 376499526, 16000,
+     557721950, 376499727, 15739, 0, 8243, 8, true},
+    {459000, 557721818, 376499526, 16000,
+     557721959, 376499806, 16170, 10, 1447, 9, true},
+    {460000, 557721818, 376499526, 16000,
+     557721831, 376499615, 16294, 3, 18446, 8, true},
+    {461000, 557721818, 376499526, 16000,
+     557721979, 376499601, 16101, 3, 27570, 8, true},
+    {462000, 557721818, 376499526, 16000,
+     557721871, 376499443, 16343, 3, 30163, 8, true},
+    {463000, 557721818, 376499526, 16000,
+     557721880, 376499688, 16117, 6, 23653, 7, true},
+    {464000, 557721818, 376499526, 16000,
+     557721830, 376499626, 16410, 14, 75, 7, true},
+    {465000, 557721818, 376499526, 16000,
+     557721929, 376499494, 15967, 4, 25428, 8, true},
+    {466000, 557721818, 376499526, 16000,
+     557721931, 376499581, 16312, 8, 33095, 8, true},
+    {467000, 557721818, 376499526, 16000,
+     557721885, 376499708, 16562, 3, 20278, 8, true},
+    {468000, 557721818, 376499526, 16000,
+     557721859, 376499675, 16287, 6, 17805, 8, true},
+    {469000, 557721818, 376499526, 16000,
+     557721977, 376499903, 16309, 4, 29428, 8, true},
+    {470000, 557721818, 376499526, 16000,
+     557721919, 376499787, 16096, 5, 26597, 8, true},
+    {471000, 557721818, 376499526, 16000,
+     557721850, 376499786, 16187, 12, 26958, 8, true},
+    {472000, 557721818, 376499526, 16000,
+     557721685, 376499830, 15914, 4, 29218, 7, true},
+    {473000, 557721818, 376499526, 16000,
+     557721802, 376499876, 16239, 1, 23713, 7, true},
+    {474000, 557721818, 376499526, 16000,
+     557721819, 376499783, 15940, 2, 10225, 8, true},
+    {475000, 557721818, 376499526, 16000,
+     557721913, 376499752, 15974, 5, 12691, 8, true},
+    {476000, 557721818, 376499526, 16000,
+     557721983, 376499687, 15889, 5, 28463, 7, true},
+    {477000, 557721818, 376499526, 16000,
+     557721910, 376499822, 15751, 5, 35501, 7, true},
+    {478000, 557721818, 376499526, 16000,
+     557721988, 376499894, 15777, 12, 12117, 8, true},
+    {479000, 557721818, 376499526, 16000,
+     557721882, 376499822, 15788, 11, 27679, 7, true},
+    {480000, 557721818, 376499526, 16000,
+     557721936, 376499678, 15674, 6, 3289, 7, true},
+    {481000, 557721818, 376499526, 16000,
+     557721912, 376499811, 16138, 1, 14726, 7, true},
+    {482000, 557721818, 376499526, 16000,
+     557721818, 376499659, 15607, 9, 369, 8, true},
+    {483000, 557721818, 376499526, 16000,
+     557721795, 376499768, 15775, 4, 25787, 8, true},
+    {484000, 557721818, 376499526, 16000,
+     557721855, 376499686, 15763, 4, 26252, 7, true},
+    {485000, 557721818, 376499526, 16000,
+     557721823, 376499855, 15908, 3, 29771, 7, true},
+    {486000, 557721818, 376499526, 16000,
+     557721847, 376499911, 15872, 8, 26884, 6, true},
+    {487000, 557721818, 376499526, 16000,
+     557721853, 376499869, 15778, 7, 20272, 8, true},
+    {488000, 557721818, 376499526, 16000,
+     557721825, 376499802, 15765, 9, 20016, 7, true},
+    {489000, 557721818, 376499526, 16000,
+     557721771, 376499643, 15854, 9, 26959, 7, true},
+    {490000, 557721818, 376499526, 16000,
+     557721869, 376499732, 15530, 7, 3078, 7, true},
+    {491000, 557721818, 376499526, 16000,
+     557721828, 376499689, 15940, 2, 233, 7, true},
+    {492000, 557721818, 376499526, 16000,
+     557721868, 376499721, 15930, 10, 33021, 7, true},
+    {493000, 557721818, 376499526, 16000,
+     557721816, 376499722, 15871, 13, 18957, 7, true},
+    {494000, 557721818, 376499526, 16000,
+     557721828, 376499766, 16132, 11, 2772, 6, true},
+    {495000, 557721818, 376499526, 16000,
+     557721821, 376499614, 16079, 16, 1305, 6, true},
+    {496000, 557721818, 376499526, 16000,
+     557721721, 376499726, 16076, 9, 34088, 7, true},
+    {497000, 557721818, 376499526, 16000,
+     557721778, 376499766, 16428, 1, 19111, 6, true},
+    {498000, 557721818, 376499526, 16000,
+     557721911, 376499754, 15860, 10, 26102, 7, true},
+    {499000, 557721818, 376499526, 16000,
+     557721843, 376499762, 15926, 10, 11831, 6, true},
+};
+
+constexpr size_t kTrackSize = sizeof(kTrack) / sizeof(kTrack[0]);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef TRACK_REPLAY_H
+#define TRACK_REPLAY_H
+
+// Helpers for the tests that replay drive_track.h through a module.
+
+#include <math.h>
+
+#include "drive_track.h"
+#include "nav_kalman.h"
+#include "nav_sample.h"
+
+constexpr double kMetersPerDegLat = 111320.0;
+constexpr double kDegToRad = M_PI / 180.0;
+
+// Flat-earth distance, plenty for the metres the tests compare.
+inline double horizontalErrorM(double latitude, double longitude,
+                               double truthLatitude, double truthLongitude) {
+  double north = (latitude - truthLatitude) * kMetersPerDegLat;
+  double east = (longitude - truthLongitude) * kMetersPerDegLat *
+                cos(truthLatitude * kDegToRad);
+  return sqrt(north * north + east * east);
+}
+
+inline double horizontalErrorM(double latitude, double longitude,
+                               const TrackRow &row) {
+  return horizontalErrorM(latitude, longitude, row.truthLatitudeE7 * 1e-7,
+                          row.truthLongitudeE7 * 1e-7);
+}
+
+// The accuracy the firmware derives from the fix's HDOP.
+inline float rowAccuracyM(const TrackRow &row) {
+  return horizontalAccuracyFromHdop(row.hdop10 * 0.1f);
+}
+
+inline NavDataSample sampleFrom(const TrackRow &row) {
+  NavDataSample sample;
+  sample.latitude = row.latitudeE7 * 1e-7;
+  sample.longitude = row.longitudeE7 * 1e-7;
+  sample.altitude = row.altitudeCm * 0.01f;
+  sample.speed = row.speedCms * 0.01f;
+  sample.heading = row.courseCdeg * 0.01f;
+  sample.horizontalAccuracy = rowAccuracyM(row);
+  return sample;
+}
+
+inline NavMeasurement measurementFrom(const TrackRow &row) {
+  NavMeasurement m;
+  m.latitude = row.latitudeE7 * 1e-7;
+  m.longitude = row.longitudeE7 * 1e-7;
+  m.altitude = row.altitudeCm * 0.01f;
+  m.speed = row.speedCms * 0.01f;
+  m.heading = row.courseCdeg * 0.01f;
+  m.horizontalAccuracy = rowAccuracyM(row);
+  return m;
+}
+
+// First row at or after timeMs, the last row if none.
+inline size_t rowAt(uint32_t timeMs) {
+  size_t i = 0;
+  while (i + 1 < kTrackSize && kTrack[i].timeMs < timeMs) {
+    ++i;
+  }
+  return i;
+}
+
+// Walks the track in order: onFix(index, row) for rows with a fix,
+// onLost(index, row) for the tunnel.
+template <typename OnFix, typename OnLost>
+void replayTrack(OnFix onFix, OnLost onLost) {
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    if (kTrack[i].fix) {
+      onFix(i, kTrack[i]);
+    } else {
+      onLost(i, kTrack[i]);
+    }
+  }
+}
+
+#endif
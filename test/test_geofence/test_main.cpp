@@ -0,0 +1,244 @@
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+
+#include "drive_track.h"
+#include "geofence.h"
+
+namespace {
+constexpr int32_t kOriginLatitudeE7 = 557512000;
+constexpr int32_t kOriginLongitudeE7 = 376184000;
+// About 10 km by 10 km at the track latitude.
+constexpr int32_t kAreaLatitudeE7 = 900000;
+constexpr int32_t kAreaLongitudeE7 = 1600000;
+constexpr size_t kProbePoints = 2000;
+
+uint32_t gSeed = 1;
+
+uint32_t nextRandom() {
+  gSeed ^= gSeed << 13;
+  gSeed ^= gSeed >> 17;
+  gSeed ^= gSeed << 5;
+  return gSeed;
+}
+
+int32_t randomIn(int32_t span) {
+  return static_cast<int32_t>(nextRandom() % static_cast<uint32_t>(span));
+}
+
+void randomPoint(int32_t &latitudeE7, int32_t &longitudeE7) {
+  latitudeE7 = kOriginLatitudeE7 - kAreaLatitudeE7 / 2 +
+               randomIn(kAreaLatitudeE7);
+  longitudeE7 = kOriginLongitudeE7 - kAreaLongitudeE7 / 2 +
+                randomIn(kAreaLongitudeE7);
+}
+
+// Circles of 30-400 m and quads or triangles of similar size, scattered
+// over the area; every tenth one is ten times larger.
+void buildRandomSet(GeofenceSet &set, size_t count, uint32_t seed) {
+  gSeed = seed;
+  set.clear();
+  for (size_t i = 0; i < count; ++i) {
+    int32_t latitude = 0;
+    int32_t longitude = 0;
+    randomPoint(latitude, longitude);
+    uint32_t scale = (i % 10 == 9) ? 10 : 1;
+    uint16_t id = static_cast<uint16_t>(i + 1);
+    if (nextRandom() % 2 == 0) {
+      uint32_t radius = (30 + nextRandom() % 370) * scale;
+      TEST_ASSERT_TRUE(set.addCircle(id, latitude, longitude, radius));
+    } else {
+      int32_t half = static_cast<int32_t>((300 + nextRandom() % 3300) * scale);
+      int32_t lats[4] = {latitude - half, latitude - half, latitude + half,
+                         latitude + half};
+      int32_t lons[4] = {longitude - 2 * half, longitude + 2 * half,
+                         longitude + half, longitude - half};
+      size_t vertices = nextRandom() % 2 == 0 ? 3 : 4;
+      TEST_ASSERT_TRUE(set.addPolygon(id, lats, lons, vertices));
+    }
+  }
+  set.build();
+}
+
+double nanosecondsPer(std::chrono::steady_clock::duration elapsed,
+                      size_t count) {
+  return std::chrono::duration<double, std::nano>(elapsed).count() / count;
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_parses_the_upload_format() {
+  GeofenceSet set;
+  TEST_ASSERT_TRUE(parseGeofenceLine("# depot", set));
+  TEST_ASSERT_TRUE(parseGeofenceLine("", set));
+  TEST_ASSERT_TRUE(parseGeofenceLine("C 7 55.7512 37.6184 150", set));
+  TEST_ASSERT_TRUE(parseGeofenceLine(
+      "P 8 55.75,37.61 55.76,37.61 55.76,37.63 55.75,37.63", set));
+  TEST_ASSERT_FALSE(parseGeofenceLine("C 9 55.7512 37.6184", set));
+  TEST_ASSERT_FALSE(parseGeofenceLine("P 10 55.75,37.61 55.76,37.61", set));
+  TEST_ASSERT_FALSE(parseGeofenceLine("X 11 1 2 3", set));
+  TEST_ASSERT_EQUAL(2, set.size());
+  TEST_ASSERT_EQUAL(7, set.fence(0).id);
+  TEST_ASSERT_EQUAL(4, set.vertexCount());
+}
+
+void test_transition_needs_two_fixes() {
+  GeofenceSet set;
+  TEST_ASSERT_TRUE(
+      set.addCircle(1, kOriginLatitudeE7, kOriginLongitudeE7, 100));
+  set.build();
+  GeofenceTransition out[4];
+  const int32_t outsideLatitude = kOriginLatitudeE7 + 20000; // ~220 m north
+  TEST_ASSERT_EQUAL(0, set.update(outsideLatitude, kOriginLongitudeE7, out,
+                                  4));
+  TEST_ASSERT_EQUAL(0, set.update(kOriginLatitudeE7, kOriginLongitudeE7, out,
+                                  4));
+  // One fix back out is jitter, not an exit.
+  TEST_ASSERT_EQUAL(0, set.update(outsideLatitude, kOriginLongitudeE7, out,
+                                  4));
+  TEST_ASSERT_EQUAL(0, set.update(kOriginLatitudeE7, kOriginLongitudeE7, out,
+                                  4));
+  TEST_ASSERT_EQUAL(1, set.update(kOriginLatitudeE7, kOriginLongitudeE7, out,
+                                  4));
+  TEST_ASSERT_TRUE(out[0].entered);
+  TEST_ASSERT_EQUAL(1, out[0].fenceId);
+  TEST_ASSERT_EQUAL(0, set.update(outsideLatitude, kOriginLongitudeE7, out,
+                                  4));
+  TEST_ASSERT_EQUAL(1, set.update(outsideLatitude, kOriginLongitudeE7, out,
+                                  4));
+  TEST_ASSERT_FALSE(out[0].entered);
+  TEST_ASSERT_EQUAL(0, set.insideCount());
+}
+
+void test_grid_agrees_with_brute_force() {
+  GeofenceSet set;
+  buildRandomSet(set, 300, 0x5eed);
+  GeofenceTransition out[64];
+  size_t insideTotal = 0;
+  for (size_t p = 0; p < kProbePoints; ++p) {
+    int32_t latitude = 0;
+    int32_t longitude = 0;
+    randomPoint(latitude, longitude);
+    // The second update confirms whatever the first one started.
+    set.update(latitude, longitude, out, 64);
+    set.update(latitude, longitude, out, 64);
+    for (size_t i = 0; i < set.size(); ++i) {
+      bool expected = set.contains(i, latitude, longitude);
+      TEST_ASSERT_EQUAL(expected, set.inside(i));
+      insideTotal += expected ? 1 : 0;
+    }
+  }
+  // The probe would prove little if it never landed in a fence.
+  TEST_ASSERT_GREATER_THAN(kProbePoints / 4, insideTotal);
+}
+
+void test_candidates_stay_a_small_share() {
+  const size_t sizes[] = {300, 5000};
+  for (size_t size : sizes) {
+    GeofenceSet set;
+    buildRandomSet(set, size, 0xfe11ce);
+    GeofenceTransition out[64];
+    uint64_t candidates = 0;
+    for (size_t p = 0; p < kProbePoints; ++p) {
+      int32_t latitude = 0;
+      int32_t longitude = 0;
+      randomPoint(latitude, longitude);
+      set.update(latitude, longitude, out, 64);
+      candidates += set.lastCandidates();
+    }
+    double average = static_cast<double>(candidates) / kProbePoints;
+    char message[80];
+    snprintf(message, sizeof(message),
+             "%u fences, %u cells: %.1f candidates per fix",
+             static_cast<unsigned>(size),
+             static_cast<unsigned>(set.gridCells()), average);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(size / 20, static_cast<uint32_t>(average));
+  }
+}
+
+void test_grid_beats_the_full_scan() {
+  GeofenceSet set;
+  buildRandomSet(set, 5000, 0xfe11ce);
+  int32_t latitudes[kProbePoints];
+  int32_t longitudes[kProbePoints];
+  for (size_t p = 0; p < kProbePoints; ++p) {
+    randomPoint(latitudes[p], longitudes[p]);
+  }
+  GeofenceTransition out[64];
+  auto started = std::chrono::steady_clock::now();
+  for (size_t p = 0; p < kProbePoints; ++p) {
+    set.update(latitudes[p], longitudes[p], out, 64);
+  }
+  double gridNs =
+      nanosecondsPer(std::chrono::steady_clock::now() - started, kProbePoints);
+
+  size_t hits = 0;
+  started = std::chrono::steady_clock::now();
+  for (size_t p = 0; p < kProbePoints; ++p) {
+    for (size_t i = 0; i < set.size(); ++i) {
+      hits += set.contains(i, latitudes[p], longitudes[p]) ? 1 : 0;
+    }
+  }
+  double scanNs =
+      nanosecondsPer(std::chrono::steady_clock::now() - started, kProbePoints);
+  char message[80];
+  snprintf(message, sizeof(message),
+           "5000 fences: grid %.0f ns, full scan %.0f ns per fix (%u hits)",
+           gridNs, scanNs, static_cast<unsigned>(hits));
+  TEST_MESSAGE(message);
+  // The gap is two orders of magnitude; a factor of ten leaves room for a
+  // noisy host.
+  TEST_ASSERT_LESS_THAN_FLOAT(scanNs / 10.0, gridNs);
+}
+
+void test_drive_reports_each_crossing_once() {
+  // A 60 m circle on the red light (the car stands at 210-240 s) and the
+  // parking lot at the end as a polygon.
+  const TrackRow &light = kTrack[225];
+  const TrackRow &parked = kTrack[kTrackSize - 1];
+  GeofenceSet set;
+  TEST_ASSERT_TRUE(
+      set.addCircle(1, light.truthLatitudeE7, light.truthLongitudeE7, 60));
+  const int32_t lats[4] = {
+      parked.truthLatitudeE7 - 5000, parked.truthLatitudeE7 - 5000,
+      parked.truthLatitudeE7 + 5000, parked.truthLatitudeE7 + 5000};
+  const int32_t lons[4] = {
+      parked.truthLongitudeE7 - 8000, parked.truthLongitudeE7 + 8000,
+      parked.truthLongitudeE7 + 8000, parked.truthLongitudeE7 - 8000};
+  TEST_ASSERT_TRUE(set.addPolygon(2, lats, lons, 4));
+  set.build();
+
+  size_t enters[3] = {};
+  size_t exits[3] = {};
+  GeofenceTransition out[4];
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    if (!kTrack[i].fix) {
+      continue;
+    }
+    size_t count =
+        set.update(kTrack[i].latitudeE7, kTrack[i].longitudeE7, out, 4);
+    for (size_t t = 0; t < count; ++t) {
+      (out[t].entered ? enters : exits)[out[t].fenceId]++;
+    }
+  }
+  TEST_ASSERT_EQUAL(1, enters[1]);
+  TEST_ASSERT_EQUAL(1, exits[1]);
+  TEST_ASSERT_EQUAL(1, enters[2]);
+  TEST_ASSERT_EQUAL(0, exits[2]);
+  TEST_ASSERT_TRUE(set.inside(1));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_parses_the_upload_format);
+  RUN_TEST(test_transition_needs_two_fixes);
+  RUN_TEST(test_grid_agrees_with_brute_force);
+  RUN_TEST(test_candidates_stay_a_small_share);
+  RUN_TEST(test_grid_beats_the_full_scan);
+  RUN_TEST(test_drive_reports_each_crossing_once);
+  return UNITY_END();
+}
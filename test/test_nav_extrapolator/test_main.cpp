@@ -0,0 +1,195 @@
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "nav_extrapolator.h"
+#include "track_replay.h"
+
+namespace {
+// Track time 0 on the local clock; PPS marks each track second.
+constexpr int64_t kBootUs = 5000000;
+constexpr int64_t kNmeaLatencyUs = 80000;
+constexpr int64_t kOutputPeriodUs = 50000; // 20 Hz nav-out job
+constexpr uint32_t kOutageWindowMs = 30000;
+
+struct ReplayResult {
+  double fixErrorSum = 0.0; // measured fixes against the truth
+  size_t fixes = 0;
+  double predictedErrorSum = 0.0; // between epochs, fix present
+  size_t predicted = 0;
+  size_t bridged = 0; // estimated samples inside the tunnel
+  size_t bridgeMisses = 0;
+  size_t uncovered = 0; // bridged error above the claimed accuracy
+  float lastBridgeErrorM = 0.0f;
+  bool accuracyGrows = true;
+};
+
+NavExtrapolator gExtrapolator;
+ReplayResult gResult;
+
+int64_t localUs(uint32_t trackMs) {
+  return kBootUs + static_cast<int64_t>(trackMs) * 1000;
+}
+
+// Ground truth at any local time, linear between the 1 Hz rows.
+void truthAt(int64_t atUs, double &latitude, double &longitude) {
+  double trackS = static_cast<double>(atUs - kBootUs) * 1e-6;
+  size_t row = static_cast<size_t>(trackS);
+  if (row + 1 >= kTrackSize) {
+    row = kTrackSize - 2;
+  }
+  double t = trackS - row;
+  const TrackRow &a = kTrack[row];
+  const TrackRow &b = kTrack[row + 1];
+  latitude = (a.truthLatitudeE7 + (b.truthLatitudeE7 - a.truthLatitudeE7) * t) *
+             1e-7;
+  longitude =
+      (a.truthLongitudeE7 + (b.truthLongitudeE7 - a.truthLongitudeE7) * t) *
+      1e-7;
+}
+
+NavDataSample measuredSample(const TrackRow &row) {
+  NavDataSample sample = sampleFrom(row);
+  sample.speedAccuracy = 0.2f;
+  return sample;
+}
+
+// Feeds fixes as they arrive over NMEA and runs the nav-out job between
+// them, the way GpsController does at NAV_OUTPUT_RATE_HZ = 20.
+void replay() {
+  gExtrapolator = NavExtrapolator();
+  gExtrapolator.setOutageWindow(kOutageWindowMs);
+  gResult = ReplayResult();
+  float previousAccuracy = 0.0f;
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    const TrackRow &row = kTrack[i];
+    int64_t ppsUs = localUs(row.timeMs);
+    int64_t arrivalUs = ppsUs + kNmeaLatencyUs;
+    if (row.fix) {
+      NavDataSample sample = measuredSample(row);
+      gExtrapolator.onMeasurement(sample, arrivalUs, ppsUs);
+      gResult.fixErrorSum +=
+          horizontalErrorM(sample.latitude, sample.longitude, row);
+      gResult.fixes++;
+    }
+    for (int64_t at = arrivalUs + kOutputPeriodUs;
+         at < arrivalUs + 1000000; at += kOutputPeriodUs) {
+      NavDataSample out;
+      bool lost = !row.fix;
+      if (!gExtrapolator.extrapolate(at, out, lost)) {
+        if (lost) {
+          gResult.bridgeMisses++;
+        }
+        continue;
+      }
+      double truthLatitude = 0.0;
+      double truthLongitude = 0.0;
+      truthAt(at, truthLatitude, truthLongitude);
+      double error = horizontalErrorM(out.latitude, out.longitude,
+                                      truthLatitude, truthLongitude);
+      if (!lost) {
+        gResult.predictedErrorSum += error;
+        gResult.predicted++;
+        previousAccuracy = 0.0f;
+        continue;
+      }
+      TEST_ASSERT_TRUE(out.estimated);
+      gResult.bridged++;
+      gResult.lastBridgeErrorM = static_cast<float>(error);
+      if (error > out.horizontalAccuracy) {
+        gResult.uncovered++;
+      }
+      if (out.horizontalAccuracy < previousAccuracy) {
+        gResult.accuracyGrows = false;
+      }
+      previousAccuracy = out.horizontalAccuracy;
+    }
+  }
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_epochs_lock_to_the_pps_grid() {
+  ExtrapolationStats stats = gExtrapolator.stats();
+  TEST_ASSERT_EQUAL_UINT32(1000, stats.epochPeriodMs);
+  TEST_ASSERT_TRUE(gExtrapolator.epochUs() ==
+                   localUs(kTrack[kTrackSize - 1].timeMs));
+}
+
+void test_predictions_are_as_good_as_the_fixes() {
+  double fixError = gResult.fixErrorSum / gResult.fixes;
+  double predictedError = gResult.predictedErrorSum / gResult.predicted;
+  char message[80];
+  snprintf(message, sizeof(message),
+           "mean error: fixes %.2f m, 20 Hz predictions %.2f m", fixError,
+           predictedError);
+  TEST_MESSAGE(message);
+  // Turns and braking add a little on top of the fix noise.
+  TEST_ASSERT_LESS_THAN_FLOAT(fixError + 1.0, predictedError);
+}
+
+void test_tunnel_is_bridged_for_its_whole_length() {
+  // 20 s of lost fix at 20 Hz, all inside the 30 s window.
+  TEST_ASSERT_EQUAL_UINT32(0, gResult.bridgeMisses);
+  TEST_ASSERT_EQUAL_UINT32(20 * 19, gResult.bridged);
+  TEST_ASSERT_TRUE(gResult.accuracyGrows);
+  TEST_ASSERT_EQUAL_UINT32(0, gResult.uncovered);
+  // Straight at 12 m/s: the velocity of the last fix carries it through.
+  TEST_ASSERT_LESS_THAN_FLOAT(10.0f, gResult.lastBridgeErrorM);
+}
+
+void test_fix_after_the_tunnel_scores_the_bridge() {
+  ExtrapolationStats stats = gExtrapolator.stats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.outages);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 21.0f, stats.lastOutageS);
+  TEST_ASSERT_LESS_THAN_FLOAT(10.0f, stats.lastOutageErrorM);
+  TEST_ASSERT_EQUAL_UINT32(gResult.bridged, stats.estimated);
+}
+
+void test_bridge_ends_with_the_window() {
+  NavExtrapolator extrapolator;
+  extrapolator.setOutageWindow(5000);
+  const TrackRow &row = kTrack[300];
+  int64_t ppsUs = localUs(row.timeMs);
+  extrapolator.onMeasurement(measuredSample(row), ppsUs + kNmeaLatencyUs,
+                             ppsUs);
+  NavDataSample out;
+  TEST_ASSERT_TRUE(extrapolator.extrapolate(ppsUs + 4900000, out, true));
+  TEST_ASSERT_TRUE(out.estimated);
+  TEST_ASSERT_FALSE(extrapolator.extrapolate(ppsUs + 5100000, out, true));
+  // Once past the window the old fix is dropped for good.
+  TEST_ASSERT_FALSE(extrapolator.extrapolate(ppsUs + 5200000, out, false));
+  const TrackRow &next = kTrack[310];
+  int64_t nextPpsUs = localUs(next.timeMs);
+  extrapolator.onMeasurement(measuredSample(next), nextPpsUs + kNmeaLatencyUs,
+                             nextPpsUs);
+  TEST_ASSERT_EQUAL_UINT32(0, extrapolator.stats().outages);
+}
+
+void test_no_bridge_without_a_window() {
+  NavExtrapolator extrapolator;
+  const TrackRow &row = kTrack[300];
+  int64_t ppsUs = localUs(row.timeMs);
+  extrapolator.onMeasurement(measuredSample(row), ppsUs + kNmeaLatencyUs,
+                             ppsUs);
+  NavDataSample out;
+  TEST_ASSERT_TRUE(extrapolator.extrapolate(ppsUs + 500000, out, false));
+  TEST_ASSERT_TRUE(out.extrapolated);
+  TEST_ASSERT_FALSE(out.estimated);
+  TEST_ASSERT_FALSE(extrapolator.extrapolate(ppsUs + 500000, out, true));
+}
+
+int main() {
+  replay();
+  UNITY_BEGIN();
+  RUN_TEST(test_epochs_lock_to_the_pps_grid);
+  RUN_TEST(test_predictions_are_as_good_as_the_fixes);
+  RUN_TEST(test_tunnel_is_bridged_for_its_whole_length);
+  RUN_TEST(test_fix_after_the_tunnel_scores_the_bridge);
+  RUN_TEST(test_bridge_ends_with_the_window);
+  RUN_TEST(test_no_bridge_without_a_window);
+  return UNITY_END();
+}
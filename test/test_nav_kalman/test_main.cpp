@@ -0,0 +1,135 @@
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "nav_kalman.h"
+#include "track_replay.h"
+
+namespace {
+// Same reset rule as GpsController::applyNavFilter.
+constexpr uint32_t kMaxGapMs = 5000;
+
+struct Replayed {
+  bool valid;
+  float rawErrorM;
+  float errorM;
+  float speed;
+  float horizontalAccuracy;
+};
+
+Replayed gResults[kTrackSize];
+NavKalmanFilter gFilter;
+
+void replay() {
+  gFilter = NavKalmanFilter();
+  uint32_t lastMs = 0;
+  auto onFix = [&](size_t i, const TrackRow &row) {
+    if (gFilter.initialized()) {
+      uint32_t gapMs = row.timeMs - lastMs;
+      if (gapMs > kMaxGapMs) {
+        gFilter.reset();
+      } else {
+        gFilter.predict(gapMs * 1e-3f);
+      }
+    }
+    lastMs = row.timeMs;
+    NavMeasurement m = measurementFrom(row);
+    gFilter.update(m);
+    NavEstimate estimate = gFilter.estimate();
+    Replayed &out = gResults[i];
+    out.valid = estimate.valid;
+    out.rawErrorM =
+        static_cast<float>(horizontalErrorM(m.latitude, m.longitude, row));
+    out.errorM = static_cast<float>(
+        horizontalErrorM(estimate.latitude, estimate.longitude, row));
+    out.speed = estimate.speed;
+    out.horizontalAccuracy = estimate.horizontalAccuracy;
+  };
+  replayTrack(onFix, [](size_t i, const TrackRow &) { gResults[i] = {}; });
+}
+
+bool moving(const TrackRow &row) { return row.speedCms >= 200; }
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_every_fix_yields_an_estimate() {
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    TEST_ASSERT_EQUAL(kTrack[i].fix, gResults[i].valid);
+  }
+}
+
+void test_filter_is_closer_to_truth_than_the_fixes() {
+  double rawSq = 0.0;
+  double filteredSq = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    if (!gResults[i].valid || kTrack[i].timeMs == kTrackOutlierMs) {
+      continue;
+    }
+    rawSq += gResults[i].rawErrorM * gResults[i].rawErrorM;
+    filteredSq += gResults[i].errorM * gResults[i].errorM;
+    count++;
+  }
+  float rawRms = static_cast<float>(sqrt(rawSq / count));
+  float filteredRms = static_cast<float>(sqrt(filteredSq / count));
+  char message[64];
+  snprintf(message, sizeof(message), "raw %.2f m, filtered %.2f m", rawRms,
+           filteredRms);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.9f * rawRms, filteredRms);
+}
+
+void test_multipath_outlier_is_gated() {
+  size_t i = rowAt(kTrackOutlierMs);
+  TEST_ASSERT_GREATER_THAN_FLOAT(30.0f, gResults[i].rawErrorM);
+  TEST_ASSERT_LESS_THAN_FLOAT(8.0f, gResults[i].errorM);
+  TEST_ASSERT_GREATER_OR_EQUAL(1, gFilter.rejectedCount());
+}
+
+void test_tunnel_exit_reseeds_the_filter() {
+  // The 20 s gap is the only one past the reset threshold.
+  TEST_ASSERT_EQUAL(1, gFilter.resetCount());
+  size_t exit = rowAt(kTrackTunnelEndMs);
+  for (size_t i = exit; i < exit + 5; ++i) {
+    TEST_ASSERT_LESS_THAN_FLOAT(10.0f, gResults[i].errorM);
+  }
+}
+
+void test_parked_speed_stays_near_zero() {
+  // Skip the first fixes while the velocity variance settles.
+  for (size_t i = 10; i < kTrackSize && kTrack[i].timeMs < 60000; ++i) {
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, gResults[i].speed);
+  }
+}
+
+void test_accuracy_covers_the_error_while_moving() {
+  size_t covered = 0;
+  size_t count = 0;
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    if (!gResults[i].valid || !moving(kTrack[i]) ||
+        kTrack[i].timeMs == kTrackOutlierMs) {
+      continue;
+    }
+    count++;
+    if (gResults[i].errorM <= 2.0f * gResults[i].horizontalAccuracy) {
+      covered++;
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(100, count);
+  TEST_ASSERT_GREATER_OR_EQUAL(count * 9 / 10, covered);
+}
+
+int main() {
+  replay();
+  UNITY_BEGIN();
+  RUN_TEST(test_every_fix_yields_an_estimate);
+  RUN_TEST(test_filter_is_closer_to_truth_than_the_fixes);
+  RUN_TEST(test_multipath_outlier_is_gated);
+  RUN_TEST(test_tunnel_exit_reseeds_the_filter);
+  RUN_TEST(test_parked_speed_stays_near_zero);
+  RUN_TEST(test_accuracy_covers_the_error_while_moving);
+  return UNITY_END();
+}
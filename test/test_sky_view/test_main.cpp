@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <unity.h>
+
+#include "satellite_table.h"
+#include "sky_view.h"
+
+namespace {
+// 23-byte default ATT MTU less the notification header: three records.
+constexpr size_t kSmallFrame = 20;
+constexpr size_t kLargeFrame = 244;
+constexpr size_t kDrainFrames = 64;
+
+uint32_t gSeed = 1;
+
+uint32_t nextRandom() {
+  gSeed ^= gSeed << 13;
+  gSeed ^= gSeed >> 17;
+  gSeed ^= gSeed << 5;
+  return gSeed;
+}
+
+// What a phone holds after applying every frame it was sent.
+struct ClientView {
+  SatelliteTable satellites;
+  uint8_t nextSequence = 0;
+  bool sequenceKnown = false;
+  bool overflow = false;
+
+  void apply(const uint8_t *frame, size_t length) {
+    TEST_ASSERT_EQUAL_UINT8(kSkyViewVersion, frame[0]);
+    TEST_ASSERT_EQUAL(kSkyViewHeaderSize + frame[3] * kSkyViewRecordSize,
+                      length);
+    if (sequenceKnown) {
+      TEST_ASSERT_EQUAL_UINT8(nextSequence, frame[2]);
+    }
+    nextSequence = static_cast<uint8_t>(frame[2] + 1);
+    sequenceKnown = true;
+    if (frame[1] & kSkyViewFlagReset) {
+      satellites.clear();
+    }
+    for (size_t i = 0; i < frame[3]; ++i) {
+      const uint8_t *record =
+          frame + kSkyViewHeaderSize + i * kSkyViewRecordSize;
+      SatelliteRecord sat;
+      sat.gnssId = record[0] & 0x0F;
+      sat.svId = record[1];
+      if (record[0] & 0x20) {
+        satellites.remove(sat.gnssId, sat.svId);
+        continue;
+      }
+      sat.used = (record[0] & 0x80) != 0;
+      sat.elevation = record[2];
+      sat.azimuth = static_cast<uint16_t>(record[3] |
+                                          ((record[0] & 0x40) ? 0x100 : 0));
+      sat.cno = record[4];
+      if (!satellites.update(sat, 0)) {
+        overflow = true;
+      }
+    }
+  }
+};
+
+// Sends frames until the encoder has nothing left.
+void drain(SkyViewEncoder &encoder, const SatelliteTable &current,
+           ClientView &client, size_t frameLength) {
+  uint8_t frame[kLargeFrame];
+  for (size_t i = 0; i < kDrainFrames; ++i) {
+    size_t length = encoder.nextFrame(current, frame, frameLength);
+    if (length == 0) {
+      return;
+    }
+    client.apply(frame, length);
+  }
+  TEST_FAIL_MESSAGE("encoder never caught up");
+}
+
+// The client matches the table up to the C/N0 deadband.
+void checkInSync(const SatelliteTable &current, const ClientView &client) {
+  TEST_ASSERT_FALSE(client.overflow);
+  TEST_ASSERT_EQUAL(current.size(), client.satellites.size());
+  SatelliteRecord sat;
+  SatelliteRecord seen;
+  for (size_t i = 0; i < current.capacity(); ++i) {
+    if (!current.at(i, sat)) {
+      continue;
+    }
+    TEST_ASSERT_TRUE(client.satellites.find(sat.gnssId, sat.svId, seen));
+    TEST_ASSERT_EQUAL(sat.used, seen.used);
+    TEST_ASSERT_EQUAL_UINT8(sat.elevation, seen.elevation);
+    TEST_ASSERT_EQUAL(sat.azimuth, seen.azimuth);
+    TEST_ASSERT_INT32_WITHIN(SkyViewEncoder::kCnoDeadbandDb - 1, sat.cno,
+                             seen.cno);
+  }
+}
+
+SatelliteRecord randomSatellite() {
+  SatelliteRecord sat;
+  sat.gnssId = static_cast<uint8_t>(1 + nextRandom() % 5);
+  sat.svId = static_cast<uint8_t>(1 + nextRandom() % 36);
+  sat.cno = static_cast<uint8_t>(nextRandom() % 55);
+  sat.elevation = static_cast<uint8_t>(nextRandom() % 91);
+  sat.azimuth = static_cast<uint16_t>(nextRandom() % 360);
+  sat.used = nextRandom() % 3 == 0;
+  return sat;
+}
+
+// Drops a random satellite, found by walking from a random slot.
+void removeRandom(SatelliteTable &table) {
+  SatelliteRecord sat;
+  size_t start = nextRandom() % table.capacity();
+  for (size_t i = 0; i < table.capacity(); ++i) {
+    if (table.at((start + i) % table.capacity(), sat)) {
+      table.remove(sat.gnssId, sat.svId);
+      return;
+    }
+  }
+}
+
+// Churns a sky of up to 180 candidates, so the table sits at its limit,
+// while only one or two frames go out between changes: the encoder is
+// left with many removals it has not sent yet.
+void runChurn(uint32_t seed, size_t frameLength) {
+  gSeed = seed;
+  SatelliteTable current;
+  SkyViewEncoder encoder;
+  ClientView client;
+  uint8_t frame[kLargeFrame];
+  size_t nearFull = 0;
+  for (uint32_t step = 0; step < 3000; ++step) {
+    size_t adds = nextRandom() % 6;
+    for (size_t i = 0; i < adds; ++i) {
+      current.update(randomSatellite(), step);
+    }
+    // Satellites set about as fast as they rise once the table is full.
+    size_t drops = nextRandom() % (current.size() > 56 ? 6 : 2);
+    for (size_t i = 0; i < drops; ++i) {
+      removeRandom(current);
+    }
+    if (current.size() + 8 >= current.capacity()) {
+      nearFull++;
+    }
+    size_t frames = 1 + nextRandom() % 2;
+    for (size_t i = 0; i < frames; ++i) {
+      size_t length = encoder.nextFrame(current, frame, frameLength);
+      if (length > 0) {
+        client.apply(frame, length);
+      }
+    }
+    if (step % 50 == 49) {
+      drain(encoder, current, client, frameLength);
+      checkInSync(current, client);
+    }
+  }
+  // The churn is only a test of the limit if it gets there.
+  TEST_ASSERT_GREATER_THAN(300, nearFull);
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_first_frame_resets_and_carries_the_table() {
+  SatelliteTable current;
+  gSeed = 7;
+  for (size_t i = 0; i < 20; ++i) {
+    current.update(randomSatellite(), 0);
+  }
+  SkyViewEncoder encoder;
+  ClientView client;
+  uint8_t frame[kLargeFrame];
+  size_t length = encoder.nextFrame(current, frame, sizeof(frame));
+  TEST_ASSERT_TRUE(frame[1] & kSkyViewFlagReset);
+  TEST_ASSERT_FALSE(frame[1] & kSkyViewFlagMore);
+  client.apply(frame, length);
+  checkInSync(current, client);
+  TEST_ASSERT_EQUAL(0, encoder.nextFrame(current, frame, sizeof(frame)));
+}
+
+void test_small_changes_stay_quiet() {
+  SatelliteTable current;
+  SatelliteRecord sat;
+  sat.gnssId = 1;
+  sat.svId = 12;
+  sat.cno = 40;
+  sat.elevation = 30;
+  sat.azimuth = 300;
+  current.update(sat, 0);
+  SkyViewEncoder encoder;
+  ClientView client;
+  drain(encoder, current, client, kSmallFrame);
+  sat.cno = 41;
+  current.update(sat, 1);
+  uint8_t frame[kLargeFrame];
+  TEST_ASSERT_EQUAL(0, encoder.nextFrame(current, frame, sizeof(frame)));
+  sat.cno = 42;
+  current.update(sat, 2);
+  size_t length = encoder.nextFrame(current, frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(kSkyViewHeaderSize + kSkyViewRecordSize, length);
+  client.apply(frame, length);
+  checkInSync(current, client);
+}
+
+void test_removal_reaches_the_client() {
+  SatelliteTable current;
+  gSeed = 11;
+  for (size_t i = 0; i < 10; ++i) {
+    current.update(randomSatellite(), 0);
+  }
+  SkyViewEncoder encoder;
+  ClientView client;
+  drain(encoder, current, client, kSmallFrame);
+  removeRandom(current);
+  removeRandom(current);
+  drain(encoder, current, client, kSmallFrame);
+  checkInSync(current, client);
+}
+
+void test_churn_at_capacity_leaves_no_ghosts_small_frames() {
+  runChurn(0x5ca1ab1e, kSmallFrame);
+}
+
+void test_churn_at_capacity_leaves_no_ghosts_large_frames() {
+  runChurn(0xdecade, kLargeFrame);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_frame_resets_and_carries_the_table);
+  RUN_TEST(test_small_changes_stay_quiet);
+  RUN_TEST(test_removal_reaches_the_client);
+  RUN_TEST(test_churn_at_capacity_leaves_no_ghosts_small_frames);
+  RUN_TEST(test_churn_at_capacity_leaves_no_ghosts_large_frames);
+  return UNITY_END();
+}
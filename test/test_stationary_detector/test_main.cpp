@@ -0,0 +1,147 @@
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "stationary_detector.h"
+#include "track_replay.h"
+
+namespace {
+// STATIONARY_WINDOW_S in gps_config.h.
+constexpr uint32_t kWindowMs = 5000;
+
+struct Replayed {
+  bool held;
+  double latitude;
+  double longitude;
+  float speed;
+  bool stationary;
+};
+
+Replayed gResults[kTrackSize];
+StationaryDetector gDetector(kWindowMs);
+
+// Raw fixes, as with NAV_FILTER_ENABLED 0; a lost fix resets the detector
+// the way GpsController does.
+void replay() {
+  gDetector = StationaryDetector(kWindowMs);
+  auto onFix = [](size_t i, const TrackRow &row) {
+    NavDataSample sample = sampleFrom(row);
+    Replayed &out = gResults[i];
+    out.held = gDetector.update(sample, row.timeMs);
+    out.latitude = sample.latitude;
+    out.longitude = sample.longitude;
+    out.speed = sample.speed;
+    out.stationary = sample.stationary;
+  };
+  auto onLost = [](size_t i, const TrackRow &row) {
+    gResults[i] = Replayed();
+    gDetector.reset(row.timeMs);
+  };
+  replayTrack(onFix, onLost);
+}
+
+// First held row at or after fromMs, kTrackSize if none.
+size_t firstHeld(uint32_t fromMs) {
+  for (size_t i = rowAt(fromMs); i < kTrackSize; ++i) {
+    if (gResults[i].held) {
+      return i;
+    }
+  }
+  return kTrackSize;
+}
+
+// First row at or after fromMs that is not held.
+size_t firstReleased(uint32_t fromMs) {
+  for (size_t i = rowAt(fromMs); i < kTrackSize; ++i) {
+    if (!gResults[i].held) {
+      return i;
+    }
+  }
+  return kTrackSize;
+}
+
+// Checks the hold over one stop: it starts a window after the car stands,
+// keeps one position with zero speed and ends within a fix of pulling away.
+void checkStop(uint32_t stoppedMs, uint32_t pullAwayMs) {
+  size_t start = firstHeld(stoppedMs);
+  TEST_ASSERT_TRUE(start < kTrackSize);
+  TEST_ASSERT_UINT32_WITHIN(1000, stoppedMs + kWindowMs,
+                            kTrack[start].timeMs);
+  size_t end = firstReleased(kTrack[start].timeMs);
+  for (size_t i = start; i < end; ++i) {
+    TEST_ASSERT_TRUE(gResults[i].stationary);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, gResults[i].speed);
+    TEST_ASSERT_TRUE(gResults[i].latitude == gResults[start].latitude);
+    TEST_ASSERT_TRUE(gResults[i].longitude == gResults[start].longitude);
+    // The window mean sits on the car, not on one noisy fix.
+    TEST_ASSERT_LESS_THAN_FLOAT(
+        5.0f, horizontalErrorM(gResults[i].latitude, gResults[i].longitude,
+                               kTrack[i]));
+  }
+  if (pullAwayMs == 0) {
+    TEST_ASSERT_EQUAL(kTrackSize, end);
+    return;
+  }
+  // The first fix over 1 m/s comes one second into the pull-away.
+  TEST_ASSERT_EQUAL_UINT32(pullAwayMs + 1000, kTrack[end].timeMs);
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_holds_while_parked_at_the_start() { checkStop(0, 60000); }
+
+void test_holds_at_the_red_light() { checkStop(210000, 240000); }
+
+void test_holds_while_parked_at_the_end() { checkStop(440000, 0); }
+
+void test_never_holds_while_moving() {
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    if (kTrack[i].speedCms >= 100) {
+      TEST_ASSERT_FALSE(gResults[i].held);
+    }
+  }
+  StationaryStats stats = gDetector.stats(kTrack[kTrackSize - 1].timeMs);
+  TEST_ASSERT_EQUAL_UINT32(3, stats.holds);
+  TEST_ASSERT_TRUE(stats.holding);
+}
+
+void test_stop_shorter_than_the_window_is_not_held() {
+  StationaryDetector detector(kWindowMs);
+  // Four parked fixes, then the car moves on.
+  for (size_t i = 10; i < 14; ++i) {
+    NavDataSample sample = sampleFrom(kTrack[i]);
+    TEST_ASSERT_FALSE(detector.update(sample, kTrack[i].timeMs));
+  }
+  NavDataSample moving = sampleFrom(kTrack[100]);
+  TEST_ASSERT_FALSE(detector.update(moving, 14000));
+  TEST_ASSERT_EQUAL_UINT32(0, detector.stats(14000).holds);
+}
+
+void test_scatter_above_the_accuracy_is_not_held() {
+  // Slow fixes that wander 20 m around a 3 m accuracy: walking pace or a
+  // receiver in trouble, not a parked car.
+  StationaryDetector detector(kWindowMs);
+  const TrackRow &row = kTrack[20];
+  for (uint32_t t = 0; t <= 10; ++t) {
+    NavDataSample sample = sampleFrom(row);
+    sample.latitude += ((t % 2) ? 20.0 : -20.0) / kMetersPerDegLat;
+    sample.horizontalAccuracy = 3.0f;
+    TEST_ASSERT_FALSE(detector.update(sample, t * 1000));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, detector.stats(10000).holds);
+}
+
+int main() {
+  replay();
+  UNITY_BEGIN();
+  RUN_TEST(test_holds_while_parked_at_the_start);
+  RUN_TEST(test_holds_at_the_red_light);
+  RUN_TEST(test_holds_while_parked_at_the_end);
+  RUN_TEST(test_never_holds_while_moving);
+  RUN_TEST(test_stop_shorter_than_the_window_is_not_held);
+  RUN_TEST(test_scatter_above_the_accuracy_is_not_held);
+  return UNITY_END();
+}
@@ -0,0 +1,152 @@
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "track_replay.h"
+#include "trip_computer.h"
+
+namespace {
+constexpr double kEarthRadiusM = 6371008.8;
+
+TripComputer gComputer;
+// Totals right after the parked start and before the parked end.
+TripTotals gAfterStart;
+TripTotals gBeforeEnd;
+
+double haversineM(int32_t latitudeE7A, int32_t longitudeE7A,
+                  int32_t latitudeE7B, int32_t longitudeE7B) {
+  double lat1 = latitudeE7A * 1e-7 * kDegToRad;
+  double lat2 = latitudeE7B * 1e-7 * kDegToRad;
+  double dLat = lat2 - lat1;
+  double dLon = (longitudeE7B - longitudeE7A) * 1e-7 * kDegToRad;
+  double a = sin(dLat / 2) * sin(dLat / 2) +
+             cos(lat1) * cos(lat2) * sin(dLon / 2) * sin(dLon / 2);
+  return 2.0 * kEarthRadiusM * asin(sqrt(a));
+}
+
+double truthDistanceM() {
+  double total = 0.0;
+  for (size_t i = 1; i < kTrackSize; ++i) {
+    total += haversineM(kTrack[i - 1].truthLatitudeE7,
+                        kTrack[i - 1].truthLongitudeE7,
+                        kTrack[i].truthLatitudeE7,
+                        kTrack[i].truthLongitudeE7);
+  }
+  return total;
+}
+
+// Receiver-quality fixes as TripMeter gets them: measured epochs only.
+void replay() {
+  gComputer.reset();
+  for (size_t i = 0; i < kTrackSize; ++i) {
+    const TrackRow &row = kTrack[i];
+    if (row.timeMs == 60000) {
+      gAfterStart = gComputer.totals();
+    } else if (row.timeMs == 445000) {
+      gBeforeEnd = gComputer.totals();
+    }
+    if (!row.fix) {
+      continue;
+    }
+    TripFix fix;
+    fix.timeMs = row.timeMs;
+    fix.latitudeE7 = row.latitudeE7;
+    fix.longitudeE7 = row.longitudeE7;
+    fix.altitudeCm = row.altitudeCm;
+    fix.speedCms = row.speedCms;
+    fix.accuracyCm = static_cast<uint16_t>(rowAccuracyM(row) * 100.0f);
+    gComputer.update(fix);
+  }
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_step_matches_haversine() {
+  // 100 m and 10 km steps in several directions at the track latitude.
+  const int32_t lat = 557512000;
+  const int32_t lon = 376184000;
+  const int32_t offsets[][2] = {
+      {8983, 0}, {0, 15946}, {6352, 11276}, {-898315, 0}, {0, -1594600}};
+  for (const auto &offset : offsets) {
+    double expected =
+        haversineM(lat, lon, lat + offset[0], lon + offset[1]) * 1000.0;
+    uint32_t step =
+        TripComputer::stepMm(lat, lon, lat + offset[0], lon + offset[1]);
+    TEST_ASSERT_FLOAT_WITHIN(expected * 0.002, expected, step);
+  }
+}
+
+void test_distance_follows_the_truth() {
+  double truth = truthDistanceM();
+  double measured = gComputer.totals().distanceMm / 1000.0;
+  char message[64];
+  snprintf(message, sizeof(message), "truth %.0f m, trip %.0f m", truth,
+           measured);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_FLOAT_WITHIN(truth * 0.03, truth, measured);
+}
+
+void test_parking_adds_no_distance() {
+  TEST_ASSERT_TRUE(gAfterStart.distanceMm == 0);
+  TEST_ASSERT_FALSE(gComputer.moving());
+  TEST_ASSERT_TRUE(gComputer.totals().distanceMm == gBeforeEnd.distanceMm);
+}
+
+void test_counts_the_light_and_the_final_stop() {
+  TEST_ASSERT_EQUAL_UINT32(2, gComputer.totals().stops);
+}
+
+void test_speed_and_moving_time() {
+  const TripTotals &totals = gComputer.totals();
+  TEST_ASSERT_UINT32_WITHIN(50, 1400, totals.maxSpeedCms);
+  // Driving is 60-210 s and 240-440 s; the 20 s tunnel gap is not counted
+  // and the slow fixes before each stop is confirmed are.
+  TEST_ASSERT_UINT32_WITHIN(20000, 330000, totals.movingMs);
+  // The tunnel adds distance but no moving time.
+  TEST_ASSERT_UINT32_WITHIN(100, 1250, gComputer.averageSpeedCms());
+}
+
+void test_elevation_ignores_altitude_noise() {
+  // The drive climbs 20 m and descends 10 m. Receiver altitude drifts by
+  // metres over tens of seconds, which no filter can tell from terrain, so
+  // the check is the net change plus a bound against summing every step.
+  uint32_t naiveGainCm = 0;
+  int32_t previousCm = kTrack[0].altitudeCm;
+  for (size_t i = 1; i < kTrackSize; ++i) {
+    if (!kTrack[i].fix) {
+      continue;
+    }
+    if (kTrack[i].altitudeCm > previousCm) {
+      naiveGainCm += kTrack[i].altitudeCm - previousCm;
+    }
+    previousCm = kTrack[i].altitudeCm;
+  }
+  const TripTotals &totals = gComputer.totals();
+  char message[80];
+  snprintf(message, sizeof(message),
+           "gain %lu cm, loss %lu cm, naive %lu cm",
+           static_cast<unsigned long>(totals.elevationGainCm),
+           static_cast<unsigned long>(totals.elevationLossCm),
+           static_cast<unsigned long>(naiveGainCm));
+  TEST_MESSAGE(message);
+  int32_t net = static_cast<int32_t>(totals.elevationGainCm) -
+                static_cast<int32_t>(totals.elevationLossCm);
+  TEST_ASSERT_INT32_WITHIN(300, 1000, net);
+  TEST_ASSERT_GREATER_OR_EQUAL(1700, totals.elevationGainCm);
+  TEST_ASSERT_LESS_THAN(naiveGainCm / 10, totals.elevationGainCm);
+}
+
+int main() {
+  replay();
+  UNITY_BEGIN();
+  RUN_TEST(test_step_matches_haversine);
+  RUN_TEST(test_distance_follows_the_truth);
+  RUN_TEST(test_parking_adds_no_distance);
+  RUN_TEST(test_counts_the_light_and_the_final_stop);
+  RUN_TEST(test_speed_and_moving_time);
+  RUN_TEST(test_elevation_ignores_altitude_noise);
+  return UNITY_END();
+}
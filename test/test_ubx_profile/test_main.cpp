@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "ubx_profile.h"
+
+namespace {
+// CFG-NAVSPG-DYNMODEL (U1), CFG-RATE-MEAS (U2), CFG-NAVSPG-INIFIX3D (L)
+// and CFG-NAVSPG-CONSTR_ALT (I4).
+constexpr uint32_t kDynModel = 0x20110021;
+constexpr uint32_t kRateMeas = 0x30210001;
+constexpr uint32_t kIniFix3d = 0x10110013;
+constexpr uint32_t kConstrAlt = 0x401100C1;
+
+UbxNamedProfile gProfile;
+
+bool parse(const char *json, const char *&error) {
+  error = nullptr;
+  return parseUbxProfileJson(json, strlen(json), gProfile, error);
+}
+
+bool parse(const char *json) {
+  const char *error = nullptr;
+  return parse(json, error);
+}
+
+// The single item of a one-item profile, refused or not.
+bool parseItem(const char *items, uint64_t &value, const char *&error) {
+  char json[96];
+  snprintf(json, sizeof(json), "{\"name\":\"t\",\"items\":{%s}}", items);
+  if (!parse(json, error)) {
+    return false;
+  }
+  TEST_ASSERT_EQUAL(1, gProfile.itemCount);
+  value = gProfile.items[0].value;
+  return true;
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_parses_a_profile() {
+  TEST_ASSERT_TRUE(parse("{\"name\":\"rover\",\"layers\":3,\"items\":"
+                         "{\"20110021\":4,\"0x30210001\":100}}"));
+  TEST_ASSERT_EQUAL(0, strcmp("rover", gProfile.name));
+  TEST_ASSERT_EQUAL_UINT8(3, gProfile.layers);
+  TEST_ASSERT_EQUAL(2, gProfile.itemCount);
+  TEST_ASSERT_EQUAL_UINT32(kDynModel, gProfile.items[0].key);
+  TEST_ASSERT_EQUAL(4, gProfile.items[0].value);
+  TEST_ASSERT_EQUAL_UINT32(kRateMeas, gProfile.items[1].key);
+  TEST_ASSERT_EQUAL(100, gProfile.items[1].value);
+}
+
+void test_rejects_malformed_profiles() {
+  const char *error = nullptr;
+  TEST_ASSERT_FALSE(parse("{\"items\":{\"20110021\":4}}", error));
+  TEST_ASSERT_EQUAL(0, strcmp("missing name", error));
+  TEST_ASSERT_FALSE(parse("{\"name\":\"bad name\",\"items\":{}}"));
+  TEST_ASSERT_FALSE(parse("{\"name\":\"t\",\"items\":{}}"));
+  TEST_ASSERT_FALSE(parse("{\"name\":\"t\",\"layers\":8,"
+                          "\"items\":{\"20110021\":4}}"));
+  TEST_ASSERT_FALSE(parse("{\"name\":\"t\",\"layers\":-1,"
+                          "\"items\":{\"20110021\":4}}"));
+  TEST_ASSERT_FALSE(parse("{\"name\":\"t\",\"items\":{\"00110021\":4}}"));
+  TEST_ASSERT_FALSE(parse("{\"name\":\"t\",\"items\":{\"20110021\":4}} x"));
+}
+
+void test_values_must_fit_the_key() {
+  uint64_t value = 0;
+  const char *error = nullptr;
+  TEST_ASSERT_TRUE(parseItem("\"20110021\":255", value, error));
+  TEST_ASSERT_EQUAL(255, value);
+  TEST_ASSERT_FALSE(parseItem("\"20110021\":300", value, error));
+  TEST_ASSERT_EQUAL(0, strcmp("value out of range for the key size", error));
+  TEST_ASSERT_FALSE(parseItem("\"20110021\":\"0x100\"", value, error));
+  TEST_ASSERT_TRUE(parseItem("\"30210001\":65535", value, error));
+  TEST_ASSERT_FALSE(parseItem("\"30210001\":65536", value, error));
+}
+
+void test_negative_values_use_the_signed_range() {
+  uint64_t value = 0;
+  const char *error = nullptr;
+  TEST_ASSERT_TRUE(parseItem("\"20110021\":-1", value, error));
+  TEST_ASSERT_EQUAL(0xFF, value);
+  TEST_ASSERT_TRUE(parseItem("\"20110021\":-128", value, error));
+  TEST_ASSERT_EQUAL(0x80, value);
+  TEST_ASSERT_FALSE(parseItem("\"20110021\":-129", value, error));
+  TEST_ASSERT_TRUE(parseItem("\"401100C1\":-2000", value, error));
+  TEST_ASSERT_EQUAL_UINT32(kConstrAlt, gProfile.items[0].key);
+  TEST_ASSERT_EQUAL(0xFFFFF830u, value);
+  TEST_ASSERT_FALSE(parseItem("\"401100C1\":-2147483649", value, error));
+}
+
+void test_l_keys_take_zero_or_one() {
+  uint64_t value = 0;
+  const char *error = nullptr;
+  TEST_ASSERT_TRUE(parseItem("\"10110013\":1", value, error));
+  TEST_ASSERT_EQUAL_UINT32(kIniFix3d, gProfile.items[0].key);
+  TEST_ASSERT_EQUAL(1, value);
+  TEST_ASSERT_TRUE(parseItem("\"10110013\":0", value, error));
+  TEST_ASSERT_FALSE(parseItem("\"10110013\":2", value, error));
+  TEST_ASSERT_EQUAL(0, strcmp("L key takes 0 or 1", error));
+  TEST_ASSERT_FALSE(parseItem("\"10110013\":-1", value, error));
+}
+
+void test_blob_and_json_round_trip() {
+  TEST_ASSERT_TRUE(parse("{\"name\":\"rt\",\"layers\":5,\"items\":"
+                         "{\"20110021\":-1,\"10110013\":1,"
+                         "\"401100C1\":-2000,\"30210001\":200}}"));
+  UbxNamedProfile parsed = gProfile;
+  uint8_t blob[kUbxProfileBlobMax];
+  size_t length = encodeUbxProfile(parsed, blob, sizeof(blob));
+  TEST_ASSERT_EQUAL(4 + 2 + 4 * 4 + 1 + 1 + 4 + 2, length);
+  UbxNamedProfile decoded;
+  // A cut blob is refused.
+  TEST_ASSERT_FALSE(decodeUbxProfile(blob, length - 1, decoded));
+  TEST_ASSERT_TRUE(decodeUbxProfile(blob, length, decoded));
+
+  // What the firmware lists comes back as the same profile.
+  char json[256];
+  size_t jsonLength = 0;
+  TEST_ASSERT_TRUE(
+      formatUbxProfileJson(decoded, json, sizeof(json), jsonLength));
+  TEST_ASSERT_TRUE(parse(json));
+  TEST_ASSERT_EQUAL(0, strcmp(parsed.name, gProfile.name));
+  TEST_ASSERT_EQUAL_UINT8(parsed.layers, gProfile.layers);
+  TEST_ASSERT_EQUAL(parsed.itemCount, gProfile.itemCount);
+  for (size_t i = 0; i < parsed.itemCount; ++i) {
+    TEST_ASSERT_EQUAL_UINT32(parsed.items[i].key, gProfile.items[i].key);
+    TEST_ASSERT_TRUE(parsed.items[i].value == gProfile.items[i].value);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_parses_a_profile);
+  RUN_TEST(test_rejects_malformed_profiles);
+  RUN_TEST(test_values_must_fit_the_key);
+  RUN_TEST(test_negative_values_use_the_signed_range);
+  RUN_TEST(test_l_keys_take_zero_or_one);
+  RUN_TEST(test_blob_and_json_round_trip);
+  return UNITY_END();
+}
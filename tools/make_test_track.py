@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Generate test/fixtures/drive_track.h, the 1 Hz drive the native unit tests
+replay through the navigation code.
+
+A real recording has no ground truth to score a filter against, so the
+drive is simulated: a parked start, a climb, a turn, a stop at a light, a
+multipath outlier, a 20 s tunnel, a descent and a parked end. The receiver
+error is modelled the way it looks in u-blox logs: a slow Gauss-Markov
+drift (tau 30 s) plus white noise, both scaled by HDOP, and a small
+non-zero speed with random course while standing still. The seed is
+fixed, so the output only changes when this script does.
+
+Usage: python tools/make_test_track.py [-o test/fixtures/drive_track.h]
+"""
+
+from pathlib import Path
+import argparse
+import math
+import random
+
+SEED = 20240611
+ORIGIN_LAT = 55.7512
+ORIGIN_LON = 37.6184
+ORIGIN_ALT_M = 150.0
+METERS_PER_DEG_LAT = 111320.0
+
+DRIFT_TAU_S = 30.0
+DRIFT_SIGMA_M = 1.5
+WHITE_SIGMA_M = 0.8
+ALT_DRIFT_SIGMA_M = 2.5
+ALT_WHITE_SIGMA_M = 1.2
+SPEED_SIGMA_MS = 0.08
+OUTLIER_TIME_S = 280
+OUTLIER_EAST_M = 35.0
+TUNNEL = (330, 350)
+DURATION_S = 500
+
+# (end time s, target speed m/s, heading rate deg/s, climb m/s); speed
+# changes linearly from the previous segment's over each segment.
+SEGMENTS = [
+    (60, 0.0, 0.0, 0.0),        # parked
+    (70, 14.0, 0.0, 0.0),       # pull away, heading east
+    (190, 14.0, 0.0, 1 / 6),    # cruise, climbing 20 m
+    (200, 14.0, -9.0, 0.0),     # left turn to north
+    (210, 0.0, 0.0, 0.0),       # brake
+    (240, 0.0, 0.0, 0.0),       # red light
+    (250, 12.0, 0.0, 0.0),
+    (350, 12.0, 0.0, 0.0),      # cruise north, tunnel at the end
+    (420, 12.0, 0.0, -1 / 7),   # descending 10 m
+    (430, 12.0, 9.0, 0.0),      # right turn back to east
+    (440, 0.0, 0.0, 0.0),
+    (DURATION_S, 0.0, 0.0, 0.0),
+]
+
+
+def simulate():
+  rng = random.Random(SEED)
+  rows = []
+  east = north = 0.0
+  alt = ORIGIN_ALT_M
+  heading = 90.0
+  speed = 0.0
+  drift = [0.0, 0.0, 0.0]
+  decay = math.exp(-1.0 / DRIFT_TAU_S)
+  sigmas = [DRIFT_SIGMA_M, DRIFT_SIGMA_M, ALT_DRIFT_SIGMA_M]
+  start = 0
+  for end, target, turn, climb in SEGMENTS:
+    initial = speed
+    for t in range(start, end):
+      hdop = 0.9 + 0.3 * math.sin(t / 45.0) + rng.uniform(0.0, 0.2)
+      for i in range(3):
+        drift[i] = drift[i] * decay + rng.gauss(0.0, sigmas[i]) * math.sqrt(
+            1 - decay * decay)
+      lat = ORIGIN_LAT + north / METERS_PER_DEG_LAT
+      meters_per_deg_lon = METERS_PER_DEG_LAT * math.cos(math.radians(lat))
+      lon = ORIGIN_LON + east / meters_per_deg_lon
+      fix = not TUNNEL[0] <= t < TUNNEL[1]
+      noise_e = hdop * (drift[0] + rng.gauss(0.0, WHITE_SIGMA_M))
+      noise_n = hdop * (drift[1] + rng.gauss(0.0, WHITE_SIGMA_M))
+      if t == OUTLIER_TIME_S:
+        noise_e += OUTLIER_EAST_M
+      noise_alt = 1.5 * hdop * (drift[2] + rng.gauss(0.0, ALT_WHITE_SIGMA_M))
+      if speed > 0.5:
+        speed_meas = max(0.0, speed + rng.gauss(0.0, SPEED_SIGMA_MS))
+        course = (heading + rng.gauss(0.0, 0.5)) % 360.0
+      else:
+        speed_meas = abs(rng.gauss(0.0, 0.1))
+        course = rng.uniform(0.0, 360.0)
+      rows.append({
+          "t": t * 1000,
+          "truth": (lat, lon, alt),
+          "meas": (lat + noise_n / METERS_PER_DEG_LAT,
+                   lon + noise_e / meters_per_deg_lon, alt + noise_alt),
+          "speed": speed_meas,
+          "course": course,
+          "hdop": hdop,
+          "fix": fix,
+      })
+      # Advance the truth to the next second.
+      progress = (t + 1 - start) / (end - start)
+      next_speed = initial + (target - initial) * progress
+      mean_speed = 0.5 * (speed + next_speed)
+      heading_mid = math.radians(heading + 0.5 * turn)
+      east += mean_speed * math.sin(heading_mid)
+      north += mean_speed * math.cos(heading_mid)
+      alt += climb
+      heading = (heading + turn) % 360.0
+      speed = next_speed
+    start = end
+  return rows
+
+
+def e7(value):
+  return int(round(value * 1e7))
+
+
+def render(rows):
+  lines = [
+      "#ifndef DRIVE_TRACK_H",
+      "#define DRIVE_TRACK_H",
+      "",
+      "// Generated by tools/make_test_track.py; do not edit.",
+      "",
+      "#include <stddef.h>",
+      "#include <stdint.h>",
+      "",
+      "struct TrackRow {",
+      "  uint32_t timeMs;",
+      "  int32_t truthLatitudeE7;",
+      "  int32_t truthLongitudeE7;",
+      "  int32_t truthAltitudeCm;",
+      "  int32_t latitudeE7;",
+      "  int32_t longitudeE7;",
+      "  int32_t altitudeCm;",
+      "  uint16_t speedCms;",
+      "  uint16_t courseCdeg;",
+      "  uint8_t hdop10;",
+      "  bool fix;",
+      "};",
+      "",
+      "constexpr uint32_t kTrackOutlierMs = %d;" % (OUTLIER_TIME_S * 1000),
+      "constexpr uint32_t kTrackTunnelStartMs = %d;" % (TUNNEL[0] * 1000),
+      "constexpr uint32_t kTrackTunnelEndMs = %d;" % (TUNNEL[1] * 1000),
+      "",
+      "static const TrackRow kTrack[] = {",
+  ]
+  for row in rows:
+    lat, lon, alt = row["truth"]
+    mlat, mlon, malt = row["meas"]
+    lines.append(
+        "    {%d, %d, %d, %d,\n     %d, %d, %d, %d, %d, %d, %s}," %
+        (row["t"], e7(lat), e7(lon), round(alt * 100), e7(mlat), e7(mlon),
+         round(malt * 100), round(row["speed"] * 100),
+         round(row["course"] * 100) % 36000, round(row["hdop"] * 10),
+         "true" if row["fix"] else "false"))
+  lines += [
+      "};",
+      "",
+      "constexpr size_t kTrackSize = sizeof(kTrack) / sizeof(kTrack[0]);",
+      "",
+      "#endif",
+      "",
+  ]
+  return "\n".join(lines)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  root = Path(__file__).resolve().parent.parent
+  parser.add_argument("-o", "--output", type=Path,
+                      default=root / "test" / "fixtures" / "drive_track.h")
+  args = parser.parse_args()
+  args.output.parent.mkdir(parents=True, exist_ok=True)
+  args.output.write_text(render(simulate()))
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""
+Decode track files recorded by the firmware (/tracks/NNNNN.trk on LittleFS).
+
+The format is described in include/track_format.h. Prints CSV by default or
+GPX with --gpx, plus a summary on stderr. Blocks with a bad sync or CRC are
+reported and skipped, the rest of the file still decodes.
+
+Usage: python tools/track_decode.py 00012.trk [--gpx] [-o out.gpx]
+"""
+
+from datetime import datetime, timezone
+from pathlib import Path
+import argparse
+import struct
+import sys
+import zlib
+
+FILE_MAGIC = b"GTRK"
+FORMAT_VERSION = 1
+FILE_HEADER = struct.Struct("<4sBBHI")
+BLOCK_HEADER = struct.Struct("<BBHHI")
+BLOCK_SYNC = (0xA5, 0x5A)
+BLOCK_PAYLOAD_MAX = 4096 - BLOCK_HEADER.size
+
+RECORD_KEY = 1
+RECORD_DELTA = 2
+FLAG_PPS_LOCKED = 0x01
+FLAG_FILTERED = 0x02
+FLAG_LOCAL_TIME = 0x04
+FULL_TURN_CDEG = 36000
+
+
+class TrackFormatError(Exception):
+  pass
+
+
+def _uvarint(data, offset):
+  value = 0
+  shift = 0
+  while True:
+    if offset >= len(data) or shift >= 64:
+      raise TrackFormatError("truncated varint")
+    byte = data[offset]
+    offset += 1
+    value |= (byte & 0x7F) << shift
+    if not byte & 0x80:
+      return value, offset
+    shift += 7
+
+
+def _svarint(data, offset):
+  value, offset = _uvarint(data, offset)
+  return (value >> 1) ^ -(value & 1), offset
+
+
+def _decode_block(payload):
+  fixes = []
+  reference = None
+  offset = 0
+  while offset < len(payload):
+    head = payload[offset]
+    offset += 1
+    kind = head & 0x0F
+    if kind == RECORD_KEY:
+      time_ms, offset = _uvarint(payload, offset)
+      lat, offset = _svarint(payload, offset)
+      lon, offset = _svarint(payload, offset)
+      alt, offset = _svarint(payload, offset)
+      speed, offset = _uvarint(payload, offset)
+      heading, offset = _uvarint(payload, offset)
+    elif kind == RECORD_DELTA and reference is not None:
+      dt, offset = _uvarint(payload, offset)
+      dlat, offset = _svarint(payload, offset)
+      dlon, offset = _svarint(payload, offset)
+      dalt, offset = _svarint(payload, offset)
+      dspeed, offset = _svarint(payload, offset)
+      dheading, offset = _svarint(payload, offset)
+      time_ms = reference["time_ms"] + dt
+      lat = reference["lat_e7"] + dlat
+      lon = reference["lon_e7"] + dlon
+      alt = reference["alt_dm"] + dalt
+      speed = reference["speed_cms"] + dspeed
+      heading = (reference["heading_cdeg"] + dheading) % FULL_TURN_CDEG
+    else:
+      raise TrackFormatError(f"bad record type {kind} at offset {offset - 1}")
+    accuracy, offset = _uvarint(payload, offset)
+    reference = {
+        "time_ms": time_ms,
+        "lat_e7": lat,
+        "lon_e7": lon,
+        "alt_dm": alt,
+        "speed_cms": speed,
+        "heading_cdeg": heading % FULL_TURN_CDEG,
+        "acc_dm": accuracy,
+        "flags": head >> 4,
+    }
+    fixes.append(reference)
+  return fixes
+
+
+def decode_track(data):
+  """Returns (track_id, fixes, errors) for the raw contents of a .trk file."""
+  if len(data) < FILE_HEADER.size:
+    raise TrackFormatError("file too short")
+  magic, version, _, _, track_id = FILE_HEADER.unpack_from(data)
+  if magic != FILE_MAGIC or version != FORMAT_VERSION:
+    raise TrackFormatError("not a version 1 track file")
+
+  fixes = []
+  errors = []
+  offset = FILE_HEADER.size
+  while offset + BLOCK_HEADER.size <= len(data):
+    sync0, sync1, length, count, crc = BLOCK_HEADER.unpack_from(data, offset)
+    if (sync0, sync1) != BLOCK_SYNC or length > BLOCK_PAYLOAD_MAX:
+      # Lost framing: scan forward for the next block sync.
+      errors.append(f"offset {offset}: bad block header")
+      offset = data.find(bytes(BLOCK_SYNC), offset + 1)
+      if offset < 0:
+        break
+      continue
+    start = offset + BLOCK_HEADER.size
+    payload = data[start:start + length]
+    offset = start + length
+    if len(payload) < length:
+      errors.append(f"offset {start}: truncated block")
+      break
+    if zlib.crc32(payload) != crc:
+      errors.append(f"offset {start}: CRC mismatch, block skipped")
+      continue
+    try:
+      block = _decode_block(payload)
+    except TrackFormatError as exc:
+      errors.append(f"offset {start}: {exc}")
+      continue
+    if len(block) != count:
+      errors.append(f"offset {start}: {len(block)} records, header says "
+                    f"{count}")
+    fixes.extend(block)
+  return track_id, fixes, errors
+
+
+def _iso_time(fix):
+  if fix["flags"] & FLAG_LOCAL_TIME:
+    return None
+  stamp = datetime.fromtimestamp(fix["time_ms"] / 1000.0, tz=timezone.utc)
+  return stamp.isoformat(timespec="milliseconds").replace("+00:00", "Z")
+
+
+def write_csv(fixes, out):
+  out.write("time,lat,lon,alt_m,speed_ms,heading_deg,hacc_m,pps,filtered\n")
+  for fix in fixes:
+    time = _iso_time(fix) or f"+{fix['time_ms'] / 1000.0:.3f}s"
+    out.write(f"{time},{fix['lat_e7'] / 1e7:.7f},{fix['lon_e7'] / 1e7:.7f},"
+              f"{fix['alt_dm'] / 10.0:.1f},{fix['speed_cms'] / 100.0:.2f},"
+              f"{fix['heading_cdeg'] / 100.0:.2f},{fix['acc_dm'] / 10.0:.1f},"
+              f"{int(bool(fix['flags'] & FLAG_PPS_LOCKED))},"
+              f"{int(bool(fix['flags'] & FLAG_FILTERED))}\n")
+
+
+def write_gpx(track_id, fixes, out):
+  out.write('<?xml version="1.0" encoding="UTF-8"?>\n'
+            '<gpx version="1.1" creator="ublox-gps-ble" '
+            'xmlns="http://www.topografix.com/GPX/1/1">\n'
+            f"<trk><name>track {track_id}</name><trkseg>\n")
+  for fix in fixes:
+    out.write(f'<trkpt lat="{fix["lat_e7"] / 1e7:.7f}" '
+              f'lon="{fix["lon_e7"] / 1e7:.7f}">'
+              f"<ele>{fix['alt_dm'] / 10.0:.1f}</ele>")
+    time = _iso_time(fix)
+    if time:
+      out.write(f"<time>{time}</time>")
+    out.write("</trkpt>\n")
+  out.write("</trkseg></trk>\n</gpx>\n")
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+  parser.add_argument("track", type=Path)
+  parser.add_argument("--gpx", action="store_true", help="write GPX")
+  parser.add_argument("-o", "--output", type=Path, help="default: stdout")
+  args = parser.parse_args()
+
+  data = args.track.read_bytes()
+  try:
+    track_id, fixes, errors = decode_track(data)
+  except TrackFormatError as exc:
+    sys.exit(f"{args.track}: {exc}")
+
+  out = args.output.open("w") if args.output else sys.stdout
+  try:
+    if args.gpx:
+      write_gpx(track_id, fixes, out)
+    else:
+      write_csv(fixes, out)
+  finally:
+    if args.output:
+      out.close()
+
+  for error in errors:
+    print(f"{args.track}: {error}", file=sys.stderr)
+  per_fix = len(data) / len(fixes) if fixes else 0.0
+  print(f"track {track_id}: {len(fixes)} fixes, {len(data)} bytes, "
+        f"{per_fix:.1f} bytes/fix", file=sys.stderr)
+
+
+if __name__ == "__main__":
+  main()